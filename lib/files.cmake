@@ -5,6 +5,7 @@ set(smooth_inc_dir ${CMAKE_CURRENT_LIST_DIR}/smooth/include/smooth)
 
 set(SMOOTH_SOURCES
         ${smooth_dir}/application/display/LCDSpi.cpp
+        ${smooth_dir}/application/compression/GzipCompressor.cpp
         ${smooth_dir}/application/hash/base64.cpp
         ${smooth_dir}/application/hash/sha.cpp
         ${smooth_dir}/application/io/i2c/ADS1115.cpp
@@ -19,18 +20,30 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/application/io/wiegand/Wiegand.cpp
         ${smooth_dir}/application/network/http/HTTPProtocol.cpp
         ${smooth_dir}/application/network/http/HTTPServerClient.cpp
+        ${smooth_dir}/application/network/http/ResponsePacketSource.cpp
         ${smooth_dir}/application/network/http/http_utils.cpp
+        ${smooth_dir}/application/network/http/regular/ByteRanges.cpp
+        ${smooth_dir}/application/network/http/regular/ChunkedEncoding.cpp
+        ${smooth_dir}/application/network/http/regular/CompiledTemplate.cpp
         ${smooth_dir}/application/network/http/regular/HTTPHeaderDef.cpp
+        ${smooth_dir}/application/network/http/regular/HTTPHeaderParser.cpp
         ${smooth_dir}/application/network/http/regular/HTTPPacket.cpp
         ${smooth_dir}/application/network/http/regular/HTTPRequestHandler.cpp
         ${smooth_dir}/application/network/http/regular/MIMEParser.cpp
         ${smooth_dir}/application/network/http/regular/RegularHTTPProtocol.cpp
+        ${smooth_dir}/application/network/http/regular/RequestRouter.cpp
+        ${smooth_dir}/application/network/http/regular/responses/CachedFileResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/ErrorResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/FileContentResponse.cpp
+        ${smooth_dir}/application/network/http/regular/responses/GzipResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/HeaderOnlyResponse.cpp
+        ${smooth_dir}/application/network/http/regular/responses/StreamingResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/StringResponse.cpp
+        ${smooth_dir}/application/network/http/regular/responses/TemplateResponse.cpp
+        ${smooth_dir}/application/network/http/regular/StaticFileCache.cpp
         ${smooth_dir}/application/network/http/regular/TemplateProcessor.cpp
         ${smooth_dir}/application/network/http/URLEncoding.cpp
+        ${smooth_dir}/application/network/http/websocket/Masking.cpp
         ${smooth_dir}/application/network/http/websocket/responses/WSResponse.cpp
         ${smooth_dir}/application/network/http/websocket/WebsocketProtocol.cpp
         ${smooth_dir}/application/network/http/websocket/WebSocketServer.cpp
@@ -65,6 +78,7 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/application/security/PasswordHash.cpp
         ${smooth_dir}/core/Application.cpp
         ${smooth_dir}/core/filesystem/File.cpp
+        ${smooth_dir}/core/filesystem/FileReader.cpp
         ${smooth_dir}/core/filesystem/filesystem.cpp
         ${smooth_dir}/core/filesystem/FSLock.cpp
         ${smooth_dir}/core/filesystem/MMCSDCard.cpp
@@ -85,10 +99,15 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/core/json/JsonFile.cpp
         ${smooth_dir}/core/logging/log.cpp
         ${smooth_dir}/core/network/CommonSocket.cpp
+        ${smooth_dir}/core/network/CryptoWorkerPool.cpp
+        ${smooth_dir}/core/network/EpollBackend.cpp
         ${smooth_dir}/core/network/IPv4.cpp
         ${smooth_dir}/core/network/IPv6.cpp
         ${smooth_dir}/core/network/MbedTLSContext.cpp
+        ${smooth_dir}/core/network/ReadAheadBuffer.cpp
+        ${smooth_dir}/core/network/SelectBackend.cpp
         ${smooth_dir}/core/network/SocketDispatcher.cpp
+        ${smooth_dir}/core/network/TLSSessionCache.cpp
         ${smooth_dir}/core/network/Wifi.cpp
         ${smooth_dir}/core/sntp/Sntp.cpp
         ${smooth_dir}/core/SystemStatistics.cpp
@@ -96,6 +115,7 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/core/timer/ElapsedTime.cpp
         ${smooth_dir}/core/timer/Timer.cpp
         ${smooth_dir}/core/timer/TimerService.cpp
+        ${smooth_dir}/core/timer/TimerWheel.cpp
         ${smooth_dir}/core/util/string_util.cpp
         ${smooth_inc_dir}/application/display/DisplayPin.h
         ${smooth_inc_dir}/application/display/LCDSpi.h
@@ -104,6 +124,7 @@ set(SMOOTH_SOURCES
         ${smooth_inc_dir}/application/display/ILI9341.h
         ${smooth_inc_dir}/application/display/SH1107.h
         ${smooth_inc_dir}/application/display/ST7735.h
+        ${smooth_inc_dir}/application/compression/GzipCompressor.h
         ${smooth_inc_dir}/application/io/spi/BME280SPI.h
         ${smooth_inc_dir}/application/io/spi/BME280Core.h
         ${smooth_inc_dir}/application/io/i2c/ADS1115.h
@@ -118,13 +139,21 @@ set(SMOOTH_SOURCES
         ${smooth_inc_dir}/application/network/http/HTTPServerConfig.h
         ${smooth_inc_dir}/application/network/http/http_utils.h
         ${smooth_inc_dir}/application/network/http/IResponseOperation.h
+        ${smooth_inc_dir}/application/network/http/ResponsePacketSource.h
+        ${smooth_inc_dir}/application/network/http/regular/ByteRanges.h
+        ${smooth_inc_dir}/application/network/http/regular/ChunkedEncoding.h
         ${smooth_inc_dir}/application/network/http/regular/ITemplateDataRetriever.h
         ${smooth_inc_dir}/application/network/http/regular/RegularHTTPProtocol.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/CachedFileResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/ErrorResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/FileContentResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/GzipResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/StreamingResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/StringResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/StaticFileCache.h
         ${smooth_inc_dir}/application/network/http/regular/TemplateProcessor.h
         ${smooth_inc_dir}/application/network/http/URLEncoding.h
+        ${smooth_inc_dir}/application/network/http/websocket/Masking.h
         ${smooth_inc_dir}/application/network/http/websocket/WebsocketProtocol.h
         ${smooth_inc_dir}/application/network/http/websocket/WebsocketServer.h
         ${smooth_inc_dir}/application/network/mqtt/event/BaseEvent.h
@@ -0,0 +1,312 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/compression/GzipCompressor.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace smooth::application::compression
+{
+    static constexpr std::size_t min_match = 3;
+    static constexpr std::size_t max_match = 258;
+    static constexpr int max_chain = 32;
+    static constexpr uint32_t end_of_block = 256;
+
+    static constexpr std::array<uint16_t, 29> length_base{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                           35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+
+    static constexpr std::array<uint8_t, 29> length_extra{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                           3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+    static constexpr std::array<uint16_t, 30> distance_base{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                                             193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+                                                             4097, 6145, 8193, 12289, 16385, 24577 };
+
+    static constexpr std::array<uint8_t, 30> distance_extra{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7,
+                                                             8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    class CRCTable
+    {
+        public:
+            constexpr CRCTable()
+                    : values()
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t c = i;
+
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+                    }
+
+                    values[i] = c;
+                }
+            }
+
+            uint32_t values[256];
+    };
+
+    static constexpr CRCTable crc_table{};
+
+    static uint8_t clamp_window_bits(uint8_t window_bits)
+    {
+        return std::min(std::max(window_bits, GzipCompressor::min_window_bits), GzipCompressor::max_window_bits);
+    }
+
+    GzipCompressor::GzipCompressor(uint8_t window_bits)
+            : window_size(static_cast<std::size_t>(1) << clamp_window_bits(window_bits)),
+              hash_mask((static_cast<std::size_t>(1) << clamp_window_bits(window_bits)) - 1),
+              window(window_size * 2),
+              head(hash_mask + 1),
+              prev(window_size * 2)
+    {
+    }
+
+    void GzipCompressor::write(const uint8_t* data, std::size_t length, std::vector<uint8_t>& target)
+    {
+        write_header(target);
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            crc = crc_table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+
+        input_size += static_cast<uint32_t>(length);
+
+        while (length > 0)
+        {
+            auto count = std::min(length, window.size() - fill);
+            std::memcpy(&window[fill], data, count);
+            fill += count;
+            data += count;
+            length -= count;
+
+            compress(false, target);
+
+            if (fill == window.size())
+            {
+                slide();
+            }
+        }
+    }
+
+    void GzipCompressor::finish(std::vector<uint8_t>& target)
+    {
+        if (!finished)
+        {
+            write_header(target);
+            compress(true, target);
+
+            // End the current block, then add an empty final block.
+            put_symbol(end_of_block, target);
+            put_bits(1, 1, target);
+            put_bits(1, 2, target);
+            put_symbol(end_of_block, target);
+
+            // Pad to a byte boundary
+            put_bits(0, (8 - bit_count % 8) % 8, target);
+
+            auto value = crc ^ 0xFFFFFFFF;
+
+            for (auto v : { value, input_size })
+            {
+                for (int i = 0; i < 4; ++i)
+                {
+                    target.push_back(static_cast<uint8_t>(v >> (i * 8)));
+                }
+            }
+
+            finished = true;
+        }
+    }
+
+    void GzipCompressor::write_header(std::vector<uint8_t>& target)
+    {
+        if (!header_written)
+        {
+            header_written = true;
+
+            // Magic, deflate, no flags, no modification time, no extra flags, unknown OS.
+            target.insert(target.end(), { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xFF });
+
+            // Start of a non-final block with fixed Huffman codes.
+            put_bits(0, 1, target);
+            put_bits(1, 2, target);
+        }
+    }
+
+    void GzipCompressor::compress(bool flush, std::vector<uint8_t>& target)
+    {
+        // Unless flushing, leave enough data to find the longest possible match.
+        while (pos < fill && (flush || fill - pos >= max_match))
+        {
+            std::size_t best_length = 0;
+            std::size_t best_distance = 0;
+
+            if (fill - pos >= min_match)
+            {
+                auto candidate = head[hash(pos)];
+                insert(pos);
+
+                const auto limit = pos > window_size ? pos - window_size : 0;
+                const auto max = std::min(max_match, fill - pos);
+                int chain = max_chain;
+
+                while (candidate != 0 && static_cast<std::size_t>(candidate - 1) >= limit && chain-- > 0
+                       && best_length < max)
+                {
+                    auto c = static_cast<std::size_t>(candidate - 1);
+                    auto length = match_length(c, pos, max);
+
+                    if (length > best_length)
+                    {
+                        best_length = length;
+                        best_distance = pos - c;
+                    }
+
+                    candidate = prev[c];
+                }
+            }
+
+            if (best_length >= min_match)
+            {
+                put_match(best_length, best_distance, target);
+
+                for (std::size_t i = 1; i < best_length; ++i)
+                {
+                    if (pos + i + min_match <= fill)
+                    {
+                        insert(pos + i);
+                    }
+                }
+
+                pos += best_length;
+            }
+            else
+            {
+                put_symbol(window[pos], target);
+                ++pos;
+            }
+        }
+    }
+
+    void GzipCompressor::slide()
+    {
+        // Only called when the window is full, at which point at most max_match bytes are left to compress,
+        // all of them in the upper half.
+        std::memcpy(window.data(), window.data() + window_size, window_size);
+        std::memcpy(prev.data(), prev.data() + window_size, window_size * sizeof(prev[0]));
+        pos -= window_size;
+        fill -= window_size;
+
+        auto adjust = [this](uint16_t& v) {
+                          v = v > window_size ? static_cast<uint16_t>(v - window_size) : 0;
+                      };
+
+        std::for_each(head.begin(), head.end(), adjust);
+        std::for_each(prev.begin(), prev.begin() + static_cast<long>(window_size), adjust);
+    }
+
+    std::size_t GzipCompressor::hash(std::size_t p) const
+    {
+        return ((static_cast<std::size_t>(window[p]) << 10)
+                ^ (static_cast<std::size_t>(window[p + 1]) << 5)
+                ^ window[p + 2]) & hash_mask;
+    }
+
+    void GzipCompressor::insert(std::size_t p)
+    {
+        auto& h = head[hash(p)];
+        prev[p] = h;
+        h = static_cast<uint16_t>(p + 1);
+    }
+
+    std::size_t GzipCompressor::match_length(std::size_t candidate, std::size_t p, std::size_t max) const
+    {
+        std::size_t length = 0;
+
+        while (length < max && window[candidate + length] == window[p + length])
+        {
+            ++length;
+        }
+
+        return length;
+    }
+
+    void GzipCompressor::put_bits(uint32_t value, uint32_t count, std::vector<uint8_t>& target)
+    {
+        bit_buffer |= value << bit_count;
+        bit_count += count;
+
+        while (bit_count >= 8)
+        {
+            target.push_back(static_cast<uint8_t>(bit_buffer));
+            bit_buffer >>= 8;
+            bit_count -= 8;
+        }
+    }
+
+    void GzipCompressor::put_code(uint32_t code, uint32_t length, std::vector<uint8_t>& target)
+    {
+        // Huffman codes are packed starting with their most significant bit.
+        uint32_t reversed = 0;
+
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+
+        put_bits(reversed, length, target);
+    }
+
+    void GzipCompressor::put_symbol(uint32_t symbol, std::vector<uint8_t>& target)
+    {
+        // The fixed literal/length code, RFC 1951 section 3.2.6
+        if (symbol < 144)
+        {
+            put_code(0x30 + symbol, 8, target);
+        }
+        else if (symbol < 256)
+        {
+            put_code(0x190 + symbol - 144, 9, target);
+        }
+        else if (symbol < 280)
+        {
+            put_code(symbol - 256, 7, target);
+        }
+        else
+        {
+            put_code(0xC0 + symbol - 280, 8, target);
+        }
+    }
+
+    void GzipCompressor::put_match(std::size_t length, std::size_t distance, std::vector<uint8_t>& target)
+    {
+        auto l = static_cast<std::size_t>(
+            std::distance(length_base.begin(), std::upper_bound(length_base.begin(), length_base.end(), length)) - 1);
+        put_symbol(static_cast<uint32_t>(257 + l), target);
+        put_bits(static_cast<uint32_t>(length - length_base[l]), length_extra[l], target);
+
+        auto d = static_cast<std::size_t>(
+            std::distance(distance_base.begin(),
+                          std::upper_bound(distance_base.begin(), distance_base.end(), distance)) - 1);
+        put_code(static_cast<uint32_t>(d), 5, target);
+        put_bits(static_cast<uint32_t>(distance - distance_base[d]), distance_extra[d], target);
+    }
+}
@@ -18,6 +18,7 @@ limitations under the License.
 #include "smooth/application/network/http/HTTPServerClient.h"
 #include "smooth/application/network/http/IResponseOperation.h"
 #include "smooth/application/network/http/websocket/responses/WSResponse.h"
+#include "smooth/config_constants.h"
 
 namespace smooth::application::network::http
 {
@@ -41,35 +42,171 @@ namespace smooth::application::network::http
     void HTTPServerClient::event(
         const smooth::core::network::event::TransmitBufferEmptyEvent&)
     {
-        if (current_operation)
+        if (pull_source)
         {
-            std::vector<uint8_t> data;
-            auto res = current_operation->get_data(content_chunk_size, data);
+            // While the socket pulls the response there is nothing to do, until it has been pulled dry.
+            if (!this->container->get_tx_buffer().is_pulling())
+            {
+                auto failed = pull_source->has_failed();
+                pull_source.reset();
 
-            if (res == ResponseStatus::Error)
+                if (failed)
+                {
+                    Log::error(tag, "Current operation reported error, closing server client.");
+                    this->close();
+                }
+                else if (close_when_sent)
+                {
+                    close_if_sent();
+                }
+                else
+                {
+                    send_first_part();
+                }
+            }
+        }
+        else if (current_operation)
+        {
+            // The event may arrive while packets still are queued. A chunked part needs room for three packets,
+            // and a finished response for its last chunk and the first part of the next; until there is room,
+            // the part is left with the response and requested on a later event.
+            if (this->container->get_tx_buffer().available_slots() >= 3)
             {
-                Log::error(tag, "Current operation reported error, closing server client.");
-                this->close();
+                send_next_part();
             }
-            else if (res == ResponseStatus::NoData)
+        }
+        else if (close_when_sent)
+        {
+            close_if_sent();
+        }
+        else
+        {
+            send_first_part();
+        }
+    }
+
+    void HTTPServerClient::send_next_part()
+    {
+        HTTPPacket p{};
+        auto res = get_next_chunk(p);
+
+        if (res == ResponseStatus::Error)
+        {
+            Log::error(tag, "Current operation reported error, closing server client.");
+            this->close();
+        }
+        else if (res == ResponseStatus::NoData)
+        {
+            if (chunked_response)
             {
-                current_operation.reset();
+                // The response ended without saying which part was the last one.
+                std::vector<uint8_t> last{};
+                chunked::append_last_chunk(last);
+                this->container->get_tx_buffer().put(HTTPPacket{ last });
+                chunked_response = false;
+            }
+
+            current_operation.reset();
 
+            if (close_when_sent)
+            {
+                close_if_sent();
+            }
+            else
+            {
                 // Immediately send next
                 send_first_part();
             }
-            else if (res == ResponseStatus::HasMoreData
-                     || res == ResponseStatus::LastData)
+        }
+        else if (res == ResponseStatus::HasMoreData
+                 || res == ResponseStatus::LastData)
+        {
+            auto& tx = this->container->get_tx_buffer();
+
+            if (chunked_response && p.get_send_length() > 0)
             {
-                HTTPPacket p{ data };
-                auto& tx = this->container->get_tx_buffer();
+                // The chunk framing goes in packets of its own so that the data is still sent from where the
+                // response keeps it; all three are handed to the socket in a single call.
+                std::vector<uint8_t> start{};
+                chunked::append_chunk_start(static_cast<std::size_t>(p.get_send_length()), start);
+                std::vector<uint8_t> end{};
+                chunked::append_chunk_end(res == ResponseStatus::LastData, end);
+
+                tx.put(HTTPPacket{ start });
                 tx.put(p);
+                tx.put(HTTPPacket{ end });
+            }
+            else if (chunked_response && res == ResponseStatus::LastData)
+            {
+                std::vector<uint8_t> last{};
+                chunked::append_last_chunk(last);
+                tx.put(HTTPPacket{ last });
             }
+            else
+            {
+                tx.put(p);
+            }
+
+            if (res == ResponseStatus::LastData)
+            {
+                chunked_response = false;
+            }
+        }
+    }
+
+    void HTTPServerClient::close_if_sent()
+    {
+        // The body of the response ends when the connection closes, so all of it must have been sent first.
+        if (this->container->get_tx_buffer().is_empty())
+        {
+            this->close();
+        }
+    }
+
+    ResponseStatus HTTPServerClient::get_next_chunk(HTTPPacket& packet)
+    {
+        ResponseStatus res;
+
+        if (current_operation->has_data_view())
+        {
+            // The packet references the data held by the operation, no copy is made.
+            std::shared_ptr<const uint8_t> view{};
+            std::size_t length = 0;
+            res = current_operation->get_data_view(content_chunk_size, view, length);
+            packet = HTTPPacket{ std::move(view), length };
         }
         else
         {
-            send_first_part();
+            std::vector<uint8_t> data;
+            res = current_operation->get_data(content_chunk_size, data);
+            packet = HTTPPacket{ data };
         }
+
+        return res;
+    }
+
+    ResponseStatus HTTPServerClient::get_first_chunk(std::vector<uint8_t>& data)
+    {
+        ResponseStatus res;
+
+        if (current_operation->has_data_view())
+        {
+            // The first chunk is sent together with the headers so it is copied.
+            std::shared_ptr<const uint8_t> view{};
+            std::size_t length = 0;
+            res = current_operation->get_data_view(content_chunk_size, view, length);
+
+            if (length > 0)
+            {
+                data.assign(view.get(), view.get() + length);
+            }
+        }
+        else
+        {
+            res = current_operation->get_data(content_chunk_size, data);
+        }
+
+        return res;
     }
 
     void HTTPServerClient::disconnected()
@@ -85,6 +222,8 @@ namespace smooth::application::network::http
     {
         operations.clear();
         current_operation.reset();
+        pull_source.reset();
+        close_when_sent = false;
         mode = Mode::HTTP;
         ws_server.reset();
     }
@@ -179,7 +318,7 @@ namespace smooth::application::network::http
                 operations.emplace_back(std::move(response));
             }
 
-            if (!current_operation)
+            if (!is_sending())
             {
                 send_first_part();
             }
@@ -192,7 +331,7 @@ namespace smooth::application::network::http
         response->add_header(CONNECTION, "close");
         operations.emplace_back(std::move(response));
 
-        if (!current_operation)
+        if (!is_sending())
         {
             send_first_part();
         }
@@ -212,7 +351,7 @@ namespace smooth::application::network::http
                 const auto& headers = current_operation->get_headers();
 
                 std::vector<uint8_t> data{};
-                res = current_operation->get_data(content_chunk_size, data);
+                res = get_first_chunk(data);
 
                 if (res == ResponseStatus::Error)
                 {
@@ -224,7 +363,56 @@ namespace smooth::application::network::http
                     auto& tx = this->container->get_tx_buffer();
                     auto buffer_consumed_data = false;
 
-                    if (mode == Mode::HTTP)
+                    chunked_response = false;
+
+                    if (mode == Mode::HTTP
+                        && !peer_accepts_chunked
+                        && res == ResponseStatus::HasMoreData
+                        && headers.find(CONTENT_LENGTH) == headers.end())
+                    {
+                        // HTTP/1.0 doesn't know chunked encoding; the end of the response is instead marked
+                        // by closing the connection.
+                        close_when_sent = true;
+                        auto closing_headers = headers;
+                        closing_headers.erase(KEEP_ALIVE);
+                        closing_headers[CONNECTION] = "close";
+
+                        HTTPPacket p{ current_operation->get_response_code(), "1.1", closing_headers, data };
+                        buffer_consumed_data = tx.put(p);
+                    }
+                    else if (mode == Mode::HTTP
+                             && res == ResponseStatus::HasMoreData
+                             && headers.find(CONTENT_LENGTH) == headers.end())
+                    {
+                        // The length of the response isn't known up front, send it in chunks as it is produced.
+                        chunked_response = true;
+                        auto chunked_headers = headers;
+                        chunked_headers[TRANSFER_ENCODING] = "chunked";
+
+                        std::vector<uint8_t> content{};
+
+                        if (!data.empty())
+                        {
+                            content.reserve(data.size() + 32);
+                            chunked::append_chunk_start(data.size(), content);
+                            content.insert(content.end(), data.begin(), data.end());
+                            chunked::append_chunk_end(false, content);
+                        }
+
+                        HTTPPacket p{ current_operation->get_response_code(), "1.1", chunked_headers, content };
+                        buffer_consumed_data = tx.put(p);
+                    }
+                    else if (mode == Mode::HTTP
+                             && !data.empty()
+                             && headers.find(CONTENT_LENGTH) == headers.end())
+                    {
+                        // All of the response fit in the first part, so its length is known after all.
+                        auto sized_headers = headers;
+                        sized_headers[CONTENT_LENGTH] = std::to_string(data.size());
+                        HTTPPacket p{ current_operation->get_response_code(), "1.1", sized_headers, data };
+                        buffer_consumed_data = tx.put(p);
+                    }
+                    else if (mode == Mode::HTTP)
                     {
                         // Whether or not everything is sent, send the current (possibly header-only) packet.
                         HTTPPacket p{ current_operation->get_response_code(), "1.1", headers, data };
@@ -241,6 +429,17 @@ namespace smooth::application::network::http
                     {
                         current_operation.reset();
                     }
+                    else if (CONFIG_SMOOTH_HTTP_RESPONSE_LOOK_AHEAD > 0
+                             && !chunked_response
+                             && res == ResponseStatus::HasMoreData
+                             && current_operation->has_data_view()
+                             && current_operation->can_be_pulled())
+                    {
+                        // Let the socket pull the rest of the response as it is able to send it.
+                        pull_source = std::make_shared<ResponsePacketSource>(std::move(current_operation),
+                                                                             content_chunk_size);
+                        tx.set_source(pull_source, CONFIG_SMOOTH_HTTP_RESPONSE_LOOK_AHEAD);
+                    }
                 }
             }
         }
@@ -300,7 +499,7 @@ namespace smooth::application::network::http
 
     void HTTPServerClient::http_event(const core::network::event::DataAvailableEvent<HTTPProtocol>& event)
     {
-        typename HTTPProtocol::packet_type packet;
+        auto& packet = received_packet;
 
         if (event.get(packet))
         {
@@ -315,6 +514,7 @@ namespace smooth::application::network::http
                 request_headers.clear();
                 std::swap(request_headers, packet.headers());
                 requested_url = packet.get_request_url();
+                peer_accepts_chunked = packet.get_request_version() >= "1.1";
                 res = parse_url(requested_url);
                 set_keep_alive();
             }
@@ -352,7 +552,7 @@ namespace smooth::application::network::http
 
     void HTTPServerClient::websocket_event(const smooth::core::network::event::DataAvailableEvent<HTTPProtocol>& event)
     {
-        typename HTTPProtocol::packet_type packet;
+        auto& packet = received_packet;
 
         if (event.get(packet))
         {
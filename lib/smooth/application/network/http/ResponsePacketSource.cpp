@@ -0,0 +1,46 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/ResponsePacketSource.h"
+
+namespace smooth::application::network::http
+{
+    bool ResponsePacketSource::get_next_packet(HTTPPacket& packet)
+    {
+        bool res = false;
+
+        // A chunk may be empty, f.ex. between the parts of a multi-part range response; those aren't queued.
+        while (!res && !done)
+        {
+            std::shared_ptr<const uint8_t> view{};
+            std::size_t length = 0;
+            auto status = operation->get_data_view(chunk_size, view, length);
+
+            failed = status == ResponseStatus::Error;
+            done = status != ResponseStatus::HasMoreData;
+            res = !failed && length > 0;
+
+            if (res)
+            {
+                packet = HTTPPacket{ std::move(view), length };
+            }
+        }
+
+        return res;
+    }
+}
@@ -17,10 +17,15 @@ limitations under the License.
 
 #include "smooth/application/network/http/http_utils.h"
 
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <cstdlib>
 #include <sstream>
 #include <iomanip>
 #include <mutex>
+#include <unordered_map>
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
 
 using namespace smooth::application::network::http::regular;
 using namespace std::chrono;
@@ -86,19 +91,112 @@ namespace smooth::application::network::http::utils
 
     std::string get_content_type(const smooth::core::filesystem::Path& path)
     {
-        // https://developer.mozilla.org/en-US/docs/Web/HTTP/Basics_of_HTTP/MIME_types/Complete_list_of_MIME_types
-        const auto& ext = path.extension();
-
-        if (ext == ".jpeg")
+        // https://developer.mozilla.org/en-US/docs/Web/HTTP/Basics_of_HTTP/MIME_types/Common_types
+        static const std::unordered_map<std::string, const char*> types{
+            { "html", "text/html" },
+            { "htm", "text/html" },
+            { "css", "text/css" },
+            { "js", "text/javascript" },
+            { "mjs", "text/javascript" },
+            { "json", "application/json" },
+            { "map", "application/json" },
+            { "xml", "application/xml" },
+            { "txt", "text/plain" },
+            { "csv", "text/csv" },
+            { "png", "image/png" },
+            { "jpg", "image/jpeg" },
+            { "jpeg", "image/jpeg" },
+            { "gif", "image/gif" },
+            { "svg", "image/svg+xml" },
+            { "ico", "image/vnd.microsoft.icon" },
+            { "webp", "image/webp" },
+            { "bmp", "image/bmp" },
+            { "woff", "font/woff" },
+            { "woff2", "font/woff2" },
+            { "ttf", "font/ttf" },
+            { "otf", "font/otf" },
+            { "eot", "application/vnd.ms-fontobject" },
+            { "pdf", "application/pdf" },
+            { "zip", "application/zip" },
+            { "gz", "application/gzip" },
+            { "wasm", "application/wasm" },
+            { "mp3", "audio/mpeg" },
+            { "wav", "audio/wav" },
+            { "ogg", "audio/ogg" },
+            { "mp4", "video/mp4" },
+            { "webm", "video/webm" }
+        };
+
+        auto ext = path.extension();
+        std::string res = "application/octet-stream";
+
+        if (ext.size() > 1)
         {
-            return "image/jpeg";
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+                               return static_cast<char>(std::tolower(c));
+                           });
+
+            auto type = types.find(ext.substr(1));
+
+            if (type != types.end())
+            {
+                res = type->second;
+            }
         }
-        else if (ext == ".html")
+
+        return res;
+    }
+
+    bool accepts_encoding(const std::unordered_map<std::string, std::string>& request_headers,
+                          const std::string& encoding)
+    {
+        // https://developer.mozilla.org/en-US/docs/Web/HTTP/Headers/Accept-Encoding
+        bool accepted = false;
+        bool explicitly_listed = false;
+        auto header = request_headers.find(ACCEPT_ENCODING);
+
+        if (header != request_headers.end())
         {
-            return "text/html";
+            std::string value = header->second;
+            std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+                               return static_cast<char>(std::tolower(c));
+                           });
+
+            std::istringstream ss(value);
+            std::string item;
+
+            while (std::getline(ss, item, ','))
+            {
+                // "gzip;q=0.5" -> coding "gzip" with weight 0.5; a zero weight means "not acceptable".
+                auto semicolon = item.find(';');
+                auto coding = item.substr(0, semicolon);
+                coding.erase(std::remove(coding.begin(), coding.end(), ' '), coding.end());
+
+                bool acceptable = true;
+
+                if (semicolon != std::string::npos)
+                {
+                    auto q = item.find("q=", semicolon);
+
+                    if (q != std::string::npos)
+                    {
+                        acceptable = std::strtod(item.c_str() + q + 2, nullptr) > 0.0;
+                    }
+                }
+
+                if (coding == encoding)
+                {
+                    accepted = acceptable;
+                    explicitly_listed = true;
+                }
+                else if (coding == "*" && !explicitly_listed)
+                {
+                    accepted = acceptable;
+                }
+            }
         }
 
-        return "application/octet-stream";
+        return accepted;
     }
 
     time_t timegm(tm& tm)
@@ -0,0 +1,253 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/ByteRanges.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/core/util/string_util.h"
+
+using namespace smooth::core;
+
+namespace smooth::application::network::http::regular
+{
+    namespace
+    {
+        // Positions with more digits than this are larger than any file we can serve, and would overflow.
+        constexpr std::size_t max_position_digits = 18;
+
+        bool parse_position(const std::string& s, std::size_t& value)
+        {
+            bool res = !s.empty() && s.size() <= max_position_digits
+                       && std::all_of(s.begin(), s.end(), [](unsigned char c) { return std::isdigit(c); });
+
+            if (res)
+            {
+                auto parsed = std::stoull(s);
+                value = static_cast<std::size_t>(std::min<unsigned long long>(parsed,
+                                                                              std::numeric_limits<std::size_t>::max()));
+            }
+
+            return res;
+        }
+
+        std::string content_range(const ByteRange& range, std::size_t size)
+        {
+            return "bytes " + std::to_string(range.first) + "-" + std::to_string(range.last) + "/"
+                   + std::to_string(size);
+        }
+
+        std::string make_boundary()
+        {
+            static std::atomic<uint32_t> count{ 0 };
+            std::stringstream ss;
+            ss << "smooth_" << std::hex << std::chrono::steady_clock::now().time_since_epoch().count() << "_" << ++count;
+
+            return ss.str();
+        }
+    }
+
+    bool ByteRanges::parse(const std::string& value, std::size_t representation_size)
+    {
+        size = representation_size;
+        ranges.clear();
+        parts.clear();
+
+        auto equals = value.find('=');
+        bool valid = equals != std::string::npos
+                     && string_util::to_lower_copy(string_util::trim(value.substr(0, equals))) == "bytes";
+
+        std::size_t count = 0;
+        std::size_t pos = equals + 1;
+
+        while (valid && pos <= value.size())
+        {
+            auto end = std::min(value.find(',', pos), value.size());
+            auto spec = string_util::trim(value.substr(pos, end - pos));
+            pos = end + 1;
+
+            // Empty list elements are allowed, https://tools.ietf.org/html/rfc7230#section-7
+            if (!spec.empty())
+            {
+                ++count;
+                valid = count <= max_ranges && parse_range(spec);
+            }
+        }
+
+        valid = valid && count > 0;
+
+        if (!valid)
+        {
+            ranges.clear();
+        }
+
+        return valid;
+    }
+
+    bool ByteRanges::parse_range(const std::string& spec)
+    {
+        auto dash = spec.find('-');
+        bool valid = dash != std::string::npos;
+
+        if (valid)
+        {
+            auto first_pos = spec.substr(0, dash);
+            auto last_pos = spec.substr(dash + 1);
+            std::size_t first = 0;
+            std::size_t last = 0;
+
+            if (first_pos.empty())
+            {
+                // A suffix range, the last N bytes.
+                valid = parse_position(last_pos, last);
+
+                if (valid && last > 0 && size > 0)
+                {
+                    ranges.push_back(ByteRange{ size - std::min(last, size), size - 1 });
+                }
+            }
+            else
+            {
+                valid = parse_position(first_pos, first);
+
+                if (valid && !last_pos.empty())
+                {
+                    valid = parse_position(last_pos, last) && last >= first;
+                }
+                else
+                {
+                    last = std::numeric_limits<std::size_t>::max();
+                }
+
+                if (valid && first < size)
+                {
+                    ranges.push_back(ByteRange{ first, std::min(last, size - 1) });
+                }
+            }
+        }
+
+        return valid;
+    }
+
+    void ByteRanges::prepare(std::unordered_map<std::string, std::string>& headers)
+    {
+        parts.clear();
+        current = 0;
+        sent = 0;
+
+        if (ranges.size() == 1)
+        {
+            const auto& range = ranges.front();
+            parts.push_back(Part{ false, range.first, range.last - range.first + 1 });
+            headers[CONTENT_RANGE] = content_range(range, size);
+        }
+        else if (ranges.size() > 1)
+        {
+            auto type = headers.find(CONTENT_TYPE);
+            auto boundary = make_boundary();
+            std::string framing{};
+
+            for (const auto& range : ranges)
+            {
+                auto start = framing.size();
+
+                // The first boundary doesn't need to be preceded by CRLF, https://tools.ietf.org/html/rfc2046#section-5.1.1
+                framing += start == 0 ? "--" : "\r\n--";
+                framing += boundary + "\r\n";
+
+                if (type != headers.end())
+                {
+                    framing += "Content-Type: " + type->second + "\r\n";
+                }
+
+                framing += "Content-Range: " + content_range(range, size) + "\r\n\r\n";
+
+                parts.push_back(Part{ true, start, framing.size() - start });
+                parts.push_back(Part{ false, range.first, range.last - range.first + 1 });
+            }
+
+            auto start = framing.size();
+            framing += "\r\n--" + boundary + "--\r\n";
+            parts.push_back(Part{ true, start, framing.size() - start });
+
+            framing_data = std::make_shared<const std::string>(std::move(framing));
+            headers[CONTENT_TYPE] = "multipart/byteranges; boundary=" + boundary;
+        }
+
+        headers[CONTENT_LENGTH] = std::to_string(content_length());
+    }
+
+    ResponseStatus ByteRanges::next(std::size_t max_amount,
+                                    std::shared_ptr<const uint8_t>& framing,
+                                    std::size_t& offset,
+                                    std::size_t& length)
+    {
+        auto res = ResponseStatus::NoData;
+        framing.reset();
+        offset = 0;
+        length = 0;
+
+        if (current < parts.size())
+        {
+            const auto& part = parts[current];
+            length = std::min(part.length - sent, max_amount);
+
+            if (part.is_framing)
+            {
+                const auto* start = reinterpret_cast<const uint8_t*>(framing_data->data()) + part.offset + sent;
+                framing = std::shared_ptr<const uint8_t>(framing_data, start);
+            }
+            else
+            {
+                offset = part.offset + sent;
+            }
+
+            sent += length;
+
+            if (sent == part.length)
+            {
+                ++current;
+                sent = 0;
+            }
+
+            res = current < parts.size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    std::size_t ByteRanges::content_length() const
+    {
+        std::size_t length = 0;
+
+        for (const auto& part : parts)
+        {
+            length += part.length;
+        }
+
+        return length;
+    }
+
+    std::string ByteRanges::unsatisfied_range(std::size_t size)
+    {
+        return "bytes */" + std::to_string(size);
+    }
+}
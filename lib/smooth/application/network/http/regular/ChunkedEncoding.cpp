@@ -0,0 +1,217 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/ChunkedEncoding.h"
+#include <algorithm>
+#include <cstring>
+
+namespace smooth::application::network::http::regular
+{
+    // A chunk size of more than 15 hex digits would overflow.
+    static constexpr std::size_t max_size_digits = sizeof(std::size_t) * 2 - 1;
+
+    static int hex_value(uint8_t c)
+    {
+        int value = -1;
+
+        if (c >= '0' && c <= '9')
+        {
+            value = c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            value = c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            value = c - 'A' + 10;
+        }
+
+        return value;
+    }
+
+    std::size_t ChunkedDecoder::decode(uint8_t* data, std::size_t length)
+    {
+        std::size_t read = 0;
+        std::size_t written = 0;
+
+        while (read < length && state != State::Done && state != State::Error)
+        {
+            if (state == State::Data)
+            {
+                // The data of a chunk is moved towards the start of the buffer, over the framing already read.
+                auto count = std::min(remaining, length - read);
+                std::memmove(data + written, data + read, count);
+                written += count;
+                read += count;
+                remaining -= count;
+                state = remaining == 0 ? State::DataCR : State::Data;
+            }
+            else
+            {
+                auto c = data[read++];
+
+                if (state == State::Size)
+                {
+                    auto value = hex_value(c);
+
+                    if (value >= 0 && digits < max_size_digits)
+                    {
+                        remaining = (remaining << 4) | static_cast<std::size_t>(value);
+                        ++digits;
+                    }
+                    else if (digits > 0 && (c == ';' || c == ' ' || c == '\t'))
+                    {
+                        state = State::Extension;
+                    }
+                    else if (digits > 0 && c == '\r')
+                    {
+                        state = State::SizeEnd;
+                    }
+                    else
+                    {
+                        state = State::Error;
+                    }
+                }
+                else if (state == State::Extension)
+                {
+                    state = c == '\r' ? State::SizeEnd : State::Extension;
+                }
+                else if (state == State::SizeEnd)
+                {
+                    if (c != '\n')
+                    {
+                        state = State::Error;
+                    }
+                    else if (remaining == 0)
+                    {
+                        // The last chunk, possibly followed by trailer fields.
+                        line_length = 0;
+                        state = State::Trailer;
+                    }
+                    else
+                    {
+                        state = State::Data;
+                    }
+                }
+                else if (state == State::DataCR)
+                {
+                    state = c == '\r' ? State::DataLF : State::Error;
+                }
+                else if (state == State::DataLF)
+                {
+                    digits = 0;
+                    state = c == '\n' ? State::Size : State::Error;
+                }
+                else if (state == State::Trailer)
+                {
+                    if (c == '\r')
+                    {
+                        state = State::TrailerEnd;
+                    }
+                    else
+                    {
+                        ++line_length;
+                    }
+                }
+                else if (state == State::TrailerEnd)
+                {
+                    if (c != '\n')
+                    {
+                        state = State::Error;
+                    }
+                    else if (line_length == 0)
+                    {
+                        state = State::Done;
+                    }
+                    else
+                    {
+                        // End of a trailer field, look for the empty line ending the body.
+                        line_length = 0;
+                        state = State::Trailer;
+                    }
+                }
+            }
+        }
+
+        return written;
+    }
+
+    std::size_t ChunkedDecoder::get_wanted_amount(std::size_t max_amount) const
+    {
+        std::size_t wanted = 0;
+
+        if (state == State::Data)
+        {
+            // The data is always followed by CRLF.
+            wanted = std::min(max_amount, remaining + 2);
+        }
+        else if (state != State::Done && state != State::Error)
+        {
+            // The framing is read a byte at a time, so that nothing beyond the body is read.
+            wanted = std::min(max_amount, std::size_t{ 1 });
+        }
+
+        return wanted;
+    }
+
+    void ChunkedDecoder::reset()
+    {
+        state = State::Size;
+        remaining = 0;
+        digits = 0;
+        line_length = 0;
+    }
+
+    namespace chunked
+    {
+        static const uint8_t crlf[] = { '\r', '\n' };
+        static const uint8_t last_chunk[] = { '0', '\r', '\n', '\r', '\n' };
+
+        void append_chunk_start(std::size_t length, std::vector<uint8_t>& target)
+        {
+            static const char hex[] = "0123456789abcdef";
+            uint8_t digits[sizeof(std::size_t) * 2];
+            auto first = std::end(digits);
+
+            do
+            {
+                *--first = static_cast<uint8_t>(hex[length & 0xF]);
+                length >>= 4;
+            }
+            while (length > 0);
+
+            target.insert(target.end(), first, std::end(digits));
+            target.insert(target.end(), std::begin(crlf), std::end(crlf));
+        }
+
+        void append_chunk_end(bool last, std::vector<uint8_t>& target)
+        {
+            target.insert(target.end(), std::begin(crlf), std::end(crlf));
+
+            if (last)
+            {
+                append_last_chunk(target);
+            }
+        }
+
+        void append_last_chunk(std::vector<uint8_t>& target)
+        {
+            target.insert(target.end(), std::begin(last_chunk), std::end(last_chunk));
+        }
+    }
+}
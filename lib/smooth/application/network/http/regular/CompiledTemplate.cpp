@@ -0,0 +1,97 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/CompiledTemplate.h"
+#include <algorithm>
+#include <cctype>
+
+namespace smooth::application::network::http::regular
+{
+    CompiledTemplate::CompiledTemplate(std::string template_data)
+            : data(std::move(template_data))
+    {
+        compile();
+    }
+
+    void CompiledTemplate::compile()
+    {
+        std::size_t literal_start = 0;
+        auto open = data.find("{{");
+
+        while (open != std::string::npos)
+        {
+            auto end = find_token_end(open);
+
+            if (end == npos)
+            {
+                // Not a token, but a token may start at the next brace, as in "{{{name}}".
+                open = data.find("{{", open + 1);
+            }
+            else
+            {
+                if (open > literal_start)
+                {
+                    segments.push_back({ literal_start, open - literal_start, npos });
+                }
+
+                auto length = end - open;
+                segments.push_back({ open, length, add_token(std::string_view{ data }.substr(open, length)) });
+
+                literal_start = end;
+                open = data.find("{{", end);
+            }
+        }
+
+        if (literal_start < data.size())
+        {
+            segments.push_back({ literal_start, data.size() - literal_start, npos });
+        }
+    }
+
+    std::size_t CompiledTemplate::find_token_end(std::size_t start) const
+    {
+        auto is_name_char = [](char c) {
+                                return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' || c == '-';
+                            };
+
+        auto name_start = start + 2;
+        auto name_end = name_start;
+
+        while (name_end < data.size() && is_name_char(data[name_end]))
+        {
+            ++name_end;
+        }
+
+        auto has_name = name_end > name_start;
+        auto is_closed = data.compare(name_end, 2, "}}") == 0;
+
+        return has_name && is_closed ? name_end + 2 : npos;
+    }
+
+    std::size_t CompiledTemplate::add_token(std::string_view token)
+    {
+        auto found = std::find(tokens.begin(), tokens.end(), token);
+        auto index = static_cast<std::size_t>(std::distance(tokens.begin(), found));
+
+        if (found == tokens.end())
+        {
+            tokens.emplace_back(token);
+        }
+
+        return index;
+    }
+}
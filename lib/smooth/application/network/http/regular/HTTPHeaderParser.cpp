@@ -0,0 +1,240 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+#include <algorithm>
+#include <cstring>
+
+namespace smooth::application::network::http::regular
+{
+    static constexpr std::string_view crlf{ "\r\n" };
+    static constexpr std::string_view http_prefix{ "HTTP/" };
+
+    static constexpr bool is_space(char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    static constexpr bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static constexpr char to_lower(char c)
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    static std::string_view trim(std::string_view s)
+    {
+        while (!s.empty() && is_space(s.front()))
+        {
+            s.remove_prefix(1);
+        }
+
+        while (!s.empty() && is_space(s.back()))
+        {
+            s.remove_suffix(1);
+        }
+
+        return s;
+    }
+
+    /// Splits off the part before the first occurrence of c, removing it and c from s.
+    static std::string_view next_token(std::string_view& s, char c)
+    {
+        auto pos = s.find(c);
+        auto token = s.substr(0, pos);
+        s.remove_prefix(pos == std::string_view::npos ? s.size() : pos + 1);
+
+        return token;
+    }
+
+    static bool is_valid_version(std::string_view v)
+    {
+        return v.size() == 3 && is_digit(v[0]) && v[1] == '.' && is_digit(v[2]);
+    }
+
+    HTTPHeaderParser::Result HTTPHeaderParser::parse(const uint8_t* data, std::size_t length)
+    {
+        auto res = Result::Complete;
+
+        if (!complete)
+        {
+            auto end = find_header_end(data, length, scan_pos);
+
+            if (end == npos)
+            {
+                // The terminator may straddle the boundary to the next chunk of data.
+                scan_pos = length > 3 ? length - 3 : 0;
+                res = Result::Incomplete;
+            }
+            else
+            {
+                complete = true;
+                header_end = end + 2 * crlf.size();
+
+                // Include the CRLF ending the last header line so that every line is terminated.
+                std::string_view block{ reinterpret_cast<const char*>(data), end + crlf.size() };
+                res = parse_block(block) ? Result::Complete : Result::Error;
+            }
+        }
+
+        return res;
+    }
+
+    void HTTPHeaderParser::reset()
+    {
+        *this = HTTPHeaderParser{};
+    }
+
+    std::size_t HTTPHeaderParser::find_header_end(const uint8_t* data, std::size_t length, std::size_t start)
+    {
+        // Scan for '\r' one word at a time: a byte of (w ^ CR-pattern) is zero where w holds a '\r',
+        // which the classic "has zero byte" expression detects without looking at each byte.
+        constexpr uint64_t ones = 0x0101010101010101ULL;
+        constexpr uint64_t highs = 0x8080808080808080ULL;
+        constexpr uint64_t carriage_returns = ones * '\r';
+
+        auto found = npos;
+        auto pos = start;
+
+        while (found == npos && pos + 3 < length)
+        {
+            bool candidate = true;
+
+            if (pos + sizeof(uint64_t) <= length)
+            {
+                uint64_t w;
+                std::memcpy(&w, data + pos, sizeof(w));
+                auto x = w ^ carriage_returns;
+                candidate = ((x - ones) & ~x & highs) != 0;
+            }
+
+            if (candidate)
+            {
+                // Check each position in this word (or the remaining tail).
+                auto last = std::min(pos + sizeof(uint64_t), length - 3);
+
+                for (auto i = pos; found == npos && i < last; ++i)
+                {
+                    if (data[i] == '\r' && data[i + 1] == '\n' && data[i + 2] == '\r' && data[i + 3] == '\n')
+                    {
+                        found = i;
+                    }
+                }
+            }
+
+            pos += sizeof(uint64_t);
+        }
+
+        return found;
+    }
+
+    std::string_view HTTPHeaderParser::get(std::string_view name) const
+    {
+        auto equals = [name](const Header& h) {
+                          return h.name.size() == name.size()
+                                 && std::equal(h.name.begin(), h.name.end(), name.begin(),
+                                               [](char a, char b) { return to_lower(a) == to_lower(b); });
+                      };
+
+        auto found = std::find_if(begin(), end(), equals);
+
+        return found == end() ? std::string_view{} : found->value;
+    }
+
+    bool HTTPHeaderParser::parse_block(std::string_view block)
+    {
+        bool ok = parse_start_line(next_token(block, '\n'));
+
+        while (ok && !block.empty())
+        {
+            ok = parse_header(next_token(block, '\n'));
+        }
+
+        return ok;
+    }
+
+    bool HTTPHeaderParser::parse_start_line(std::string_view line)
+    {
+        // Lines are split on LF, the CR must be the last character.
+        bool ok = !line.empty() && line.back() == '\r';
+        line.remove_suffix(ok ? 1 : 0);
+
+        if (ok && line.substr(0, http_prefix.size()) == http_prefix)
+        {
+            // Response, e.g. "HTTP/1.1 200 OK"
+            request = false;
+            line.remove_prefix(http_prefix.size());
+            http_version = next_token(line, ' ');
+            auto code = next_token(line, ' ');
+
+            ok = is_valid_version(http_version)
+                 && code.size() == 3
+                 && std::all_of(code.begin(), code.end(), is_digit);
+
+            if (ok)
+            {
+                status = (code[0] - '0') * 100 + (code[1] - '0') * 10 + (code[2] - '0');
+            }
+        }
+        else if (ok)
+        {
+            // Request, e.g. "GET / HTTP/1.1"
+            request = true;
+            request_method = next_token(line, ' ');
+            request_url = next_token(line, ' ');
+
+            ok = !request_method.empty()
+                 && !request_url.empty()
+                 && line.substr(0, http_prefix.size()) == http_prefix;
+
+            if (ok)
+            {
+                http_version = line.substr(http_prefix.size());
+                ok = is_valid_version(http_version);
+            }
+        }
+
+        return ok;
+    }
+
+    bool HTTPHeaderParser::parse_header(std::string_view line)
+    {
+        bool ok = !line.empty() && line.back() == '\r' && header_count < headers.size();
+        line.remove_suffix(ok ? 1 : 0);
+
+        if (ok)
+        {
+            auto colon = line.find(':');
+
+            // No whitespace is allowed in or after the field name: https://tools.ietf.org/html/rfc7230#section-3.2.4
+            ok = colon != std::string_view::npos
+                 && colon > 0
+                 && std::none_of(line.begin(), line.begin() + static_cast<long>(colon),
+                                 [](char c) { return is_space(c) || c == '\r'; });
+
+            if (ok)
+            {
+                headers[header_count++] = { line.substr(0, colon), trim(line.substr(colon + 1)) };
+            }
+        }
+
+        return ok;
+    }
+}
@@ -100,4 +100,10 @@ namespace smooth::application::network::http
     {
         content = std::move(response_content);
     }
+
+    HTTPPacket::HTTPPacket(std::shared_ptr<const uint8_t> external_content, std::size_t length)
+            : external(std::move(external_content)),
+              external_length(length)
+    {
+    }
 }
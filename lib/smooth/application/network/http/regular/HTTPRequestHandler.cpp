@@ -10,13 +10,24 @@ namespace smooth::application::network::http::regular
         // In case the expected headers don't exist, catch any exceptions.
         try
         {
-            mime.detect_mode(headers().at(CONTENT_TYPE),
-                            std::stoul(headers().at(CONTENT_LENGTH)));
+            // Chunked requests have no Content-Length, so their end is only known once the last part arrives.
+            auto content_length = headers().find(CONTENT_LENGTH);
+
+            if (content_length == headers().end())
+            {
+                mime.detect_mode(headers().at(CONTENT_TYPE));
+            }
+            else
+            {
+                mime.detect_mode(headers().at(CONTENT_TYPE), std::stoul(content_length->second));
+            }
         }
         catch (...)
         {
             // Ignore
         }
+
+        mime.set_last_part(is_last());
     }
 
     void HTTPRequestHandler::update_call_params(bool first_part,
@@ -30,5 +41,6 @@ namespace smooth::application::network::http::regular
         request_params.response = &response;
         request_params.headers = &headers;
         request_params.request_parameters = &request_parameters;
+        mime.set_last_part(last_part);
     }
 }
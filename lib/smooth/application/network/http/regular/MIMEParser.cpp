@@ -16,6 +16,8 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/regular/MIMEParser.h"
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include "smooth/core/util/split.h"
 #include "smooth/core/util/string_util.h"
@@ -33,13 +35,16 @@ namespace smooth::application::network::http::regular
 {
     void MIMEParser::reset() noexcept
     {
+        first_boundary.clear();
         boundary.clear();
-        end_boundary.clear();
+        end_of_headers.clear();
         form_url_encoded_data.clear();
         data.clear();
+        scanned = 0;
         expected_content_length = 0;
+        length_known = true;
+        last_part = false;
         mode = Mode::None;
-        end_of_transmission = false;
         parse_status = ParseStatus::Begin;
     }
 
@@ -58,18 +63,10 @@ namespace smooth::application::network::http::regular
             // fields for the next part, or by two CRLFs, in which case there are no header fields for the next part
             // (and it is therefore assumed to be of Content-Type text/plain).
 
-            // Note that we don't include the leading CRLF in the boundary pattern - that is handled separately
-            // so that we also match the very first boundary after the HTTP-headers.
-            boundary = { b.begin(), b.end() };
-            boundary.insert(boundary.begin(), '-');
-            boundary.insert(boundary.begin(), '-');
-            end_boundary = boundary;
-
-            // The ending boundary is the same as the normal one, but suffixed by "--\r\n" instead of just \r\n
-            end_boundary.emplace_back('-');
-            end_boundary.emplace_back('-');
-            end_boundary.emplace_back('\r');
-            end_boundary.emplace_back('\n');
+            // The very first boundary directly follows the HTTP-headers so it has no leading CRLF.
+            first_boundary.set_pattern("--" + b);
+            boundary.set_pattern("\r\n--" + b);
+            end_of_headers.set_pattern("\r\n\r\n");
 
             mode = Mode::FormData;
         }
@@ -79,141 +76,98 @@ namespace smooth::application::network::http::regular
         }
 
         expected_content_length = content_length;
+        length_known = true;
 
         return mode != Mode::None;
     }
 
-    auto MIMEParser::find_boundary() const
+    bool MIMEParser::detect_mode(const std::string& content_type)
     {
-        BoundaryIterator p = data.cend();
-
-        if (data.size() > boundary.size() + LEN_OF_CRLF)
-        {
-            p = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
-        }
+        auto res = detect_mode(content_type, 0);
+        length_known = false;
 
-        return p;
+        return res;
     }
 
-    auto MIMEParser::find_end_boundary() const
+    void MIMEParser::BoundaryMatcher::set_pattern(const std::string& p)
     {
-        BoundaryIterator p = data.cend();
+        pattern = { p.begin(), p.end() };
 
-        if (data.size() >= end_boundary.size())
+        // Distance from the last occurrence of each byte (not counting the final position) to the end of the
+        // pattern; bytes not in the pattern allow skipping its full length.
+        skip.fill(pattern.size());
+
+        for (std::size_t i = 0; i + 1 < pattern.size(); ++i)
         {
-            p = std::search(data.cbegin(), data.cend(), end_boundary.cbegin(), end_boundary.cend());
+            skip[pattern[i]] = pattern.size() - 1 - i;
         }
+    }
 
-        return p;
+    void MIMEParser::BoundaryMatcher::clear()
+    {
+        pattern.clear();
     }
 
-    void MIMEParser::parse(const uint8_t* p, std::size_t length, IFormData& form_data, IURLEncodedData& url_data,
-                           const uint16_t chunksize)
+    bool MIMEParser::BoundaryMatcher::find(const MimeData& data, std::size_t& from) const
     {
-        BoundaryIterator begin{};
-        BoundaryIterator end{};
-        bool get_more_data = false;
+        const auto m = pattern.size();
+        auto pos = from;
+        bool found = false;
 
-        for (std::size_t i = 0; i < length; ++i)
+        while (m > 0 && !found && pos + m <= data.size())
         {
-            data.emplace_back(p[i]);
+            const auto last = data[pos + m - 1];
+
+            found = last == pattern[m - 1] && std::memcmp(&data[pos], pattern.data(), m - 1) == 0;
+
+            if (!found)
+            {
+                pos += skip[last];
+            }
         }
 
-        // data.reserve(data.size()+length+1);
-        // std::copy(&p[0], &p[length], data.end());
-        // Log::info("MIMEParser::myparse", "length={}; data.size()={}", length, data.size());
+        from = pos;
+
+        return found;
+    }
 
+    void MIMEParser::parse(const uint8_t* p, std::size_t length, IFormData& form_data, IURLEncodedData& url_data,
+                           const uint16_t chunksize)
+    {
         if (mode == Mode::FormData)
         {
-            while (!end_of_transmission && !get_more_data)
-            {
-                if (parse_status == ParseStatus::Begin)
-                {
-                    begin = find_boundary();
-
-                    if (begin != data.cend())  // begin boundary found
-                    {
-                        parse_status = ParseStatus::Headers;
+            // Enough room for a full chunk followed by the start of a boundary that may complete it.
+            const auto capacity = static_cast<std::size_t>(chunksize) + boundary.size();
 
-                        // "+LEN_OF_CRLF": also delete trailing crlf
-                        data.erase(data.begin(), get_end_of_boundary(begin) + LEN_OF_CRLF);
-                    }
-                    else
-                    {
-                        get_more_data = true;
-                    }
-                }
-                else if (parse_status == ParseStatus::Headers)
-                {
-                    auto p = std::search(data.cbegin(), data.cend(), crlf_double.cbegin(), crlf_double.cend());
+            if (data.capacity() < capacity)
+            {
+                data.reserve(capacity);
+            }
 
-                    if (p != data.cend())  // end of headers found
-                    {
-                        auto [new_start_of_content, headers,
-                              content_disposition] = consume_headers(data.cbegin(), p + 2 * LEN_OF_CRLF);
-                        id = content_disposition["name"];
-                        filename = content_disposition["filename"];
-
-                        // Delete two CRLF
-                        data.erase(data.begin(), p + 2 * LEN_OF_CRLF);
-                        parse_status = ParseStatus::Data;
-                        first_part = true;
-                    }
-                    else
-                    {
-                        get_more_data = true;
-                    }
-                }
-                else if (parse_status == ParseStatus::Data)
-                {
-                    auto b = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
+            std::size_t consumed = 0;
 
-                    if ((data.size() > chunksize + end_boundary.size()) || (b != data.cend()))  // got something to
-                                                                                                // write
-                    {
-                        while (std::distance(data.cbegin(), b - LEN_OF_CRLF) > chunksize)
-                        {
-                            form_data.form_data(id,
-                            filename,
-                            data.cbegin(),
-                            data.cbegin() + chunksize,
-                            first_part,
-                            false);
-                            data.erase(data.begin(), data.begin() + chunksize);
-                            first_part = false;
-                            b = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
-                        }
+            // parse_form_data() always leaves room in the window unless the parsing is done.
+            while (consumed < length && parse_status != ParseStatus::Done)
+            {
+                const auto count = std::min(length - consumed, capacity - std::min(capacity, data.size()));
+                data.insert(data.end(), p + consumed, p + consumed + count);
+                consumed += count;
 
-                        if (b != data.cend())
-                        {
-                            form_data.form_data(id, filename, data.cbegin(), b - LEN_OF_CRLF, first_part, true);  // first_b-2
-                                                                                                                  // to
-                            // avoid additional
-                            // crlf in file end
-                            parse_status = ParseStatus::Headers;
-                            data.erase(data.begin(), b - LEN_OF_CRLF);
-                            first_part = false;
-
-                            if (std::distance(data.cbegin(), find_end_boundary()) <= 2 * LEN_OF_CRLF)
-                            {
-                                end_of_transmission = true;
-                                data.clear();
-                            }
-                        }
-                    }
-                    else
-                    {
-                        get_more_data = true;
-                    }
-                }
-            }  // while(!end_of_transmission && !get_more_data)
+                parse_form_data(form_data, chunksize, capacity);
+            }
 
-            end_of_transmission = false;
+            if (parse_status == ParseStatus::Done)
+            {
+                // Ignore the epilogue.
+                data.clear();
+            }
         }
         else if (mode == Mode::FormURLEncoded)
         {
+            data.insert(data.end(), p, p + length);
+
             // URL encoded data can't be parsed in chunks, so wait until all data is received
-            if (data.size() >= expected_content_length)
+            if (length_known ? data.size() >= expected_content_length : last_part)
             {
                 // Split data on '&' as it comes in. Each part is then expected to contain X=Y, so split on '='.
                 // If a part doesn't contain a '=', put it back in the buffer to be used next time.
@@ -265,17 +219,129 @@ namespace smooth::application::network::http::regular
         }
     }
 
-    BoundaryIterator MIMEParser::get_end_of_boundary(BoundaryIterator begin)
+    void MIMEParser::parse_form_data(IFormData& form_data, std::size_t chunksize, std::size_t capacity)
     {
-        // Adjust for CRLF at beginning of boundary pattern
-        auto offset = is_crlf(begin) ? LEN_OF_CRLF : 0;
+        bool get_more_data = false;
 
-        return begin + static_cast<Boundaries::difference_type>(boundary.size()) + offset;
+        while (!get_more_data)
+        {
+            if (parse_status == ParseStatus::Begin)
+            {
+                if (first_boundary.find(data, scanned))
+                {
+                    consume(scanned + first_boundary.size());
+                    set_status(ParseStatus::AfterBoundary);
+                }
+                else
+                {
+                    // Discard the preamble, but keep what may be the start of the boundary.
+                    consume(scanned);
+                    get_more_data = true;
+                }
+            }
+            else if (parse_status == ParseStatus::AfterBoundary)
+            {
+                if (data.size() < LEN_OF_CRLF)
+                {
+                    get_more_data = true;
+                }
+                else if (data[0] == '-' && data[1] == '-')
+                {
+                    // The boundary is the ending boundary
+                    set_status(ParseStatus::Done);
+                    get_more_data = true;
+                }
+                else
+                {
+                    // Skip the CRLF after the boundary
+                    consume(LEN_OF_CRLF);
+                    set_status(ParseStatus::Headers);
+                }
+            }
+            else if (parse_status == ParseStatus::Headers)
+            {
+                if (data.size() >= LEN_OF_CRLF && data[0] == '\r' && data[1] == '\n')
+                {
+                    // No headers for this part
+                    id.clear();
+                    filename.clear();
+                    consume(LEN_OF_CRLF);
+                    set_status(ParseStatus::Data);
+                    first_part = true;
+                }
+                else if (end_of_headers.find(data, scanned))
+                {
+                    const auto end = scanned + end_of_headers.size();
+                    auto [new_start_of_content, headers,
+                          content_disposition] = consume_headers(data.cbegin(),
+                                                                 data.cbegin() + static_cast<long>(end));
+                    id = content_disposition["name"];
+                    filename = content_disposition["filename"];
+
+                    consume(end);
+                    set_status(ParseStatus::Data);
+                    first_part = true;
+                }
+                else if (data.size() >= capacity)
+                {
+                    Log::error("MIMEParser", "Headers of form part do not fit in {} bytes", capacity);
+                    set_status(ParseStatus::Done);
+                    get_more_data = true;
+                }
+                else
+                {
+                    get_more_data = true;
+                }
+            }
+            else if (parse_status == ParseStatus::Data)
+            {
+                if (boundary.find(data, scanned))
+                {
+                    // The CRLF before the boundary belongs to the boundary, not to the data.
+                    form_data.form_data(id,
+                                        filename,
+                                        data.cbegin(),
+                                        data.cbegin() + static_cast<long>(scanned),
+                                        first_part,
+                                        true);
+                    first_part = false;
+                    consume(scanned + boundary.size());
+                    set_status(ParseStatus::AfterBoundary);
+                }
+                else if (scanned >= chunksize)
+                {
+                    // The first chunksize bytes can't be part of a boundary.
+                    form_data.form_data(id,
+                                        filename,
+                                        data.cbegin(),
+                                        data.cbegin() + static_cast<long>(chunksize),
+                                        first_part,
+                                        false);
+                    first_part = false;
+                    consume(chunksize);
+                }
+                else
+                {
+                    get_more_data = true;
+                }
+            }
+            else
+            {
+                get_more_data = true;
+            }
+        }
+    }
+
+    void MIMEParser::consume(std::size_t count)
+    {
+        data.erase(data.begin(), data.begin() + static_cast<long>(count));
+        scanned = scanned > count ? scanned - count : 0;
     }
 
-    bool MIMEParser::is_crlf(MIMEParser::BoundaryIterator start) const
+    void MIMEParser::set_status(ParseStatus status)
     {
-        return *start == '\r' && *(start + 1) == '\n';
+        parse_status = status;
+        scanned = 0;
     }
 
     std::tuple<MIMEParser::BoundaryIterator,
@@ -16,6 +16,7 @@ limitations under the License.
 */
 
 #include <algorithm>
+#include <charconv>
 #include "smooth/core/util/string_util.h"
 #include "smooth/application/network/http/regular/HTTPHeaderDef.h"
 #include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
@@ -39,6 +40,16 @@ namespace smooth::application::network::http
             // Make sure there is room for what he have received and what we ask for.
             packet.expand_by(amount_to_request);
         }
+        else if (chunked_content)
+        {
+            // Never ask for more than what fills the current part, and only make room for what is asked for
+            // since the framing is removed from the buffer as it is received.
+            auto room = std::max(0, content_chunk_size - content_bytes_received_in_current_part);
+            amount_to_request =
+                static_cast<int>(chunked_decoder.get_wanted_amount(static_cast<std::size_t>(room)));
+
+            packet.data().resize(static_cast<std::size_t>(content_bytes_received_in_current_part + amount_to_request));
+        }
         else
         {
             // Never ask for more than content_chunk_size
@@ -57,34 +68,45 @@ namespace smooth::application::network::http
 
         if (state == State::reading_headers)
         {
-            const auto end_of_header = packet.find_header_ending();
+            // Only the newly received bytes are scanned for the end of the headers.
+            const auto res = parser.parse(packet.data().data(), static_cast<std::size_t>(total_bytes_received));
 
-            if (end_of_header != packet.data().end())
+            if (res == HTTPHeaderParser::Result::Complete)
             {
                 // End of header found
                 state = State::reading_content;
-                actual_header_size = consume_headers(packet, end_of_header);
+                actual_header_size = consume_headers(packet);
                 total_content_bytes_received = total_bytes_received - actual_header_size;
 
+                if (chunked_content)
+                {
+                    // Any part of the body received along with the headers is decoded in place.
+                    total_content_bytes_received = static_cast<int>(
+                        chunked_decoder.decode(packet.data().data(),
+                                               static_cast<std::size_t>(total_content_bytes_received)));
+                }
+
                 // content_bytes_received_in_current_part may be larger than content_chunk_size
                 content_bytes_received_in_current_part = total_content_bytes_received;
 
-                try
+                if (incoming_content_length < 0)
                 {
-                    incoming_content_length = packet.headers()[CONTENT_LENGTH].empty() ? 0 : std::stoi(
-                            packet.headers()[CONTENT_LENGTH]);
-
-                    if (incoming_content_length < 0)
-                    {
-                        error = true;
-                        Log::error("HTTPProtocol", "{} is < 0: {}.", CONTENT_LENGTH, incoming_content_length);
-                    }
+                    error = true;
+                    Log::error("HTTPProtocol", "{} is < 0: {}.", CONTENT_LENGTH, incoming_content_length);
                 }
-                catch (...)
+                else if (chunked_decoder.is_error())
                 {
-                    incoming_content_length = 0;
+                    response.reply_error(std::make_unique<responses::ErrorResponse>(ResponseCode::Bad_Request));
+                    Log::error("HTTPProtocol", "Malformed chunked content.");
+                    reset();
                 }
             }
+            else if (res == HTTPHeaderParser::Result::Error)
+            {
+                response.reply_error(std::make_unique<responses::ErrorResponse>(ResponseCode::Bad_Request));
+                Log::error("HTTPProtocol", "Malformed headers.");
+                reset();
+            }
             else if (total_bytes_received >= max_header_size)
             {
                 // Headers are too large
@@ -98,6 +120,20 @@ namespace smooth::application::network::http
                 reset();
             }
         }
+        else if (chunked_content)
+        {
+            auto* received = &packet.data()[static_cast<std::size_t>(content_bytes_received_in_current_part)];
+            auto decoded = static_cast<int>(chunked_decoder.decode(received, static_cast<std::size_t>(length)));
+            total_content_bytes_received += decoded;
+            content_bytes_received_in_current_part += decoded;
+
+            if (chunked_decoder.is_error())
+            {
+                response.reply_error(std::make_unique<responses::ErrorResponse>(ResponseCode::Bad_Request));
+                Log::error("HTTPProtocol", "Malformed chunked content.");
+                reset();
+            }
+        }
         else
         {
             total_content_bytes_received += length;
@@ -113,22 +149,18 @@ namespace smooth::application::network::http
             packet.set_request_data(last_method, last_url, last_request_version);
 
             // When there are more data expected, then this packet is "to be continued"
-            if (total_content_bytes_received < incoming_content_length)
+            if (!is_content_received())
             {
                 packet.set_continued();
             }
 
-            // When still reading the headers, the packet can never be a continuation.
-            if (state != State::reading_headers)
+            // Packets following the first one of a request continue it.
+            if (part_delivered)
             {
-                // If we've already received more data than what fits in a single chunk, then this packet
-                // is a continuation of an earlier packet.
-                if (total_content_bytes_received - content_bytes_received_in_current_part > content_chunk_size)
-                {
-                    // Packet continues a previous packet.
-                    packet.set_continuation();
-                }
+                packet.set_continuation();
             }
+
+            part_delivered = true;
         }
     }
 
@@ -153,99 +185,94 @@ namespace smooth::application::network::http
         auto complete = state != State::reading_headers;
 
         bool content_received =
-            incoming_content_length == 0 // No content to read.
-            || total_content_bytes_received == incoming_content_length // All content received
+            is_content_received()
             || content_bytes_received_in_current_part >= content_chunk_size; // Packet filled, split into multiple
                                                                              // chunks.
 
         return complete && content_received;
     }
 
+    bool RegularHTTPProtocol::is_content_received() const
+    {
+        bool received;
+
+        if (chunked_content)
+        {
+            received = chunked_decoder.is_done();
+        }
+        else
+        {
+            received = incoming_content_length == 0 // No content to read.
+                       || total_content_bytes_received >= incoming_content_length; // All content received
+        }
+
+        return received;
+    }
+
     bool RegularHTTPProtocol::is_error()
     {
         return error;
     }
 
-    int RegularHTTPProtocol::consume_headers(HTTPPacket& packet,
-                                             std::vector<uint8_t>::const_iterator header_ending)
+    int RegularHTTPProtocol::consume_headers(HTTPPacket& packet)
     {
-        std::stringstream ss;
-
-        std::for_each(packet.data().cbegin(),
-                      header_ending,
-                      [&ss](auto& c) {
-                          if (c != '\n')
-                          {
-                              ss << static_cast<char>(c);
-                          }
-        });
-
-        // Get actual end of header
-        header_ending += HTTPPacket::ending.size();
-
-        // Update actual header size
-        auto actual_header_bytes_received = static_cast<int>(std::distance(packet.data().cbegin(), header_ending));
-
-        // Erase headers from buffer
-        packet.data().erase(packet.data().begin(), header_ending);
-
-        std::string s;
+        if (parser.is_request())
+        {
+            // Store method for use in continued packets.
+            last_method = parser.method();
+            last_url = parser.url();
+            last_request_version = parser.version();
+            packet.set_request_data(last_method, last_url, last_request_version);
+        }
+        else
+        {
+            packet.set_response_data(static_cast<ResponseCode>(parser.status_code()));
+        }
 
-        while (std::getline(ss, s, '\r'))
+        for (const auto& h : parser)
         {
-            if (!s.empty())
+            if (!h.value.empty())
             {
-                auto colon = std::find(s.begin(), s.end(), ':');
+                // Headers are case-insensitive: https://tools.ietf.org/html/rfc7230#section-3.2
+                // Headers may be split on several lines, so append data if header isn't empty.
+                auto& curr_header = packet.headers()[string_util::to_lower_copy(std::string{ h.name })];
 
-                if (colon == s.end() && !s.empty())
+                if (curr_header.empty())
                 {
-                    std::smatch m;
-
-                    if (std::regex_match(s, m, request_line))
-                    {
-                        // Store method for use in continued packets.
-                        last_method = m[1].str();
-                        last_url = m[2].str();
-                        last_request_version = m[3].str();
-                        packet.set_request_data(last_method, last_url, last_request_version);
-                    }
-                    else if (std::regex_match(s, m, response_line))
-                    {
-                        // Store response data for later use
-                        try
-                        {
-                            auto response_code = std::stoi(m[2].str());
-                            packet.set_response_data(static_cast<ResponseCode>(response_code));
-                        }
-                        catch (...)
-                        {
-                            error = true;
-
-                            Log::error("HTTPProtocol", "Invalid response code: {}", m[2].str());
-                        }
-                    }
+                    curr_header = h.value;
                 }
                 else
                 {
-                    if (std::distance(colon, s.end()) > 2)
-                    {
-                        // Headers are case-insensitive: https://tools.ietf.org/html/rfc7230#section-3.2
-                        // Headers may be split on several lines, so append data if header isn't empty.
-                        auto& curr_header = packet.headers()[string_util::to_lower_copy({ s.begin(), colon })];
-
-                        if (curr_header.empty())
-                        {
-                            curr_header = { colon + 2, s.end() };
-                        }
-                        else
-                        {
-                            curr_header.append(", ").append({ colon + 2, s.end() });
-                        }
-                    }
+                    curr_header.append(", ").append(h.value);
                 }
             }
         }
 
+        incoming_content_length = 0;
+        const auto content_length = parser.get(CONTENT_LENGTH);
+
+        // Transfer-Encoding overrides Content-Length, https://tools.ietf.org/html/rfc7230#section-3.3.3
+        // Chunked must be the last encoding applied.
+        const auto transfer_encoding = string_util::to_lower_copy(std::string{ parser.get(TRANSFER_ENCODING) });
+        const std::string chunked{ "chunked" };
+        chunked_content = transfer_encoding.size() >= chunked.size()
+                          && transfer_encoding.compare(transfer_encoding.size() - chunked.size(),
+                                                       chunked.size(), chunked) == 0;
+        chunked_decoder.reset();
+
+        // An invalid value is treated as no content, same as a missing header.
+        if (chunked_content
+            || std::from_chars(content_length.data(), content_length.data() + content_length.size(),
+                               incoming_content_length).ec != std::errc{})
+        {
+            incoming_content_length = 0;
+        }
+
+        const auto actual_header_bytes_received = static_cast<int>(parser.header_size());
+
+        // Erase headers from buffer, the parsed views are not used beyond this point.
+        packet.data().erase(packet.data().begin(), packet.data().begin() + actual_header_bytes_received);
+
         return actual_header_bytes_received;
     }
 
@@ -253,14 +280,18 @@ namespace smooth::application::network::http
     {
         content_bytes_received_in_current_part = 0;
 
-        if (error || total_content_bytes_received >= incoming_content_length)
+        if (error || is_content_received())
         {
             // All chunks of the current request has been received.
             total_bytes_received = 0;
             incoming_content_length = 0;
             total_content_bytes_received = 0;
             actual_header_size = 0;
+            chunked_content = false;
+            chunked_decoder.reset();
+            part_delivered = false;
             state = State::reading_headers;
+            parser.reset();
         }
 
         error = false;
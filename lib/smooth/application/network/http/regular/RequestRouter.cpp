@@ -0,0 +1,216 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/RequestRouter.h"
+#include <algorithm>
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular
+{
+    static constexpr const char* tag = "RequestRouter";
+
+    bool RequestRouter::add(HTTPMethod method, const std::string& route, std::shared_ptr<HTTPRequestHandler> handler)
+    {
+        std::string_view rest{ route };
+        Node* node = &roots[method];
+        std::size_t parameter_count = 0;
+        bool ok = true;
+
+        while (ok && !rest.empty())
+        {
+            auto special = rest.find_first_of("{*");
+
+            if (special > 0)
+            {
+                // Plain text up to the next parameter or wildcard, or the end of the route.
+                auto literal = rest.substr(0, special);
+                node = insert_static(*node, literal);
+                rest.remove_prefix(literal.size());
+            }
+            else if (rest[0] == '*')
+            {
+                // A wildcard must be last
+                ok = rest.size() == 1;
+
+                if (ok)
+                {
+                    if (!node->wildcard)
+                    {
+                        node->wildcard = std::make_unique<Node>();
+                    }
+
+                    node = node->wildcard.get();
+                    rest.remove_prefix(1);
+                }
+            }
+            else
+            {
+                // A parameter must span an entire path segment.
+                auto start = route.size() - rest.size();
+                auto close = rest.find('}');
+                ok = start > 0
+                     && route[start - 1] == '/'
+                     && close != std::string_view::npos
+                     && close > 1
+                     && (close + 1 == rest.size() || rest[close + 1] == '/')
+                     && ++parameter_count <= RouteParameters::max_parameters;
+
+                if (ok)
+                {
+                    auto name = rest.substr(1, close - 1);
+
+                    if (!node->parameter)
+                    {
+                        node->parameter = std::make_unique<Node>();
+                        node->parameter_name = name;
+                    }
+
+                    ok = node->parameter_name == name;
+                    node = node->parameter.get();
+                    rest.remove_prefix(close + 1);
+                }
+            }
+        }
+
+        if (ok)
+        {
+            node->handler = std::move(handler);
+        }
+        else
+        {
+            Log::error(tag, "Invalid route: '{}'", route);
+        }
+
+        return ok;
+    }
+
+    RequestRouter::Node* RequestRouter::insert_static(Node& node, std::string_view path)
+    {
+        Node* current = &node;
+
+        while (!path.empty())
+        {
+            auto child = std::find_if(current->children.begin(), current->children.end(),
+                                      [path](const std::unique_ptr<Node>& n) {
+                                          return n->prefix[0] == path[0];
+                                      });
+
+            if (child == current->children.end())
+            {
+                auto n = std::make_unique<Node>();
+                n->prefix = path;
+                current->children.emplace_back(std::move(n));
+                current = current->children.back().get();
+                path = {};
+            }
+            else
+            {
+                auto& existing = *child;
+                auto mismatch = std::mismatch(existing->prefix.begin(), existing->prefix.end(),
+                                              path.begin(), path.end());
+                auto common = static_cast<std::size_t>(std::distance(existing->prefix.begin(), mismatch.first));
+
+                if (common < existing->prefix.size())
+                {
+                    // Split the edge; the existing node keeps the part after the common prefix.
+                    auto split = std::make_unique<Node>();
+                    split->prefix = existing->prefix.substr(0, common);
+                    existing->prefix.erase(0, common);
+                    split->children.emplace_back(std::move(existing));
+                    existing = std::move(split);
+                }
+
+                current = existing.get();
+                path.remove_prefix(common);
+            }
+        }
+
+        return current;
+    }
+
+    HTTPRequestHandler* RequestRouter::find(HTTPMethod method, std::string_view url, RouteParameters& parameters) const
+    {
+        HTTPRequestHandler* res = nullptr;
+        parameters.clear();
+
+        auto root = roots.find(method);
+
+        if (root != roots.end())
+        {
+            auto node = match(root->second, url, parameters);
+
+            if (node)
+            {
+                res = node->handler.get();
+            }
+        }
+
+        return res;
+    }
+
+    const RequestRouter::Node* RequestRouter::match(const Node& node, std::string_view path, RouteParameters& parameters)
+    {
+        const Node* found = nullptr;
+
+        if (path.empty() && node.handler)
+        {
+            found = &node;
+        }
+
+        if (!found && !path.empty())
+        {
+            // Children never share their first character, so at most one can match.
+            auto child = std::find_if(node.children.begin(), node.children.end(),
+                                      [path](const std::unique_ptr<Node>& n) {
+                                          return n->prefix[0] == path[0];
+                                      });
+
+            if (child != node.children.end() && path.compare(0, (*child)->prefix.size(), (*child)->prefix) == 0)
+            {
+                found = match(**child, path.substr((*child)->prefix.size()), parameters);
+            }
+        }
+
+        if (!found && node.parameter && !path.empty() && path[0] != '/')
+        {
+            auto value = path.substr(0, path.find('/'));
+            auto count = parameters.size();
+
+            if (parameters.push(node.parameter_name, value))
+            {
+                found = match(*node.parameter, path.substr(value.size()), parameters);
+            }
+
+            if (!found)
+            {
+                parameters.truncate(count);
+            }
+        }
+
+        if (!found && node.wildcard && node.wildcard->handler)
+        {
+            if (parameters.push(RouteParameters::wildcard, path))
+            {
+                found = node.wildcard.get();
+            }
+        }
+
+        return found;
+    }
+}
@@ -0,0 +1,322 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/StaticFileCache.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/Fileinfo.h"
+
+using namespace smooth::core::filesystem;
+using namespace std::chrono;
+
+namespace smooth::application::network::http::regular
+{
+    StaticFileCache::StaticFileCache(Path web_root,
+                                     std::vector<std::string> index_files,
+                                     std::set<std::string> template_files,
+                                     std::size_t max_size,
+                                     std::size_t max_file_size,
+                                     milliseconds revalidate_interval)
+            : web_root(std::move(web_root)),
+              index_files(std::move(index_files)),
+              template_files(std::move(template_files)),
+              max_size(max_size),
+              max_file_size(max_file_size),
+              revalidate_interval(revalidate_interval)
+    {
+    }
+
+    /// Drops empty and "." segments and applies ".." segments, so that e.g. "/a", "//a" and "/./a" share
+    /// a cache entry.
+    /// \return false if the URL refers to something above the web root.
+    static bool normalize(const std::string& url, std::string& path)
+    {
+        std::vector<std::string> segments{};
+        bool valid = true;
+        std::size_t start = 0;
+
+        while (valid && start <= url.size())
+        {
+            auto end = std::min(url.find('/', start), url.size());
+            auto segment = url.substr(start, end - start);
+            start = end + 1;
+
+            if (segment == "..")
+            {
+                valid = !segments.empty();
+
+                if (valid)
+                {
+                    segments.pop_back();
+                }
+            }
+            else if (!segment.empty() && segment != ".")
+            {
+                segments.emplace_back(std::move(segment));
+            }
+        }
+
+        path.clear();
+
+        for (const auto& segment : segments)
+        {
+            path.append("/").append(segment);
+        }
+
+        if (path.empty())
+        {
+            path = "/";
+        }
+
+        return valid;
+    }
+
+    std::shared_ptr<const CachedFile> StaticFileCache::get(const std::string& url)
+    {
+        std::shared_ptr<const CachedFile> res{};
+        std::string path{};
+
+        if (normalize(url, path))
+        {
+            res = get_normalized(path);
+        }
+
+        return res;
+    }
+
+    std::shared_ptr<const CachedFile> StaticFileCache::get_normalized(const std::string& url)
+    {
+        std::shared_ptr<const CachedFile> res{};
+        auto now = steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(guard);
+        auto cached = lookup.find(url);
+
+        if (cached != lookup.end())
+        {
+            auto entry = cached->second;
+
+            if (now - entry->validated < revalidate_interval || is_unchanged(*entry->file))
+            {
+                entry->validated = now;
+                entries.splice(entries.begin(), entries, entry);
+                res = entry->file;
+            }
+            else
+            {
+                remove(entry);
+            }
+        }
+
+        if (!res)
+        {
+            // Don't hold the lock while reading the file.
+            lock.unlock();
+            res = load(url);
+            lock.lock();
+
+            if (res && lookup.find(url) == lookup.end())
+            {
+                insert(url, res, now);
+            }
+        }
+
+        return res;
+    }
+
+    std::size_t StaticFileCache::size() const
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        return used;
+    }
+
+    void StaticFileCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        entries.clear();
+        lookup.clear();
+        used = 0;
+    }
+
+    std::shared_ptr<const CachedFile> StaticFileCache::load(const std::string& url) const
+    {
+        std::shared_ptr<CachedFile> res{};
+
+        Path search{ web_root };
+        search /= url;
+
+        if (web_root.is_parent_of(search) || web_root == search)
+        {
+            if (FileInfo{ search }.is_directory())
+            {
+                search = find_index(search);
+            }
+        }
+        else
+        {
+            search = Path{};
+        }
+
+        if (!search.empty())
+        {
+            bool is_template = template_files.find(search.extension()) != template_files.end();
+            res = load_file(search, search, is_template);
+
+            if (res && !is_template)
+            {
+                Path gz{ (search.str() + ".gz").c_str() };
+
+                if (FileInfo{ gz }.is_regular_file())
+                {
+                    res->headers[VARY] = ACCEPT_ENCODING;
+                    auto gzipped = load_file(gz, search, false);
+
+                    if (gzipped)
+                    {
+                        gzipped->headers[CONTENT_ENCODING] = "gzip";
+                        gzipped->headers[VARY] = ACCEPT_ENCODING;
+                        res->gzipped = std::move(gzipped);
+                    }
+                }
+            }
+        }
+
+        return res;
+    }
+
+    std::shared_ptr<CachedFile> StaticFileCache::load_file(const Path& path,
+                                                           const Path& content_path,
+                                                           bool is_template) const
+    {
+        std::shared_ptr<CachedFile> res{};
+        FileInfo info(path);
+
+        if (info.is_regular_file())
+        {
+            res = std::make_shared<CachedFile>();
+            res->path = info.path();
+            res->modified = info.last_modified();
+            res->size = info.size();
+
+            std::stringstream etag;
+            etag << '"' << std::hex << res->size << '-' << res->modified << '"';
+            res->etag = etag.str();
+
+            // The content type is that of the original file also for compressed variants.
+            res->headers[CONTENT_LENGTH] = std::to_string(res->size);
+            res->headers[CONTENT_TYPE] = utils::get_content_type(content_path);
+            res->headers[LAST_MODIFIED] = utils::make_http_time(res->modified);
+            res->headers[ETAG] = res->etag;
+
+            if (!is_template)
+            {
+                // Templates are generated for each request, so only static files can be requested in parts.
+                res->headers[ACCEPT_RANGES] = "bytes";
+            }
+
+            if (!is_template && res->size <= max_file_size)
+            {
+                auto content = std::make_shared<std::vector<uint8_t>>();
+
+                if (res->size == 0 || File::read(res->path, *content, 0, res->size))
+                {
+                    res->content = std::move(content);
+                }
+            }
+        }
+
+        return res;
+    }
+
+    Path StaticFileCache::find_index(const Path& search_path) const
+    {
+        Path found_index{};
+
+        for (auto index = index_files.begin(); found_index.empty() && index != index_files.end(); ++index)
+        {
+            auto index_path = search_path / *index;
+
+            if (web_root.is_parent_of(index_path))
+            {
+                FileInfo index_info(index_path);
+
+                if (index_info.is_regular_file())
+                {
+                    found_index = index_path;
+                }
+            }
+        }
+
+        return found_index;
+    }
+
+    bool StaticFileCache::is_unchanged(const CachedFile& file) const
+    {
+        FileInfo info{ file.path };
+
+        bool unchanged = info.is_regular_file() && info.last_modified() == file.modified && info.size() == file.size;
+
+        if (unchanged && !file.gzipped)
+        {
+            // A compressed variant may have been added.
+            unchanged = file.headers.find(VARY) != file.headers.end()
+                        || !FileInfo{ Path{ (file.path.str() + ".gz").c_str() } }.is_regular_file();
+        }
+        else if (unchanged)
+        {
+            unchanged = is_unchanged(*file.gzipped);
+        }
+
+        return unchanged;
+    }
+
+    void StaticFileCache::insert(const std::string& url,
+                                 std::shared_ptr<const CachedFile> file,
+                                 steady_clock::time_point now)
+    {
+        auto cost = sizeof(Entry) + sizeof(CachedFile) + url.size() + (file->content ? file->content->size() : 0);
+
+        if (file->gzipped)
+        {
+            cost += sizeof(CachedFile) + (file->gzipped->content ? file->gzipped->content->size() : 0);
+        }
+
+        if (cost <= max_size)
+        {
+            while (used + cost > max_size)
+            {
+                remove(std::prev(entries.end()));
+            }
+
+            entries.push_front(Entry{ url, std::move(file), now, cost });
+            lookup[url] = entries.begin();
+            used += cost;
+        }
+    }
+
+    void StaticFileCache::remove(Entries::iterator entry)
+    {
+        used -= entry->cost;
+        lookup.erase(entry->url);
+        entries.erase(entry);
+    }
+}
@@ -16,15 +16,13 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
-#include <regex>
-#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "smooth/application/network/http/regular/responses/TemplateResponse.h"
 #include "smooth/application/network/http/regular/responses/ErrorResponse.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
 #include "smooth/core/filesystem/File.h"
-#include "smooth/core/util/string_util.h"
+#include "smooth/core/filesystem/Fileinfo.h"
 
 using namespace smooth::core::filesystem;
-using namespace smooth::core::string_util;
 
 namespace smooth::application::network::http::regular
 {
@@ -43,18 +41,51 @@ namespace smooth::application::network::http::regular
         bool is_template_file = template_files.find(ext) != template_files.end();
 
         if (is_template_file)
+        {
+            auto compiled = get_compiled(path);
+
+            if (compiled)
+            {
+                res = std::make_unique<responses::TemplateResponse>(ResponseCode::OK,
+                                                                    std::move(compiled),
+                                                                    data_retriever.get());
+            }
+            else
+            {
+                res = std::make_unique<responses::ErrorResponse>(ResponseCode::Internal_Server_Error);
+            }
+        }
+
+        return res;
+    }
+
+    std::shared_ptr<const CompiledTemplate> TemplateProcessor::get_compiled(const Path& path)
+    {
+        std::shared_ptr<const CompiledTemplate> res{};
+        FileInfo info{ path };
+
+        std::lock_guard<std::mutex> lock(cache_guard);
+        auto cached = cache.find(path.str());
+
+        if (cached != cache.end()
+            && cached->second.modified == info.last_modified()
+            && cached->second.size == info.size())
+        {
+            res = cached->second.compiled;
+        }
+        else
         {
             std::string data;
             File src{ path };
 
-            if (!src.read(data) || data.empty())
+            if (src.read(data) && !data.empty())
             {
-                res = std::make_unique<responses::ErrorResponse>(ResponseCode::Internal_Server_Error);
+                res = std::make_shared<const CompiledTemplate>(std::move(data));
+                cache[path.str()] = CacheEntry{ info.last_modified(), info.size(), res };
             }
             else
             {
-                process_template(data);
-                res = std::make_unique<responses::StringResponse>(ResponseCode::OK, data, false);
+                cache.erase(path.str());
             }
         }
 
@@ -64,28 +95,30 @@ namespace smooth::application::network::http::regular
     void TemplateProcessor::process_template(std::string& template_data) const
     {
         // Find keys in the form "{{alpha_num}}, then do a lookup on the alpha_num part
-        // and replace the entire found token. Continue search after the found token until end of data.
-
+        // and replace the entire found token. Any token without corresponding data is replaced
+        // with an empty string.
         if (data_retriever)
         {
-            try
+            CompiledTemplate compiled{ template_data };
+            std::vector<std::string> values{};
+
+            for (const auto& token : compiled.get_tokens())
             {
-                // Find all tokens
-                std::smatch match{};
+                values.emplace_back(data_retriever->get(token));
+            }
 
-                while (std::regex_search(template_data, match, token))
-                {
-                    std::stringstream ss;
-                    const auto& found_token = match[0].str();
+            template_data.clear();
 
-                    // Replaces any matched token, even if no corresponding data exists, in which case empty string is
-                    // used.
-                    replace_all(template_data, found_token, data_retriever->get(found_token));
-                }
-            }
-            catch (std::regex_error& ex)
+            for (const auto& segment : compiled.get_segments())
             {
-                Log::error("TemplateProcessor", ex.what());
+                if (segment.token == CompiledTemplate::npos)
+                {
+                    template_data.append(compiled.text(segment));
+                }
+                else
+                {
+                    template_data.append(values[segment.token]);
+                }
             }
         }
     }
@@ -0,0 +1,90 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/responses/CachedFileResponse.h"
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    CachedFileResponse::CachedFileResponse(std::shared_ptr<const CachedFile> file)
+            : HeaderOnlyResponse(ResponseCode::OK, file->headers),
+              file(std::move(file))
+    {
+    }
+
+    void CachedFileResponse::set_ranges(ByteRanges byte_ranges)
+    {
+        code = ResponseCode::Partial_Content;
+        ranges = std::move(byte_ranges);
+        ranges.prepare(headers);
+    }
+
+    ResponseStatus CachedFileResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        std::shared_ptr<const uint8_t> data{};
+        std::size_t length = 0;
+        auto res = get_data_view(max_amount, data, length);
+
+        if (length > 0)
+        {
+            target.insert(target.end(), data.get(), data.get() + length);
+        }
+
+        return res;
+    }
+
+    ResponseStatus CachedFileResponse::get_data_view(std::size_t max_amount,
+                                                     std::shared_ptr<const uint8_t>& data,
+                                                     std::size_t& length)
+    {
+        auto res = ResponseStatus::NoData;
+        const auto& content = file->content;
+        length = 0;
+
+        if (ranges.is_satisfiable())
+        {
+            std::size_t offset = 0;
+            res = ranges.next(max_amount, data, offset, length);
+
+            if (!data && length > 0)
+            {
+                data = std::shared_ptr<const uint8_t>(content, content->data() + offset);
+            }
+
+            sent += length;
+        }
+        else if (sent < content->size())
+        {
+            length = std::min(content->size() - sent, max_amount);
+
+            // Refers directly into the cached content, keeping it alive while the data is being sent.
+            data = std::shared_ptr<const uint8_t>(content, content->data() + sent);
+            sent += length;
+            res = sent < content->size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    void CachedFileResponse::dump() const
+    {
+        Log::debug("CachedFileResponse", "Code: {}; Status: {}/{} bytes, Path: {}", code, sent,
+                   file->content->size(), file->path);
+    }
+}
@@ -31,19 +31,45 @@ namespace smooth::application::network::http::regular::responses
     FileContentResponse::FileContentResponse(smooth::core::filesystem::Path full_path)
             : StringResponse(ResponseCode::OK),
               path(std::move(full_path)),
-              info(path)
+              info(path),
+              reader(smooth::core::filesystem::FileReader::open(path))
     {
         headers[CONTENT_LENGTH] = std::to_string(info.size());
         headers[CONTENT_TYPE] = utils::get_content_type(info.path());
         headers[LAST_MODIFIED] = utils::make_http_time(info.last_modified());
     }
 
+    void FileContentResponse::set_ranges(ByteRanges byte_ranges)
+    {
+        code = ResponseCode::Partial_Content;
+        ranges = std::move(byte_ranges);
+        ranges.prepare(headers);
+    }
+
     // Called at least once when sending a response and until ResponseStatus::NoData is returned
     ResponseStatus FileContentResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
     {
         auto res = ResponseStatus::NoData;
 
-        if (sent < info.size())
+        if (ranges.is_satisfiable())
+        {
+            std::shared_ptr<const uint8_t> framing{};
+            std::size_t offset = 0;
+            std::size_t length = 0;
+            res = ranges.next(max_amount, framing, offset, length);
+
+            if (framing)
+            {
+                target.insert(target.end(), framing.get(), framing.get() + length);
+            }
+            else if (length > 0 && !smooth::core::filesystem::File::read(path, target, offset, length))
+            {
+                res = ResponseStatus::Error;
+            }
+
+            sent += length;
+        }
+        else if (sent < info.size())
         {
             auto to_send = std::min(info.size() - sent, max_amount);
 
@@ -63,6 +89,50 @@ namespace smooth::application::network::http::regular::responses
         return res;
     }
 
+    bool FileContentResponse::has_data_view() const
+    {
+        return reader != nullptr;
+    }
+
+    ResponseStatus FileContentResponse::get_data_view(std::size_t max_amount,
+                                                      std::shared_ptr<const uint8_t>& data,
+                                                      std::size_t& length)
+    {
+        auto res = ResponseStatus::NoData;
+        length = 0;
+
+        if (ranges.is_satisfiable())
+        {
+            // Framing is provided by the ranges, content is read straight from its offset in the file.
+            std::size_t offset = 0;
+            res = ranges.next(max_amount, data, offset, length);
+
+            if (!data && length > 0 && !reader->read(offset, length, data))
+            {
+                res = ResponseStatus::Error;
+            }
+
+            sent += length;
+        }
+        else if (sent < info.size())
+        {
+            auto to_send = std::min(info.size() - sent, max_amount);
+
+            if (reader->read(sent, to_send, data))
+            {
+                sent += to_send;
+                length = to_send;
+                res = sent < info.size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+            }
+            else
+            {
+                res = ResponseStatus::Error;
+            }
+        }
+
+        return res;
+    }
+
     void FileContentResponse::dump() const
     {
         Log::debug("FileContentResponse", "Code: {}; Status: {}/{} bytes, Path: {}", code, sent, info.size(), path);
@@ -0,0 +1,98 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/responses/GzipResponse.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    GzipResponse::GzipResponse(std::unique_ptr<IResponseOperation> response, uint8_t window_bits)
+            : HeaderOnlyResponse(response->get_response_code(), response->get_headers()),
+              response(std::move(response)),
+              compressor(window_bits)
+    {
+        headers.erase(CONTENT_LENGTH);
+        headers[CONTENT_ENCODING] = "gzip";
+        headers[VARY] = ACCEPT_ENCODING;
+    }
+
+    ResponseStatus GzipResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res = ResponseStatus::NoData;
+
+        // Compress until there is enough to fill the requested amount, so that only about one chunk
+        // of compressed data is held at a time.
+        while (response && pending.size() < max_amount)
+        {
+            read_response(max_amount);
+        }
+
+        if (failed)
+        {
+            res = ResponseStatus::Error;
+        }
+        else if (!pending.empty())
+        {
+            auto count = std::min(max_amount, pending.size());
+            target.insert(target.end(), pending.begin(), pending.begin() + static_cast<long>(count));
+            pending.erase(pending.begin(), pending.begin() + static_cast<long>(count));
+            sent += count;
+            res = pending.empty() && !response ? ResponseStatus::LastData : ResponseStatus::HasMoreData;
+        }
+
+        return res;
+    }
+
+    void GzipResponse::read_response(std::size_t amount)
+    {
+        auto status = ResponseStatus::NoData;
+
+        if (response->has_data_view())
+        {
+            std::shared_ptr<const uint8_t> view{};
+            std::size_t length = 0;
+            status = response->get_data_view(amount, view, length);
+            compressor.write(view.get(), length, pending);
+        }
+        else
+        {
+            part.clear();
+            status = response->get_data(amount, part);
+            compressor.write(part.data(), part.size(), pending);
+        }
+
+        if (status == ResponseStatus::Error)
+        {
+            Log::error("GzipResponse", "Compressed response reported an error.");
+            failed = true;
+            response.reset();
+        }
+        else if (status != ResponseStatus::HasMoreData)
+        {
+            compressor.finish(pending);
+            response.reset();
+        }
+    }
+
+    void GzipResponse::dump() const
+    {
+        Log::debug("GzipResponse", "Code: {}; Sent: {} bytes, pending: {} bytes", code, sent, pending.size());
+    }
+}
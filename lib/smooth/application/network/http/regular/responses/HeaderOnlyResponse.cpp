@@ -35,6 +35,13 @@ namespace smooth::application::network::http::regular::responses
         headers[LAST_MODIFIED] = utils::make_http_time(std::chrono::system_clock::now());
     }
 
+    HeaderOnlyResponse::HeaderOnlyResponse(ResponseCode code,
+                                           std::unordered_map<std::string, std::string> initial_headers)
+            : code(code)
+    {
+        headers = std::move(initial_headers);
+    }
+
     ResponseCode HeaderOnlyResponse::get_response_code()
     {
         return code;
@@ -0,0 +1,52 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/responses/StreamingResponse.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    StreamingResponse::StreamingResponse(ResponseCode code, const std::string& content_type, Producer producer)
+            : HeaderOnlyResponse(code),
+              producer(std::move(producer))
+    {
+        headers[CONTENT_TYPE] = content_type;
+    }
+
+    ResponseStatus StreamingResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res = ResponseStatus::NoData;
+
+        if (!done)
+        {
+            auto size_before = target.size();
+            res = producer(max_amount, target);
+            sent += target.size() - size_before;
+            done = res != ResponseStatus::HasMoreData;
+        }
+
+        return res;
+    }
+
+    void StreamingResponse::dump() const
+    {
+        Log::debug("StreamingResponse", "Code: {}; Sent: {} bytes", code, sent);
+    }
+}
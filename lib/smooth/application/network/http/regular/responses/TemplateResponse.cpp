@@ -0,0 +1,102 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/responses/TemplateResponse.h"
+#include <algorithm>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    TemplateResponse::TemplateResponse(ResponseCode code,
+                                       std::shared_ptr<const CompiledTemplate> compiled_template,
+                                       const ITemplateDataRetriever* data_retriever)
+            : HeaderOnlyResponse(code),
+              compiled(std::move(compiled_template)),
+              has_values(data_retriever != nullptr)
+    {
+        if (has_values)
+        {
+            // Any token without corresponding data is replaced with an empty string.
+            values.reserve(compiled->get_tokens().size());
+
+            for (const auto& token : compiled->get_tokens())
+            {
+                values.emplace_back(data_retriever->get(token));
+            }
+        }
+
+        std::size_t length = 0;
+
+        for (const auto& segment : compiled->get_segments())
+        {
+            length += segment_text(segment).size();
+        }
+
+        headers[CONTENT_LENGTH] = std::to_string(length);
+        headers[CONTENT_TYPE] = "text/html";
+    }
+
+    std::string_view TemplateResponse::segment_text(const CompiledTemplate::Segment& segment) const
+    {
+        return has_values && segment.token != CompiledTemplate::npos
+               ? std::string_view{ values[segment.token] }
+               : compiled->text(segment);
+    }
+
+    ResponseStatus TemplateResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res{ ResponseStatus::NoData };
+        const auto& segments = compiled->get_segments();
+
+        if (current_segment < segments.size())
+        {
+            std::size_t added = 0;
+
+            while (added < max_amount && current_segment < segments.size())
+            {
+                auto text = segment_text(segments[current_segment]);
+                auto to_copy = std::min(text.size() - segment_offset, max_amount - added);
+
+                target.insert(target.end(),
+                              text.begin() + static_cast<long>(segment_offset),
+                              text.begin() + static_cast<long>(segment_offset + to_copy));
+
+                added += to_copy;
+                segment_offset += to_copy;
+
+                if (segment_offset == text.size())
+                {
+                    ++current_segment;
+                    segment_offset = 0;
+                }
+            }
+
+            res = current_segment < segments.size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    void TemplateResponse::dump() const
+    {
+        Log::debug("Response", "Code: {}; Template segment {} of {}", code, current_segment,
+                   compiled->get_segments().size());
+    }
+}
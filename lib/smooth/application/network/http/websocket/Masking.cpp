@@ -0,0 +1,93 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/websocket/Masking.h"
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace smooth::application::network::http::websocket
+{
+#ifdef ESP_PLATFORM
+    // Xtensa has 32-bit registers and requires aligned word access.
+    using MaskWord = uint32_t;
+#else
+    using MaskWord = uint64_t;
+#endif
+
+    void apply_mask(uint8_t* data, std::size_t length, const uint8_t (& key)[4], uint64_t& offset)
+    {
+        auto phase = static_cast<std::size_t>(offset & 3);
+        offset += length;
+        std::size_t i = 0;
+
+        // Byte by byte until data is word aligned.
+        while (i < length && reinterpret_cast<uintptr_t>(data + i) % sizeof(MaskWord) != 0)
+        {
+            data[i] = static_cast<uint8_t>(data[i] ^ key[phase]);
+            phase = (phase + 1) & 3;
+            ++i;
+        }
+
+        // The key rotated to the current phase, repeated. Since all block sizes below are
+        // multiples of four bytes the phase stays the same throughout.
+        uint8_t rotated[16];
+
+        for (std::size_t k = 0; k < sizeof(rotated); ++k)
+        {
+            rotated[k] = key[(phase + k) & 3];
+        }
+
+#if defined(__SSE2__)
+        const auto vector_mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rotated));
+
+        for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i))
+        {
+            auto p = reinterpret_cast<__m128i*>(data + i);
+            _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), vector_mask));
+        }
+#elif defined(__ARM_NEON)
+        const auto vector_mask = vld1q_u8(rotated);
+
+        for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t))
+        {
+            vst1q_u8(data + i, veorq_u8(vld1q_u8(data + i), vector_mask));
+        }
+#endif
+
+        MaskWord word_mask;
+        std::memcpy(&word_mask, rotated, sizeof(word_mask));
+
+        for (; i + sizeof(MaskWord) <= length; i += sizeof(MaskWord))
+        {
+            MaskWord w;
+            std::memcpy(&w, data + i, sizeof(w));
+            w ^= word_mask;
+            std::memcpy(data + i, &w, sizeof(w));
+        }
+
+        for (; i < length; ++i)
+        {
+            data[i] = static_cast<uint8_t>(data[i] ^ key[phase]);
+            phase = (phase + 1) & 3;
+        }
+    }
+}
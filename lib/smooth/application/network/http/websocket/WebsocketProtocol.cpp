@@ -16,6 +16,7 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/websocket/WebsocketProtocol.h"
+#include "smooth/application/network/http/websocket/Masking.h"
 #include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
 #include "smooth/core/network/util.h"
 
@@ -146,13 +147,7 @@ namespace smooth::application::network::http::websocket
                 // De-mask data
                 if (is_data_masked())
                 {
-                    for (decltype(packet.data().size()) i = 0; i < packet.data().size(); ++i, ++demask_ix)
-                    {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wconversion"
-                        packet.data()[i] = packet.data()[i] ^ frame_data.mask_key[demask_ix % 4];
-#pragma GCC diagnostic pop
-                    }
+                    apply_mask(packet.data().data(), packet.data().size(), frame_data.mask_key, demask_ix);
                 }
 
                 set_message_properties(packet);
@@ -16,122 +16,140 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/websocket/responses/WSResponse.h"
+#include <cstring>
+#include <limits>
 #include "smooth/core/network/util.h"
 
 namespace smooth::application::network::http::websocket::responses
 {
-    ResponseStatus WSResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
-    {
-        // Portion data in such a way that at most max_amount of *data* is moved into target.
-
-        auto res{ ResponseStatus::NoData };
-
-        auto remaining = std::distance(data.begin(), data.end());
-
-        if (!header_sent)
-        {
-            header_sent = true;
-            uint8_t val;
-
-            if (!first_fragment)
-            {
-                val = static_cast<uint8_t>(OpCode::Continuation);
-            }
-            else
-            {
-                val = static_cast<uint8_t>(op_code);
-            }
-
-            if (last_fragment)
-            {
-                // Set fin-bit
-                val |= 0x80;
-            }
-
-            target.emplace_back(val);
-
-            if (remaining == 0)
-            {
-                set_length(0, target);
-                res = ResponseStatus::LastData;
-            }
-        }
-
-        if (remaining > 0)
-        {
-            auto to_send = std::min(static_cast<std::size_t>(remaining), max_amount);
-
-            set_length(to_send, target);
-
-            auto begin = data.begin();
-            auto end = data.begin() + static_cast<long>(to_send);
-
-            std::copy(begin, end, std::back_inserter(target));
-            data.erase(begin, end);
-
-            // Anything still left?
-            remaining = std::distance(data.begin(), data.end());
-            res = remaining > 0 ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
-        }
-
-        return res;
-    }
-
     WSResponse::WSResponse(OpCode code)
-            : op_code(code)
+            : op_code(code),
+              payload(std::make_shared<const std::vector<uint8_t>>())
     {
+        build_header(true, true);
     }
 
     WSResponse::WSResponse(const std::string& text, bool first_fragment, bool last_fragment)
-            : op_code(OpCode::Text), first_fragment(first_fragment), last_fragment(last_fragment)
+            : op_code(OpCode::Text),
+              payload(std::make_shared<const std::vector<uint8_t>>(text.begin(), text.end()))
     {
-        std::copy(text.begin(), text.end(), std::back_inserter(data));
+        build_header(first_fragment, last_fragment);
     }
 
     WSResponse::WSResponse(std::string&& text, bool first_fragment, bool last_fragment)
-            : op_code(OpCode::Text), first_fragment(first_fragment), last_fragment(last_fragment)
+            : op_code(OpCode::Text),
+              payload(std::make_shared<const std::vector<uint8_t>>(text.begin(), text.end()))
     {
-        std::copy(std::make_move_iterator(text.begin()),
-                  std::make_move_iterator(text.end()),
-                  std::back_inserter(data));
+        build_header(first_fragment, last_fragment);
     }
 
     WSResponse::WSResponse(const std::vector<uint8_t>& binary, bool treat_as_text, bool first_fragment,
                            bool last_fragment)
-            : op_code(treat_as_text ? OpCode::Text : OpCode::Binary), first_fragment(first_fragment),
-              last_fragment(last_fragment)
+            : op_code(treat_as_text ? OpCode::Text : OpCode::Binary),
+              payload(std::make_shared<const std::vector<uint8_t>>(binary))
     {
-        std::copy(binary.begin(), binary.end(), std::back_inserter(data));
+        build_header(first_fragment, last_fragment);
     }
 
     WSResponse::WSResponse(std::vector<uint8_t>&& binary, bool first_fragment, bool last_fragment)
-            : op_code(OpCode::Binary), first_fragment(first_fragment), last_fragment(last_fragment)
+            : op_code(OpCode::Binary),
+              payload(std::make_shared<const std::vector<uint8_t>>(std::move(binary)))
     {
-        std::copy(std::make_move_iterator(binary.begin()),
-                  std::make_move_iterator(binary.end()),
-                  std::back_inserter(data));
+        build_header(first_fragment, last_fragment);
     }
 
-    void WSResponse::set_length(uint64_t len, std::vector<uint8_t>& buff) const
+    WSResponse::WSResponse(Payload payload, bool treat_as_text, bool first_fragment, bool last_fragment)
+            : op_code(treat_as_text ? OpCode::Text : OpCode::Binary),
+              payload(payload ? std::move(payload) : std::make_shared<const std::vector<uint8_t>>())
     {
+        build_header(first_fragment, last_fragment);
+    }
+
+    void WSResponse::build_header(bool first_fragment, bool last_fragment)
+    {
+        auto val = static_cast<uint8_t>(first_fragment ? op_code : OpCode::Continuation);
+
+        if (last_fragment)
+        {
+            // Set fin-bit
+            val |= 0x80;
+        }
+
+        header[0] = val;
+
+        // The length of the entire payload, even when it is sent in several parts.
+        auto len = static_cast<uint64_t>(payload->size());
+
         if (len <= 125)
         {
-            buff.emplace_back(len);
+            header[1] = static_cast<uint8_t>(len);
+            header_length = 2;
         }
         else if (len > std::numeric_limits<uint16_t>::max())
         {
             auto size = smooth::core::network::hton(len);
-            buff.emplace_back(127);
-            auto p = reinterpret_cast<uint8_t*>(&size);
-            std::copy(p, p + sizeof(size), std::back_inserter(buff));
+            header[1] = 127;
+            std::memcpy(&header[2], &size, sizeof(size));
+            header_length = 2 + sizeof(size);
         }
         else
         {
-            auto l = static_cast<uint16_t>(len);
-            std::uint16_t size = smooth::core::network::hton(l);
-            buff.emplace_back(126);
-            auto p = reinterpret_cast<uint8_t*>(&size);
-            std::copy(p, p + sizeof(size), std::back_inserter(buff));
+            auto size = smooth::core::network::hton(static_cast<uint16_t>(len));
+            header[1] = 126;
+            std::memcpy(&header[2], &size, sizeof(size));
+            header_length = 2 + sizeof(size);
+        }
+    }
+
+    ResponseStatus WSResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        // Portion data in such a way that at most max_amount of *data* is moved into target.
+        auto res{ ResponseStatus::NoData };
+        auto to_send = std::min(remaining(), max_amount);
+
+        if (!header_sent || to_send > 0)
+        {
+            target.reserve(target.size() + header_length + to_send);
+
+            if (!header_sent)
+            {
+                header_sent = true;
+                target.insert(target.end(), header.begin(), header.begin() + static_cast<long>(header_length));
+            }
+
+            auto begin = payload->begin() + static_cast<long>(sent);
+            target.insert(target.end(), begin, begin + static_cast<long>(to_send));
+            sent += to_send;
+            res = status();
+        }
+
+        return res;
+    }
+
+    ResponseStatus WSResponse::get_data_view(std::size_t max_amount,
+                                             std::shared_ptr<const uint8_t>& data,
+                                             std::size_t& length)
+    {
+        auto res{ ResponseStatus::NoData };
+        length = 0;
+
+        if (!header_sent)
+        {
+            // The header and the first part of the payload go together; this is the only copy made.
+            auto first = std::make_shared<std::vector<uint8_t>>();
+            res = get_data(max_amount, *first);
+            length = first->size();
+            data = std::shared_ptr<const uint8_t>(first, first->data());
         }
+        else if (remaining() > 0)
+        {
+            // Refers directly into the payload, keeping it alive while the data is being sent.
+            length = std::min(remaining(), max_amount);
+            data = std::shared_ptr<const uint8_t>(payload, payload->data() + sent);
+            sent += length;
+            res = status();
+        }
+
+        return res;
     }
 }
@@ -199,11 +199,9 @@ namespace smooth::application::network::mqtt
 
     void MqttClient::event(const core::network::event::DataAvailableEvent<packet::MQTTProtocol>& event)
     {
-        packet::MQTTPacket p;
-
-        if (event.get(p))
+        if (event.get(received_packet))
         {
-            fsm.packet_received(p);
+            fsm.packet_received(received_packet);
         }
     }
 
@@ -21,6 +21,8 @@ limitations under the License.
 #include "smooth/application/network/mqtt/Logging.h"
 #include "smooth/core/logging/log.h"
 #include "smooth/config_constants.h"
+#include <algorithm>
+#include <tuple>
 
 #ifdef ESP_PLATFORM
 #include "sdkconfig.h"
@@ -32,240 +34,291 @@ using namespace std::chrono;
 namespace smooth::application::network::mqtt
 {
     Publication::Publication()
+            : send_window(static_cast<size_t>(CONFIG_SMOOTH_MQTT_SEND_WINDOW))
     {
-        in_progress.reserve(CONFIG_SMOOTH_MAX_MQTT_OUTGOING_MESSAGES);
+        in_flight.reserve(send_window);
+        to_resend.reserve(send_window);
     }
 
     bool Publication::publish(const std::string& topic, const uint8_t* data, int length, mqtt::QoS qos,
                               bool retain)
     {
         std::lock_guard<std::mutex> lock(guard);
-        bool res = in_progress.size() < CONFIG_SMOOTH_MAX_MQTT_OUTGOING_MESSAGES;
+        bool res = pending.size() + in_flight.size() < max_outgoing();
 
         if (res)
         {
-            packet::Publish p(topic, data, length, qos, retain);
-            in_progress.emplace_back(p);
+            pending.emplace_back(topic, data, length, qos, retain);
         }
 
         return res;
     }
 
+    void Publication::set_send_window(size_t size)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        send_window = std::max(size, static_cast<size_t>(1));
+        in_flight.reserve(send_window);
+        to_resend.reserve(send_window);
+    }
+
+    size_t Publication::max_outgoing() const
+    {
+        return std::max(static_cast<size_t>(CONFIG_SMOOTH_MAX_MQTT_OUTGOING_MESSAGES), send_window);
+    }
+
     void Publication::handle_disconnect()
     {
         std::lock_guard<std::mutex> lock(guard);
 
         // When a disconnection happens, any outgoing messages currently being timed must be reset
         // so that they don't cause a timeout before a resend of the package happens.
-        if (!in_progress.empty())
+        for (auto& outgoing : in_flight)
         {
-            auto& flight = in_progress.front();
-            flight.zero_timer();
+            outgoing.second.flight.zero_timer();
         }
     }
 
-    void Publication::resend_outstanding_control_packet(IMqttClient& mqtt, bool clean_session)
+    void Publication::resend_outstanding_control_packet(IMqttClient& /*mqtt*/, bool clean_session)
     {
         std::lock_guard<std::mutex> lock(guard);
+        to_resend.clear();
 
         // When a Client reconnects with CleanSession set to 0, both the Client and Server MUST re-send
         // any unacknowledged PUBLISH Packets (where QoS > 0) and PUBREL Packets using their original
         // Packet Identifiers [MQTT-4.4.0-1]. This is the only circumstance where a Client or Server is
         // REQUIRED to redeliver messages.
 
-        if (!in_progress.empty())
+        for (auto it = in_flight.begin(); it != in_flight.end(); )
         {
-            auto& flight = in_progress.front();
+            auto& flight = it->second.flight;
+            auto waiting_for = flight.get_waiting_for();
+            bool drop = false;
 
-            if (clean_session)
+            if (waiting_for == PacketType::PUBACK
+                || waiting_for == PacketType::PUBREC)
             {
-                if (flight.get_waiting_for() == PacketType::PUBACK
-                    || flight.get_waiting_for() == PacketType::PUBREC
-                    || flight.get_waiting_for() == PacketType::PUBCOMP)
-                {
-                    // Drop message
-                    in_progress.erase(in_progress.begin());
-                }
+                // Set dup flag and let normal procedure send the packet.
+                drop = clean_session;
+                flight.get_packet().set_dup_flag();
+                flight.set_wait_packet(PacketType::Reserved);
+            }
+            else if (waiting_for == PacketType::PUBCOMP)
+            {
+                // Let normal procedure send the PubRel.
+                drop = clean_session;
+                flight.set_wait_packet(PacketType::PUBREL);
+            }
+
+            if (drop)
+            {
+                it = in_flight.erase(it);
             }
             else
             {
+                flight.zero_timer();
+                to_resend.push_back(it->first);
+                ++it;
+            }
+        }
+
+        // Resend in the original order, taking from the back.
+        std::sort(to_resend.begin(), to_resend.end(), [this](uint16_t a, uint16_t b) {
+                      return in_flight.at(a).sequence > in_flight.at(b).sequence;
+                  });
+    }
+
+    void Publication::publish_next(IMqttClient& mqtt)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        if (!has_timed_out(mqtt) && resend_in_flight(mqtt))
+        {
+            send_pending(mqtt);
+        }
+    }
+
+    bool Publication::has_timed_out(IMqttClient& mqtt)
+    {
+        bool timed_out = false;
+
+        for (auto& outgoing : in_flight)
+        {
+            auto& flight = outgoing.second.flight;
+
+            if (!timed_out
+                && flight.get_waiting_for() != PacketType::Reserved
+                && flight.get_waiting_for() != PacketType::PUBREL
+                && flight.get_elapsed_time() > seconds{ 5 })
+            {
+                // Waited too long, force a disconnect.
+                Log::error(mqtt_log_tag,
+                "Too long since a reply was received to a publish message, forcing disconnect.");
+
+                flight.stop_timer();
+                mqtt.force_disconnect();
+                timed_out = true;
+            }
+        }
+
+        return timed_out;
+    }
+
+    bool Publication::resend_in_flight(IMqttClient& mqtt)
+    {
+        bool can_send = true;
+
+        while (can_send && !to_resend.empty())
+        {
+            auto it = in_flight.find(to_resend.back());
+
+            if (it == in_flight.end())
+            {
+                // Completed in the meantime
+                to_resend.pop_back();
+            }
+            else
+            {
+                auto& flight = it->second.flight;
                 auto& packet = flight.get_packet();
 
-                if (flight.get_waiting_for() == PacketType::PUBACK)
-                {
-                    // Set dup flag and let normal procedure send the packet.
-                    packet.set_dup_flag();
-                    flight.zero_timer();
-                    flight.set_wait_packet(PacketType::Reserved);
-                }
-                else if (flight.get_waiting_for() == PacketType::PUBREC)
+                if (flight.get_waiting_for() == PacketType::Reserved)
                 {
-                    // Let normal procedure send the packet
-                    flight.zero_timer();
-                    flight.set_wait_packet(PacketType::Reserved);
+                    can_send = mqtt.send_packet(packet);
+
+                    if (can_send)
+                    {
+                        flight.start_timer();
+                        flight.set_wait_packet(packet.get_qos() == QoS::AT_LEAST_ONCE ? PUBACK : PUBREC);
+                        to_resend.pop_back();
+                    }
                 }
-                else if (flight.get_waiting_for() == PacketType::PUBCOMP)
+                else if (flight.get_waiting_for() == PacketType::PUBREL)
                 {
-                    packet::PubRel pub_rel(packet.get_packet_identifier());
+                    packet::PubRel pub_rel(it->first);
+                    can_send = mqtt.send_packet(pub_rel);
 
-                    // As this is running directly after a reconnect, and the TX buffer is cleared
-                    // on disconnect, it is guaranteed that this message will fit in the buffer.
-                    mqtt.send_packet(pub_rel);
+                    if (can_send)
+                    {
+                        flight.start_timer();
+                        flight.set_wait_packet(PUBCOMP);
+                        to_resend.pop_back();
+                    }
                 }
                 else
                 {
-                    // Haven't gotten far enough to wait for PUBACK or PUBCOMP, reset.
-                    packet.set_dup_flag();
-                    flight.start_timer();
-                    flight.set_wait_packet(PacketType::Reserved);
+                    to_resend.pop_back();
                 }
             }
         }
+
+        return can_send;
     }
 
-    void Publication::publish_next(IMqttClient& mqtt)
+    void Publication::send_pending(IMqttClient& mqtt)
     {
-        std::lock_guard<std::mutex> lock(guard);
+        bool can_send = true;
 
-        auto& flight = in_progress.front();
-        auto& packet = flight.get_packet();
-
-        if (!in_progress.empty())
+        while (can_send && !pending.empty())
         {
+            auto& packet = pending.front();
+
             if (packet.get_qos() == QoS::AT_MOST_ONCE)
             {
                 // Fire and forget
-                if (mqtt.send_packet(packet))
+                can_send = mqtt.send_packet(packet);
+
+                if (can_send)
                 {
                     Log::verbose(mqtt_log_tag, "QoS {} publish completed", packet.get_qos());
-                    in_progress.erase(in_progress.begin());
-                }
-                else
-                {
-                    Log::error(mqtt_log_tag, "Could not enqueue packet of QoS {}", packet.get_qos());
+                    pending.pop_front();
                 }
             }
-            else if (flight.get_waiting_for() == PacketType::Reserved)
+            else if (in_flight.size() < send_window)
             {
-                // Packet with QoS > AT_MOST_ONCE and not yet sent first in queue.
-                // We will only ever have a single active in-flight message
+                can_send = mqtt.send_packet(packet);
 
-                if (packet.get_qos() == QoS::AT_LEAST_ONCE)
+                if (can_send)
                 {
-                    // Send packet, wait for PubAck
-                    if (mqtt.send_packet(packet))
-                    {
-                        flight.start_timer();
-                        flight.set_wait_packet(PUBACK);
-                    }
-                    else
-                    {
-                        Log::error(mqtt_log_tag, "Could not enqueue packet of QoS {}", packet.get_qos());
-                    }
-                }
-                else if (packet.get_qos() == QoS::EXACTLY_ONCE)
-                {
-                    // Send packet, wait for PubRec
-                    if (mqtt.send_packet(packet))
-                    {
-                        flight.start_timer();
-                        flight.set_wait_packet(PUBREC);
-                    }
-                    else
-                    {
-                        Log::error(mqtt_log_tag, "Could not enqueue packet of QoS {}", packet.get_qos());
-                    }
+                    // Send packet, wait for PubAck or PubRec
+                    auto wait_for = packet.get_qos() == QoS::AT_LEAST_ONCE ? PUBACK : PUBREC;
+                    auto id = packet.get_packet_identifier();
+                    auto& flight = in_flight.emplace(std::piecewise_construct,
+                                                     std::forward_as_tuple(id),
+                                                     std::forward_as_tuple(std::move(packet), next_sequence++))
+                                            .first->second.flight;
+                    flight.start_timer();
+                    flight.set_wait_packet(wait_for);
+                    pending.pop_front();
                 }
-
-                // At this point, the message we're currently trying to send
-                // will be left first in the vector.
             }
             else
             {
-                // Still waiting for a reply...
-                if (flight.get_elapsed_time() > seconds{ 5 })
-                {
-                    // Waited too long, force a disconnect.
-                    Log::error(mqtt_log_tag,
-                    "Too long since a reply was received to a publish message, forcing disconnect.");
-
-                    flight.stop_timer();
-                    mqtt.force_disconnect();
-                }
-                else
-                {
-                    Log::debug(mqtt_log_tag,
-                               "Waiting to send: {}, QoS {}, waiting for: {}, timer: {}ms",
-                               packet.get_mqtt_type_as_string(),
-                               packet.get_qos(),
-                               flight.get_waiting_for(),
-                               flight.get_elapsed_time().count());
-                }
+                // Window is full, wait for acknowledgements.
+                can_send = false;
             }
         }
+
+        if (!can_send && !pending.empty())
+        {
+            Log::debug(mqtt_log_tag,
+                       "Waiting to send {} messages, {} in flight",
+                       pending.size(),
+                       in_flight.size());
+        }
     }
 
     void Publication::receive(packet::PubAck& pub_ack, IMqttClient&)
     {
         std::lock_guard<std::mutex> lock(guard);
-        auto first = in_progress.begin();
+        auto it = in_flight.find(pub_ack.get_packet_identifier());
 
-        if (first != in_progress.end())
+        if (it != in_flight.end())
         {
-            auto& flight = *first;
-
-            if (flight.get_packet().get_packet_identifier() == pub_ack.get_packet_identifier())
-            {
-                Log::verbose(mqtt_log_tag, "QoS {} publish completed", flight.get_packet().get_qos());
-                in_progress.erase(in_progress.begin());
-            }
+            Log::verbose(mqtt_log_tag, "QoS {} publish completed", it->second.flight.get_packet().get_qos());
+            in_flight.erase(it);
         }
     }
 
     void Publication::receive(packet::PubRec& pub_rec, IMqttClient& mqtt)
     {
         std::lock_guard<std::mutex> lock(guard);
-        auto first = in_progress.begin();
+        auto it = in_flight.find(pub_rec.get_packet_identifier());
 
-        if (first != in_progress.end())
+        if (it != in_flight.end())
         {
-            auto& flight = *first;
+            auto& flight = it->second.flight;
 
-            if (flight.get_waiting_for() == PUBREC
-                && flight.get_packet().get_packet_identifier() == pub_rec.get_packet_identifier())
+            if (flight.get_waiting_for() == PUBREC)
             {
                 flight.start_timer();
 
-                packet::PubRel pub_rel(flight.get_packet().get_packet_identifier());
+                packet::PubRel pub_rel(it->first);
 
                 if (mqtt.send_packet(pub_rel))
                 {
                     // Wait for PubComp and send PubRel
-                    first->set_wait_packet(PUBCOMP);
+                    flight.set_wait_packet(PUBCOMP);
                 }
                 else
                 {
-                    // Couldn't send, this will result in a timeout and reconnect with subsequent resend.
+                    // Couldn't send, try again on next publish_next().
+                    flight.set_wait_packet(PUBREL);
+                    to_resend.push_back(it->first);
                 }
             }
         }
     }
 
-    void Publication::receive(packet::PubComp& pub_rec, IMqttClient&)
+    void Publication::receive(packet::PubComp& pub_comp, IMqttClient&)
     {
         std::lock_guard<std::mutex> lock(guard);
-        auto first = in_progress.begin();
+        auto it = in_flight.find(pub_comp.get_packet_identifier());
 
-        if (first != in_progress.end())
+        if (it != in_flight.end() && it->second.flight.get_waiting_for() == PUBCOMP)
         {
-            auto& flight = *first;
-
-            if (flight.get_waiting_for() == PUBCOMP
-                && flight.get_packet().get_packet_identifier() == pub_rec.get_packet_identifier())
-            {
-                Log::verbose(mqtt_log_tag, "QoS {} publish completed", flight.get_packet().get_qos());
-                in_progress.erase(in_progress.begin());
-            }
+            Log::verbose(mqtt_log_tag, "QoS {} publish completed", it->second.flight.get_packet().get_qos());
+            in_flight.erase(it);
         }
     }
 }
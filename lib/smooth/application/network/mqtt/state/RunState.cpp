@@ -39,9 +39,22 @@ namespace smooth::application::network::mqtt::state
         }
     }
 
+    void RunState::event(const core::network::event::TransmitBufferEmptyEvent&)
+    {
+        // Room for more messages
+        if (reconnect_handled)
+        {
+            fsm.get_mqtt().get_publication().publish_next(fsm.get_mqtt());
+        }
+    }
+
     void RunState::receive(packet::PubAck& pub_ack)
     {
-        fsm.get_mqtt().get_publication().receive(pub_ack, fsm.get_mqtt());
+        auto& publication = fsm.get_mqtt().get_publication();
+        publication.receive(pub_ack, fsm.get_mqtt());
+
+        // Fill the window again without waiting for the next tick.
+        publication.publish_next(fsm.get_mqtt());
     }
 
     void RunState::receive(packet::PubRec& pub_rec)
@@ -56,7 +69,9 @@ namespace smooth::application::network::mqtt::state
 
     void RunState::receive(packet::PubComp& pub_comp)
     {
-        fsm.get_mqtt().get_publication().receive(pub_comp, fsm.get_mqtt());
+        auto& publication = fsm.get_mqtt().get_publication();
+        publication.receive(pub_comp, fsm.get_mqtt());
+        publication.publish_next(fsm.get_mqtt());
     }
 
     void RunState::receive(packet::Publish& publish)
@@ -35,8 +35,10 @@ static constexpr const char* tag = "MemStat";
 
 namespace smooth::core
 {
-    TaskStats::TaskStats(uint32_t stack_size)
-            : stack_size(stack_size)
+    TaskStats::TaskStats(uint32_t stack_size, uint64_t event_count, uint64_t wakeup_count)
+            : stack_size(stack_size),
+              event_count(event_count),
+              wakeup_count(wakeup_count)
     {
 #ifdef ESP_PLATFORM
         high_water_mark = uxTaskGetStackHighWaterMark(nullptr);
@@ -67,18 +69,45 @@ namespace smooth::core
 
         { // Only need to lock while accessing the shared data
             synch guard{ lock };
-            constexpr const char* stack_format = "{:>16} | {:>10} | {:>15} | {:>15}";
+            constexpr const char* stack_format = "{:>16} | {:>10} | {:>15} | {:>15} | {:>10} | {:>13}";
             Log::info(tag, "");
-            Log::info(tag, stack_format, "Name", "Stack", "Min free stack", "Max used stack" );
+            Log::info(tag, stack_format, "Name", "Stack", "Min free stack", "Max used stack", "Events",
+                      "Events/wakeup");
 
             for (const auto& stat : task_info)
             {
+                const auto& s = stat.second;
+                auto per_wakeup = s.get_wakeup_count() > 0
+                                  ? static_cast<double>(s.get_event_count()) / static_cast<double>(s.get_wakeup_count())
+                                  : 0.0;
+
                 Log::info(tag,
                           stack_format,
                           stat.first,
-                          stat.second.get_stack_size(),
-                          stat.second.get_high_water_mark(),
-                          stat.second.get_stack_size() - stat.second.get_high_water_mark());
+                          s.get_stack_size(),
+                          s.get_high_water_mark(),
+                          s.get_stack_size() - s.get_high_water_mark(),
+                          s.get_event_count(),
+                          fmt::format("{:.2f}", per_wakeup));
+            }
+
+            if (!connection_info.empty())
+            {
+                constexpr const char* connection_format = "{:>16} | {:>11} | {:>16} | {:>11}";
+                Log::info(tag, "");
+                Log::info(tag, connection_format, "Connections", "Open", "Bytes/connection", "Total bytes");
+
+                for (const auto& stat : connection_info)
+                {
+                    const auto& s = stat.second;
+
+                    Log::info(tag,
+                              connection_format,
+                              stat.first,
+                              s.get_count(),
+                              s.get_bytes_per_connection(),
+                              s.get_count() * s.get_bytes_per_connection());
+                }
             }
         }
     }
@@ -161,18 +161,9 @@ namespace smooth::core
                 }
 
                 // Wait for data to become available, or a timeout to occur.
-                auto queue_ptr = notification.wait_for_notification(tick_interval);
-
-                // Check if the weak_ptr we got back is uninitialized using the defined behaviour here:
-                // https://en.cppreference.com/w/cpp/memory/weak_ptr/owner_before
-                //
-                // Quote: The order is such that two smart pointers compare equivalent only
-                // if they are both empty or if they both own the same object, even if the
-                // values of the pointers obtained by get() are different (e.g. because they
-                // point at different subobjects within the same object)
-                decltype(queue_ptr) empty_ptr{};
-
-                if (!queue_ptr.owner_before(empty_ptr) && !empty_ptr.owner_before(queue_ptr))
+                notification.wait_for_notifications(tick_interval, event_batch, event_batch_size);
+
+                if (event_batch.empty())
                 {
                     // Timeout - no messages.
                     tick();
@@ -180,16 +171,24 @@ namespace smooth::core
                 }
                 else
                 {
-                    // A queue has signaled an item is available.
-                    // Note: Do not retrieve all messages from the the queue;
+                    ++wakeup_count;
+
+                    // The queues have signaled that items are available.
+                    // Note: Do not retrieve all messages from each queue;
                     // it will prevent messages to arrive in the same order
                     // they were sent when there are more than one receiver queue.
-                    auto queue = queue_ptr.lock();
-
-                    if (queue)
+                    for (auto& queue_ptr : event_batch)
                     {
-                        queue->forward_to_event_listener();
+                        auto queue = queue_ptr.lock();
+
+                        if (queue)
+                        {
+                            queue->forward_to_event_listener();
+                            ++event_count;
+                        }
                     }
+
+                    event_batch.clear();
                 }
             }
 
@@ -224,8 +223,14 @@ namespace smooth::core
         }
     }
 
+    void Task::set_event_batch_size(size_t size)
+    {
+        event_batch_size = std::max(size, static_cast<size_t>(1));
+        event_batch.reserve(event_batch_size);
+    }
+
     void Task::report_stack_status()
     {
-        SystemStatistics::instance().report(name, TaskStats{ stack_size });
+        SystemStatistics::instance().report(name, TaskStats{ stack_size, event_count, wakeup_count });
     }
 }
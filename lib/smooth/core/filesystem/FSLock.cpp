@@ -54,6 +54,7 @@ namespace smooth::core::filesystem
         cv.wait(guard, [] { return count < max; });
 
         count++;
+        acquired = true;
 
         if (count > max_ever_opened)
         {
@@ -64,11 +65,36 @@ namespace smooth::core::filesystem
         cv.notify_one();
     }
 
+    FSLock::FSLock(std::try_to_lock_t)
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+
+        if (max <= 0)
+        {
+            throw std::invalid_argument("Must call FSLock::set_limit() before using FSLock");
+        }
+
+        if (count < max)
+        {
+            count++;
+            acquired = true;
+
+            if (count > max_ever_opened)
+            {
+                max_ever_opened = count;
+            }
+        }
+    }
+
     FSLock::~FSLock()
     {
         std::unique_lock<std::mutex> guard{ lock };
-        count--;
-        cv.notify_one();
+
+        if (acquired)
+        {
+            count--;
+            cv.notify_one();
+        }
     }
 
     int FSLock::max_concurrently_opened()
@@ -0,0 +1,179 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/filesystem/FileReader.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifndef ESP_PLATFORM
+#include <sys/mman.h>
+#endif
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::filesystem
+{
+    static constexpr const char* tag = "FileReader";
+
+    std::shared_ptr<FileReader> FileReader::open(const Path& path)
+    {
+        // Private constructor, so make_shared can't be used.
+        auto reader = std::shared_ptr<FileReader>(new FileReader());
+
+        if (!reader->open_file(path))
+        {
+            reader.reset();
+        }
+
+        return reader;
+    }
+
+#ifdef ESP_PLATFORM
+
+    bool FileReader::open_file(const Path& path)
+    {
+        // Don't wait for a file to become available; the caller is expected to fall back to
+        // reading the file in one go instead.
+        lock = std::make_unique<FSLock>(std::try_to_lock);
+
+        if (lock->owns_lock())
+        {
+            fd = ::open(path, O_RDONLY);
+
+            struct stat s {};
+
+            if (fd >= 0 && fstat(fd, &s) == 0)
+            {
+                file_size = static_cast<std::size_t>(s.st_size);
+            }
+            else
+            {
+                Log::error(tag, "Could not open {}", path);
+            }
+        }
+
+        return fd >= 0;
+    }
+
+    FileReader::~FileReader()
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    bool FileReader::read(std::size_t offset, std::size_t length, std::shared_ptr<const uint8_t>& data)
+    {
+        bool res = offset + length <= file_size;
+
+        if (res)
+        {
+            // Only reuse the buffer when the previous chunk has been released, i.e. sent.
+            if (!buffer || buffer.use_count() > 1 || buffer->size() < length)
+            {
+                buffer = std::make_shared<std::vector<uint8_t>>(length);
+            }
+
+            if (offset != position)
+            {
+                res = lseek(fd, static_cast<off_t>(offset), SEEK_SET) == static_cast<off_t>(offset);
+                position = offset;
+            }
+
+            std::size_t received = 0;
+
+            while (res && received < length)
+            {
+                auto count = ::read(fd, buffer->data() + received, length - received);
+                res = count > 0;
+                received += res ? static_cast<std::size_t>(count) : 0;
+            }
+
+            position += received;
+            data = std::shared_ptr<const uint8_t>(buffer, buffer->data());
+        }
+
+        return res;
+    }
+
+#else
+
+    bool FileReader::open_file(const Path& path)
+    {
+        // The lock is only needed while the file descriptor is open; the mapping stays valid after closing it.
+        FSLock fs_lock;
+
+        auto fd = ::open(path, O_RDONLY);
+        struct stat s {};
+        bool res = fd >= 0 && fstat(fd, &s) == 0;
+
+        if (res)
+        {
+            file_size = static_cast<std::size_t>(s.st_size);
+
+            // An empty file can't be mapped, but there's nothing to read from it either.
+            if (file_size > 0)
+            {
+                auto* m = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                res = m != MAP_FAILED;
+
+                if (res)
+                {
+                    mapping = static_cast<uint8_t*>(m);
+                    madvise(mapping, file_size, MADV_SEQUENTIAL);
+                }
+            }
+        }
+
+        if (!res)
+        {
+            Log::error(tag, "Could not open {}", path);
+        }
+
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        return res;
+    }
+
+    FileReader::~FileReader()
+    {
+        if (mapping != nullptr)
+        {
+            munmap(mapping, file_size);
+        }
+    }
+
+    bool FileReader::read(std::size_t offset, std::size_t length, std::shared_ptr<const uint8_t>& data)
+    {
+        bool res = offset + length <= file_size;
+
+        if (res)
+        {
+            // The pointer shares ownership of the reader so the mapping outlives any packet referencing it.
+            data = std::shared_ptr<const uint8_t>(shared_from_this(), mapping + offset);
+        }
+
+        return res;
+    }
+
+#endif
+}
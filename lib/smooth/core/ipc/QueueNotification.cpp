@@ -42,37 +42,28 @@ namespace smooth::core::ipc
         queues.erase(new_end, queues.end());
     }
 
-    std::weak_ptr<ITaskEventQueue> QueueNotification::wait_for_notification(std::chrono::milliseconds timeout)
+    void QueueNotification::wait_for_notifications(std::chrono::milliseconds timeout,
+                                                   std::vector<std::weak_ptr<ITaskEventQueue>>& notifications,
+                                                   size_t max_count)
     {
         std::unique_lock<std::mutex> lock{ guard };
-        std::weak_ptr<ITaskEventQueue> res{};
 
         if (queues.empty())
         {
             // Wait until data is available, or timeout. This will atomically release the lock.
-            auto wait_result = cond.wait_until(lock,
-                                               std::chrono::steady_clock::now() + timeout,
-                                               [this]() {
-                                                   // Stop waiting when there is data
-                                                   return !queues.empty();
-                                               });
-
-            // At this point we will have the lock again.
-            if (wait_result)
-            {
-                if (!queues.empty())
-                {
-                    res = queues.front();
-                    queues.pop_front();
-                }
-            }
+            cond.wait_until(lock,
+                            std::chrono::steady_clock::now() + timeout,
+                            [this]() {
+                                // Stop waiting when there is data
+                                return !queues.empty();
+                            });
         }
-        else
+
+        // Take them in order so that events are forwarded in the same order they were sent.
+        for (size_t i = 0; i < max_count && !queues.empty(); ++i)
         {
-            res = queues.front();
+            notifications.emplace_back(std::move(queues.front()));
             queues.pop_front();
         }
-
-        return res;
     }
 }
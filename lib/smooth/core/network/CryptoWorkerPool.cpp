@@ -0,0 +1,98 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/CryptoWorkerPool.h"
+#include "smooth/core/task_priorities.h"
+#include "smooth/config_constants.h"
+
+namespace smooth::core::network
+{
+#if defined(ESP_PLATFORM) && !defined(CONFIG_FREERTOS_UNICORE)
+    static constexpr int crypto_worker_core = CONFIG_SMOOTH_CRYPTO_WORKER_CORE;
+#else
+    static constexpr int crypto_worker_core = tskNO_AFFINITY;
+#endif
+
+    CryptoWorkerPool& CryptoWorkerPool::instance()
+    {
+        static CryptoWorkerPool instance;
+
+        // Start workers on first use
+        static bool initialized = false;
+
+        if (!initialized)
+        {
+            initialized = true;
+            instance.start();
+        }
+
+        return instance;
+    }
+
+    CryptoWorkerPool::CryptoWorkerPool()
+    {
+        for (int i = 0; i < CONFIG_SMOOTH_CRYPTO_WORKER_COUNT; ++i)
+        {
+            workers.emplace_back(std::make_unique<Worker>("CryptoWorker" + std::to_string(i)));
+        }
+    }
+
+    void CryptoWorkerPool::start()
+    {
+        for (auto& w : workers)
+        {
+            w->start();
+        }
+    }
+
+    bool CryptoWorkerPool::submit(std::function<void()> work)
+    {
+        bool accepted = false;
+        const auto count = workers.size();
+
+        if (count > 0)
+        {
+            CryptoJob job{ std::move(work) };
+            const auto first = next_worker++;
+
+            // Spread the work round-robin, skipping workers whose queue is full.
+            for (size_t i = 0; !accepted && i < count; ++i)
+            {
+                accepted = workers[(first + i) % count]->submit(job);
+            }
+        }
+
+        return accepted;
+    }
+
+    CryptoWorkerPool::Worker::Worker(const std::string& name)
+            : Task(name, CONFIG_SMOOTH_CRYPTO_WORKER_STACK_SIZE, CRYPTO_WORKER_PRIO,
+                   std::chrono::seconds(1), crypto_worker_core),
+              jobs(JobQueue::create(CONFIG_LWIP_MAX_SOCKETS, *this, *this))
+    {
+    }
+
+    bool CryptoWorkerPool::Worker::submit(const CryptoJob& job)
+    {
+        return jobs->push(job);
+    }
+
+    void CryptoWorkerPool::Worker::event(const CryptoJob& job)
+    {
+        job.run();
+    }
+}
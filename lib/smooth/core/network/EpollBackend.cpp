@@ -0,0 +1,175 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/EpollBackend.h"
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::network
+{
+    static constexpr const char* tag = "EpollBackend";
+
+    EpollBackend::EpollBackend()
+            : epoll_fd(epoll_create1(EPOLL_CLOEXEC)),
+              wake_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        if (epoll_fd < 0 || wake_fd < 0)
+        {
+            Log::error(tag, "Could not create epoll instance: {}", strerror(errno));
+        }
+        else
+        {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = wake_fd;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+        }
+    }
+
+    EpollBackend::~EpollBackend()
+    {
+        if (wake_fd >= 0)
+        {
+            close(wake_fd);
+        }
+
+        if (epoll_fd >= 0)
+        {
+            close(epoll_fd);
+        }
+    }
+
+    bool EpollBackend::add(int socket_id, uint8_t interest)
+    {
+        bool res = control(EPOLL_CTL_ADD, socket_id, interest);
+
+        if (res)
+        {
+            ++registered;
+        }
+
+        return res;
+    }
+
+    bool EpollBackend::modify(int socket_id, uint8_t interest)
+    {
+        return control(EPOLL_CTL_MOD, socket_id, interest);
+    }
+
+    void EpollBackend::remove(int socket_id)
+    {
+        // Pre 2.6.9 kernels require a non-null event, even though it is ignored.
+        epoll_event ev{};
+
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_DEL, socket_id, &ev) == 0)
+        {
+            --registered;
+        }
+    }
+
+    bool EpollBackend::wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready)
+    {
+        ready.clear();
+
+        int count = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()),
+                               static_cast<int>(timeout.count()));
+
+        if (count < 0 && errno != EINTR)
+        {
+            Log::error(tag, "Error during epoll_wait: {}", strerror(errno));
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& ev = events[static_cast<size_t>(i)];
+
+            if (ev.data.fd == wake_fd)
+            {
+                // Drain before clearing the flag; a wake() arriving in between is covered by this
+                // wait returning, since the work it signals has already been queued.
+                uint64_t value;
+
+                while (read(wake_fd, &value, sizeof(value)) > 0)
+                {
+                }
+
+                wake_pending = false;
+            }
+            else
+            {
+                // Errors and hang-ups are reported as readiness so that the socket gets to
+                // see the error via recv()/send(), just like it would with select().
+                bool error = (ev.events & (EPOLLERR | EPOLLHUP)) != 0;
+                bool readable = error || (ev.events & EPOLLIN) != 0;
+                bool writable = error || (ev.events & EPOLLOUT) != 0;
+
+                ready.push_back(SocketReadiness{ ev.data.fd, readable, writable });
+            }
+        }
+
+        return count >= 0 || errno == EINTR;
+    }
+
+    void EpollBackend::wake()
+    {
+        // Only the first wake() since the last wait needs to touch the eventfd.
+        if (!wake_pending.exchange(true))
+        {
+            uint64_t value = 1;
+
+            if (write(wake_fd, &value, sizeof(value)) < 0)
+            {
+                wake_pending = false;
+            }
+        }
+    }
+
+    bool EpollBackend::control(int op, int socket_id, uint8_t interest)
+    {
+        epoll_event ev{};
+        ev.data.fd = socket_id;
+
+        if ((interest & INTEREST_READ) == INTEREST_READ)
+        {
+            ev.events |= EPOLLIN;
+        }
+
+        if ((interest & INTEREST_WRITE) == INTEREST_WRITE)
+        {
+            ev.events |= EPOLLOUT;
+        }
+
+        bool res = epoll_ctl(epoll_fd, op, socket_id, &ev) == 0;
+
+        if (!res)
+        {
+            Log::error(tag, "epoll_ctl failed for socket {}: {}", socket_id, strerror(errno));
+        }
+
+        return res;
+    }
+}
+
+#endif
@@ -17,8 +17,17 @@ limitations under the License.
 
 #include "smooth/core/network/MbedTLSContext.h"
 #include <mbedtls/error.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#if __has_include(<mbedtls/ssl_internal.h>)
+// mbedtls 2 only declares the sizes of the record buffers in this internal header.
+#include <mbedtls/ssl_internal.h>
+#endif
+#include <atomic>
 #include <memory>
 #include "smooth/core/logging/log.h"
+#include "smooth/core/SystemStatistics.h"
+#include "smooth/config_constants.h"
 #include <cstring>
 
 #if defined(ESP_PLATFORM) && defined(CONFIG_MBEDTLS_DEBUG)
@@ -50,15 +59,122 @@ namespace smooth::core::network
         Log::error(log_tag, "{} returned {}: {}", prefix, err_code, buf);
     }
 
+    /// The entropy source and random generator used by all contexts. Seeding is slow and each pair takes
+    /// a fair amount of memory, so there is only one. Handshakes run on several crypto workers, so access
+    /// is serialized.
+    class SharedRandom
+    {
+        public:
+            static SharedRandom& instance()
+            {
+                static SharedRandom instance;
+
+                return instance;
+            }
+
+            SharedRandom(const SharedRandom&) = delete;
+
+            SharedRandom& operator=(const SharedRandom&) = delete;
+
+            ~SharedRandom()
+            {
+                mbedtls_ctr_drbg_free(&ctr_drbg);
+                mbedtls_entropy_free(&entropy);
+            }
+
+            [[nodiscard]] int get_seed_result() const
+            {
+                return seed_result;
+            }
+
+            static int random(void* ctx, unsigned char* output, size_t length)
+            {
+                auto rng = static_cast<SharedRandom*>(ctx);
+                std::lock_guard<std::mutex> lock(rng->guard);
+
+                return mbedtls_ctr_drbg_random(&rng->ctr_drbg, output, length);
+            }
+
+        private:
+            SharedRandom()
+            {
+                mbedtls_entropy_init(&entropy);
+                mbedtls_ctr_drbg_init(&ctr_drbg);
+                seed_result = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, nullptr, 0);
+
+                if (seed_result != 0)
+                {
+                    log_mbedtls_error(tag, "mbedtls_ctr_drbg_seed", seed_result);
+                }
+            }
+
+            mbedtls_entropy_context entropy{};
+            mbedtls_ctr_drbg_context ctr_drbg{};
+            std::mutex guard{};
+            int seed_result{ 0 };
+    };
+
+    // The context itself and the record buffers allocated by mbedtls_ssl_setup().
+#if defined(MBEDTLS_SSL_IN_BUFFER_LEN) && defined(MBEDTLS_SSL_OUT_BUFFER_LEN)
+    static constexpr uint32_t bytes_per_connection = sizeof(SSLContext)
+                                                     + MBEDTLS_SSL_IN_BUFFER_LEN
+                                                     + MBEDTLS_SSL_OUT_BUFFER_LEN;
+#else
+    // Without the buffer sizes, the record header and room for IV, MAC and padding are not counted.
+    static constexpr uint32_t bytes_per_connection = sizeof(SSLContext)
+                                                     + MBEDTLS_SSL_IN_CONTENT_LEN
+                                                     + MBEDTLS_SSL_OUT_CONTENT_LEN;
+#endif
+
+    static std::atomic<uint32_t> open_connections{ 0 };
+
+    void SSLContext::update_statistics(int change)
+    {
+        auto count = change > 0 ? ++open_connections : --open_connections;
+        SystemStatistics::instance().report("TLS", ConnectionStats{ count, bytes_per_connection });
+    }
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+
+    static unsigned char max_fragment_length_code()
+    {
+        auto code = MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+
+        if (CONFIG_SMOOTH_TLS_MAX_FRAGMENT_LENGTH == 512)
+        {
+            code = MBEDTLS_SSL_MAX_FRAG_LEN_512;
+        }
+        else if (CONFIG_SMOOTH_TLS_MAX_FRAGMENT_LENGTH == 1024)
+        {
+            code = MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+        }
+        else if (CONFIG_SMOOTH_TLS_MAX_FRAGMENT_LENGTH == 2048)
+        {
+            code = MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+        }
+        else if (CONFIG_SMOOTH_TLS_MAX_FRAGMENT_LENGTH == 4096)
+        {
+            code = MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+        }
+
+        return static_cast<unsigned char>(code);
+    }
+
+#endif
+
     MBedTLSContext::MBedTLSContext()
+            : session_cache(static_cast<size_t>(CONFIG_SMOOTH_TLS_SESSION_CACHE_SIZE),
+                            std::chrono::seconds(CONFIG_SMOOTH_TLS_SESSION_LIFETIME))
     {
         mbedtls_pk_init(&pk_key);
         mbedtls_ssl_config_init(&conf);
         mbedtls_x509_crt_init(&ca_cert);
         mbedtls_x509_crt_init(&ca_chain);
         mbedtls_x509_crt_init(&server_cert);
-        mbedtls_entropy_init(&entropy);
-        mbedtls_ctr_drbg_init(&ctr_drbg);
+        mbedtls_ssl_session_init(&client_session);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+        mbedtls_ssl_ticket_init(&ticket_ctx);
+#endif
 
 #if defined(ESP_PLATFORM)
     #if defined(CONFIG_MBEDTLS_DEBUG)
@@ -72,13 +188,12 @@ namespace smooth::core::network
 
     int MBedTLSContext::common_init(bool server)
     {
-        auto res = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, nullptr, 0);
+        is_server = server;
 
-        if (res != 0)
-        {
-            log_mbedtls_error(tag, "mbedtls_ctr_drbg_seed returned", res);
-        }
-        else
+        auto& rng = SharedRandom::instance();
+        auto res = rng.get_seed_result();
+
+        if (res == 0)
         {
             res = mbedtls_ssl_config_defaults(&conf,
                                               server ? MBEDTLS_SSL_IS_SERVER : MBEDTLS_SSL_IS_CLIENT,
@@ -91,7 +206,15 @@ namespace smooth::core::network
             }
             else
             {
-                mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &ctr_drbg);
+                mbedtls_ssl_conf_rng(&conf, SharedRandom::random, &rng);
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+                res = mbedtls_ssl_conf_max_frag_len(&conf, max_fragment_length_code());
+
+                if (res != 0)
+                {
+                    log_mbedtls_error(tag, "mbedtls_ssl_conf_max_frag_len", res);
+                }
+#endif
             }
         }
 
@@ -161,17 +284,53 @@ namespace smooth::core::network
                     {
                         log_mbedtls_error(tag, "mbedtls_ssl_conf_own_cert", res);
                     }
+                    else
+                    {
+                        init_session_resumption();
+                    }
                 }
             }
         }
 
-        return res;
+        return res == 0;
+    }
+
+    void MBedTLSContext::init_session_resumption()
+    {
+        // Session resumption is an optimization; failing to set it up only means that
+        // every connection does a full handshake.
+        if (CONFIG_SMOOTH_TLS_SESSION_CACHE_SIZE > 0)
+        {
+            session_cache.attach(conf);
+        }
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+        auto res = mbedtls_ssl_ticket_setup(&ticket_ctx,
+                                            SharedRandom::random,
+                                            &SharedRandom::instance(),
+                                            MBEDTLS_CIPHER_AES_256_GCM,
+                                            static_cast<uint32_t>(CONFIG_SMOOTH_TLS_SESSION_LIFETIME));
+
+        if (res != 0)
+        {
+            log_mbedtls_error(tag, "mbedtls_ssl_ticket_setup", res);
+        }
+        else
+        {
+            mbedtls_ssl_conf_session_tickets_cb(&conf,
+                                                mbedtls_ssl_ticket_write,
+                                                mbedtls_ssl_ticket_parse,
+                                                &ticket_ctx);
+        }
+#endif
     }
 
     MBedTLSContext::~MBedTLSContext()
     {
-        mbedtls_ctr_drbg_free(&ctr_drbg);
-        mbedtls_entropy_free(&entropy);
+        mbedtls_ssl_session_free(&client_session);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+        mbedtls_ssl_ticket_free(&ticket_ctx);
+#endif
         mbedtls_x509_crt_free(&ca_chain);
         mbedtls_x509_crt_free(&ca_cert);
         mbedtls_x509_crt_free(&server_cert);
@@ -197,14 +356,73 @@ namespace smooth::core::network
 
     std::unique_ptr<SSLContext> MBedTLSContext::create_context()
     {
-        auto context = std::make_unique<SSLContext>();
+        auto context = std::make_unique<SSLContext>(*this);
         auto res = mbedtls_ssl_setup(*context, &conf);
 
         if (res != 0)
         {
             log_mbedtls_error(tag, "mbedtls_ssl_setup", res);
         }
+        else if (!is_server)
+        {
+            resume_session(*context);
+        }
 
         return context;
     }
+
+    void MBedTLSContext::set_session_reuse(bool enable)
+    {
+        std::lock_guard<std::mutex> lock(session_guard);
+        session_reuse = enable;
+
+        if (!session_reuse)
+        {
+            mbedtls_ssl_session_free(&client_session);
+            mbedtls_ssl_session_init(&client_session);
+            has_client_session = false;
+        }
+    }
+
+    void MBedTLSContext::save_session(SSLContext& context)
+    {
+        std::lock_guard<std::mutex> lock(session_guard);
+
+        if (!is_server && session_reuse)
+        {
+            mbedtls_ssl_session_free(&client_session);
+            mbedtls_ssl_session_init(&client_session);
+
+            auto res = mbedtls_ssl_get_session(context, &client_session);
+            has_client_session = res == 0;
+
+            if (res != 0)
+            {
+                log_mbedtls_error(tag, "mbedtls_ssl_get_session", res);
+            }
+        }
+    }
+
+    void MBedTLSContext::resume_session(SSLContext& context)
+    {
+        std::lock_guard<std::mutex> lock(session_guard);
+
+        if (session_reuse && has_client_session)
+        {
+            auto res = mbedtls_ssl_set_session(context, &client_session);
+
+            if (res != 0)
+            {
+                log_mbedtls_error(tag, "mbedtls_ssl_set_session", res);
+            }
+        }
+    }
+
+    void SSLContext::handshake_completed()
+    {
+        if (owner != nullptr)
+        {
+            owner->save_session(*this);
+        }
+    }
 }
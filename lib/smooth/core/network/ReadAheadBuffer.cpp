@@ -0,0 +1,53 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/ReadAheadBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <sys/socket.h>
+
+namespace smooth::core::network
+{
+    int ReadAheadBuffer::receive(int socket_id, uint8_t* target, std::size_t length)
+    {
+        int res = 0;
+
+        if (is_empty() && length >= size)
+        {
+            res = static_cast<int>(recv(socket_id, target, length, 0));
+        }
+        else
+        {
+            if (is_empty())
+            {
+                buffer.resize(size);
+                res = static_cast<int>(recv(socket_id, buffer.data(), buffer.size(), 0));
+                pos = 0;
+                end = res > 0 ? static_cast<std::size_t>(res) : 0;
+            }
+
+            if (!is_empty())
+            {
+                res = static_cast<int>(std::min(length, end - pos));
+                std::memcpy(target, buffer.data() + pos, static_cast<std::size_t>(res));
+                pos += static_cast<std::size_t>(res);
+            }
+        }
+
+        return res;
+    }
+}
@@ -0,0 +1,248 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include "smooth/core/network/SelectBackend.h"
+#include "smooth/core/logging/log.h"
+
+#ifdef ESP_PLATFORM
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::network
+{
+    static constexpr const char* tag = "SelectBackend";
+
+    SelectBackend::SelectBackend()
+    {
+        if (!create_wake_channel())
+        {
+            Log::error(tag, "Could not create wake channel: {}", strerror(errno));
+        }
+    }
+
+    SelectBackend::~SelectBackend()
+    {
+        if (wake_read_fd >= 0)
+        {
+            close(wake_read_fd);
+        }
+
+        if (wake_write_fd >= 0 && wake_write_fd != wake_read_fd)
+        {
+            close(wake_write_fd);
+        }
+    }
+
+#ifdef ESP_PLATFORM
+
+    bool SelectBackend::create_wake_channel()
+    {
+        // A UDP socket bound to, and connected to, itself on the loopback interface.
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        bool res = fd >= 0;
+
+        if (res)
+        {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = 0;
+            socklen_t len = sizeof(addr);
+            auto* sa = reinterpret_cast<sockaddr*>(&addr);
+
+            res = bind(fd, sa, len) == 0
+                  && getsockname(fd, sa, &len) == 0
+                  && connect(fd, sa, len) == 0
+                  && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) == 0;
+
+            wake_read_fd = fd;
+            wake_write_fd = fd;
+        }
+
+        return res;
+    }
+
+#else
+
+    bool SelectBackend::create_wake_channel()
+    {
+        int fds[2];
+        bool res = pipe(fds) == 0;
+
+        if (res)
+        {
+            wake_read_fd = fds[0];
+            wake_write_fd = fds[1];
+            res = fcntl(wake_read_fd, F_SETFL, O_NONBLOCK) == 0
+                  && fcntl(wake_write_fd, F_SETFL, O_NONBLOCK) == 0;
+        }
+
+        return res;
+    }
+
+#endif
+
+    void SelectBackend::wake()
+    {
+        // Only the first wake() since the last wait needs to touch the channel.
+        if (!wake_pending.exchange(true))
+        {
+            uint8_t b = 1;
+
+            if (write(wake_write_fd, &b, 1) < 0)
+            {
+                wake_pending = false;
+            }
+        }
+    }
+
+    void SelectBackend::drain_wake_channel()
+    {
+        uint8_t buff[16];
+
+        while (read(wake_read_fd, buff, sizeof(buff)) > 0)
+        {
+        }
+
+        // Cleared after draining; see EpollBackend::wait().
+        wake_pending = false;
+    }
+
+    bool SelectBackend::add(int socket_id, uint8_t interest)
+    {
+        interests[socket_id] = interest;
+
+        return true;
+    }
+
+    bool SelectBackend::modify(int socket_id, uint8_t interest)
+    {
+        auto it = interests.find(socket_id);
+        bool res = it != interests.end();
+
+        if (res)
+        {
+            it->second = interest;
+        }
+
+        return res;
+    }
+
+    void SelectBackend::remove(int socket_id)
+    {
+        interests.erase(socket_id);
+    }
+
+    bool SelectBackend::wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready)
+    {
+        ready.clear();
+
+        int max_file_descriptor = build_sets();
+
+        tv.tv_sec = static_cast<decltype(tv.tv_sec)>(timeout.count() / 1000);
+        tv.tv_usec = static_cast<decltype(tv.tv_usec)>((timeout.count() % 1000) * 1000);
+
+        int res = select(max_file_descriptor + 1, &read_set, &write_set, nullptr, &tv);
+
+        if (res == -1)
+        {
+            Log::error(tag, "Error during select: {}", strerror(errno));
+        }
+        else if (res > 0)
+        {
+            if (wake_read_fd >= 0 && is_fd_set(static_cast<FD>(wake_read_fd), read_set))
+            {
+                drain_wake_channel();
+            }
+
+            for (const auto& pair : interests)
+            {
+                auto fd = static_cast<FD>(pair.first);
+                bool readable = is_fd_set(fd, read_set);
+                bool writable = is_fd_set(fd, write_set);
+
+                if (readable || writable)
+                {
+                    ready.push_back(SocketReadiness{ pair.first, readable, writable });
+                }
+            }
+        }
+
+        return res != -1;
+    }
+
+    void SelectBackend::clear_sets()
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+        FD_ZERO(&read_set);
+        FD_ZERO(&write_set);
+#pragma GCC diagnostic pop
+    }
+
+    int SelectBackend::build_sets()
+    {
+        clear_sets();
+
+        int max = wake_read_fd;
+
+        if (wake_read_fd >= 0)
+        {
+            set_fd(static_cast<FD>(wake_read_fd), read_set);
+        }
+
+        for (const auto& pair : interests)
+        {
+            if ((pair.second & INTEREST_READ) == INTEREST_READ)
+            {
+                set_fd(static_cast<FD>(pair.first), read_set);
+                max = std::max(max, pair.first);
+            }
+
+            if ((pair.second & INTEREST_WRITE) == INTEREST_WRITE)
+            {
+                set_fd(static_cast<FD>(pair.first), write_set);
+                max = std::max(max, pair.first);
+            }
+        }
+
+        return max;
+    }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+
+    void SelectBackend::set_fd(FD socket_id, fd_set& fd)
+    {
+        FD_SET(socket_id, &fd);
+    }
+
+    bool SelectBackend::is_fd_set(FD socket_id, fd_set& fd)
+    {
+        return FD_ISSET(socket_id, &fd);
+    }
+
+#pragma GCC diagnostic pop
+}
@@ -20,6 +20,8 @@ limitations under the License.
 #include "smooth/core/network/SocketDispatcher.h"
 #include "smooth/core/task_priorities.h"
 #include "smooth/config_constants.h"
+#include "smooth/core/network/SelectBackend.h"
+#include "smooth/core/network/EpollBackend.h"
 
 #ifndef ESP_PLATFORM
 
@@ -27,7 +29,10 @@ limitations under the License.
 
 #endif
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
 #include <sys/socket.h>
+#pragma GCC diagnostic pop
 
 using namespace smooth::core::logging;
 using namespace std::chrono;
@@ -50,6 +55,17 @@ namespace smooth::core::network
         return instance;
     }
 
+    static std::unique_ptr<IReadinessBackend> create_backend()
+    {
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+
+        return std::make_unique<EpollBackend>();
+#else
+
+        return std::make_unique<SelectBackend>();
+#endif
+    }
+
     SocketDispatcher::SocketDispatcher()
             : Task(tag, CONFIG_SMOOTH_SOCKET_DISPATCHER_STACK_SIZE, SOCKET_DISPATCHER_PRIO,
                    std::chrono::milliseconds(0)),
@@ -59,9 +75,9 @@ namespace smooth::core::network
               network_events(NetworkEventQueue::create(10, *this, *this)),
               socket_op(SocketOperationQueue::create(CONFIG_LWIP_MAX_SOCKETS,
                                                      *this,
-                                                     *this))
+                                                     *this)),
+              backend(create_backend())
     {
-        clear_sets();
     }
 
     void SocketDispatcher::tick()
@@ -69,108 +85,171 @@ namespace smooth::core::network
         std::lock_guard<std::mutex> lock(socket_guard);
         restart_inactive_sockets();
         check_socket_timeouts();
+        retry_deferred_shutdowns();
+        process_interest_updates();
+        expire_back_offs();
+
+        // Block until a socket is ready, or until woken by perform_op() or request_interest_update().
+        // Blocking in select() also lets other tasks run, so there is no need to sleep between ticks.
+        // The timeout only bounds how late socket timeouts, back-offs and network events are handled.
+        if (backend->wait(wait_time, ready))
+        {
+            for (const auto& r : ready)
+            {
+                dispatch(r);
+            }
+        }
+    }
 
-        int max_file_descriptor = build_sets();
+    void SocketDispatcher::dispatch(const SocketReadiness& readiness)
+    {
+        auto it = active_sockets.find(readiness.socket_id);
 
-        if (max_file_descriptor >= 0)
+        if (it != active_sockets.end())
         {
-            set_timeout();
-            int res = select(max_file_descriptor + 1, &read_set, &write_set, nullptr, &tv);
+            // Keep a reference; the socket may be removed from the active sockets as a result of the callbacks.
+            auto socket = it->second;
+            const auto interest = interests[readiness.socket_id];
 
-            if (res == -1)
+            if (readiness.readable
+                && (interest & IReadinessBackend::INTEREST_READ) == IReadinessBackend::INTEREST_READ)
             {
-                Log::error(tag, "Error during select: {}", strerror(errno));
+                socket->readable(*this);
             }
-            else if (res > 0)
+
+            if (readiness.writable
+                && (interest & IReadinessBackend::INTEREST_WRITE) == IReadinessBackend::INTEREST_WRITE)
             {
-                for (int i = 0; i <= max_file_descriptor; ++i)
-                {
-                    if (is_fd_set(static_cast<FD>(i), read_set))
-                    {
-                        auto it = active_sockets.find(i);
-
-                        if (it != active_sockets.end())
-                        {
-                            it->second->readable(*this);
-                        }
-                    }
-
-                    if (is_fd_set(static_cast<FD>(i), write_set))
-                    {
-                        auto it = active_sockets.find(i);
-
-                        if (it != active_sockets.end())
-                        {
-                            it->second->writable();
-                        }
-                    }
-                }
+                socket->writable();
+            }
+
+            if (interest == IReadinessBackend::INTEREST_NONE)
+            {
+                // Hang-ups and errors are reported even without any interest, which would make every
+                // wait return immediately. The socket will see the error once it reads or writes again.
+                park(readiness.socket_id);
+            }
+            else
+            {
+                update_interest(socket);
+                dispatch_buffered(socket);
             }
         }
-        else
+    }
+
+    void SocketDispatcher::dispatch_buffered(const std::shared_ptr<ISocket>& socket)
+    {
+        // Data already taken off the network, by the read-ahead buffer or decrypted by mbedtls,
+        // doesn't make the socket readable again, so it gets a synthetic readable event instead.
+        auto it = interests.find(socket->get_socket_id());
+
+        if (it != interests.end()
+            && it->second != parked
+            && (it->second & IReadinessBackend::INTEREST_READ) == IReadinessBackend::INTEREST_READ
+            && socket->has_buffered_data())
+        {
+            socket->readable(*this);
+            update_interest(socket);
+        }
+    }
+
+    void SocketDispatcher::park(int socket_id)
+    {
+        auto it = interests.find(socket_id);
+
+        if (it != interests.end() && it->second != parked)
         {
-            // Nothing to do, wait for work.
-            // Note: We cannot block, waiting for a notification from a socket since we're the ones polling
-            // the sockets to determine if there are work to be done. And since ESP-IDF does not guarantee
-            // round-robin scheduling, std::this_thread::yield() is not an option as that results in this
-            // thread hogging the CPU, starving other threads. As such, we must spend some time sleeping to
-            // guarantee other tasks gets a chance to run.
-            //
-            // https://esp32.com/viewtopic.php?p=28594#p28589
-            // https://docs.espressif.com/projects/esp-idf/en/v3.0.2/api-guides/freertos-smp.html#round-robin-scheduling
-            //
-            // Sleep times less than 1ms hogs the CPU due to the FreeRTOS tick interval.
-            // In practice, this delay means that there is up to an additional 1ms delay for any socket
-            // operation, but only when there was no socket read/write to do prior to that operation being queued.
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            backend->remove(socket_id);
+            it->second = parked;
         }
     }
 
-    void SocketDispatcher::set_timeout()
+    uint8_t SocketDispatcher::get_interest(const std::shared_ptr<ISocket>& socket)
     {
-        tv.tv_sec = 0;
-        tv.tv_usec = 10000;
+        bool read = false;
+        bool write = false;
+
+        if (socket->is_active() && !socket->is_busy() && !is_backed_off(socket->get_socket_id()))
+        {
+            write = socket->has_data_to_transmit() || !socket->is_connected();
+            read = socket->is_connected() && socket->has_room_to_receive();
+        }
+
+        return IReadinessBackend::make_interest(read, write);
     }
 
-    void SocketDispatcher::clear_sets()
+    void SocketDispatcher::update_interest(const std::shared_ptr<ISocket>& socket)
     {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-        FD_ZERO(&read_set);
-        FD_ZERO(&write_set);
-#pragma GCC diagnostic pop
+        auto it = interests.find(socket->get_socket_id());
+
+        if (it != interests.end())
+        {
+            auto wanted = get_interest(socket);
+            bool changed = false;
+
+            // Only touch the backend when the interest actually changes.
+            if (it->second == parked)
+            {
+                changed = wanted != IReadinessBackend::INTEREST_NONE && backend->add(it->first, wanted);
+            }
+            else if (wanted != it->second)
+            {
+                changed = backend->modify(it->first, wanted);
+            }
+
+            if (changed)
+            {
+                it->second = wanted;
+            }
+        }
     }
 
-    int SocketDispatcher::build_sets()
+    void SocketDispatcher::request_interest_update(int socket_id)
     {
-        clear_sets();
+        {
+            std::lock_guard<std::mutex> lock(interest_update_guard);
+            requested_interest_updates.push_back(socket_id);
+        }
 
-        int max = ISocket::INVALID_SOCKET;
+        backend->wake();
+    }
 
-        for (auto& pair : active_sockets)
+    void SocketDispatcher::process_interest_updates()
+    {
         {
-            auto& s = pair.second;
+            std::lock_guard<std::mutex> lock(interest_update_guard);
+            std::swap(requested_interest_updates, interest_updates_to_process);
+        }
 
-            max = std::max(max, s->get_socket_id());
+        for (auto id : interest_updates_to_process)
+        {
+            auto it = active_sockets.find(id);
 
-            if (s->is_active())
+            if (it != active_sockets.end())
             {
-                if (!is_backed_off(s->get_socket_id()))
-                {
-                    if (s->has_data_to_transmit() || !s->is_connected())
-                    {
-                        set_fd(static_cast<FD>(s->get_socket_id()), write_set);
-                    }
-
-                    if (s->is_connected())
-                    {
-                        set_fd(static_cast<FD>(s->get_socket_id()), read_set);
-                    }
-                }
+                // Keep a reference; the socket may be removed from the active sockets by the callbacks.
+                auto socket = it->second;
+                update_interest(socket);
+                dispatch_buffered(socket);
             }
         }
 
-        return max;
+        interest_updates_to_process.clear();
+    }
+
+    void SocketDispatcher::add_active_socket(const std::shared_ptr<ISocket>& socket)
+    {
+        auto id = socket->get_socket_id();
+
+        if (active_sockets.emplace(id, socket).second)
+        {
+            auto interest = get_interest(socket);
+
+            if (backend->add(id, interest))
+            {
+                interests[id] = interest;
+            }
+        }
     }
 
     void SocketDispatcher::start_socket(const std::shared_ptr<ISocket>& socket)
@@ -181,7 +260,7 @@ namespace smooth::core::network
         {
             if (socket->internal_start())
             {
-                active_sockets.insert(std::make_pair(socket->get_socket_id(), socket));
+                add_active_socket(socket);
             }
         }
         else
@@ -196,6 +275,18 @@ namespace smooth::core::network
 
         Log::verbose(tag, "Shutting down socket {}, ID: {}", static_cast<void*>(socket.get()), socket->get_socket_id());
         socket->stop_internal();
+
+        if (socket->is_busy())
+        {
+            // A worker is still using the socket, so it can't be closed yet.
+            if (std::find(deferred_shutdowns.begin(), deferred_shutdowns.end(), socket) == deferred_shutdowns.end())
+            {
+                deferred_shutdowns.push_back(socket);
+            }
+
+            return;
+        }
+
         remove_socket_from_active_sockets(socket);
         remove_socket_from_collection(inactive_sockets, socket);
         remove_backed_off_socket(socket->get_socket_id());
@@ -231,6 +322,24 @@ namespace smooth::core::network
         }
     }
 
+    void SocketDispatcher::retry_deferred_shutdowns()
+    {
+        // Workers request an interest update when they're done, which wakes the dispatcher
+        // so that the shutdown is completed right away.
+        for (auto it = deferred_shutdowns.begin(); it != deferred_shutdowns.end();)
+        {
+            if ((*it)->is_busy())
+            {
+                ++it;
+            }
+            else
+            {
+                perform_op(SocketOperation::Op::Stop, *it);
+                it = deferred_shutdowns.erase(it);
+            }
+        }
+    }
+
     void SocketDispatcher::remove_socket_from_collection(std::vector<std::shared_ptr<ISocket>>& col,
                                                          const std::shared_ptr<ISocket>& socket) const
     {
@@ -256,6 +365,19 @@ namespace smooth::core::network
 
         if (found != active_sockets.end())
         {
+            auto interest = interests.find(found->first);
+
+            // Must be unregistered before the socket is closed.
+            if (interest != interests.end() && interest->second != parked)
+            {
+                backend->remove(found->first);
+            }
+
+            if (interest != interests.end())
+            {
+                interests.erase(interest);
+            }
+
             active_sockets.erase(found);
         }
     }
@@ -269,7 +391,7 @@ namespace smooth::core::network
             {
                 if (socket->internal_start())
                 {
-                    active_sockets.insert(std::make_pair(socket->get_socket_id(), socket));
+                    add_active_socket(socket);
                 }
                 else
                 {
@@ -319,8 +441,7 @@ namespace smooth::core::network
         }
         else if (event.get_op() == SocketOperation::Op::AddActiveSocket)
         {
-            auto socket = event.get_socket();
-            active_sockets.emplace(socket->get_socket_id(), socket);
+            add_active_socket(event.get_socket());
         }
         else
         {
@@ -333,24 +454,33 @@ namespace smooth::core::network
     void SocketDispatcher::perform_op(SocketOperation::Op op, std::shared_ptr<ISocket> socket)
     {
         socket_op->push(SocketOperation(op, std::move(socket)));
+        backend->wake();
     }
 
     void SocketDispatcher::check_socket_timeouts()
     {
-        for (auto& pair : active_sockets)
+        // Timeouts are counted in seconds, so there is no need to visit every socket on each tick.
+        const auto now = steady_clock::now();
+
+        if (now >= next_timeout_check)
         {
-            if (pair.second->has_send_expired())
-            {
-                Log::warning(tag, "Send timeout on socket {} ({} ms)", static_cast<void*>(pair.second.get()),
-                                         pair.second->get_send_timeout().count());
-                pair.second->stop("Send timeout");
-            }
-            else if (pair.second->has_receive_expired())
+            next_timeout_check = now + timeout_check_interval;
+
+            for (auto& pair : active_sockets)
             {
-                Log::warning(tag, "Receive timeout on socket {} ({} ms)",
-                                      static_cast<void*>(pair.second.get()),
-                                      pair.second->get_receive_timeout().count());
-                pair.second->stop("Receive timeout");
+                if (pair.second->has_send_expired())
+                {
+                    Log::warning(tag, "Send timeout on socket {} ({} ms)", static_cast<void*>(pair.second.get()),
+                                 pair.second->get_send_timeout().count());
+                    pair.second->stop("Send timeout");
+                }
+                else if (pair.second->has_receive_expired())
+                {
+                    Log::warning(tag, "Receive timeout on socket {} ({} ms)",
+                                 static_cast<void*>(pair.second.get()),
+                                 pair.second->get_receive_timeout().count());
+                    pair.second->stop("Receive timeout");
+                }
             }
         }
     }
@@ -358,16 +488,6 @@ namespace smooth::core::network
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wsign-conversion"
 
-    void SocketDispatcher::set_fd(FD socket_id, fd_set& fd)
-    {
-        FD_SET(socket_id, &fd);
-    }
-
-    bool SocketDispatcher::is_fd_set(FD socket_id, fd_set& fd)
-    {
-        return FD_ISSET(socket_id, &fd);
-    }
-
     void SocketDispatcher::back_off(int socket_id, std::chrono::milliseconds duration)
     {
         backed_off[socket_id] = steady_clock::now() + duration;
@@ -393,6 +513,38 @@ namespace smooth::core::network
         return b_off;
     }
 
+    void SocketDispatcher::expire_back_offs()
+    {
+        const auto now = steady_clock::now();
+        std::vector<int> expired{};
+
+        for (auto it = backed_off.begin(); it != backed_off.end();)
+        {
+            if (it->second < now)
+            {
+                expired.push_back(it->first);
+                it = backed_off.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Resumed sockets may back off again, so they're handled once done with the map.
+        for (auto id : expired)
+        {
+            auto socket = active_sockets.find(id);
+
+            if (socket != active_sockets.end())
+            {
+                auto s = socket->second;
+                update_interest(s);
+                dispatch_buffered(s);
+            }
+        }
+    }
+
     void SocketDispatcher::remove_backed_off_socket(int socket_id)
     {
         const auto& it = backed_off.find(socket_id);
@@ -0,0 +1,164 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/TLSSessionCache.h"
+#include <algorithm>
+#include <cstring>
+#include <mbedtls/platform_util.h>
+
+namespace smooth::core::network
+{
+    TLSSessionCache::TLSSessionCache(size_t max_entries, std::chrono::seconds timeout)
+            : max_entries(max_entries),
+              timeout(timeout)
+    {
+    }
+
+    void TLSSessionCache::attach(mbedtls_ssl_config& conf)
+    {
+        mbedtls_ssl_conf_session_cache(&conf, this, &TLSSessionCache::get, &TLSSessionCache::set);
+    }
+
+    size_t TLSSessionCache::size() const
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        return entries.size();
+    }
+
+    int TLSSessionCache::get(void* ctx, mbedtls_ssl_session* session)
+    {
+        auto* cache = static_cast<TLSSessionCache*>(ctx);
+        std::lock_guard<std::mutex> lock(cache->guard);
+
+        int res = 1;
+        auto entry = cache->find(*session);
+
+        if (entry != cache->entries.end())
+        {
+            if (std::chrono::steady_clock::now() - entry->stored > cache->timeout)
+            {
+                cache->entries.erase(entry);
+            }
+            else if (session->ciphersuite == 0
+                     || (session->ciphersuite == entry->ciphersuite
+                         && session->compression == entry->compression))
+            {
+                // Older mbedtls versions fill in the negotiated cipher suite before asking the cache,
+                // newer ones leave it empty and compare it themselves afterwards.
+                entry->restore(*session);
+                cache->entries.splice(cache->entries.begin(), cache->entries, entry);
+                res = 0;
+            }
+        }
+
+        return res;
+    }
+
+    int TLSSessionCache::set(void* ctx, const mbedtls_ssl_session* session)
+    {
+        auto* cache = static_cast<TLSSessionCache*>(ctx);
+        std::lock_guard<std::mutex> lock(cache->guard);
+
+        if (session->id_len > 0 && cache->max_entries > 0)
+        {
+            auto entry = cache->find(*session);
+
+            if (entry != cache->entries.end())
+            {
+                cache->entries.splice(cache->entries.begin(), cache->entries, entry);
+            }
+            else
+            {
+                if (cache->entries.size() >= cache->max_entries)
+                {
+                    cache->entries.pop_back();
+                }
+
+                cache->entries.emplace_front();
+            }
+
+            cache->entries.front().store(*session);
+        }
+
+        return 0;
+    }
+
+    std::list<TLSSessionCache::Entry>::iterator TLSSessionCache::find(const mbedtls_ssl_session& session)
+    {
+        return std::find_if(entries.begin(), entries.end(),
+                            [&session](const Entry& e) { return e.matches(session); });
+    }
+
+    TLSSessionCache::Entry::~Entry()
+    {
+        mbedtls_platform_zeroize(master.data(), master.size());
+    }
+
+    bool TLSSessionCache::Entry::matches(const mbedtls_ssl_session& session) const
+    {
+        return id_len == session.id_len
+               && std::memcmp(id.data(), session.id, id_len) == 0;
+    }
+
+    void TLSSessionCache::Entry::store(const mbedtls_ssl_session& session)
+    {
+        // Only the values needed to resume the session are kept; in particular the peer
+        // certificate is not, as it isn't verified again when a session is resumed.
+        id_len = session.id_len;
+        std::memcpy(id.data(), session.id, id.size());
+        ciphersuite = session.ciphersuite;
+        compression = session.compression;
+        std::memcpy(master.data(), session.master, master.size());
+        verify_result = session.verify_result;
+#if defined(MBEDTLS_HAVE_TIME)
+        start = session.start;
+#endif
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+        mfl_code = session.mfl_code;
+#endif
+#if defined(MBEDTLS_SSL_TRUNCATED_HMAC)
+        trunc_hmac = session.trunc_hmac;
+#endif
+#if defined(MBEDTLS_SSL_ENCRYPT_THEN_MAC)
+        encrypt_then_mac = session.encrypt_then_mac;
+#endif
+        stored = std::chrono::steady_clock::now();
+    }
+
+    void TLSSessionCache::Entry::restore(mbedtls_ssl_session& session) const
+    {
+        session.id_len = id_len;
+        std::memcpy(session.id, id.data(), id.size());
+        session.ciphersuite = ciphersuite;
+        session.compression = compression;
+        std::memcpy(session.master, master.data(), master.size());
+        session.verify_result = verify_result;
+#if defined(MBEDTLS_HAVE_TIME)
+        session.start = start;
+#endif
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+        session.mfl_code = mfl_code;
+#endif
+#if defined(MBEDTLS_SSL_TRUNCATED_HMAC)
+        session.trunc_hmac = trunc_hmac;
+#endif
+#if defined(MBEDTLS_SSL_ENCRYPT_THEN_MAC)
+        session.encrypt_then_mac = encrypt_then_mac;
+#endif
+    }
+}
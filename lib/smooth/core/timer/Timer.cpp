@@ -94,6 +94,16 @@ namespace smooth::core::timer
         expire_time = steady_clock::now() + timer_interval;
     }
 
+    void Timer::calculate_next_repetition(steady_clock::time_point now)
+    {
+        expire_time += timer_interval;
+
+        if (expire_time <= now)
+        {
+            expire_time = now + timer_interval;
+        }
+    }
+
     TimerOwner::TimerOwner(std::shared_ptr<Timer> t) noexcept
             : t(std::move(t))
     {}
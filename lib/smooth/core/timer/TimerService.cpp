@@ -15,6 +15,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
 #include "smooth/core/timer/TimerService.h"
 #include "smooth/core/timer/Timer.h"
 #include "smooth/core/task_priorities.h"
@@ -30,11 +31,7 @@ namespace smooth::core::timer
                    CONFIG_SMOOTH_TIMER_SERVICE_STACK_SIZE,
                    TIMER_SERVICE_PRIO,
                    milliseconds(0)),
-              cmp([](const SharedTimer& left, const SharedTimer& right) {
-                      // We want the timer with the least time left to be first in the list
-                      return left->expires_at() > right->expires_at();
-                  }),
-              queue(cmp),
+              epoch(steady_clock::now()),
               guard()
     {
     }
@@ -55,71 +52,79 @@ namespace smooth::core::timer
     {
         std::lock_guard<std::mutex> lock(guard);
         timer->calculate_next_execution();
-        queue.push(timer);
-        cond.notify_one();
+        wheel.schedule(*timer, to_tick(timer->expires_at()));
+        timer->scheduled_self = timer;
+
+        if (timer->get_expiry_tick() < wake_tick)
+        {
+            // Expires before the service wakes up
+            wake_tick = timer->get_expiry_tick();
+            cond.notify_one();
+        }
     }
 
     void TimerService::remove_timer(const SharedTimer& timer)
     {
         std::lock_guard<std::mutex> lock(guard);
-        queue.remove_timer(timer);
-        cond.notify_one();
+        wheel.cancel(*timer);
+        timer->scheduled_self.reset();
     }
 
     void TimerService::tick()
     {
         std::unique_lock<std::mutex> lock(guard);
 
-        if (queue.empty())
+        // Get a fixed 'now'
+        auto now = steady_clock::now();
+        auto elapsed_ticks = static_cast<uint64_t>(duration_cast<milliseconds>(now - epoch).count());
+
+        // Process any expired timers
+        wheel.advance(elapsed_ticks, [this, now](TimerWheelNode& node) {
+                          expire(static_cast<Timer&>(node), now);
+                      });
+
+        wake_tick = wheel.next_tick_with_work();
+        auto waiting_for = wake_tick;
+
+        // Wait for the next timer to expire, or a timer that expires before that to be added.
+        // When there are no timers, wait until one is added.
+        auto until = waiting_for == TimerWheel::no_tick
+                     ? now + seconds(1)
+                     : epoch + milliseconds(waiting_for);
+
+        cond.wait_until(lock,
+                        until,
+                        [waiting_for, this]() {
+                            return wake_tick < waiting_for;
+                        });
+    }
+
+    void TimerService::expire(Timer& timer, steady_clock::time_point now)
+    {
+        timer.expired();
+
+        if (timer.is_repeating())
         {
-            // No timers, wait until one is added.
-            cond.wait_for(lock, seconds(1));
+            timer.calculate_next_repetition(now);
+            wheel.schedule(timer, to_tick(timer.expires_at()));
         }
         else
         {
-            // Get a fixed 'now'
-            auto now = steady_clock::now();
-
-            std::vector<SharedTimer> processed{};
-
-            // Process any expired timers
-            while (!queue.empty() && now >= queue.top()->expires_at())
-            {
-                auto timer = queue.top();
-                timer->expired();
-
-                // Timer expired, remove from queue
-                queue.pop();
-
-                // Save timer to later add it, if repeating.
-                // Otherwise, simply forget about it.
-                if (timer->is_repeating())
-                {
-                    processed.push_back(timer);
-                }
-            }
-
-            for (auto& t : processed)
-            {
-                t->calculate_next_execution();
-                queue.push(t);
-            }
-
-            if (!queue.empty())
-            {
-                // Get next timer to expire
-                auto timer = queue.top();
-
-                // Wait for the timer to expire, or a timer to be removed or added.
-                auto current_queue_length = queue.size();
-
-                cond.wait_until(lock,
-                                timer->expires_at(),
-                                [current_queue_length, this]() {
-                                    // Wake up if a timer has been added or removed.
-                                    return current_queue_length != queue.size();
-                                });
-            }
+            // Timer expired, forget about it. This may be the last reference to the timer.
+            timer.scheduled_self.reset();
         }
     }
+
+    uint64_t TimerService::to_tick(steady_clock::time_point time) const
+    {
+        auto since_epoch = duration_cast<nanoseconds>(time - epoch);
+        auto ticks = duration_cast<milliseconds>(since_epoch);
+
+        if (ticks < since_epoch)
+        {
+            ++ticks;
+        }
+
+        return static_cast<uint64_t>(std::max(ticks, milliseconds(0)).count());
+    }
 }
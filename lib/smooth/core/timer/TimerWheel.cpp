@@ -0,0 +1,222 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/timer/TimerWheel.h"
+#include <algorithm>
+
+namespace smooth::core::timer
+{
+    /// \return The number of ticks covered by one slot on the given level.
+    static constexpr uint64_t ticks_per_slot(size_t level)
+    {
+        return static_cast<uint64_t>(1) << (TimerWheel::slot_bits * level);
+    }
+
+    static constexpr size_t slot_of(uint64_t tick, size_t level)
+    {
+        return static_cast<size_t>((tick >> (TimerWheel::slot_bits * level)) & (TimerWheel::slot_count - 1));
+    }
+
+    void TimerWheel::schedule(TimerWheelNode& node, uint64_t expiry_tick)
+    {
+        cancel(node);
+        node.expiry = expiry_tick;
+        link(node);
+        ++count;
+    }
+
+    void TimerWheel::cancel(TimerWheelNode& node)
+    {
+        if (node.is_scheduled())
+        {
+            unlink(node);
+            --count;
+        }
+    }
+
+    void TimerWheel::advance(uint64_t until, const std::function<void(TimerWheelNode&)>& on_expired)
+    {
+        while (current <= until)
+        {
+            auto next = next_tick_with_work();
+
+            if (next > until)
+            {
+                // Nothing happens before 'until' so it is safe to skip right past it.
+                current = until + 1;
+            }
+            else
+            {
+                current = next;
+                process_current_tick(on_expired);
+            }
+        }
+    }
+
+    uint64_t TimerWheel::next_tick_with_work() const
+    {
+        uint64_t res = no_tick;
+
+        if (occupied[0] != 0)
+        {
+            // Each slot on the lowest level is one tick, the slot at the current index is the current tick.
+            res = current + first_set_from(occupied[0], slot_of(current, 0));
+        }
+
+        for (size_t level = 1; level < level_count; ++level)
+        {
+            if (occupied[level] != 0)
+            {
+                // Slots on higher levels are worked on (cascaded) when the level below wraps around.
+                auto span = ticks_per_slot(level);
+                auto boundary = (current + span - 1) / span * span;
+                auto cascade_at = boundary + first_set_from(occupied[level], slot_of(boundary, level)) * span;
+                res = std::min(res, cascade_at);
+            }
+        }
+
+        return res;
+    }
+
+    void TimerWheel::link(TimerWheelNode& node)
+    {
+        // Nodes that already have expired go into the slot that is processed next.
+        auto at = std::max(node.expiry, current);
+        auto delta = at - current;
+        size_t level = 0;
+
+        while (level < level_count - 1 && delta >= ticks_per_slot(level + 1))
+        {
+            ++level;
+        }
+
+        if (delta >= ticks_per_slot(level_count))
+        {
+            // Out of range, place at the far end. It will be placed again when cascaded.
+            at = current + ticks_per_slot(level_count) - 1;
+        }
+
+        auto slot = slot_of(at, level);
+        auto& head = slots[level][slot];
+
+        node.prev = nullptr;
+        node.next = head;
+
+        if (head)
+        {
+            head->prev = &node;
+        }
+
+        head = &node;
+        occupied[level] |= static_cast<uint64_t>(1) << slot;
+        node.level = static_cast<int>(level);
+        node.slot = slot;
+    }
+
+    void TimerWheel::unlink(TimerWheelNode& node)
+    {
+        auto level = static_cast<size_t>(node.level);
+        auto& head = slots[level][node.slot];
+
+        if (node.prev)
+        {
+            node.prev->next = node.next;
+        }
+        else
+        {
+            head = node.next;
+        }
+
+        if (node.next)
+        {
+            node.next->prev = node.prev;
+        }
+
+        if (head == nullptr)
+        {
+            occupied[level] &= ~(static_cast<uint64_t>(1) << node.slot);
+        }
+
+        node.next = nullptr;
+        node.prev = nullptr;
+        node.level = -1;
+    }
+
+    void TimerWheel::cascade(size_t level)
+    {
+        auto slot = slot_of(current, level);
+        auto* node = slots[level][slot];
+        slots[level][slot] = nullptr;
+        occupied[level] &= ~(static_cast<uint64_t>(1) << slot);
+
+        while (node)
+        {
+            auto* next = node->next;
+            link(*node);
+            node = next;
+        }
+    }
+
+    void TimerWheel::process_current_tick(const std::function<void(TimerWheelNode&)>& on_expired)
+    {
+        // When the lowest level wraps around, move the nodes of the next slot on the level above
+        // down, and so on for as long as the levels wrap around.
+        bool wrapped = slot_of(current, 0) == 0;
+
+        for (size_t level = 1; wrapped && level < level_count; ++level)
+        {
+            cascade(level);
+            wrapped = slot_of(current, level) == 0;
+        }
+
+        // Detach the expired nodes before handing them out so that they can be scheduled again,
+        // possibly into the very same slot.
+        auto slot = slot_of(current, 0);
+        auto* node = slots[0][slot];
+        slots[0][slot] = nullptr;
+        occupied[0] &= ~(static_cast<uint64_t>(1) << slot);
+
+        for (auto* n = node; n != nullptr; n = n->next)
+        {
+            n->level = -1;
+            --count;
+        }
+
+        ++current;
+
+        while (node)
+        {
+            auto* next = node->next;
+            node->next = nullptr;
+            node->prev = nullptr;
+            on_expired(*node);
+            node = next;
+        }
+    }
+
+    size_t TimerWheel::first_set_from(uint64_t bits, size_t start)
+    {
+        size_t distance = 0;
+
+        while ((bits & (static_cast<uint64_t>(1) << ((start + distance) & (slot_count - 1)))) == 0)
+        {
+            ++distance;
+        }
+
+        return distance;
+    }
+}
@@ -0,0 +1,92 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace smooth::application::compression
+{
+    /// Streaming gzip (RFC 1952) compressor. The data is deflated (RFC 1951) using fixed Huffman codes and
+    /// a sliding window of a configurable size, so that memory use is bounded and small enough for an ESP32:
+    /// about 8 * 2^window_bits bytes, i.e. 8 KB with the default 1 KB window. Compression is less effective
+    /// than that of zlib, but text typically shrinks to a third.
+    class GzipCompressor
+    {
+        public:
+            static constexpr uint8_t min_window_bits = 9;
+            static constexpr uint8_t max_window_bits = 14;
+
+            /// \param window_bits Base two logarithm of the window size, clamped to
+            /// [min_window_bits, max_window_bits].
+            explicit GzipCompressor(uint8_t window_bits = 10);
+
+            /// Compresses data, appending the compressed data that is ready to target.
+            void write(const uint8_t* data, std::size_t length, std::vector<uint8_t>& target);
+
+            /// Compresses any remaining data and appends it, followed by the gzip trailer, to target.
+            void finish(std::vector<uint8_t>& target);
+
+            [[nodiscard]] bool is_finished() const
+            {
+                return finished;
+            }
+
+        private:
+            void write_header(std::vector<uint8_t>& target);
+
+            void compress(bool flush, std::vector<uint8_t>& target);
+
+            void slide();
+
+            [[nodiscard]] std::size_t hash(std::size_t pos) const;
+
+            void insert(std::size_t pos);
+
+            [[nodiscard]] std::size_t match_length(std::size_t candidate, std::size_t pos, std::size_t max) const;
+
+            void put_bits(uint32_t value, uint32_t count, std::vector<uint8_t>& target);
+
+            void put_code(uint32_t code, uint32_t length, std::vector<uint8_t>& target);
+
+            void put_symbol(uint32_t symbol, std::vector<uint8_t>& target);
+
+            void put_match(std::size_t length, std::size_t distance, std::vector<uint8_t>& target);
+
+            const std::size_t window_size;
+            const std::size_t hash_mask;
+
+            // Two windows; the first holds the history, the second incoming data. When full,
+            // the second half is moved to the first.
+            std::vector<uint8_t> window;
+
+            // Heads of the hash chains and links to the previous position with the same hash,
+            // stored as position + 1 so that 0 means none.
+            std::vector<uint16_t> head;
+            std::vector<uint16_t> prev;
+
+            std::size_t pos{ 0 };
+            std::size_t fill{ 0 };
+            uint32_t bit_buffer{ 0 };
+            uint32_t bit_count{ 0 };
+            uint32_t crc{ 0xFFFFFFFF };
+            uint32_t input_size{ 0 };
+            bool header_written{ false };
+            bool finished{ false };
+    };
+}
@@ -18,6 +18,8 @@ limitations under the License.
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -44,6 +46,8 @@ namespace smooth::application::network::http
 
             HTTPPacket(HTTPPacket&&) = default;
 
+            HTTPPacket& operator=(HTTPPacket&&) = default;
+
             HTTPPacket(regular::ResponseCode code, const std::string& version,
                        const std::unordered_map<std::string, std::string>& new_headers,
                        const std::vector<uint8_t>& response_content);
@@ -54,16 +58,25 @@ namespace smooth::application::network::http
 
             explicit HTTPPacket(std::vector<uint8_t>& response_content);
 
+            /// Creates a packet that sends data owned by someone else, without copying it.
+            HTTPPacket(std::shared_ptr<const uint8_t> external_content, std::size_t length);
+
             // Must return the total amount of bytes to send
             int get_send_length() override
             {
-                return static_cast<int>(content.size());
+                return static_cast<int>(external ? external_length : content.size());
             }
 
             // Must return a pointer to the data to be sent.
             const uint8_t* get_data() override
             {
-                return content.data();
+                return external ? external.get() : content.data();
+            }
+
+            void release_data() override
+            {
+                external.reset();
+                external_length = 0;
             }
 
             const auto& get_buffer()
@@ -144,6 +157,22 @@ namespace smooth::application::network::http
                 content.clear();
             }
 
+            /// Returns the packet to its default state, keeping allocated storage for reuse.
+            void recycle()
+            {
+                request_headers.clear();
+                request_method.clear();
+                request_url.clear();
+                request_version.clear();
+                content.clear();
+                external.reset();
+                external_length = 0;
+                resp_code = regular::ResponseCode{};
+                continuation = false;
+                continued = false;
+                ws_opcode = websocket::OpCode::Continuation;
+            }
+
             auto find_header_ending() const
             {
                 const auto end = std::search(content.cbegin(), content.cend(), ending.cbegin(), ending.cend());
@@ -172,6 +201,8 @@ namespace smooth::application::network::http
             std::string request_url{};
             std::string request_version{};
             std::vector<uint8_t> content{};
+            std::shared_ptr<const uint8_t> external{};
+            std::size_t external_length{ 0 };
             regular::ResponseCode resp_code{};
             bool continuation = false;
             bool continued = false;
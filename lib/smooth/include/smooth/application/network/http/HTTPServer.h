@@ -37,12 +37,19 @@ limitations under the License.
 #include "smooth/application/network/http/http_utils.h"
 #include "smooth/application/network/http/HTTPProtocol.h"
 #include "smooth/application/network/http/HTTPServerClient.h"
+#include "smooth/application/network/http/regular/ByteRanges.h"
+#include "smooth/application/network/http/regular/responses/CachedFileResponse.h"
 #include "smooth/application/network/http/regular/responses/ErrorResponse.h"
 #include "smooth/application/network/http/regular/responses/FileContentResponse.h"
+#include "smooth/application/network/http/regular/responses/GzipResponse.h"
+#include "smooth/application/network/http/regular/responses/HeaderOnlyResponse.h"
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
+#include "smooth/application/network/http/regular/StaticFileCache.h"
 #include "smooth/application/hash/sha.h"
+#include "smooth/config_constants.h"
 #include "regular/RequestHandlerSignature.h"
 #include "regular/HTTPRequestHandler.h"
+#include "regular/RequestRouter.h"
 #include "regular/WebSocketUpgradeDetector.h"
 #include "HTTPServerConfig.h"
 
@@ -93,21 +100,20 @@ namespace smooth::application::network::http
             }
 
             /// Configure a request handler to handle a specific HTTP verb and path.
+            /// The path may contain parameter segments, e.g. "/api/sensor/{id}", and end with a wildcard,
+            /// e.g. "/static/*"; see RequestRouter. The handler gets the values via route_parameters().
             /// Responders may be used for multiple URLS and/or methods, but must not be shared
             /// between different instances of an HTTP server since there is no guarantee in
             /// what order the data arrives to the handler. (If a handler is state-less, then this
             /// limitation does not apply.)
-            void on(HTTPMethod method, const std::string& url,
+            /// \return false, after logging an error, if the path is rejected by RequestRouter::add().
+            bool on(HTTPMethod method, const std::string& url,
                     const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler);
 
             template<typename WServerType>
             void enable_websocket_on(const std::string& url);
 
         private:
-            using HandlerByURL = std::unordered_map<std::string,
-                                                    std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>>;
-            using HandlerByMethod = std::unordered_map<HTTPMethod, HandlerByURL>;
-
             void handle(HTTPMethod method,
                         IServerResponse& response,
                         IConnectionTimeoutModifier& timeout_modifier,
@@ -118,7 +124,12 @@ namespace smooth::application::network::http
                         bool fist_part,
                         bool last_part) override;
 
-            smooth::core::filesystem::Path find_index(const smooth::core::filesystem::Path& search_path) const;
+            bool is_not_modified(const regular::CachedFile& file,
+                                 const std::unordered_map<std::string, std::string>& request_headers) const;
+
+            bool is_range_requested(const regular::CachedFile& file,
+                                    const std::unordered_map<std::string, std::string>& request_headers,
+                                    regular::ByteRanges& ranges) const;
 
             void
             reply_with(IServerResponse& response, std::unique_ptr<IResponseOperation> res);
@@ -131,10 +142,11 @@ namespace smooth::application::network::http
                                 smooth::application::network::http::HTTPServerClient,
                                 smooth::application::network::http::HTTPProtocol, IRequestHandler>> server{};
 
-            HandlerByMethod handlers{};
+            smooth::application::network::http::regular::RequestRouter router{};
             HTTPServerConfig config;
             const char* tag = "HTTPServer";
             TemplateProcessor template_processor;
+            regular::StaticFileCache file_cache;
     };
 
     template<typename ServerSocketType>
@@ -142,16 +154,31 @@ namespace smooth::application::network::http
             :
               task(task),
               config(configuration),
-              template_processor(configuration.templates(), config.data_retriever())
+              template_processor(configuration.templates(), config.data_retriever()),
+              file_cache(configuration.web_root(),
+                         configuration.indexes(),
+                         configuration.templates(),
+                         CONFIG_SMOOTH_HTTP_FILE_CACHE_SIZE,
+                         CONFIG_SMOOTH_HTTP_FILE_CACHE_MAX_FILE_SIZE,
+                         std::chrono::milliseconds(CONFIG_SMOOTH_HTTP_FILE_CACHE_REVALIDATE_MS))
     {
     }
 
     template<typename ServerType>
-    void HTTPServer<ServerType>::on(HTTPMethod method,
+    bool HTTPServer<ServerType>::on(HTTPMethod method,
                                     const std::string& url,
                                     const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler)
     {
-        handlers[method][url] = handler;
+        using namespace smooth::core::logging;
+
+        bool res = router.add(method, url, handler);
+
+        if (!res)
+        {
+            Log::error(tag, "Invalid route: {}: '{}'", utils::http_method_to_string(method), url);
+        }
+
+        return res;
     }
 
     template<typename ServerType>
@@ -168,49 +195,41 @@ namespace smooth::application::network::http
     {
         using namespace smooth::core::logging;
 
-        // Is there a URL for the given method?
-        auto by_url = handlers.find(method);
+        // Is there a handler for the URL and method?
+        regular::RouteParameters route_parameters{};
+        auto handler = router.find(method, requested_url, route_parameters);
 
-        if (by_url != handlers.end())
+        if (handler)
         {
-            // Is there a specific handler for this URL?
-            auto response_handler = (*by_url).second.find(requested_url);
+            // Call order is important - must update call params before calling the rest of the methods in the
+            // inheriting class. Done for every part so that is_first()/is_last() are correct for streamed bodies.
+            handler->update_call_params(first_part, last_part, response, request_headers, request_parameters);
 
-            if (response_handler == (*by_url).second.end())
+            handler->set_route_parameters(route_parameters);
+
+            if (first_part)
             {
-                // No handler for this URL, does it match a file path beneath the web root?
-                serve_file(method, response, requested_url, request_headers);
+                handler->prepare_mime();
+                handler->start_of_request();
             }
-            else
-            {
-                auto handler = (*response_handler).second;
 
-                // Call order is important - must update call params before calling the rest of the methods in the
-                // inheriting class.
-                if (first_part || last_part)
-                {
-                    handler->update_call_params(first_part, last_part, response, request_headers, request_parameters);
-                }
+            handler->request(timeout_modifier, requested_url, data);
 
-                if (first_part)
-                {
-                    handler->prepare_mime();
-                    handler->start_of_request();
-                }
-
-                handler->request(timeout_modifier, requested_url, data);
-
-                if (last_part)
-                {
-                    handler->end_of_request();
-                }
+            if (last_part)
+            {
+                handler->end_of_request();
             }
         }
-        else
+        else if (method == HTTPMethod::GET || method == HTTPMethod::HEAD)
         {
-            // No specific handler for this URL.
+            // No handler for this URL, does it match a file path beneath the web root?
             serve_file(method, response, requested_url, request_headers);
         }
+        else if (first_part)
+        {
+            // Only files can be served without a handler, so there is no need to look for one.
+            reply_with(response, std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Found));
+        }
     }
 
     template<typename ServerType>
@@ -219,105 +238,160 @@ namespace smooth::application::network::http
                                             const std::string& requested_url,
                                             const std::unordered_map<std::string, std::string>& request_headers)
     {
-        auto found = false;
-
         Log::info(tag, "Request: {}: '{}'", utils::http_method_to_string(method), requested_url);
 
-        filesystem::Path search{ config.web_root() };
-        search /= requested_url;
+        // Does the URL match a file beneath the web root, or the index file of a directory?
+        auto file = file_cache.get(requested_url);
 
-        if (config.web_root().is_parent_of(search) || config.web_root() == search)
+        if (!file)
+        {
+            reply_with(response, std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Found));
+        }
+        else
         {
-            filesystem::FileInfo info(search);
+            const bool accepts_gzip = utils::accepts_encoding(request_headers, "gzip");
 
-            if (info.is_regular_file())
+            if (file->gzipped && accepts_gzip)
             {
-                // Attempt to process the file as a template.
-                auto processed_template = template_processor.process_template(info.path());
+                file = file->gzipped;
+            }
+
+            // Attempt to process the file as a template.
+            auto processed_template = template_processor.process_template(file->path);
 
-                if (processed_template)
+            if (processed_template)
+            {
+                if (CONFIG_SMOOTH_HTTP_GZIP_WINDOW_BITS > 0 && accepts_gzip)
                 {
-                    reply_with(response, std::move(processed_template));
+                    processed_template = std::make_unique<responses::GzipResponse>(
+                        std::move(processed_template),
+                        static_cast<uint8_t>(CONFIG_SMOOTH_HTTP_GZIP_WINDOW_BITS));
                 }
-                else
-                {
-                    // Not a template, simply serve the requested file
-                    bool send_not_modified = false;
-                    auto if_modified_since = request_headers.find("if-modified-since");
 
-                    if (if_modified_since != request_headers.end())
-                    {
-                        auto since = utils::parse_http_time((*if_modified_since).second);
+                reply_with(response, std::move(processed_template));
+            }
+            else if (is_not_modified(*file, request_headers))
+            {
+                // A 304 has no body; it only repeats the validators and Vary of the file.
+                auto not_modified = std::make_unique<responses::HeaderOnlyResponse>(ResponseCode::Not_Modified);
 
-                        if (since >= info.last_modified_point())
-                        {
-                            send_not_modified = true;
-                        }
-                    }
+                for (const auto* key : { ETAG, LAST_MODIFIED, VARY })
+                {
+                    auto header = file->headers.find(key);
 
-                    if (send_not_modified)
+                    if (header != file->headers.end())
                     {
-                        reply_with(response,
-                                   std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Modified));
-                    }
-                    else
-                    {
-                        reply_with(response, std::make_unique<responses::FileContentResponse>(search));
+                        not_modified->set_header(key, header->second);
                     }
                 }
 
-                found = true;
+                reply_with(response, std::move(not_modified));
             }
-            else if (info.is_directory())
+            else
             {
-                auto index_path = find_index(search);
+                regular::ByteRanges ranges{};
+                bool partial = method == HTTPMethod::GET && is_range_requested(*file, request_headers, ranges);
+
+                if (partial && !ranges.is_satisfiable())
+                {
+                    auto not_satisfiable =
+                        std::make_unique<responses::ErrorResponse>(ResponseCode::Requested_Range_Not_Satisfiable);
+                    not_satisfiable->set_header(CONTENT_RANGE, regular::ByteRanges::unsatisfied_range(file->size));
+                    reply_with(response, std::move(not_satisfiable));
+                }
+                else if (file->content)
+                {
+                    auto content = std::make_unique<responses::CachedFileResponse>(file);
 
-                if (!index_path.empty())
+                    if (partial)
+                    {
+                        content->set_ranges(std::move(ranges));
+                    }
+
+                    reply_with(response, std::move(content));
+                }
+                else
                 {
-                    auto processed_template = template_processor.process_template(index_path);
+                    // Too large to be cached, serve it from the file system. The cached headers also carry
+                    // the content type and encoding of precompressed files.
+                    auto content = std::make_unique<responses::FileContentResponse>(file->path);
 
-                    if (processed_template)
+                    for (const auto& header : file->headers)
                     {
-                        reply_with(response, std::move(processed_template));
+                        content->set_header(header.first, header.second);
                     }
-                    else
+
+                    if (partial)
                     {
-                        reply_with(response, std::make_unique<responses::FileContentResponse>(index_path));
+                        content->set_ranges(std::move(ranges));
                     }
 
-                    found = true;
+                    reply_with(response, std::move(content));
                 }
             }
         }
+    }
+
+    template<typename ServerType>
+    bool HTTPServer<ServerType>::is_not_modified(const regular::CachedFile& file,
+                                                 const std::unordered_map<std::string, std::string>& request_headers)
+    const
+    {
+        bool not_modified = false;
+
+        // If-None-Match takes precedence over If-Modified-Since, https://tools.ietf.org/html/rfc7232#section-6
+        auto if_none_match = request_headers.find(IF_NONE_MATCH);
 
-        if (!found)
+        if (if_none_match != request_headers.end())
         {
-            reply_with(response, std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Found));
+            const auto& tags = if_none_match->second;
+            not_modified = tags == "*" || tags.find(file.etag) != std::string::npos;
+        }
+        else
+        {
+            auto if_modified_since = request_headers.find(IF_MODIFIED_SINCE);
+
+            if (if_modified_since != request_headers.end())
+            {
+                auto since = utils::parse_http_time(if_modified_since->second);
+                not_modified = since >= std::chrono::system_clock::from_time_t(file.modified);
+            }
         }
+
+        return not_modified;
     }
 
     template<typename ServerType>
-    smooth::core::filesystem::Path HTTPServer<ServerType>::find_index(
-        const smooth::core::filesystem::Path& search_path) const
+    bool HTTPServer<ServerType>::is_range_requested(const regular::CachedFile& file,
+                                                    const std::unordered_map<std::string, std::string>& request_headers,
+                                                    regular::ByteRanges& ranges) const
     {
-        smooth::core::filesystem::Path found_index{};
+        bool requested = false;
+        auto range = request_headers.find(RANGE);
 
-        for (auto index = config.indexes().begin(); found_index.empty() && index != config.indexes().end(); ++index)
+        if (range != request_headers.end() && ranges.parse(range->second, file.size))
         {
-            auto index_path = search_path / *index;
+            // When If-Range doesn't match the current representation the entire representation is sent instead,
+            // https://tools.ietf.org/html/rfc7233#section-3.2
+            auto if_range = request_headers.find(IF_RANGE);
 
-            if (config.web_root().is_parent_of(index_path))
+            if (if_range == request_headers.end())
             {
-                core::filesystem::FileInfo index_info(search_path / *index);
-
-                if (index_info.is_regular_file())
-                {
-                    found_index = search_path / *index;
-                }
+                requested = true;
+            }
+            else if (!if_range->second.empty() && if_range->second.front() == '"')
+            {
+                // Strong comparison; a weak entity tag never matches.
+                requested = if_range->second == file.etag;
+            }
+            else
+            {
+                auto date = utils::parse_http_time(if_range->second);
+                requested = date == std::chrono::system_clock::from_time_t(file.modified);
             }
         }
 
-        return found_index;
+        return requested;
     }
 
     template<typename ServerType>
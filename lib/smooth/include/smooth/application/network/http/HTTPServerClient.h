@@ -23,12 +23,14 @@ limitations under the License.
 #include "smooth/core/network/ServerClient.h"
 #include "smooth/application/network/http/HTTPProtocol.h"
 #include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "smooth/application/network/http/regular/ChunkedEncoding.h"
 #include "smooth/application/network/http/IConnectionTimeoutModifier.h"
 #include "smooth/application/network/http/websocket/WebsocketServer.h"
 #include "regular/IRequestHandler.h"
 #include "URLEncoding.h"
 #include "IServerResponse.h"
 #include "IResponseOperation.h"
+#include "ResponsePacketSource.h"
 
 namespace smooth::application::network::http
 {
@@ -122,6 +124,19 @@ namespace smooth::application::network::http
 
             void send_first_part();
 
+            void send_next_part();
+
+            void close_if_sent();
+
+            ResponseStatus get_first_chunk(std::vector<uint8_t>& data);
+
+            ResponseStatus get_next_chunk(HTTPPacket& packet);
+
+            bool is_sending() const
+            {
+                return current_operation || pull_source || close_when_sent;
+            }
+
             bool translate_method(const HTTPPacket& packet, HTTPMethod& method) const;
 
             const std::size_t content_chunk_size;
@@ -132,8 +147,23 @@ namespace smooth::application::network::http
             URLEncoding encoding{};
             std::deque<std::unique_ptr<IResponseOperation>> operations{};
             std::unique_ptr<IResponseOperation> current_operation{};
+
+            // Set while the socket pulls the remainder of the current response directly from it.
+            std::shared_ptr<ResponsePacketSource> pull_source{};
+
+            // Set while sending a response whose length wasn't known when its headers were sent.
+            bool chunked_response{ false };
+
+            // Cleared for HTTP/1.0 clients, which are sent responses of unknown length by closing the connection.
+            bool peer_accepts_chunked{ true };
+
+            // Set once a response without a length has been started, the connection is closed after it.
+            bool close_when_sent{ false };
             const std::size_t max_enqueued_responses;
 
+            // Kept between events so that its storage goes back to the receive buffer for reuse.
+            HTTPPacket received_packet{};
+
             void set_keep_alive();
     };
 }
@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include "smooth/core/network/BufferContainer.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
@@ -51,6 +52,32 @@ namespace smooth::application::network::http
             // Called at least once when sending a response and until ResponseStatus::AllSent is returned
             virtual ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) = 0;
 
+            /// Responses that can provide their data without copying it into a vector return true
+            /// and implement get_data_view(), which is then called instead of get_data().
+            virtual bool has_data_view() const
+            {
+                return false;
+            }
+
+            /// Provides the next chunk of data as a pointer to memory owned by the response.
+            /// \param max_amount Maximum number of bytes to provide
+            /// \param data Receives the data; the memory must stay valid for as long as the pointer is kept.
+            /// \param length Receives the number of bytes in data.
+            virtual ResponseStatus get_data_view(std::size_t /*max_amount*/,
+                                                 std::shared_ptr<const uint8_t>& /*data*/,
+                                                 std::size_t& /*length*/)
+            {
+                return ResponseStatus::Error;
+            }
+
+            /// Responses whose data views point into memory they already hold return true, allowing the
+            /// socket to request the views itself from the socket dispatcher. Views that have to be read
+            /// from e.g. a file, which may block, must be provided by the HTTP server task.
+            virtual bool can_be_pulled() const
+            {
+                return false;
+            }
+
             /// Sets a header, replacing any existing value
             virtual void set_header(const std::string& /*key*/, const std::string& /*value*/)
             {}
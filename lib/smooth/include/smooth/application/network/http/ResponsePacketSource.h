@@ -0,0 +1,58 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <atomic>
+#include "smooth/core/network/IPacketSource.h"
+#include "smooth/application/network/http/HTTPPacket.h"
+#include "smooth/application/network/http/IResponseOperation.h"
+
+namespace smooth::application::network::http
+{
+    /// Lets the socket pull the remaining chunks of a response directly as it becomes writable, rather than
+    /// having the HTTP task provide each chunk in response to a TransmitBufferEmptyEvent.
+    /// Only responses that can be pulled, i.e. whose views are already in memory, are suitable as the operation
+    /// is called from the socket dispatcher thread.
+    class ResponsePacketSource
+        : public smooth::core::network::IPacketSource<HTTPPacket>
+    {
+        public:
+            ResponsePacketSource(std::unique_ptr<IResponseOperation> operation, std::size_t chunk_size)
+                    : operation(std::move(operation)),
+                      chunk_size(chunk_size)
+            {
+            }
+
+            bool get_next_packet(HTTPPacket& packet) override;
+
+            /// Returns a value indicating if the operation reported an error while being pulled from.
+            /// \return true or false.
+            bool has_failed() const
+            {
+                return failed;
+            }
+
+        private:
+            std::unique_ptr<IResponseOperation> operation;
+            const std::size_t chunk_size;
+            bool done{ false };
+            std::atomic<bool> failed{ false };
+    };
+}
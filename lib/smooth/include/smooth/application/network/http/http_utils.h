@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <string>
 #include <chrono>
+#include <unordered_map>
 #include "smooth/core/filesystem/Path.h"
 #include "regular/HTTPMethod.h"
 
@@ -32,6 +33,12 @@ namespace smooth::application::network::http::utils
 
     std::string get_content_type(const smooth::core::filesystem::Path& path);
 
+    /// Determines if the client accepts the given content coding, per the Accept-Encoding request header.
+    /// \param request_headers The request headers, with lowercase keys.
+    /// \param encoding The content coding, in lowercase, e.g. "gzip".
+    bool accepts_encoding(const std::unordered_map<std::string, std::string>& request_headers,
+                          const std::string& encoding);
+
     time_t timegm(tm& tm);
 
     std::string http_method_to_string(regular::HTTPMethod m);
@@ -0,0 +1,98 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/application/network/http/IResponseOperation.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// A range of bytes, with inclusive bounds as in a Content-Range header.
+    struct ByteRange
+    {
+        std::size_t first;
+        std::size_t last;
+    };
+
+    /// The ranges of a representation requested with a Range header, https://tools.ietf.org/html/rfc7233
+    /// Provides the body of the 206 Partial Content response as a sequence of parts which are either content,
+    /// to be read from the representation at an offset, or the framing of a multipart/byteranges body.
+    class ByteRanges
+    {
+        public:
+            /// Requests with more ranges than this are answered with the entire representation.
+            static constexpr std::size_t max_ranges = 16;
+
+            /// Parses the value of a Range header.
+            /// \param value The header value, e.g. "bytes=0-499,-500"
+            /// \param size The size of the representation
+            /// \return false if the value is not a valid set of byte ranges, in which case the header is ignored.
+            bool parse(const std::string& value, std::size_t size);
+
+            /// \return true if at least one of the parsed ranges overlaps the representation.
+            [[nodiscard]] bool is_satisfiable() const
+            {
+                return !ranges.empty();
+            }
+
+            [[nodiscard]] const std::vector<ByteRange>& get() const
+            {
+                return ranges;
+            }
+
+            /// Builds the body and updates Content-Length, and Content-Range or Content-Type, to match it.
+            /// \param headers The response headers, holding the Content-Type of the representation.
+            void prepare(std::unordered_map<std::string, std::string>& headers);
+
+            /// Gets the next part of the body.
+            /// \param max_amount The maximum number of bytes to provide
+            /// \param framing Receives the framing data, or nullptr when the part is content.
+            /// \param offset Receives the offset into the representation of content.
+            /// \param length Receives the number of bytes
+            ResponseStatus next(std::size_t max_amount,
+                                std::shared_ptr<const uint8_t>& framing,
+                                std::size_t& offset,
+                                std::size_t& length);
+
+            [[nodiscard]] std::size_t content_length() const;
+
+            /// \return The value of a Content-Range header for a response to an unsatisfiable range.
+            static std::string unsatisfied_range(std::size_t size);
+
+        private:
+            struct Part
+            {
+                bool is_framing;
+                std::size_t offset;
+                std::size_t length;
+            };
+
+            bool parse_range(const std::string& spec);
+
+            std::size_t size{ 0 };
+            std::vector<ByteRange> ranges{};
+            std::vector<Part> parts{};
+            std::shared_ptr<const std::string> framing_data{};
+            std::size_t current{ 0 };
+            std::size_t sent{ 0 };
+    };
+}
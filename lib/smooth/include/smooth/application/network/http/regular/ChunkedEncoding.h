@@ -0,0 +1,86 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// Decodes a body sent with Transfer-Encoding: chunked, https://tools.ietf.org/html/rfc7230#section-4.1
+    /// Chunk extensions and trailer fields are skipped.
+    class ChunkedDecoder
+    {
+        public:
+            /// Decodes data in place, i.e. the decoded data is written to the start of the buffer.
+            /// Any data following the end of the body is ignored.
+            /// \param data The received data
+            /// \param length The number of bytes in data
+            /// \return The number of decoded bytes now at the start of data.
+            std::size_t decode(uint8_t* data, std::size_t length);
+
+            /// The number of bytes to read next, without reading beyond the end of the body.
+            /// \param max_amount The maximum number of bytes that may be read
+            [[nodiscard]] std::size_t get_wanted_amount(std::size_t max_amount) const;
+
+            [[nodiscard]] bool is_done() const
+            {
+                return state == State::Done;
+            }
+
+            [[nodiscard]] bool is_error() const
+            {
+                return state == State::Error;
+            }
+
+            void reset();
+
+        private:
+            enum class State
+            {
+                Size,
+                Extension,
+                SizeEnd,
+                Data,
+                DataCR,
+                DataLF,
+                Trailer,
+                TrailerEnd,
+                Done,
+                Error
+            };
+
+            State state{ State::Size };
+            std::size_t remaining{ 0 };
+            std::size_t digits{ 0 };
+            std::size_t line_length{ 0 };
+    };
+
+    /// Helpers for sending data with Transfer-Encoding: chunked.
+    namespace chunked
+    {
+        /// Appends the line that starts a chunk of the given, non-zero, length.
+        void append_chunk_start(std::size_t length, std::vector<uint8_t>& target);
+
+        /// Appends what follows the data of a chunk, and the last chunk ending the body when it is the last one.
+        void append_chunk_end(bool last, std::vector<uint8_t>& target);
+
+        /// Appends the last chunk, ending the body.
+        void append_last_chunk(std::vector<uint8_t>& target);
+    }
+}
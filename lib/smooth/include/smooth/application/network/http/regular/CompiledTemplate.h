@@ -0,0 +1,71 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// A template split into literal text and tokens in the form {{alpha_num}}, so that it only has to be
+    /// searched for tokens once, no matter how many times it is rendered.
+    class CompiledTemplate
+    {
+        public:
+            struct Segment
+            {
+                std::size_t offset;
+                std::size_t length;
+                /// Index into get_tokens() for tokens, npos for literal text.
+                std::size_t token;
+            };
+
+            static constexpr std::size_t npos = std::string::npos;
+
+            explicit CompiledTemplate(std::string template_data);
+
+            /// Returns the text of a segment; the token itself, including braces, for token segments.
+            [[nodiscard]] std::string_view text(const Segment& segment) const
+            {
+                return std::string_view{ data }.substr(segment.offset, segment.length);
+            }
+
+            [[nodiscard]] const std::vector<Segment>& get_segments() const
+            {
+                return segments;
+            }
+
+            /// Returns the distinct tokens present in the template.
+            [[nodiscard]] const std::vector<std::string>& get_tokens() const
+            {
+                return tokens;
+            }
+
+        private:
+            void compile();
+
+            std::size_t find_token_end(std::size_t start) const;
+
+            std::size_t add_token(std::string_view token);
+
+            std::string data;
+            std::vector<Segment> segments{};
+            std::vector<std::string> tokens{};
+    };
+}
@@ -21,7 +21,18 @@ namespace smooth::application::network::http::regular
 {
     extern const char* CONTENT_LENGTH;
     extern const char* CONTENT_TYPE;
+    extern const char* CONTENT_ENCODING;
+    extern const char* CONTENT_RANGE;
+    extern const char* TRANSFER_ENCODING;
+    extern const char* ACCEPT_ENCODING;
+    extern const char* VARY;
     extern const char* LAST_MODIFIED;
+    extern const char* ETAG;
+    extern const char* IF_NONE_MATCH;
+    extern const char* IF_MODIFIED_SINCE;
+    extern const char* ACCEPT_RANGES;
+    extern const char* RANGE;
+    extern const char* IF_RANGE;
     extern const char* CONNECTION;
     extern const char* KEEP_ALIVE;
     extern const char* ORIGIN;
@@ -0,0 +1,133 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace smooth::application::network::http::regular
+{
+    /// Allocation free parser for HTTP/1.1 request and response headers.
+    /// Data is fed incrementally; each call only scans the bytes not seen before for the end
+    /// of the header block. Once the complete header block has been received the start line
+    /// and header fields are parsed into string views referencing the caller's buffer, which
+    /// must therefore be kept unmodified while the parsed values are in use.
+    class HTTPHeaderParser
+    {
+        public:
+            static constexpr std::size_t max_headers = 32;
+            static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+            struct Header
+            {
+                std::string_view name;
+                std::string_view value;
+            };
+
+            enum class Result
+            {
+                Incomplete,
+                Complete,
+                Error
+            };
+
+            /// Parses the headers
+            /// \param data Start of the received data, including data passed in earlier calls.
+            /// \param length Total number of bytes received.
+            /// \return Complete when the header block has been parsed, Incomplete when more data
+            /// is needed and Error if the headers are malformed or there are more than max_headers fields.
+            Result parse(const uint8_t* data, std::size_t length);
+
+            /// Prepares the parser for a new message.
+            void reset();
+
+            /// Finds the empty line (CRLFCRLF) ending a header block.
+            /// \return The offset of the CRLFCRLF sequence, or npos if not found.
+            static std::size_t find_header_end(const uint8_t* data, std::size_t length, std::size_t start);
+
+            /// \return Size of the header block, including the terminating empty line.
+            [[nodiscard]] std::size_t header_size() const
+            {
+                return header_end;
+            }
+
+            [[nodiscard]] bool is_request() const
+            {
+                return request;
+            }
+
+            [[nodiscard]] std::string_view method() const
+            {
+                return request_method;
+            }
+
+            [[nodiscard]] std::string_view url() const
+            {
+                return request_url;
+            }
+
+            [[nodiscard]] std::string_view version() const
+            {
+                return http_version;
+            }
+
+            [[nodiscard]] int status_code() const
+            {
+                return status;
+            }
+
+            [[nodiscard]] const Header* begin() const
+            {
+                return headers.data();
+            }
+
+            [[nodiscard]] const Header* end() const
+            {
+                return headers.data() + header_count;
+            }
+
+            [[nodiscard]] std::size_t size() const
+            {
+                return header_count;
+            }
+
+            /// Finds the value of the first header with the given name, ignoring case.
+            /// \return The value, or an empty view if there is no such header.
+            [[nodiscard]] std::string_view get(std::string_view name) const;
+
+        private:
+            bool parse_block(std::string_view block);
+
+            bool parse_start_line(std::string_view line);
+
+            bool parse_header(std::string_view line);
+
+            std::size_t scan_pos{ 0 };
+            std::size_t header_end{ 0 };
+            bool complete{ false };
+            bool request{ false };
+            std::string_view request_method{};
+            std::string_view request_url{};
+            std::string_view http_version{};
+            int status{ 0 };
+            std::array<Header, max_headers> headers{};
+            std::size_t header_count{ 0 };
+    };
+}
@@ -23,6 +23,7 @@ limitations under the License.
 #include "smooth/application/network/http/IServerResponse.h"
 #include "smooth/application/network/http/IConnectionTimeoutModifier.h"
 #include "smooth/application/network/http/regular/MIMEParser.h"
+#include "smooth/application/network/http/regular/RouteParameters.h"
 
 namespace smooth::application::network::http::regular
 {
@@ -66,6 +67,11 @@ namespace smooth::application::network::http::regular
                                     const std::unordered_map<std::string, std::string>& headers,
                                     const std::unordered_map<std::string, std::string>& request_parameters);
 
+            void set_route_parameters(const RouteParameters& parameters)
+            {
+                route_params = parameters;
+            }
+
         protected:
             MIMEParser mime{};
 
@@ -87,6 +93,10 @@ namespace smooth::application::network::http::regular
                 return *request_params.request_parameters;
             }
 
+            /// Returns the values of the {param} segments and trailing wildcard of the route the
+            /// current request matched, e.g. "id" for "/api/sensor/{id}".
+            const RouteParameters& route_parameters() const { return route_params; }
+
         private:
             /// This structure holds parameters for the current request,
             /// to be accessed via above methods.
@@ -100,5 +110,6 @@ namespace smooth::application::network::http::regular
             };
 
             RequestParams request_params{};
+            RouteParameters route_params{};
     };
 }
@@ -17,7 +17,9 @@ limitations under the License.
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <functional>
 #include <regex>
 #include <vector>
 #include <tuple>
@@ -53,6 +55,12 @@ namespace smooth::application::network::http::regular
     static const uint8_t LEN_OF_CRLF = 2;
     const std::vector<uint8_t> equal{ '=' };
 
+    /// Streaming parser for multipart/form-data and application/x-www-form-urlencoded request bodies.
+    ///
+    /// Multipart data passes through a window of chunksize bytes plus the length of the boundary. Parts are
+    /// handed to IFormData::form_data() as iterators into the window, either when a boundary is found or once
+    /// chunksize bytes are known not to contain one. Only the few bytes that may be the start of a boundary
+    /// are kept between calls to parse(), so each received byte is copied once and scanned once.
     class MIMEParser
     {
         public:
@@ -69,6 +77,16 @@ namespace smooth::application::network::http::regular
 
             bool detect_mode(const std::string& content_type, std::size_t content_length);
 
+            /// Detects the mode of a request without a Content-Length, i.e. one sent chunked. URL encoded data
+            /// is then held until set_last_part() says that the end of the request has been passed to parse().
+            bool detect_mode(const std::string& content_type);
+
+            /// Marks whether the data given to the next call to parse() is the last part of the request.
+            void set_last_part(bool last)
+            {
+                last_part = last;
+            }
+
             void reset() noexcept;
 
             void parse(const std::vector<uint8_t>& p, IFormData& form_data,
@@ -93,17 +111,41 @@ namespace smooth::application::network::http::regular
             enum class ParseStatus
             {
                 Begin,
+                AfterBoundary,
                 Headers,
-                Data
+                Data,
+                Done
             };
 
-            auto find_boundary() const;
+            /// Boyer-Moore-Horspool search for a fixed pattern.
+            class BoundaryMatcher
+            {
+                public:
+                    void set_pattern(const std::string& p);
+
+                    void clear();
+
+                    [[nodiscard]] std::size_t size() const
+                    {
+                        return pattern.size();
+                    }
+
+                    /// Searches data for the pattern, starting at from. On return, from holds the position of the
+                    /// match or, if none was found, the first position where a match may start once more data
+                    /// has been received.
+                    /// \return true if the pattern was found.
+                    bool find(const MimeData& data, std::size_t& from) const;
+
+                private:
+                    std::vector<uint8_t> pattern{};
+                    std::array<std::size_t, 256> skip{};
+            };
 
-            auto find_end_boundary() const;
+            void parse_form_data(IFormData& form_data, std::size_t chunksize, std::size_t capacity);
 
-            BoundaryIterator get_end_of_boundary(BoundaryIterator begin);
+            void consume(std::size_t count);
 
-            bool is_crlf(BoundaryIterator start) const;
+            void set_status(ParseStatus status);
 
             std::tuple<BoundaryIterator,
                        std::unordered_map<std::string, std::string>,
@@ -113,17 +155,19 @@ namespace smooth::application::network::http::regular
             std::string id{};
             std::string filename{};
             bool first_part{ false };
-            bool end_of_transmission{ false };
-            std::vector<uint8_t> boundary{};
-            std::vector<uint8_t> end_boundary{};
+            BoundaryMatcher first_boundary{};
+            BoundaryMatcher boundary{};
+            BoundaryMatcher end_of_headers{};
             std::vector<uint8_t> data{};
+            std::size_t scanned{ 0 };
             std::unordered_map<std::string, std::string> form_url_encoded_data{};
             const std::regex form_data_pattern{ R"!(multipart\/form-data;.*boundary=(.+?)( |$))!" };
             const std::regex url_encoded_pattern{ R"!(application\/x-www-form-urlencoded)!" };
-            const std::vector<uint8_t> crlf{ '\r', '\n' };
             const std::vector<uint8_t> crlf_double{ '\r', '\n', '\r', '\n' };
             Mode mode{ Mode::None };
             std::size_t expected_content_length{ 0 };
+            bool length_known{ true };
+            bool last_part{ false };
             ParseStatus parse_status{ ParseStatus::Begin };
 
             void parse_content_disposition(const std::unordered_map<std::string, std::string>& headers,
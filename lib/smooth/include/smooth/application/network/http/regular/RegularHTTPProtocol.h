@@ -17,11 +17,12 @@ limitations under the License.
 
 #pragma once
 
-#include <regex>
 #include "smooth/core/network/IPacketAssembly.h"
 #include "smooth/application/network/http/HTTPPacket.h"
 #include "smooth/application/network/http/IServerResponse.h"
 #include "IUpgradeToWebsocket.h"
+#include "HTTPHeaderParser.h"
+#include "ChunkedEncoding.h"
 
 namespace smooth::application::network::http::regular
 {
@@ -57,7 +58,9 @@ namespace smooth::application::network::http::regular
             void reset() override;
 
         private:
-            int consume_headers(HTTPPacket& packet, std::vector<uint8_t>::const_iterator header_ending);
+            int consume_headers(HTTPPacket& packet);
+
+            [[nodiscard]] bool is_content_received() const;
 
             enum class State
             {
@@ -75,8 +78,15 @@ namespace smooth::application::network::http::regular
             int incoming_content_length{ 0 };
             int actual_header_size{ 0 };
 
-            const std::regex response_line{ R"!(HTTP\/(\d.\d)\ (\d+)\ (.+))!" }; // HTTP/1.1 200 OK
-            const std::regex request_line{ R"!((.+)\ (.+)\ HTTP\/(\d\.\d))!" }; // "GET / HTTP/1.1"
+            HTTPHeaderParser parser{};
+
+            // Requests sent with Transfer-Encoding: chunked have no Content-Length, the body ends
+            // when the decoder says so.
+            bool chunked_content{ false };
+            ChunkedDecoder chunked_decoder{};
+
+            // Set once a part of the current request has been handed over, making the following parts continuations.
+            bool part_delivered{ false };
 
             bool error = false;
             State state = State::reading_headers;
@@ -0,0 +1,73 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "HTTPMethod.h"
+#include "RouteParameters.h"
+
+namespace smooth::application::network::http::regular
+{
+    class HTTPRequestHandler;
+
+    /// Maps request URLs to handlers using a compressed radix tree per HTTP method.
+    ///
+    /// Besides plain URLs, routes may contain parameter segments, e.g. "/api/sensor/{id}", matching
+    /// a single, non-empty path segment, and end with a wildcard, e.g. "/static/*", matching the
+    /// remainder of the URL. Static segments take precedence over parameters, which take precedence
+    /// over wildcards. Matching does not allocate memory and, unless a static segment and a parameter
+    /// both match the start of a URL segment, visits each character of the URL once.
+    class RequestRouter
+    {
+        public:
+            /// Adds a route, replacing any existing handler for the same route.
+            /// \return false if the route is malformed, has too many parameters or uses a different
+            /// parameter name than an already added route at the same position.
+            bool add(HTTPMethod method, const std::string& route, std::shared_ptr<HTTPRequestHandler> handler);
+
+            /// Finds the handler for the URL
+            /// \param method The request method
+            /// \param url The requested URL, without any query string.
+            /// \param parameters Receives the route parameters, valid for as long as url is.
+            /// \return The handler, or nullptr if no route matches.
+            [[nodiscard]] HTTPRequestHandler* find(HTTPMethod method,
+                                                   std::string_view url,
+                                                   RouteParameters& parameters) const;
+
+        private:
+            struct Node
+            {
+                std::string prefix{};
+                std::vector<std::unique_ptr<Node>> children{};
+                std::unique_ptr<Node> parameter{};
+                std::string parameter_name{};
+                std::unique_ptr<Node> wildcard{};
+                std::shared_ptr<HTTPRequestHandler> handler{};
+            };
+
+            static Node* insert_static(Node& node, std::string_view path);
+
+            static const Node* match(const Node& node, std::string_view path, RouteParameters& parameters);
+
+            std::unordered_map<HTTPMethod, Node> roots{};
+    };
+}
@@ -0,0 +1,108 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <string_view>
+
+namespace smooth::application::network::http::regular
+{
+    /// The values of the {param} segments and trailing wildcard of a matched route, as views into the route
+    /// and the requested URL. They are only valid while the request is being handled.
+    class RouteParameters
+    {
+        public:
+            static constexpr std::size_t max_parameters = 8;
+
+            /// The name under which the part of the URL matched by a trailing wildcard is available.
+            static constexpr std::string_view wildcard = "*";
+
+            /// Returns the value of the named parameter, or an empty view if there is no such parameter.
+            [[nodiscard]] std::string_view get(std::string_view name) const
+            {
+                std::string_view res{};
+                bool found = false;
+
+                for (std::size_t i = 0; !found && i < count; ++i)
+                {
+                    found = parameters[i].name == name;
+
+                    if (found)
+                    {
+                        res = parameters[i].value;
+                    }
+                }
+
+                return res;
+            }
+
+            [[nodiscard]] bool has(std::string_view name) const
+            {
+                bool found = false;
+
+                for (std::size_t i = 0; !found && i < count; ++i)
+                {
+                    found = parameters[i].name == name;
+                }
+
+                return found;
+            }
+
+            [[nodiscard]] std::size_t size() const
+            {
+                return count;
+            }
+
+            [[nodiscard]] bool empty() const
+            {
+                return count == 0;
+            }
+
+            bool push(std::string_view name, std::string_view value)
+            {
+                bool res = count < max_parameters;
+
+                if (res)
+                {
+                    parameters[count++] = { name, value };
+                }
+
+                return res;
+            }
+
+            void truncate(std::size_t size)
+            {
+                count = size < count ? size : count;
+            }
+
+            void clear()
+            {
+                count = 0;
+            }
+
+        private:
+            struct Parameter
+            {
+                std::string_view name;
+                std::string_view value;
+            };
+
+            std::array<Parameter, max_parameters> parameters{};
+            std::size_t count{ 0 };
+    };
+}
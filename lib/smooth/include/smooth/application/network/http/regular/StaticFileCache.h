@@ -0,0 +1,124 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/core/filesystem/Path.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// A file beneath the web root, as resolved and loaded by StaticFileCache.
+    struct CachedFile
+    {
+        smooth::core::filesystem::Path path{};
+        std::time_t modified{ 0 };
+        std::size_t size{ 0 };
+        std::string etag{};
+
+        /// Content-Type, Content-Length, Last-Modified, ETag and, except for templates, Accept-Ranges
+        std::unordered_map<std::string, std::string> headers{};
+
+        /// The contents of the file, or nullptr for templates and files too large to keep in memory.
+        std::shared_ptr<const std::vector<uint8_t>> content{};
+
+        /// The precompressed variant of the file, i.e. foo.js.gz next to foo.js, or nullptr if there is none.
+        /// Its headers carry the Content-Type of the original file and Content-Encoding: gzip.
+        std::shared_ptr<const CachedFile> gzipped{};
+    };
+
+    /// Keeps the most recently requested files in memory, within a budget of bytes, so that they can be served
+    /// without accessing the file system. Entries are keyed by the normalized URL path and hold the file it resolves
+    /// to, including the index file for directories. A cached file is trusted for the revalidation interval after
+    /// which its modification time and size are checked again. A gzip-compressed sibling of a file is loaded along
+    /// with it, so that it can be served to clients that accept it.
+    class StaticFileCache
+    {
+        public:
+            /// \param web_root The directory files are served from
+            /// \param index_files The names of index files, in order of preference
+            /// \param template_files Extensions of files whose contents should not be cached
+            /// \param max_size Maximum number of bytes to keep in the cache
+            /// \param max_file_size Files larger than this are resolved, but their contents are not cached.
+            /// \param revalidate_interval How long a cached file is used before checking if it has changed.
+            StaticFileCache(smooth::core::filesystem::Path web_root,
+                            std::vector<std::string> index_files,
+                            std::set<std::string> template_files,
+                            std::size_t max_size,
+                            std::size_t max_file_size,
+                            std::chrono::milliseconds revalidate_interval);
+
+            /// Gets the file that serves the URL.
+            /// \return The file, or nullptr if the URL doesn't resolve to a file beneath the web root.
+            std::shared_ptr<const CachedFile> get(const std::string& url);
+
+            /// \return The number of bytes currently held by the cache.
+            std::size_t size() const;
+
+            void clear();
+
+        private:
+            struct Entry
+            {
+                std::string url;
+                std::shared_ptr<const CachedFile> file;
+                std::chrono::steady_clock::time_point validated;
+                std::size_t cost;
+            };
+
+            using Entries = std::list<Entry>;
+
+            std::shared_ptr<const CachedFile> get_normalized(const std::string& url);
+
+            std::shared_ptr<const CachedFile> load(const std::string& url) const;
+
+            std::shared_ptr<CachedFile> load_file(const smooth::core::filesystem::Path& path,
+                                                  const smooth::core::filesystem::Path& content_path,
+                                                  bool is_template) const;
+
+            smooth::core::filesystem::Path find_index(const smooth::core::filesystem::Path& search_path) const;
+
+            bool is_unchanged(const CachedFile& file) const;
+
+            void insert(const std::string& url,
+                        std::shared_ptr<const CachedFile> file,
+                        std::chrono::steady_clock::time_point now);
+
+            void remove(Entries::iterator entry);
+
+            const smooth::core::filesystem::Path web_root;
+            const std::vector<std::string> index_files;
+            const std::set<std::string> template_files;
+            const std::size_t max_size;
+            const std::size_t max_file_size;
+            const std::chrono::milliseconds revalidate_interval;
+
+            // Most recently used first
+            Entries entries{};
+            std::unordered_map<std::string, Entries::iterator> lookup{};
+            std::size_t used{ 0 };
+            mutable std::mutex guard{};
+    };
+}
@@ -18,15 +18,19 @@ limitations under the License.
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <set>
-#include <regex>
 #include <string>
+#include <unordered_map>
 #include "smooth/core/filesystem/Path.h"
-#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "smooth/application/network/http/IResponseOperation.h"
+#include "CompiledTemplate.h"
 #include "ITemplateDataRetriever.h"
 
 namespace smooth::application::network::http::regular
 {
+    /// Renders files with the configured extensions as templates. Each template is compiled once and kept
+    /// until the file changes; responses are then rendered as they are sent.
     class TemplateProcessor
     {
         public:
@@ -42,8 +46,18 @@ namespace smooth::application::network::http::regular
 
             void process_template(std::string& template_data) const;
 
+            std::shared_ptr<const CompiledTemplate> get_compiled(const smooth::core::filesystem::Path& path);
+
+            struct CacheEntry
+            {
+                time_t modified;
+                std::size_t size;
+                std::shared_ptr<const CompiledTemplate> compiled;
+            };
+
             std::set<std::string> template_files;
             std::shared_ptr<ITemplateDataRetriever> data_retriever;
-            const std::regex token{ R"!(\{\{[\d\_\-a-zA-Z]+\}\})!", std::regex::ECMAScript };
+            std::unordered_map<std::string, CacheEntry> cache{};
+            std::mutex cache_guard{};
     };
 }
@@ -0,0 +1,60 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include "HeaderOnlyResponse.h"
+#include "smooth/application/network/http/regular/StaticFileCache.h"
+#include "smooth/application/network/http/regular/ByteRanges.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Sends a file held by the StaticFileCache, using its precomputed headers and content.
+    class CachedFileResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            explicit CachedFileResponse(std::shared_ptr<const CachedFile> file);
+
+            /// Sends only the given, satisfiable, ranges of the file as a 206 Partial Content response.
+            void set_ranges(ByteRanges byte_ranges);
+
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            bool has_data_view() const override
+            {
+                return true;
+            }
+
+            bool can_be_pulled() const override
+            {
+                return true;
+            }
+
+            ResponseStatus get_data_view(std::size_t max_amount,
+                                         std::shared_ptr<const uint8_t>& data,
+                                         std::size_t& length) override;
+
+            void dump() const override;
+
+        private:
+            std::shared_ptr<const CachedFile> file;
+            std::size_t sent{ 0 };
+            ByteRanges ranges{};
+    };
+}
@@ -20,6 +20,8 @@ limitations under the License.
 #include "StringResponse.h"
 #include "smooth/core/filesystem/Path.h"
 #include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/core/filesystem/FileReader.h"
+#include "smooth/application/network/http/regular/ByteRanges.h"
 
 namespace smooth::application::network::http::regular::responses
 {
@@ -29,14 +31,28 @@ namespace smooth::application::network::http::regular::responses
         public:
             explicit FileContentResponse(smooth::core::filesystem::Path full_path);
 
+            /// Sends only the given, satisfiable, ranges of the file as a 206 Partial Content response.
+            /// Call after any other headers have been set, as it replaces Content-Length and Content-Type.
+            void set_ranges(ByteRanges byte_ranges);
+
             // Called at least once when sending a response and until ResponseStatus::AllSent is returned
             ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
 
+            bool has_data_view() const override;
+
+            ResponseStatus get_data_view(std::size_t max_amount,
+                                         std::shared_ptr<const uint8_t>& data,
+                                         std::size_t& length) override;
+
             void dump() const override;
 
         private:
             smooth::core::filesystem::Path path;
             smooth::core::filesystem::FileInfo info;
+            // Keeps the file open for the duration of the response; nullptr when the file
+            // instead is opened and read for each chunk.
+            std::shared_ptr<smooth::core::filesystem::FileReader> reader;
             std::size_t sent{ 0 };
+            ByteRanges ranges{};
     };
 }
@@ -0,0 +1,53 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "HeaderOnlyResponse.h"
+#include "smooth/application/compression/GzipCompressor.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Compresses the data of another response with gzip, for clients that accept it.
+    /// The response is compressed as it is sent, so it has no Content-Length and is sent in chunks.
+    class GzipResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            /// \param response The response to compress
+            /// \param window_bits Size of the compression window, see GzipCompressor.
+            GzipResponse(std::unique_ptr<IResponseOperation> response, uint8_t window_bits);
+
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            void dump() const override;
+
+        private:
+            void read_response(std::size_t amount);
+
+            std::unique_ptr<IResponseOperation> response;
+            smooth::application::compression::GzipCompressor compressor;
+
+            // Compressed data not yet sent
+            std::vector<uint8_t> pending{};
+            std::vector<uint8_t> part{};
+            std::size_t sent{ 0 };
+            bool failed{ false };
+    };
+}
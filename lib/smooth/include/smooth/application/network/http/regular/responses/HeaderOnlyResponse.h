@@ -49,6 +49,9 @@ namespace smooth::application::network::http::regular::responses
             void dump() const override;
 
         protected:
+            /// Uses the given headers as they are, instead of adding Last-Modified.
+            HeaderOnlyResponse(ResponseCode code, std::unordered_map<std::string, std::string> initial_headers);
+
             ResponseCode code;
     };
 }
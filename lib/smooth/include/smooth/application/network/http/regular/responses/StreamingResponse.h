@@ -0,0 +1,48 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "HeaderOnlyResponse.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Sends data as it is produced, for responses whose length isn't known up front such as exports and logs.
+    /// The response has no Content-Length, so it is sent using Transfer-Encoding: chunked.
+    class StreamingResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            /// Called each time the server is ready to send more data. Appends at most max_amount bytes to
+            /// target and returns ResponseStatus::HasMoreData, or ResponseStatus::LastData once done.
+            using Producer = std::function<ResponseStatus(std::size_t max_amount, std::vector<uint8_t>& target)>;
+
+            StreamingResponse(ResponseCode code, const std::string& content_type, Producer producer);
+
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            void dump() const override;
+
+        private:
+            Producer producer;
+            std::size_t sent{ 0 };
+            bool done{ false };
+    };
+}
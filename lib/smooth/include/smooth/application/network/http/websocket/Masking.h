@@ -0,0 +1,32 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace smooth::application::network::http::websocket
+{
+    /// Applies (or removes, the operation is symmetric) the websocket masking key to data.
+    /// \param data The data to mask, modified in place.
+    /// \param length Number of bytes in data.
+    /// \param key The four byte masking key from the frame header.
+    /// \param offset Position of data[0] within the frame payload; advanced by length so that the next part
+    /// of the same payload continues with the correct byte of the key.
+    void apply_mask(uint8_t* data, std::size_t length, const uint8_t (& key)[4], uint64_t& offset);
+}
@@ -34,15 +34,22 @@ limitations under the License.
 
 #pragma once
 
+#include <array>
+#include <memory>
+#include <vector>
 #include "smooth/application/network/http/IResponseOperation.h"
 #include "smooth/application/network/http/websocket/OpCode.h"
 
 namespace smooth::application::network::http::websocket::responses
 {
+    /// A single websocket frame. The frame header is built up front and the payload is sent
+    /// in place, in parts of at most the requested size, without being copied.
     class WSResponse
         : public IResponseOperation
     {
         public:
+            using Payload = std::shared_ptr<const std::vector<uint8_t>>;
+
             explicit WSResponse(smooth::application::network::http::websocket::OpCode code);
 
             explicit WSResponse(const std::string& text, bool first_fragment, bool last_fragment);
@@ -54,18 +61,44 @@ namespace smooth::application::network::http::websocket::responses
 
             explicit WSResponse(std::vector<uint8_t>&& binary, bool first_fragment, bool last_fragment);
 
+            /// Sends a payload that may be shared with other responses, such as when broadcasting
+            /// the same message to multiple clients.
+            explicit WSResponse(Payload payload, bool treat_as_text, bool first_fragment, bool last_fragment);
+
             ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
 
-        private:
-            bool header_sent{ false };
+            bool has_data_view() const override
+            {
+                return true;
+            }
 
-            void set_length(uint64_t len, std::vector<uint8_t>& buff) const;
+            bool can_be_pulled() const override
+            {
+                return true;
+            }
 
-            smooth::application::network::http::websocket::OpCode op_code;
+            ResponseStatus get_data_view(std::size_t max_amount,
+                                         std::shared_ptr<const uint8_t>& data,
+                                         std::size_t& length) override;
 
-            bool first_fragment{ true };
-            bool last_fragment{ true };
+        private:
+            void build_header(bool first_fragment, bool last_fragment);
+
+            [[nodiscard]] std::size_t remaining() const
+            {
+                return payload->size() - sent;
+            }
+
+            [[nodiscard]] ResponseStatus status() const
+            {
+                return remaining() > 0 ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+            }
 
-            std::vector<uint8_t> data{};
+            smooth::application::network::http::websocket::OpCode op_code;
+            Payload payload;
+            std::size_t sent{ 0 };
+            bool header_sent{ false };
+            std::array<uint8_t, 10> header{};
+            std::size_t header_length{ 0 };
     };
 }
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <vector>
 #include <chrono>
+#include <utility>
 #include "smooth/core/timer/ElapsedTime.h"
 #include "smooth/application/network/mqtt/packet/PubAck.h"
 #include "smooth/application/network/mqtt/packet/PubComp.h"
@@ -37,6 +38,11 @@ namespace smooth::application::network::mqtt
             {
             }
 
+            explicit InFlight(T&& p)
+                    : p(std::move(p))
+            {
+            }
+
             T& get_packet()
             {
                 return p;
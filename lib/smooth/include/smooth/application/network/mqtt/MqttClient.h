@@ -114,6 +114,15 @@ namespace smooth::application::network::mqtt
             bool
             publish(const std::string& topic, const uint8_t* data, int length, mqtt::QoS qos, bool retain);
 
+            /// Sets the number of outgoing messages with QoS 1 or 2 that may be waiting for their
+            /// acknowledgement at the same time. Defaults to CONFIG_SMOOTH_MQTT_SEND_WINDOW.
+            /// If needed, the number of messages that can be queued is raised to match the window.
+            /// \param size The window size, minimum 1.
+            void set_send_window(size_t size)
+            {
+                publication.set_send_window(size);
+            }
+
             /// Subscribes to a topic.
             /// \param topic The topic
             /// \param qos The QoS to use for subscription.
@@ -204,5 +213,8 @@ namespace smooth::application::network::mqtt
             bool connected = false;
             std::mutex address_guard{};
             std::shared_ptr<smooth::core::network::BufferContainer<packet::MQTTProtocol>> buff{};
+
+            // Kept between events so that its storage goes back to the receive buffer for reuse.
+            packet::MQTTPacket received_packet{};
     };
 }
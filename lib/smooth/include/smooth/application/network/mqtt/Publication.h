@@ -17,9 +17,12 @@ limitations under the License.
 
 #pragma once
 
+#include <cstdint>
+#include <deque>
 #include <vector>
 #include <chrono>
 #include <mutex>
+#include <unordered_map>
 #include "smooth/core/timer/ElapsedTime.h"
 #include "smooth/application/network/mqtt/packet/PubAck.h"
 #include "smooth/application/network/mqtt/packet/PubComp.h"
@@ -30,6 +33,9 @@ limitations under the License.
 
 namespace smooth::application::network::mqtt
 {
+    /// Keeps track of outgoing messages. Messages are sent in the order they are published. Up to
+    /// 'send window' messages with QoS 1 or 2 may be in flight, i.e. waiting for their acknowledgement,
+    /// at the same time. Messages with QoS 0 do not take up room in the window.
     class Publication
     {
         public:
@@ -50,8 +56,40 @@ namespace smooth::application::network::mqtt
 
             void receive(packet::PubComp& pub_rel, IMqttClient& mqtt);
 
+            /// Sets the number of messages with QoS 1 or 2 that may be in flight at the same time.
+            /// The number of outgoing messages that can be queued is raised to match, if needed.
+            /// \param size The window size, minimum 1.
+            void set_send_window(size_t size);
+
         private:
-            std::vector<InFlight<packet::Publish>> in_progress{};
+            struct Outgoing
+            {
+                Outgoing(packet::Publish&& packet, uint32_t sequence)
+                        : flight(std::move(packet)),
+                          sequence(sequence)
+                {
+                }
+
+                InFlight<packet::Publish> flight;
+                uint32_t sequence;
+            };
+
+            [[nodiscard]] size_t max_outgoing() const;
+
+            /// Sends messages that were in flight when the connection was lost, as well as PubRel
+            /// that couldn't be sent earlier.
+            /// \return true if all have been sent.
+            bool resend_in_flight(IMqttClient& mqtt);
+
+            void send_pending(IMqttClient& mqtt);
+
+            bool has_timed_out(IMqttClient& mqtt);
+
+            std::deque<packet::Publish> pending{};
+            std::unordered_map<uint16_t, Outgoing> in_flight{};
+            std::vector<uint16_t> to_resend{};
+            size_t send_window;
+            uint32_t next_sequence = 0;
             std::mutex guard{};
     };
 }
@@ -33,8 +33,27 @@ namespace smooth::application::network::mqtt::packet
     {
         friend class MQTTProtocol;
         public:
+            MQTTPacket() = default;
+
+            MQTTPacket(const MQTTPacket&) = default;
+
+            MQTTPacket& operator=(const MQTTPacket&) = default;
+
+            MQTTPacket(MQTTPacket&&) = default;
+
+            MQTTPacket& operator=(MQTTPacket&&) = default;
+
             ~MQTTPacket() override = default;
 
+            /// Returns the packet to its default state, keeping allocated storage for reuse.
+            void recycle()
+            {
+                data.clear();
+                variable_header_start_ix = 0;
+                error = false;
+                too_big = false;
+            }
+
             virtual std::vector<uint8_t>::const_iterator get_payload_cbegin() const
             {
                 return data.cend();
@@ -34,6 +34,8 @@ namespace smooth::application::network::mqtt::state
 
             void tick() override;
 
+            void event(const core::network::event::TransmitBufferEmptyEvent& event) override;
+
             // For publishing
             void receive(packet::PubAck& pub_ack) override;
 
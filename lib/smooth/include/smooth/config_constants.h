@@ -5,8 +5,20 @@
 // Values used when compiling Smooth for the host system.
 const int CONFIG_SMOOTH_MAX_MQTT_MESSAGE_SIZE = 512;
 const int CONFIG_SMOOTH_MAX_MQTT_OUTGOING_MESSAGES = 10;
+const int CONFIG_SMOOTH_MQTT_SEND_WINDOW = 1;
 const int SMOOTH_MQTT_LOGGING_LEVEL = 1;
 const int CONFIG_SMOOTH_SOCKET_DISPATCHER_STACK_SIZE = 20480;
 const int CONFIG_SMOOTH_TIMER_SERVICE_STACK_SIZE = 3072;
+const int CONFIG_SMOOTH_SOCKET_READ_AHEAD_SIZE = 512;
 const int CONFIG_LWIP_MAX_SOCKETS = 10;
+const int CONFIG_SMOOTH_TLS_SESSION_CACHE_SIZE = 8;
+const int CONFIG_SMOOTH_TLS_SESSION_LIFETIME = 86400;
+const int CONFIG_SMOOTH_TLS_MAX_FRAGMENT_LENGTH = 4096;
+const int CONFIG_SMOOTH_CRYPTO_WORKER_COUNT = 1;
+const int CONFIG_SMOOTH_CRYPTO_WORKER_STACK_SIZE = 8192;
+const int CONFIG_SMOOTH_HTTP_FILE_CACHE_SIZE = 1048576;
+const int CONFIG_SMOOTH_HTTP_FILE_CACHE_MAX_FILE_SIZE = 65536;
+const int CONFIG_SMOOTH_HTTP_FILE_CACHE_REVALIDATE_MS = 1000;
+const int CONFIG_SMOOTH_HTTP_GZIP_WINDOW_BITS = 12;
+const int CONFIG_SMOOTH_HTTP_RESPONSE_LOOK_AHEAD = 2;
 #endif
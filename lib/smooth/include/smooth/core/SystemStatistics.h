@@ -25,7 +25,7 @@ namespace smooth::core
         public:
             TaskStats() = default;
 
-            explicit TaskStats(uint32_t stack_size);
+            explicit TaskStats(uint32_t stack_size, uint64_t event_count = 0, uint64_t wakeup_count = 0);
 
             TaskStats(const TaskStats&) = default;
 
@@ -45,12 +45,51 @@ namespace smooth::core
                 return high_water_mark;
             }
 
+            [[nodiscard]] uint64_t get_event_count() const noexcept
+            {
+                return event_count;
+            }
+
+            [[nodiscard]] uint64_t get_wakeup_count() const noexcept
+            {
+                return wakeup_count;
+            }
+
         private:
             uint32_t stack_size{};
             uint32_t high_water_mark{};
+            uint64_t event_count{};
+            uint64_t wakeup_count{};
     };
 
-    /// \brief Displays system statistics; memory and stack usage.
+    class ConnectionStats
+    {
+        public:
+            ConnectionStats() = default;
+
+            ConnectionStats(uint32_t count, uint32_t bytes_per_connection)
+                    : count(count),
+                      bytes_per_connection(bytes_per_connection)
+            {
+            }
+
+            [[nodiscard]] uint32_t get_count() const noexcept
+            {
+                return count;
+            }
+
+            [[nodiscard]] uint32_t get_bytes_per_connection() const noexcept
+            {
+                return bytes_per_connection;
+            }
+
+        private:
+            uint32_t count{};
+            uint32_t bytes_per_connection{};
+    };
+
+    /// \brief Displays system statistics; memory and stack usage, events per wakeup and memory held by
+    /// open connections.
     class SystemStatistics
     {
         public:
@@ -69,6 +108,13 @@ namespace smooth::core
                 task_info[task_name] = stats;
             }
 
+            /// Reports the number of open connections of a kind and the memory each of them holds.
+            void report(const std::string& connection_type, ConnectionStats&& stats) noexcept
+            {
+                synch guard{ lock };
+                connection_info[connection_type] = stats;
+            }
+
             void dump() const noexcept;
 
         private:
@@ -80,5 +126,6 @@ namespace smooth::core
 
             mutable std::mutex lock{};
             std::unordered_map<std::string, TaskStats> task_info{};
+            std::unordered_map<std::string, ConnectionStats> connection_info{};
     };
 }
@@ -21,7 +21,9 @@ limitations under the License.
 #include <chrono>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 #include <condition_variable>
 
 #include <thread>
@@ -67,6 +69,26 @@ namespace smooth::core
 
             void unregister_polled_queue_with_task(smooth::core::ipc::IPolledTaskQueue* polled_queue);
 
+            /// Sets the maximum number of events forwarded to the event listeners per wakeup.
+            /// Events are always forwarded in the order they were sent, also across queues.
+            /// Larger batches reduce the overhead per event under load, at the cost of the
+            /// tick() possibly being delayed further. Defaults to 1. Must be called from within the task,
+            /// or before it is started.
+            /// \param size Number of events, minimum 1.
+            void set_event_batch_size(size_t size);
+
+            /// \return The number of events forwarded to the event listeners.
+            [[nodiscard]] uint64_t get_event_count() const
+            {
+                return event_count;
+            }
+
+            /// \return The number of times the task woke up to forward one or more events.
+            [[nodiscard]] uint64_t get_wakeup_count() const
+            {
+                return wakeup_count;
+            }
+
             Task(const Task&) = delete;
 
             Task& operator=(const Task&) = delete;
@@ -126,5 +148,9 @@ namespace smooth::core
             std::condition_variable start_condition{};
             smooth::core::timer::ElapsedTime status_report_timer{};
             std::vector<smooth::core::ipc::IPolledTaskQueue*> polled_queues{};
+            std::vector<std::weak_ptr<smooth::core::ipc::ITaskEventQueue>> event_batch{};
+            size_t event_batch_size = 1;
+            uint64_t event_count = 0;
+            uint64_t wakeup_count = 0;
     };
 }
@@ -33,8 +33,16 @@ namespace smooth::core::filesystem
 
             FSLock();
 
+            /// Acquires the lock only if it can be done without waiting; check owns_lock() for the outcome.
+            explicit FSLock(std::try_to_lock_t);
+
             virtual ~FSLock() final;
 
+            bool owns_lock() const
+            {
+                return acquired;
+            }
+
             FSLock(const FSLock&) = delete;
 
             FSLock(FSLock&&) = delete;
@@ -44,6 +52,7 @@ namespace smooth::core::filesystem
             FSLock& operator=(const FSLock&&) = delete;
 
         private:
+            bool acquired{ false };
             static std::mutex lock;
             static std::condition_variable cv;
             static int max;
@@ -0,0 +1,79 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "smooth/core/filesystem/Path.h"
+#include "smooth/core/filesystem/FSLock.h"
+
+namespace smooth::core::filesystem
+{
+    /// Provides sequential, chunked read access to a file that is kept open between reads, handing out
+    /// each chunk without copying it into a caller-provided container.
+    /// On Linux the file is memory mapped and chunks point directly into the mapping.
+    /// On ESP the file descriptor is kept open and chunks are read into a single buffer which is reused
+    /// as soon as the previous chunk is no longer referenced.
+    class FileReader
+        : public std::enable_shared_from_this<FileReader>
+    {
+        public:
+            /// Opens the file.
+            /// \return The reader, or nullptr if the file could not be opened or, on ESP, if the maximum
+            /// number of open files (see FSLock) already has been reached.
+            static std::shared_ptr<FileReader> open(const Path& path);
+
+            ~FileReader();
+
+            FileReader(const FileReader&) = delete;
+
+            FileReader& operator=(const FileReader&) = delete;
+
+            FileReader(FileReader&&) = delete;
+
+            FileReader& operator=(FileReader&&) = delete;
+
+            /// Reads a part of the file.
+            /// \param offset Offset into the file
+            /// \param length Number of bytes to read
+            /// \param data Receives a pointer to the data, valid for as long as the pointer is kept.
+            /// \return true on success, false on failure
+            bool read(std::size_t offset, std::size_t length, std::shared_ptr<const uint8_t>& data);
+
+            std::size_t size() const
+            {
+                return file_size;
+            }
+
+        private:
+            FileReader() = default;
+
+            bool open_file(const Path& path);
+
+            std::size_t file_size{ 0 };
+#ifdef ESP_PLATFORM
+            std::unique_ptr<FSLock> lock{};
+            int fd{ -1 };
+            std::size_t position{ 0 };
+            std::shared_ptr<std::vector<uint8_t>> buffer{};
+#else
+            uint8_t* mapping{ nullptr };
+#endif
+    };
+}
@@ -17,6 +17,8 @@ limitations under the License.
 
 #pragma once
 
+#include <memory>
+
 namespace smooth::core::ipc
 {
     template<typename T>
@@ -25,6 +27,6 @@ namespace smooth::core::ipc
         public:
             virtual ~ILinkSubscriber() = default;
 
-            virtual bool receive_published_data(const T& data) = 0;
+            virtual bool receive_published_data(const std::shared_ptr<const T>& data) = 0;
     };
 }
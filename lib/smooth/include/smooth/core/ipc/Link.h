@@ -17,17 +17,22 @@ limitations under the License.
 
 #pragma once
 
-#include <forward_list>
+#include <algorithm>
 #include <chrono>
+#include <memory>
 #include <mutex>
+#include <vector>
 #include "Queue.h"
 #include "ILinkSubscriber.h"
 
 namespace smooth::core::ipc
 {
     /// The Link class is used to bind subscribers of a certain message type together in a thread-safe manner
-    /// so that any Task can call core::ipc::Publisher<T>::publish(T&) to distribute a copy of an event
-    /// to each subscriber.
+    /// so that any Task can call core::ipc::Publisher<T>::publish() to distribute an event to each subscriber.
+    /// The event is placed in a single, immutable, shared instance which all subscribers receive a reference to.
+    ///
+    /// The list of subscribers is copy-on-write; publishing only takes a snapshot of the current list and never
+    /// blocks on the mutex that serializes subscribe() and unsubscribe().
     /// \tparam T The type of event to distribute.
     template<typename T>
     class Link
@@ -44,22 +49,43 @@ namespace smooth::core::ipc
             virtual ~Link() = default;
 
             /// Subscribe to messages
-            /// \param queue The subscriber which shall receive the messages.
-            void subscribe(ILinkSubscriber<T>* subscriber);
+            /// \param subscriber The subscriber which shall receive the messages. Publishers that are
+            /// in progress while unsubscribing may still hold a reference to it for a short while.
+            void subscribe(const std::shared_ptr<ILinkSubscriber<T>>& subscriber);
 
             /// Unsubscribes to messages
-            /// \param queue
-            void unsubscribe(ILinkSubscriber<T>* subscriber);
+            /// \param subscriber
+            void unsubscribe(const std::shared_ptr<ILinkSubscriber<T>>& subscriber);
 
-            /// Publishes a copy of the the provided item to each subscriber.
+            /// Publishes a copy of the the provided item to each subscriber. The copy is made once, and only
+            /// if there are any subscribers.
             /// \param item The item to publish
             /// \return true of all subscribers could receive the item, false if one or more queues were full.
             static bool publish(const T& item)
             {
-                std::lock_guard<std::mutex> l(get_mutex());
-                bool res = false;
+                auto subscribers = std::atomic_load(&get_subscribers());
 
-                for (auto subscriber : get_subscribers())
+                return subscribers->empty() || distribute(*subscribers, std::make_shared<const T>(item));
+            }
+
+            /// Publishes the provided item to each subscriber without copying it.
+            /// \param item The item to publish
+            /// \return true of all subscribers could receive the item, false if one or more queues were full.
+            static bool publish(const std::shared_ptr<const T>& item)
+            {
+                auto subscribers = std::atomic_load(&get_subscribers());
+
+                return distribute(*subscribers, item);
+            }
+
+        private:
+            using SubscriberList = std::vector<std::shared_ptr<ILinkSubscriber<T>>>;
+
+            static bool distribute(const SubscriberList& subscribers, const std::shared_ptr<const T>& item)
+            {
+                bool res = true;
+
+                for (const auto& subscriber : subscribers)
                 {
                     res &= subscriber->receive_published_data(item);
                 }
@@ -67,8 +93,7 @@ namespace smooth::core::ipc
                 return res;
             }
 
-        private:
-            static std::forward_list<ILinkSubscriber<T>*>& get_subscribers();
+            static std::shared_ptr<const SubscriberList>& get_subscribers();
 
             static std::mutex& get_mutex()
             {
@@ -79,25 +104,31 @@ namespace smooth::core::ipc
     };
 
     template<typename T>
-    void Link<T>::subscribe(ILinkSubscriber<T>* subscriber)
+    void Link<T>::subscribe(const std::shared_ptr<ILinkSubscriber<T>>& subscriber)
     {
         std::lock_guard<std::mutex> l(get_mutex());
-        get_subscribers().push_front(subscriber);
+        auto current = std::atomic_load(&get_subscribers());
+        auto updated = std::make_shared<SubscriberList>(*current);
+        updated->push_back(subscriber);
+        std::atomic_store(&get_subscribers(), std::shared_ptr<const SubscriberList>(std::move(updated)));
     }
 
     template<typename T>
-    void Link<T>::unsubscribe(ILinkSubscriber<T>* subscriber)
+    void Link<T>::unsubscribe(const std::shared_ptr<ILinkSubscriber<T>>& subscriber)
     {
         std::lock_guard<std::mutex> l(get_mutex());
-        get_subscribers().remove(subscriber);
+        auto current = std::atomic_load(&get_subscribers());
+        auto updated = std::make_shared<SubscriberList>(*current);
+        updated->erase(std::remove(updated->begin(), updated->end(), subscriber), updated->end());
+        std::atomic_store(&get_subscribers(), std::shared_ptr<const SubscriberList>(std::move(updated)));
     }
 
     template<typename T>
-    std::forward_list<ILinkSubscriber<T>*>& Link<T>::get_subscribers()
+    std::shared_ptr<const typename Link<T>::SubscriberList>& Link<T>::get_subscribers()
     {
         // Place list in method to ensure linker finds it, it also guarantees
-        // no race condition exists while constructing the forward_list.
-        static std::forward_list<ILinkSubscriber<T>*> subscribers;
+        // no race condition exists while constructing the list.
+        static std::shared_ptr<const SubscriberList> subscribers = std::make_shared<const SubscriberList>();
 
         return subscribers;
     }
@@ -0,0 +1,200 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace smooth::core::ipc
+{
+    /// A fixed-capacity, lock-free ring buffer for multiple producers (bounded queue after D. Vyukov).
+    /// Each slot carries a sequence number that tells producers and consumers whether the slot is free
+    /// or holds an item, so pushing and popping is a compare-and-swap on the respective position followed
+    /// by a single store. The producer and consumer positions live on separate cache lines so that
+    /// producers don't invalidate the consumer's line and vice versa.
+    /// The consumer side is normally a single Task, but is also safe to use concurrently, which happens when
+    /// e.g. a BufferContainer is cleared from another task.
+    /// \tparam T The item type, must be default-constructible and move- or copy-assignable.
+    template<typename T>
+    class LockFreeRing
+    {
+        public:
+            /// Constructor
+            /// \param size Minimum number of items to hold; rounded up to the nearest power of two.
+            explicit LockFreeRing(size_t size)
+                    : mask(round_up(size) - 1),
+                      cells(std::make_unique<Cell[]>(mask + 1))
+            {
+                for (size_t i = 0; i <= mask; ++i)
+                {
+                    cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            LockFreeRing(const LockFreeRing&) = delete;
+
+            LockFreeRing& operator=(const LockFreeRing&) = delete;
+
+            /// \return The number of items the ring can hold.
+            [[nodiscard]] size_t capacity() const
+            {
+                return mask + 1;
+            }
+
+            /// Copies an item into the ring.
+            /// \return true if the item could be stored, false if the ring is full.
+            bool push(const T& item)
+            {
+                return emplace(item);
+            }
+
+            /// Moves an item into the ring.
+            /// \return true if the item could be stored, false if the ring is full.
+            bool push(T&& item)
+            {
+                return emplace(std::move(item));
+            }
+
+            /// Moves the oldest item out of the ring.
+            /// \return true if an item was retrieved, false if the ring is empty.
+            bool pop(T& target)
+            {
+                Cell* cell = nullptr;
+                size_t pos = dequeue_pos.value.load(std::memory_order_relaxed);
+                bool res = false;
+                bool done = false;
+
+                while (!done)
+                {
+                    cell = &cells[pos & mask];
+                    auto seq = cell->sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+                    if (diff == 0)
+                    {
+                        res = dequeue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed);
+                        done = res;
+                    }
+                    else if (diff < 0)
+                    {
+                        // Empty
+                        done = true;
+                    }
+                    else
+                    {
+                        pos = dequeue_pos.value.load(std::memory_order_relaxed);
+                    }
+                }
+
+                if (res)
+                {
+                    target = std::move(cell->data);
+                    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+                }
+
+                return res;
+            }
+
+            /// \return The approximate number of items in the ring; exact when there is no concurrent access.
+            [[nodiscard]] size_t count() const
+            {
+                auto head = dequeue_pos.value.load(std::memory_order_relaxed);
+                auto tail = enqueue_pos.value.load(std::memory_order_relaxed);
+
+                return tail >= head ? tail - head : 0;
+            }
+
+            [[nodiscard]] bool empty() const
+            {
+                return count() == 0;
+            }
+
+        private:
+            static constexpr size_t cache_line_size = 64;
+
+            struct Cell
+            {
+                std::atomic<size_t> sequence{ 0 };
+                T data{};
+            };
+
+            struct alignas(cache_line_size) Position
+            {
+                std::atomic<size_t> value{ 0 };
+            };
+
+            template<typename Item>
+            bool emplace(Item&& item)
+            {
+                Cell* cell = nullptr;
+                size_t pos = enqueue_pos.value.load(std::memory_order_relaxed);
+                bool res = false;
+                bool done = false;
+
+                while (!done)
+                {
+                    cell = &cells[pos & mask];
+                    auto seq = cell->sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+                    if (diff == 0)
+                    {
+                        res = enqueue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed);
+                        done = res;
+                    }
+                    else if (diff < 0)
+                    {
+                        // Full
+                        done = true;
+                    }
+                    else
+                    {
+                        pos = enqueue_pos.value.load(std::memory_order_relaxed);
+                    }
+                }
+
+                if (res)
+                {
+                    cell->data = std::forward<Item>(item);
+                    cell->sequence.store(pos + 1, std::memory_order_release);
+                }
+
+                return res;
+            }
+
+            static size_t round_up(size_t size)
+            {
+                size_t res = 1;
+
+                while (res < size)
+                {
+                    res <<= 1;
+                }
+
+                return res;
+            }
+
+            const size_t mask;
+            std::unique_ptr<Cell[]> cells;
+            Position enqueue_pos{};
+            Position dequeue_pos{};
+    };
+}
@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <memory>
 #include "Link.h"
 
 namespace smooth::core::ipc
@@ -30,6 +31,11 @@ namespace smooth::core::ipc
             /// Publishes a copy of the provided item to all subscribers that are registered for it
             /// in a thread-safe manner.
             static void publish(const T& item);
+
+            /// Publishes the provided item to all subscribers that are registered for it in a thread-safe
+            /// manner, without copying it. All subscribers receive a reference to the same instance.
+            /// Prefer this for large items that are sent to several subscribers.
+            static void publish(std::shared_ptr<const T> item);
     };
 
     template<typename T>
@@ -37,4 +43,10 @@ namespace smooth::core::ipc
     {
         Link<T>::publish(item);
     }
+
+    template<typename T>
+    void Publisher<T>::publish(std::shared_ptr<const T> item)
+    {
+        Link<T>::publish(item);
+    }
 }
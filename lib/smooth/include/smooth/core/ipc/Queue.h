@@ -22,6 +22,7 @@ limitations under the License.
 #include <vector>
 #include <mutex>
 #include <algorithm>
+#include "LockFreeRing.h"
 #include "smooth/core/logging/log.h"
 
 using namespace smooth::core::logging;
@@ -29,42 +30,33 @@ using namespace smooth::core::logging;
 namespace smooth::core::ipc
 {
     /// T Queue<T> is precisely what that name suggest - a queue that holds items of type T.
-    /// It is also thread-safe. It can be used either as a stand alone queue or as the base for
+    /// It is also thread-safe, and lock-free. It can be used either as a stand alone queue or as the base for
     /// more specialized implementations, such as the TaskEventQueue and SubscribingTaskEventQueue.
     /// Please note that this implementation supports actual C++ objects as opposed to the FreeRTOS
     /// plain data-only queues. This means that you can place any type of C++ object on these queues
-    /// as long as the objects are copyable (the default copy constructor and assignment operator are enough)
-    /// Items are placed on the queue by copy, not by reference.
+    /// as long as the objects are default constructible and copyable or movable.
+    /// Items are placed on the queue by copy or move, not by reference.
     /// \tparam T The type of object to hold in the queue.
     template<typename T>
     class Queue
     {
         public:
             /// Constructor
-            /// \param name The name of the queue, mainly used for debugging and logging.
-            /// \param size The size of the queue, i.e. the number of items it can hold.
+            /// \param size The size of the queue, i.e. the number of items it can hold. Rounded up to the
+            /// nearest power of two.
             explicit Queue(int size)
-                    : queue_size(size),
-                      items(),
-                      guard()
+                    : items(static_cast<size_t>(size))
             {
-                items.reserve(static_cast<size_t>(size));
             }
 
             /// Destructor
-            virtual ~Queue()
-            {
-                std::lock_guard<std::mutex> lock(guard);
-                items.clear();
-            }
+            virtual ~Queue() = default;
 
             /// Gets the size of the queue.
             /// \return number of items the queue can hold.
             int size()
             {
-                std::lock_guard<std::mutex> lock(guard);
-
-                return queue_size;
+                return static_cast<int>(items.capacity());
             }
 
             /// Pushes an item into the queue
@@ -72,34 +64,23 @@ namespace smooth::core::ipc
             /// \return true if the queue could accept the item, otherwise false.
             bool push(const T& item)
             {
-                std::lock_guard<std::mutex> lock(guard);
-
-                bool res = items.size() < static_cast<size_t>(queue_size);
-
-                if (res)
-                {
-                    items.emplace_back(item);
-                }
+                return items.push(item);
+            }
 
-                return res;
+            /// Moves an item into the queue
+            /// \param item The item to place on the queue.
+            /// \return true if the queue could accept the item, otherwise false.
+            bool push(T&& item)
+            {
+                return items.push(std::move(item));
             }
 
             /// Pops an item off the queue.
-            /// \param target A reference to an instance of T which will be assigned the item taken from the queue.
+            /// \param target A reference to an instance of T which will be move-assigned the item taken from the queue.
             /// \return true if an item could be received, otherwise false.
             bool pop(T& target)
             {
-                std::lock_guard<std::mutex> lock(guard);
-
-                bool res = items.size() > 0;
-
-                if (res)
-                {
-                    target = items.front();
-                    items.erase(items.begin());
-                }
-
-                return res;
+                return items.pop(target);
             }
 
             /// Returns a value indicating if the queue is empty.
@@ -113,14 +94,10 @@ namespace smooth::core::ipc
             /// \return The number of items in the queue.
             int count()
             {
-                std::lock_guard<std::mutex> lock(guard);
-
-                return static_cast<int>(items.size());
+                return static_cast<int>(items.count());
             }
 
         private:
-            const int queue_size;
-            std::vector<T> items;
-            std::mutex guard;
+            LockFreeRing<T> items;
     };
 }
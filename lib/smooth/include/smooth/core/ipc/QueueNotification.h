@@ -21,6 +21,7 @@ limitations under the License.
 #include <mutex>
 #include <deque>
 #include <memory>
+#include <vector>
 #include "ITaskEventQueue.h"
 
 namespace smooth::core::ipc
@@ -36,7 +37,14 @@ namespace smooth::core::ipc
 
             void remove_expired_queues();
 
-            std::weak_ptr<ITaskEventQueue> wait_for_notification(std::chrono::milliseconds timeout);
+            /// Waits for at least one notification, or timeout, then takes up to max_count notifications
+            /// in the order they were made.
+            /// \param timeout Maximum time to wait.
+            /// \param notifications Receives the notifications, appended in order.
+            /// \param max_count Maximum number of notifications to take.
+            void wait_for_notifications(std::chrono::milliseconds timeout,
+                                        std::vector<std::weak_ptr<ITaskEventQueue>>& notifications,
+                                        size_t max_count);
 
             void clear()
             {
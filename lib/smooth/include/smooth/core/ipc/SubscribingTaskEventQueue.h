@@ -26,16 +26,18 @@ namespace smooth::core::ipc
 {
     /// In addition to the functionality of the TaskEventQueue<T>, the  SubscribingEventQueue<T> also subscribes
     /// to messages/events sent via the Publisher<T>.
+    /// Events are held by reference to a shared, immutable instance so that published events are never copied
+    /// per subscriber. Events pushed directly onto the queue are copied once into such an instance.
     /// \tparam T The type of event to receive.
     template<typename T>
     class SubscribingTaskEventQueue
-        : public TaskEventQueue<T>
+        : public TaskEventQueue<T, std::shared_ptr<const T>>
     {
         public:
             /// Destructor
             ~SubscribingTaskEventQueue()
             {
-                link.unsubscribe(&wrapper);
+                link.unsubscribe(wrapper);
             }
 
             SubscribingTaskEventQueue() = delete;
@@ -50,7 +52,21 @@ namespace smooth::core::ipc
 
             bool push(const T& item) override
             {
-                return this->push_internal(item, this->template shared_from_base<SubscribingTaskEventQueue<T>>());
+                return push(this->to_item(item));
+            }
+
+            bool push(T&& item) override
+            {
+                return push(this->to_item(std::move(item)));
+            }
+
+            /// Places a reference to the shared item on the queue.
+            /// \param item The item to place on the queue.
+            /// \return true if the queue could accept the item, otherwise false.
+            bool push(std::shared_ptr<const T> item)
+            {
+                return this->push_internal(std::move(item),
+                                           this->template shared_from_base<SubscribingTaskEventQueue<T>>());
             }
 
             static auto create(int size, Task& task, IEventListener<T>& listener)
@@ -71,7 +87,7 @@ namespace smooth::core::ipc
             /// any object instance.
             SubscribingTaskEventQueue(int size, Task& task, IEventListener<T>& listener)
                     :
-                      TaskEventQueue<T>(size, task, listener),
+                      TaskEventQueue<T, std::shared_ptr<const T>>(size, task, listener),
                       link()
             {
             }
@@ -79,10 +95,12 @@ namespace smooth::core::ipc
         private:
             void link_up()
             {
-                wrapper = LinkWrapper{ this->template shared_from_base<SubscribingTaskEventQueue<T>>() };
-                link.subscribe(&wrapper);
+                wrapper = std::make_shared<LinkWrapper>(this->template shared_from_base<SubscribingTaskEventQueue<T>>());
+                link.subscribe(wrapper);
             }
 
+            // The wrapper may outlive the queue when a publisher holds a reference to it while the queue
+            // is being destructed. It only holds a weak reference to the queue for that reason.
             class LinkWrapper : public ILinkSubscriber<T>
             {
                 public:
@@ -91,19 +109,17 @@ namespace smooth::core::ipc
                     {
                     }
 
-                    LinkWrapper() = default;
-
                     LinkWrapper(const LinkWrapper&) = delete;
 
                     LinkWrapper(LinkWrapper&&) = delete;
 
                     LinkWrapper& operator=(const LinkWrapper&) = delete;
 
-                    LinkWrapper& operator=(LinkWrapper&&) noexcept = default;
+                    LinkWrapper& operator=(LinkWrapper&&) = delete;
 
-                    ~LinkWrapper() = default;
+                    ~LinkWrapper() override = default;
 
-                    bool receive_published_data(const T& data) override
+                    bool receive_published_data(const std::shared_ptr<const T>& data) override
                     {
                         bool res = true;
                         auto q = queue.lock();
@@ -121,6 +137,6 @@ namespace smooth::core::ipc
             };
 
             Link<T> link;
-            LinkWrapper wrapper;
+            std::shared_ptr<ILinkSubscriber<T>> wrapper{};
     };
 }
@@ -19,6 +19,8 @@ limitations under the License.
 
 #include "smooth/core/Task.h"
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include "ITaskEventQueue.h"
 #include "IEventListener.h"
 #include "QueueNotification.h"
@@ -30,10 +32,11 @@ namespace smooth::core::ipc
     /// to signal a Task when an item is available, making polling a queue unnecessary which frees up the task
     /// to do other things.
     /// \tparam T The type of events to receive.
-    template<typename T>
+    /// \tparam Item The type held by the queue; either T or std::shared_ptr<const T> when the events are shared.
+    template<typename T, typename Item = T>
     class TaskEventQueue
         : public ITaskEventQueue,
-        public std::enable_shared_from_this<TaskEventQueue<T>>
+        public std::enable_shared_from_this<TaskEventQueue<T, Item>>
     {
         public:
             friend core::Task;
@@ -43,8 +46,8 @@ namespace smooth::core::ipc
 
             static auto create(int size, Task& owner_task, IEventListener<T>& event_listener)
             {
-                return smooth::core::util::create_protected_shared<TaskEventQueue<T>>(size, owner_task,
-                                                                                      event_listener);
+                return smooth::core::util::create_protected_shared<TaskEventQueue<T, Item>>(size, owner_task,
+                                                                                            event_listener);
             }
 
             ~TaskEventQueue() override
@@ -67,7 +70,15 @@ namespace smooth::core::ipc
             /// \return true if the queue could accept the item, otherwise false.
             virtual bool push(const T& item)
             {
-                return push_internal(item, this->shared_from_this());
+                return push_internal(to_item(item), this->shared_from_this());
+            }
+
+            /// Moves an item into the queue
+            /// \param item The item to place on the queue.
+            /// \return true if the queue could accept the item, otherwise false.
+            virtual bool push(T&& item)
+            {
+                return push_internal(to_item(std::move(item)), this->shared_from_this());
             }
 
             /// Gets the size of the queue.
@@ -93,7 +104,7 @@ namespace smooth::core::ipc
             {
                 while (!queue.empty())
                 {
-                    T t;
+                    Item t;
                     queue.pop(t);
                 }
             }
@@ -114,9 +125,10 @@ namespace smooth::core::ipc
                 task.register_queue_with_task(this);
             }
 
-            bool push_internal(const T& item, const std::weak_ptr<ITaskEventQueue>& receiver)
+            template<typename I>
+            bool push_internal(I&& item, const std::weak_ptr<ITaskEventQueue>& receiver)
             {
-                auto res = queue.push(item);
+                auto res = queue.push(std::forward<I>(item));
 
                 if (res)
                 {
@@ -132,21 +144,46 @@ namespace smooth::core::ipc
                 return std::static_pointer_cast<Derived>(this->shared_from_this());
             }
 
-            Queue<T> queue;
+            /// Converts an event into the type held by the queue. When events are shared, this
+            /// is the one and only copy made of the event.
+            template<typename E>
+            static decltype(auto) to_item(E&& event)
+            {
+                if constexpr (std::is_same_v<Item, T>)
+                {
+                    return std::forward<E>(event);
+                }
+                else
+                {
+                    return Item{ std::make_shared<const T>(std::forward<E>(event)) };
+                }
+            }
+
+            Queue<Item> queue;
             QueueNotification* notif = nullptr;
         private:
             void forward_to_event_listener() override
             {
                 // All messages passed via a queue needs a default constructor
-                // and must be copyable and have the assignment operator.
-                T m;
+                // and must be copyable or movable and have the assignment operator.
+                Item m;
 
                 if (queue.pop(m))
                 {
-                    listener.event(m);
+                    listener.event(as_event(m));
                 }
             }
 
+            static const T& as_event(const T& item)
+            {
+                return item;
+            }
+
+            static const T& as_event(const std::shared_ptr<const T>& item)
+            {
+                return *item;
+            }
+
             Task& task;
             IEventListener<T>& listener;
     };
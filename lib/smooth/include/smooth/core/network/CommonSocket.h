@@ -26,6 +26,7 @@ limitations under the License.
 #include <netinet/in.h>
 #endif
 
+#include <atomic>
 #include <chrono>
 #include "smooth/core/timer/ElapsedTime.h"
 
@@ -81,6 +82,21 @@ namespace smooth::core::network
 
             bool is_connected() const override;
 
+            bool has_buffered_data() override
+            {
+                return false;
+            }
+
+            bool has_room_to_receive() override
+            {
+                return true;
+            }
+
+            bool is_busy() override
+            {
+                return false;
+            }
+
             bool has_send_expired() const override
             {
                 return send_timeout.count() > 0
@@ -96,8 +112,9 @@ namespace smooth::core::network
             }
 
             std::shared_ptr<InetAddress> ip{};
-            bool active = false;
-            bool connected = false;
+            // Read by crypto workers and application tasks, not only by the socket dispatcher.
+            std::atomic_bool active{ false };
+            std::atomic_bool connected{ false };
             int socket_id = INVALID_SOCKET;
             std::chrono::milliseconds send_timeout{ 0 };
             std::chrono::milliseconds receive_timeout{ 0 };
@@ -0,0 +1,91 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "smooth/core/Task.h"
+#include "smooth/core/ipc/TaskEventQueue.h"
+#include "smooth/core/ipc/IEventListener.h"
+
+namespace smooth::core::network
+{
+    /// A piece of CPU-heavy work, such as a TLS handshake step, to be run on a crypto worker.
+    class CryptoJob
+    {
+        public:
+            CryptoJob() = default;
+
+            explicit CryptoJob(std::function<void()> work)
+                    : work(std::move(work))
+            {
+            }
+
+            void run() const
+            {
+                if (work)
+                {
+                    work();
+                }
+            }
+
+        private:
+            std::function<void()> work{};
+    };
+
+    /// The CryptoWorkerPool runs the public key operations of TLS handshakes on a set of worker tasks
+    /// so that the SocketDispatcher can keep serving other sockets while a handshake is in progress.
+    /// On dual-core devices the workers are pinned to the core not running the network stack.
+    class CryptoWorkerPool
+    {
+        public:
+            static CryptoWorkerPool& instance();
+
+            /// Hands the work over to one of the workers.
+            /// \param work The work to perform.
+            /// \return true if a worker accepted the work, false if there are no workers or all of them
+            /// are fully loaded, in which case the caller has to run the work itself.
+            bool submit(std::function<void()> work);
+
+        private:
+            CryptoWorkerPool();
+
+            void start();
+
+            class Worker
+                : public smooth::core::Task,
+                public smooth::core::ipc::IEventListener<CryptoJob>
+            {
+                public:
+                    explicit Worker(const std::string& name);
+
+                    bool submit(const CryptoJob& job);
+
+                    void event(const CryptoJob& job) override;
+
+                private:
+                    using JobQueue = smooth::core::ipc::TaskEventQueue<CryptoJob>;
+                    std::shared_ptr<JobQueue> jobs;
+            };
+
+            std::vector<std::unique_ptr<Worker>> workers{};
+            std::atomic_size_t next_worker{ 0 };
+    };
+}
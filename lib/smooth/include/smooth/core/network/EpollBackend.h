@@ -0,0 +1,73 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+
+#include <array>
+#include <atomic>
+#include <sys/epoll.h>
+#include "IReadinessBackend.h"
+
+namespace smooth::core::network
+{
+    /// Readiness backend based on epoll. Sockets are registered once and only re-armed when their
+    /// interest changes, so a wait only costs in proportion to the number of ready sockets.
+    /// An eventfd is used to wake the wait when there is new work for the dispatcher.
+    /// Level-triggered since sockets only read as much as the protocol currently wants; with edge-triggered
+    /// notifications any remaining data would not be reported again.
+    class EpollBackend
+        : public IReadinessBackend
+    {
+        public:
+            EpollBackend();
+
+            ~EpollBackend() override;
+
+            EpollBackend(const EpollBackend&) = delete;
+
+            EpollBackend& operator=(const EpollBackend&) = delete;
+
+            bool add(int socket_id, uint8_t interest) override;
+
+            bool modify(int socket_id, uint8_t interest) override;
+
+            void remove(int socket_id) override;
+
+            bool wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready) override;
+
+            void wake() override;
+
+            [[nodiscard]] size_t size() const override
+            {
+                return registered;
+            }
+
+        private:
+            bool control(int op, int socket_id, uint8_t interest);
+
+            static constexpr size_t max_events_per_wait = 64;
+            int epoll_fd;
+            int wake_fd;
+            std::atomic_bool wake_pending{ false };
+            size_t registered = 0;
+            std::array<epoll_event, max_events_per_wait> events{};
+    };
+}
+
+#endif
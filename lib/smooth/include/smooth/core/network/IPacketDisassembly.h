@@ -33,6 +33,12 @@ namespace smooth::core::network
             /// \return The read position
             virtual const uint8_t* get_data() = 0;
 
+            /// Called once the packet has been sent. Packets that refer to data owned by someone
+            /// else should let go of it here, so that the owner may reuse it.
+            virtual void release_data()
+            {
+            }
+
             virtual ~IPacketDisassembly() = default;
     };
 }
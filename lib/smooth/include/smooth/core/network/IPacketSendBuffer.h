@@ -18,6 +18,9 @@ limitations under the License.
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <sys/socket.h>
+#include "IPacketSource.h"
 
 namespace smooth::core::network
 {
@@ -41,7 +44,15 @@ namespace smooth::core::network
             /// \return The number of bytes remaining to be sent.
             virtual int get_remaining_data_length() = 0;
 
-            /// Called when the specified amount of data has been sent.
+            /// Fills in a list describing the remaining data of the current packet, followed by
+            /// the packets queued after it, for use in a single vectored send.
+            /// \param list The list to fill in.
+            /// \param max_count The maximum number of entries to fill in.
+            /// \return The number of entries filled in.
+            virtual int get_gather_list(iovec* list, int max_count) = 0;
+
+            /// Called when the specified amount of data has been sent. When the amount exceeds
+            /// the current packet, the rest is accounted to the queued packets in order.
             /// \param length The number of bytes that has been sent.
             virtual void data_has_been_sent(int length) = 0;
 
@@ -52,6 +63,34 @@ namespace smooth::core::network
             /// \return true if the item could be queued, otherwise false.
             virtual bool put(const Packet& item) = 0;
 
+            /// Holds back queued packets so that they may be sent together on flush().
+            /// The buffer is flushed automatically when it becomes full.
+            virtual void cork() = 0;
+
+            /// Releases packets held back by cork().
+            virtual void flush() = 0;
+
+            /// Returns a value indicating if sending of new packets is held back.
+            /// \return true or false.
+            virtual bool is_corked() = 0;
+
+            /// Attaches a source that packets are pulled from when pull() is called, until it is exhausted.
+            /// \param source The source
+            /// \param look_ahead The number of packets to keep queued from the source.
+            virtual void set_source(std::shared_ptr<IPacketSource<Packet>> source, int look_ahead) = 0;
+
+            /// Pulls packets from the attached source until look_ahead packets are queued, detaching the
+            /// source once it has nothing more to send.
+            virtual void pull() = 0;
+
+            /// Returns a value indicating if a source is attached.
+            /// \return true or false.
+            virtual bool is_pulling() = 0;
+
+            /// Returns the number of packets that can be put into the buffer before it is full.
+            /// \return The number of free slots.
+            virtual int available_slots() = 0;
+
             /// Clears the buffer.
             virtual void clear() = 0;
 
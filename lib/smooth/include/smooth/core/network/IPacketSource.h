@@ -0,0 +1,37 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+namespace smooth::core::network
+{
+    /// Interface for sources that outgoing packets are pulled from by the socket, as it becomes able to send
+    /// more data, instead of the application putting each packet into the transmit buffer.
+    /// The source is called from the socket dispatcher thread, and must not block.
+    /// \tparam Packet The packet type
+    template<typename Packet>
+    class IPacketSource
+    {
+        public:
+            virtual ~IPacketSource() = default;
+
+            /// Provides the next packet to send.
+            /// \param packet Receives the packet, which must not be empty.
+            /// \return true if a packet was provided, false when the source has nothing more to send.
+            virtual bool get_next_packet(Packet& packet) = 0;
+    };
+}
@@ -0,0 +1,73 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace smooth::core::network
+{
+    /// Readiness reported for a single socket by an IReadinessBackend.
+    struct SocketReadiness
+    {
+        int socket_id;
+        bool readable;
+        bool writable;
+    };
+
+    /// Interface for the mechanism the SocketDispatcher uses to wait for sockets to become readable or writable.
+    /// Sockets are registered once and their interest is only changed when it actually changes, which allows
+    /// implementations such as epoll to keep the cost of a wait independent of the number of registered sockets.
+    class IReadinessBackend
+    {
+        public:
+            static constexpr uint8_t INTEREST_NONE = 0;
+            static constexpr uint8_t INTEREST_READ = 1;
+            static constexpr uint8_t INTEREST_WRITE = 2;
+
+            static constexpr uint8_t make_interest(bool read, bool write)
+            {
+                return static_cast<uint8_t>((read ? INTEREST_READ : INTEREST_NONE)
+                                            | (write ? INTEREST_WRITE : INTEREST_NONE));
+            }
+
+            virtual ~IReadinessBackend() = default;
+
+            /// Registers a socket with the given interest.
+            virtual bool add(int socket_id, uint8_t interest) = 0;
+
+            /// Changes the interest of an already registered socket.
+            virtual bool modify(int socket_id, uint8_t interest) = 0;
+
+            /// Unregisters a socket. Must be called before the socket is closed.
+            virtual void remove(int socket_id) = 0;
+
+            /// Waits for at most the given time for any registered socket to become ready, or until woken.
+            /// \param timeout Maximum time to wait.
+            /// \param ready Receives the sockets that are ready. Cleared before being filled.
+            /// \return true on success, false on error.
+            virtual bool wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready) = 0;
+
+            /// Makes an ongoing, or the next, call to wait() return immediately. May be called from any thread.
+            virtual void wake() = 0;
+
+            /// \return The number of registered sockets.
+            [[nodiscard]] virtual size_t size() const = 0;
+    };
+}
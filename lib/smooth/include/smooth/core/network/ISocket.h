@@ -97,6 +97,19 @@ namespace smooth::core::network
 
             [[nodiscard]] virtual bool has_data_to_transmit() = 0;
 
+            /// Returns true when data has been taken off the network but not yet been passed to the
+            /// receive buffer, meaning the socket needs servicing even if it doesn't become readable.
+            [[nodiscard]] virtual bool has_buffered_data() = 0;
+
+            /// Returns true when the receive buffer can take more data. While it can't, the socket is
+            /// not watched for readability, so the dispatcher doesn't spin until the application catches up.
+            [[nodiscard]] virtual bool has_room_to_receive() = 0;
+
+            /// Returns true while work for the socket is being done outside the SocketDispatcher, such as a
+            /// TLS handshake step on a crypto worker. A busy socket is not watched for readiness until
+            /// the work is done and the worker has requested an interest update.
+            [[nodiscard]] virtual bool is_busy() = 0;
+
             [[nodiscard]] virtual bool internal_start() = 0;
 
             virtual void publish_connected_status() = 0;
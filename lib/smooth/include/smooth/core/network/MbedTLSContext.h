@@ -19,29 +19,44 @@ limitations under the License.
 
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <mbedtls/net_sockets.h>
 #include <mbedtls/ssl.h>
-#include <mbedtls/entropy.h>
-#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/ssl_ticket.h>
 #include <mbedtls/debug.h>
+#include "smooth/core/network/TLSSessionCache.h"
 
 namespace smooth::core::network
 {
     void log_mbedtls_error(const char* log_tag, const char* prefix, int err_code) noexcept;
 
+    class MBedTLSContext;
+
     class SSLContext
     {
         public:
             SSLContext()
             {
                 mbedtls_ssl_init(&ssl);
+                update_statistics(1);
+            }
+
+            explicit SSLContext(MBedTLSContext& owner)
+                    : SSLContext()
+            {
+                this->owner = &owner;
             }
 
             ~SSLContext()
             {
                 mbedtls_ssl_free(&ssl);
+                update_statistics(-1);
             }
 
+            SSLContext(const SSLContext&) = delete;
+
+            SSLContext& operator=(const SSLContext&) = delete;
+
             operator mbedtls_ssl_context*()
             {
                 return &ssl;
@@ -52,10 +67,25 @@ namespace smooth::core::network
                 return static_cast<mbedtls_ssl_states>(ssl.state);
             }
 
+            /// Called once the handshake has completed, so that the session can be kept for
+            /// resumption by later connections made using the same MBedTLSContext.
+            void handshake_completed();
+
         private:
+            /// Keeps the count of open TLS connections in SystemStatistics up to date.
+            static void update_statistics(int change);
+
             mbedtls_ssl_context ssl{};
+            MBedTLSContext* owner{ nullptr };
     };
 
+    /// Holds the configuration shared by all connections created from it, such as a secure server and the
+    /// clients it accepts. The random generator is shared by all instances.
+    ///
+    /// The memory held by each connection is dominated by its record buffers, the size of which is set by
+    /// MBEDTLS_SSL_IN_CONTENT_LEN and MBEDTLS_SSL_OUT_CONTENT_LEN in the mbedtls configuration. The
+    /// max_fragment_length extension (SMOOTH_TLS_MAX_FRAGMENT_LENGTH) keeps outgoing records within a
+    /// smaller output buffer and asks servers to do the same.
     class MBedTLSContext
     {
         public:
@@ -72,17 +102,43 @@ namespace smooth::core::network
 
             std::unique_ptr<SSLContext> create_context();
 
+            /// Enables or disables client side session reuse. When enabled (default), a client context
+            /// remembers the session of the last successful handshake and offers it to the server on the
+            /// next connection, allowing the server to skip the expensive key exchange.
+            void set_session_reuse(bool enable);
+
+            /// \return The number of sessions held by the server side session cache.
+            [[nodiscard]] size_t get_cached_session_count() const
+            {
+                return session_cache.size();
+            }
+
         private:
+            friend class SSLContext;
+
             int common_init(bool server);
 
+            void init_session_resumption();
+
+            void save_session(SSLContext& context);
+
+            void resume_session(SSLContext& context);
+
             int load_certificate(const std::vector<unsigned char>& cert, mbedtls_x509_crt& target);
 
-            mbedtls_entropy_context entropy{};
-            mbedtls_ctr_drbg_context ctr_drbg{};
             mbedtls_ssl_config conf{};
             mbedtls_x509_crt ca_cert{};
             mbedtls_x509_crt ca_chain{};
             mbedtls_x509_crt server_cert{};
             mbedtls_pk_context pk_key{};
+            TLSSessionCache session_cache;
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+            mbedtls_ssl_ticket_context ticket_ctx{};
+#endif
+            bool is_server{ false };
+            bool session_reuse{ true };
+            std::mutex session_guard{};
+            mbedtls_ssl_session client_session{};
+            bool has_client_session{ false };
     };
 }
@@ -21,6 +21,8 @@ limitations under the License.
 #include <memory>
 #include "smooth/core/util/CircularBuffer.h"
 #include "IPacketReceiveBuffer.h"
+#include "ISocket.h"
+#include "SocketDispatcher.h"
 
 namespace smooth::core::network
 {
@@ -29,7 +31,9 @@ namespace smooth::core::network
     /// Packet must provide the IPacketAssembly interface (either directly or via inheritance)
     /// and fulfill the following contract:
     /// * Default constructable
-    /// * Must be copyable
+    /// * Must be swappable; packets are never copied on their way to the application.
+    /// * Optionally provide a recycle() method that returns the packet to its default state while keeping
+    ///   any allocated storage. Packets are then reused for later data instead of being destroyed.
     /// \tparam Packet The type of packet to assemble
     /// \tparam Size  The Number of items to hold in the buffer.
     template<typename Protocol, int Size, typename Packet = typename Protocol::packet_type>
@@ -71,7 +75,8 @@ namespace smooth::core::network
 
                 if (proto->is_complete(current_item))
                 {
-                    buffer.put(current_item);
+                    // current_item takes the place of the slot's previous packet, which is recycled.
+                    buffer.exchange_put(current_item);
                     in_progress = false;
                 }
             }
@@ -85,9 +90,33 @@ namespace smooth::core::network
 
             bool get(Packet& target) override
             {
-                std::unique_lock<std::mutex> lock(guard);
+                bool res = false;
+                int id = ISocket::INVALID_SOCKET;
+
+                {
+                    std::unique_lock<std::mutex> lock(guard);
+
+                    // The socket stops reading while the buffer is full, so it must be told when there is room again.
+                    id = buffer.is_full() ? socket_id : ISocket::INVALID_SOCKET;
+
+                    // The previous content of target goes into the buffer to be recycled, so an application
+                    // that keeps its packet around between events returns the storage for reuse.
+                    res = buffer.exchange_get(target);
+                }
+
+                if (res && id != ISocket::INVALID_SOCKET)
+                {
+                    SocketDispatcher::instance().request_interest_update(id);
+                }
+
+                return res;
+            }
 
-                return buffer.get(target);
+            /// Sets the id of the socket currently receiving into this buffer.
+            void set_socket_id(int id)
+            {
+                std::unique_lock<std::mutex> lock(guard);
+                socket_id = id;
             }
 
             void clear() override
@@ -97,7 +126,7 @@ namespace smooth::core::network
 
                 // Clear out any packets in progress too.
                 in_progress = false;
-                ReplacePacketWithDefault();
+                recycle(current_item, 0);
 
                 // Reset protocol so that it isn't left in a state
                 // where it thinks it is in the middle of a receive.
@@ -114,7 +143,7 @@ namespace smooth::core::network
             void prepare_new_packet() override
             {
                 std::unique_lock<std::mutex> lock(guard);
-                ReplacePacketWithDefault();
+                recycle(current_item, 0);
                 in_progress = true;
                 proto->packet_consumed();
             }
@@ -132,14 +161,24 @@ namespace smooth::core::network
             }
 
         private:
-            void ReplacePacketWithDefault()
+            // Uses the packet's own recycle() when it has one (preferred due to the int argument),
+            // otherwise replaces it with a default packet.
+            template<typename P>
+            static auto recycle(P& packet, int) -> decltype(packet.recycle(), void())
+            {
+                packet.recycle();
+            }
+
+            template<typename P>
+            static void recycle(P& packet, long)
             {
-                current_item.~Packet();
-                new(&current_item) Packet();
+                packet.~P();
+                new(&packet) P();
             }
 
             std::mutex guard{};
             bool in_progress = false;
+            int socket_id = ISocket::INVALID_SOCKET;
             Packet current_item{};
             std::unique_ptr<Protocol> proto;
             smooth::core::util::CircularBuffer<Packet, Size> buffer{};
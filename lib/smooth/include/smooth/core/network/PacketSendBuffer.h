@@ -19,13 +19,17 @@ limitations under the License.
 
 #include "smooth/core/util/CircularBuffer.h"
 #include "IPacketSendBuffer.h"
+#include "ISocket.h"
+#include "SocketDispatcher.h"
+#include <algorithm>
 #include <mutex>
 
 namespace smooth::core::network
 {
     /// PacketSendBuffer is a buffer that can hold Size packets of type T, with
     /// byte access to each individual element which makes it easy to perform
-    /// send() operations directly on each packet.
+    /// send() operations directly on each packet, or a single vectored send
+    /// covering all queued packets. Packets may also be pulled from an attached IPacketSource by the socket.
     /// T must provide the IPacketDisassembly interface (either directly or via inheritance) and fulfill the following
     // contract:
     /// * Default constructable
@@ -37,19 +41,42 @@ namespace smooth::core::network
         : public IPacketSendBuffer<Protocol>
     {
         public:
-            bool put(const Packet& item)
+            bool put(const Packet& item) override
             {
-                std::lock_guard<std::mutex> lock(guard);
-                bool res = !buffer.is_full();
+                bool res = false;
+                int id = ISocket::INVALID_SOCKET;
+
+                {
+                    std::lock_guard<std::mutex> lock(guard);
+                    res = !buffer.is_full();
+
+                    if (res)
+                    {
+                        buffer.put(item);
+
+                        // No point in holding back data when no more can be queued.
+                        corked = corked && !buffer.is_full();
+                    }
 
-                if (res)
+                    id = corked ? ISocket::INVALID_SOCKET : socket_id;
+                }
+
+                if (res && id != ISocket::INVALID_SOCKET)
                 {
-                    buffer.put(item);
+                    // Let the dispatcher know the socket now wants to be writable.
+                    SocketDispatcher::instance().request_interest_update(id);
                 }
 
                 return res;
             }
 
+            /// Sets the id of the socket currently sending from this buffer.
+            void set_socket_id(int id)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                socket_id = id;
+            }
+
             bool is_in_progress() override
             {
                 std::lock_guard<std::mutex> lock(guard);
@@ -71,29 +98,193 @@ namespace smooth::core::network
                 return current_item.get_send_length() - bytes_sent;
             }
 
+            int get_gather_list(iovec* list, int max_count) override
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                int count = 0;
+
+                if (in_progress && max_count > 0)
+                {
+                    list[count].iov_base = const_cast<uint8_t*>(current_item.get_data() + bytes_sent);
+                    list[count].iov_len = static_cast<size_t>(current_item.get_send_length() - bytes_sent);
+                    ++count;
+                }
+
+                // Queued packets are sent from where they are stored, they're only
+                // removed from the buffer once completely sent.
+                for (int i = 0; !corked && count < max_count && i < buffer.available_items(); ++i)
+                {
+                    auto* item = buffer.peek(i);
+                    list[count].iov_base = const_cast<uint8_t*>(item->get_data());
+                    list[count].iov_len = static_cast<size_t>(item->get_send_length());
+                    ++count;
+                }
+
+                return count;
+            }
+
             void data_has_been_sent(int length) override
             {
                 std::lock_guard<std::mutex> lock(guard);
+                auto current_length = in_progress ? current_item.get_send_length() : 0;
                 bytes_sent += length;
 
-                if (bytes_sent >= current_item.get_send_length())
+                if (bytes_sent >= current_length)
                 {
+                    // Anything beyond the current packet was sent from the queued packets.
+                    auto remaining = bytes_sent - current_length;
+                    current_item.release_data();
                     in_progress = false;
+                    bytes_sent = 0;
+
+                    while (remaining > 0 && !in_progress)
+                    {
+                        auto* next = buffer.peek(0);
+
+                        if (next == nullptr)
+                        {
+                            remaining = 0;
+                        }
+                        else if (remaining >= next->get_send_length())
+                        {
+                            remaining -= next->get_send_length();
+                            next->release_data();
+                            buffer.drop();
+                        }
+                        else
+                        {
+                            // Partially sent, continue with it as the current packet.
+                            in_progress = buffer.exchange_get(current_item);
+                            bytes_sent = remaining;
+                        }
+                    }
                 }
             }
 
             void prepare_next_packet() override
             {
                 std::lock_guard<std::mutex> lock(guard);
-                in_progress = buffer.get(current_item);
+                // Swapped rather than copied; the slot is assigned a new packet by the next put().
+                in_progress = buffer.exchange_get(current_item);
                 bytes_sent = 0;
             }
 
+            void cork() override
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                corked = true;
+            }
+
+            void flush() override
+            {
+                int id = ISocket::INVALID_SOCKET;
+
+                {
+                    std::lock_guard<std::mutex> lock(guard);
+                    corked = false;
+                    id = buffer.is_empty() ? ISocket::INVALID_SOCKET : socket_id;
+                }
+
+                if (id != ISocket::INVALID_SOCKET)
+                {
+                    SocketDispatcher::instance().request_interest_update(id);
+                }
+            }
+
+            bool is_corked() override
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return corked;
+            }
+
+            void set_source(std::shared_ptr<IPacketSource<Packet>> packet_source, int look_ahead) override
+            {
+                int id = ISocket::INVALID_SOCKET;
+
+                {
+                    std::lock_guard<std::mutex> lock(guard);
+                    source = std::move(packet_source);
+                    source_look_ahead = std::max(1, std::min(look_ahead, Size));
+                    id = source && !corked ? socket_id : ISocket::INVALID_SOCKET;
+                }
+
+                if (id != ISocket::INVALID_SOCKET)
+                {
+                    SocketDispatcher::instance().request_interest_update(id);
+                }
+            }
+
+            void pull() override
+            {
+                bool more = true;
+
+                while (more)
+                {
+                    std::shared_ptr<IPacketSource<Packet>> current{};
+
+                    {
+                        std::lock_guard<std::mutex> lock(guard);
+                        more = source && buffer.available_items() < source_look_ahead && !buffer.is_full();
+                        current = more ? source : nullptr;
+                    }
+
+                    if (more)
+                    {
+                        // The source is called without holding the lock as it may have to read the data,
+                        // the shared pointer keeps it alive should the buffer be cleared meanwhile.
+                        Packet item{};
+                        more = current->get_next_packet(item);
+
+                        std::lock_guard<std::mutex> lock(guard);
+
+                        if (source == current)
+                        {
+                            if (more)
+                            {
+                                buffer.put(item);
+                            }
+                            else
+                            {
+                                source.reset();
+                            }
+                        }
+                        else
+                        {
+                            more = false;
+                        }
+                    }
+                }
+            }
+
+            bool is_pulling() override
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return source != nullptr;
+            }
+
+            int available_slots() override
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return Size - buffer.available_items();
+            }
+
             void clear() override
             {
                 std::lock_guard<std::mutex> lock(guard);
-                buffer.clear();
+                source.reset();
+                current_item.release_data();
+
+                for (auto* item = buffer.peek(0); item != nullptr; item = buffer.peek(0))
+                {
+                    item->release_data();
+                    buffer.drop();
+                }
+
                 in_progress = false;
+                corked = false;
                 bytes_sent = 0;
             }
 
@@ -108,7 +299,11 @@ namespace smooth::core::network
             Packet current_item{};
             std::mutex guard{};
             int bytes_sent = 0;
+            int socket_id = ISocket::INVALID_SOCKET;
             bool in_progress = false;
+            bool corked = false;
+            std::shared_ptr<IPacketSource<Packet>> source{};
+            int source_look_ahead = 0;
             smooth::core::util::CircularBuffer<Packet, Size> buffer{};
     };
 }
@@ -0,0 +1,62 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace smooth::core::network
+{
+    /// Buffers data received from a socket so that protocols asking for a few bytes at a time
+    /// don't result in one recv() call per request. Requests at least as large as the buffer
+    /// are received directly into the caller's buffer once earlier buffered data has been consumed.
+    class ReadAheadBuffer
+    {
+        public:
+            /// \param size The size of the buffer, allocated on first use. 0 disables read-ahead.
+            explicit ReadAheadBuffer(std::size_t size)
+                    : size(size)
+            {
+            }
+
+            /// Receives up to length bytes, from buffered data if available, otherwise from the socket.
+            /// \return The number of bytes received, 0 if the socket was closed or -1 on error, with errno set,
+            /// same as recv().
+            int receive(int socket_id, uint8_t* target, std::size_t length);
+
+            /// \return true if there is no buffered data.
+            [[nodiscard]] bool is_empty() const
+            {
+                return pos == end;
+            }
+
+            /// Discards buffered data.
+            void clear()
+            {
+                pos = 0;
+                end = 0;
+            }
+
+        private:
+            std::size_t size;
+            std::vector<uint8_t> buffer{};
+            std::size_t pos{ 0 };
+            std::size_t end{ 0 };
+    };
+}
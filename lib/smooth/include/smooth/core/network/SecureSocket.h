@@ -18,31 +18,16 @@ limitations under the License.
 #pragma once
 
 #include <sys/socket.h>
+#include <atomic>
+#include <mutex>
 #include "Socket.h"
 #include "MbedTLSContext.h"
+#include "CryptoWorkerPool.h"
 #include <mbedtls/error.h>
 
 namespace smooth::core::network
 {
-    static int ssl_recv(void* ctx, uint8_t* buf, size_t len)
-    {
-        auto socket = reinterpret_cast<ISocket*>(ctx);
-        errno = 0;
-
-        auto amount_received = socket_cast(recv(socket->get_socket_id(), buf, len, 0));
-
-        if (amount_received < 0)
-        {
-            if (errno == EWOULDBLOCK)
-            {
-                amount_received = MBEDTLS_ERR_SSL_WANT_READ;
-            }
-        }
-
-        return amount_received;
-    }
-
-    static int ssl_send(void* ctx, const uint8_t* buff, size_t len)
+    inline int ssl_send(void* ctx, const uint8_t* buff, size_t len)
     {
         auto socket = reinterpret_cast<ISocket*>(ctx);
         errno = 0;
@@ -117,13 +102,79 @@ namespace smooth::core::network
 
             bool has_data_to_transmit() override;
 
+            bool has_buffered_data() override
+            {
+                return Socket<Protocol, Packet>::has_buffered_data()
+                       || mbedtls_ssl_get_bytes_avail(*secure_context) > 0;
+            }
+
+            bool is_busy() override
+            {
+                return handshake_busy;
+            }
+
+            bool is_active() const override
+            {
+                return !stop_requested && Socket<Protocol, Packet>::is_active();
+            }
+
+            void stop_internal() override;
+
         private:
             static constexpr const char* tag = "SecureSocket";
+
+            /// Receives data for mbedtls, via the read-ahead buffer so that reading the record header and
+            /// the record body doesn't result in separate recv() calls.
+            static int ssl_recv(void* ctx, uint8_t* buf, size_t len)
+            {
+                auto socket = static_cast<SecureSocket<Protocol, Packet>*>(ctx);
+                errno = 0;
+
+                auto amount_received = socket->read_ahead.receive(socket->get_socket_id(), buf, len);
+
+                if (amount_received < 0)
+                {
+                    if (errno == EWOULDBLOCK)
+                    {
+                        amount_received = MBEDTLS_ERR_SSL_WANT_READ;
+                    }
+                }
+
+                return amount_received;
+            }
             std::unique_ptr<SSLContext> secure_context{};
 
+            /// Set while a handshake step is running on a crypto worker.
+            std::atomic_bool handshake_busy{ false };
+
+            /// Set when the handshake waits for the socket to become writable rather than readable.
+            std::atomic_bool handshake_wants_write{ true };
+
+            /// Set when the socket is stopped while a worker runs handshake steps. The socket then reports
+            /// itself as inactive, the worker returns after the current step and the socket dispatcher
+            /// completes the stop once the socket is no longer busy.
+            std::atomic_bool stop_requested{ false };
+
+            /// Held by the worker while it runs handshake steps, so that a stop from another thread
+            /// can't tear the socket down underneath it.
+            std::mutex handshake_guard{};
+
             bool is_handshake_complete(const SSLContext& ctx) const;
 
-            void do_handshake_step();
+            void start_handshake_step();
+
+            void do_handshake_step(int socket_id);
+
+            bool is_crypto_in_progress(int code) const
+            {
+#ifdef MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS
+                return code == MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS;
+#else
+                static_cast<void>(code);
+
+                return false;
+#endif
+            }
 
             bool needs_tls_transfer(int code) const
             {
@@ -178,7 +229,7 @@ namespace smooth::core::network
     template<typename Protocol, typename Packet>
     void SecureSocket<Protocol, Packet>::readable(ISocketBackOff& ops)
     {
-        if (this->is_active())
+        if (this->is_active() && !handshake_busy)
         {
             this->elapsed_receive_time.start();
 
@@ -188,7 +239,7 @@ namespace smooth::core::network
             }
             else
             {
-                do_handshake_step();
+                start_handshake_step();
             }
         }
     }
@@ -196,7 +247,7 @@ namespace smooth::core::network
     template<typename Protocol, typename Packet>
     void SecureSocket<Protocol, Packet>::writable()
     {
-        if (this->is_active() && this->signal_new_connection())
+        if (this->is_active() && !handshake_busy && this->signal_new_connection())
         {
             this->elapsed_send_time.start();
 
@@ -206,7 +257,7 @@ namespace smooth::core::network
             }
             else
             {
-                do_handshake_step();
+                start_handshake_step();
             }
         }
     }
@@ -214,70 +265,45 @@ namespace smooth::core::network
     template<typename Protocol, typename Packet>
     void SecureSocket<Protocol, Packet>::read_data(const std::shared_ptr<BufferContainer<Protocol>>& container)
     {
-        // How much data to assemble the current packet?
-
         auto& rx = container->get_rx_buffer();
+        bool more = true;
 
-        do
+        // mbedtls_ssl_read() moves data off the underlying socket, so whatever is left decrypted in mbedtls
+        // or in the read-ahead buffer once the receive buffer is full doesn't cause further readable events.
+        // The SocketDispatcher resumes reading when the application has consumed a packet.
+        while (more && this->is_active() && !rx.is_full())
         {
-            if (rx.is_full())
+            // How much data to assemble the current packet?
+            int wanted_length = rx.amount_wanted();
+            auto read_amount = 0;
+
             {
-                // Receiver is full. Since mbedtls_ssl_read() moves data from the underlying socket, we get no
-                // no more readable-events on it, which results in the SocketDispatcher no longer calling
-                // readable() on this socket, in turn preventing this function be called again to read the
-                // remaining decrypted data. As such we have to wait a bit so the application consumes at
-                // least one packet.
-                std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
-
-                // Likely better solution: Set an artificial readable-indicator on the socket telling the
-                // SocketDispatcher there are more data to be read, forcing a readable()-call on the socket.
+                auto write_pos = rx.get_write_pos();
+                read_amount = mbedtls_ssl_read(*secure_context,
+                                               static_cast<uint8_t*>(write_pos),
+                                               static_cast<size_t>(wanted_length));
             }
-            else
-            {
-                int wanted_length = rx.amount_wanted();
-                auto read_amount = 0;
 
+            if (read_amount == 0)
+            {
+                this->stop("Underlying socket closed (mbedtls_ssl_read returned 0)");
+            }
+            else if (read_amount < 0)
+            {
+                if (!needs_tls_transfer(read_amount))
                 {
-                    auto write_pos = rx.get_write_pos();
-                    read_amount = mbedtls_ssl_read(*secure_context,
-                                                   static_cast<uint8_t*>(write_pos),
-                                                   static_cast<size_t>(wanted_length));
-                }
-
-                if (read_amount == 0)
-                {
-                    this->stop("Underlying socket closed (mbedtls_ssl_read returned 0)");
-                }
-                else if (read_amount < 0)
-                {
-                    if (!needs_tls_transfer(read_amount))
-                    {
-                        char buf[128];
-                        mbedtls_strerror(read_amount, buf, sizeof(buf));
-                        this->stop(buf);
-                    }
-                }
-                else
-                {
-                    rx.data_received(read_amount);
-
-                    if (rx.is_error())
-                    {
-                        Log::error(tag, "Assembly error");
-                        rx.prepare_new_packet();
-                        this->stop("Assembly error");
-                    }
-                    else if (rx.is_packet_complete())
-                    {
-                        event::DataAvailableEvent<Protocol> d(&rx);
-                        container->get_data_available()->push(d);
-                        rx.prepare_new_packet();
-                    }
+                    char buf[128];
+                    mbedtls_strerror(read_amount, buf, sizeof(buf));
+                    this->stop(buf);
                 }
             }
+            else
+            {
+                this->packet_data_received(container, read_amount);
+            }
+
+            more = read_amount > 0 && has_buffered_data();
         }
-        while (this->is_active()
-               && mbedtls_ssl_get_bytes_avail(*secure_context) > 0);
     }
 
     template<typename Protocol, typename Packet>
@@ -304,12 +330,17 @@ namespace smooth::core::network
                 {
                     tx.data_has_been_sent(amount_sent);
 
+                    if (tx.is_pulling())
+                    {
+                        tx.pull();
+                    }
+
                     // Was a complete packet sent?
                     if (tx.is_in_progress())
                     {
                         this->elapsed_send_time.start();
                     }
-                    else
+                    else if (!tx.is_pulling())
                     {
                         // Let the application know it may now send another packet.
                         event::TransmitBufferEmptyEvent event(this->shared_from_this());
@@ -334,29 +365,88 @@ namespace smooth::core::network
     }
 
     template<typename Protocol, typename Packet>
-    void SecureSocket<Protocol, Packet>::do_handshake_step()
+    void SecureSocket<Protocol, Packet>::start_handshake_step()
     {
         this->elapsed_receive_time.start();
         this->elapsed_send_time.start();
 
-        auto res = mbedtls_ssl_handshake_step(*secure_context);
+        // The socket isn't watched for readiness while busy, so the dispatcher won't touch the SSL context
+        // until the worker is done and requests an interest update.
+        handshake_busy = true;
+
+        auto self = std::static_pointer_cast<SecureSocket<Protocol, Packet>>(this->shared_from_this());
+        auto socket_id = this->get_socket_id();
+        auto work = [self, socket_id]() {
+                        self->do_handshake_step(socket_id);
+                    };
+
+        if (!CryptoWorkerPool::instance().submit(work))
+        {
+            work();
+        }
+    }
+
+    template<typename Protocol, typename Packet>
+    void SecureSocket<Protocol, Packet>::do_handshake_step(int socket_id)
+    {
+        auto res = 0;
 
-        if (needs_tls_transfer(res))
         {
-            // Handshake not yet complete
+            std::lock_guard<std::mutex> lock(handshake_guard);
+
+            if (this->is_active())
+            {
+                // Run steps back to back until the handshake has to wait for the remote end.
+                bool more = true;
+
+                while (more && !stop_requested)
+                {
+                    res = mbedtls_ssl_handshake_step(*secure_context);
+                    more = !is_handshake_complete(*secure_context) && (res == 0 || is_crypto_in_progress(res));
+                }
+
+                handshake_wants_write = res == MBEDTLS_ERR_SSL_WANT_WRITE;
+
+                if (res == 0 && is_handshake_complete(*secure_context))
+                {
+                    // Keep the session so that the next connection can resume it.
+                    secure_context->handshake_completed();
+                }
+            }
         }
-        else if (res < 0)
+
+        if (res < 0 && !needs_tls_transfer(res))
         {
             // Handshake failed
             log_mbedtls_error("SecureSocket", "mbedtls_ssl_handshake_step", res);
             this->stop("Error during handshake");
         }
+
+        handshake_busy = false;
+        SocketDispatcher::instance().request_interest_update(socket_id);
+    }
+
+    template<typename Protocol, typename Packet>
+    void SecureSocket<Protocol, Packet>::stop_internal()
+    {
+        // Never wait for a worker; a handshake step may take hundreds of milliseconds and this is
+        // typically called on the socket dispatcher.
+        if (handshake_busy)
+        {
+            stop_requested = true;
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(handshake_guard);
+            Socket<Protocol, Packet>::stop_internal();
+            stop_requested = false;
+        }
     }
 
     template<typename Protocol, typename Packet>
     bool SecureSocket<Protocol, Packet>::has_data_to_transmit()
     {
-        return !is_handshake_complete(*secure_context)
+        return (!is_handshake_complete(*secure_context) && handshake_wants_write)
                || Socket<Protocol, Packet>::has_data_to_transmit();
     }
 }
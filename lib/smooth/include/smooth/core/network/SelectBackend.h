@@ -0,0 +1,88 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <unordered_map>
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#include <sys/socket.h>
+#pragma GCC diagnostic pop
+#include "IReadinessBackend.h"
+
+namespace smooth::core::network
+{
+    /// Readiness backend based on select(). The sets are rebuilt on each wait, so the cost grows
+    /// with the number of registered sockets. Used on ESP (lwIP) and as the fallback on other platforms.
+    /// The wait is woken via a self-pipe, or on ESP where lwIP has no pipes, a loopback UDP socket
+    /// sending to itself (requires CONFIG_LWIP_NETIF_LOOPBACK, which is enabled by default).
+    class SelectBackend
+        : public IReadinessBackend
+    {
+        public:
+#ifdef ESP_PLATFORM
+            using FD = size_t;
+#else
+            using FD = int;
+#endif
+
+            SelectBackend();
+
+            ~SelectBackend() override;
+
+            SelectBackend(const SelectBackend&) = delete;
+
+            SelectBackend& operator=(const SelectBackend&) = delete;
+
+            bool add(int socket_id, uint8_t interest) override;
+
+            bool modify(int socket_id, uint8_t interest) override;
+
+            void remove(int socket_id) override;
+
+            bool wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready) override;
+
+            void wake() override;
+
+            [[nodiscard]] size_t size() const override
+            {
+                return interests.size();
+            }
+
+        private:
+            bool create_wake_channel();
+
+            void drain_wake_channel();
+
+            int build_sets();
+
+            void clear_sets();
+
+            static void set_fd(FD socket_id, fd_set& fd);
+
+            static bool is_fd_set(FD socket_id, fd_set& fd);
+
+            std::unordered_map<int, uint8_t> interests{};
+            int wake_read_fd = -1;
+            int wake_write_fd = -1;
+            std::atomic_bool wake_pending{ false };
+            fd_set read_set{};
+            fd_set write_set{};
+            timeval tv{};
+    };
+}
@@ -30,10 +30,12 @@ limitations under the License.
 #include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
 #include "smooth/core/network/event/DataAvailableEvent.h"
 #include "smooth/core/network/PacketSendBuffer.h"
+#include "smooth/core/network/ReadAheadBuffer.h"
 #include "smooth/core/network/SocketDispatcher.h"
 #include "smooth/core/network/event/ConnectionStatusEvent.h"
 #include "smooth/core/logging/log.h"
 #include "smooth/core/util/create_protected.h"
+#include "smooth/config_constants.h"
 
 namespace smooth::core::network
 {
@@ -99,6 +101,13 @@ namespace smooth::core::network
 
             bool send(const Packet& packet);
 
+            /// Holds back packets passed to send() until flush() is called, letting them be sent
+            /// together. Sending resumes automatically should the transmit buffer become full.
+            void cork();
+
+            /// Sends packets held back since cork() was called.
+            void flush();
+
             bool is_server() const override
             {
                 return false;
@@ -113,6 +122,9 @@ namespace smooth::core::network
 
             virtual void write_data(const std::shared_ptr<BufferContainer<Protocol>>& container);
 
+            /// Notifies the receive buffer that data has been written to it and publishes the packet if completed.
+            void packet_data_received(const std::shared_ptr<BufferContainer<Protocol>>& container, int length);
+
             void send_next_packet();
 
             bool signal_new_connection();
@@ -131,13 +143,29 @@ namespace smooth::core::network
 
                     if (cont)
                     {
-                        res = !cont->get_tx_buffer().is_empty();
+                        auto& tx = cont->get_tx_buffer();
+
+                        // An attached source always has more to send until it has been pulled dry.
+                        res = (!tx.is_empty() || tx.is_pulling()) && (tx.is_in_progress() || !tx.is_corked());
                     }
                 }
 
                 return res;
             }
 
+            bool has_buffered_data() override
+            {
+                return !read_ahead.is_empty();
+            }
+
+            bool has_room_to_receive() override
+            {
+                auto cont = buffers.lock();
+
+                // Without a container there is nothing to wait for; let readable() close the socket.
+                return !cont || !cont->get_rx_buffer().is_full();
+            }
+
             void publish_connected_status() override;
 
             void stop_internal() override;
@@ -147,8 +175,14 @@ namespace smooth::core::network
             bool set_no_delay();
 
             std::weak_ptr<BufferContainer<Protocol>> buffers{};
+            ReadAheadBuffer read_ahead{ CONFIG_SMOOTH_SOCKET_READ_AHEAD_SIZE };
+
+            /// Maximum number of packets passed to a single vectored send.
+            static constexpr int max_gather_count = 16;
         private:
             void clear_buffers();
+
+            void set_buffer_socket_ids();
     };
 
     template<typename Protocol, typename Packet>
@@ -305,6 +339,11 @@ namespace smooth::core::network
             {
                 auto& tx = cont->get_tx_buffer();
 
+                if (tx.is_pulling())
+                {
+                    tx.pull();
+                }
+
                 // Any data to send?
                 if (tx.is_empty())
                 {
@@ -312,7 +351,7 @@ namespace smooth::core::network
                     smooth::core::network::event::TransmitBufferEmptyEvent event(shared_from_this());
                     cont->get_tx_empty()->push(event);
                 }
-                else
+                else if (tx.is_in_progress() || !tx.is_corked())
                 {
                     if (!tx.is_in_progress())
                     {
@@ -332,48 +371,66 @@ namespace smooth::core::network
     void Socket<Protocol, Packet>::read_data(const std::shared_ptr<BufferContainer<Protocol>>& container)
     {
         auto& rx = container->get_rx_buffer();
+        bool more = true;
 
-        // How much data to assemble the current packet?
-        int wanted_length = rx.amount_wanted();
-
-        // Try to read the desired amount
-        ssize_t read_count = 0;
+        // The first request may result in a call to recv(), any further requests are served from the
+        // read-ahead buffer. Once it runs dry, the next readable event takes over.
+        while (more && is_active() && !rx.is_full())
         {
-            auto write_pos = rx.get_write_pos();
-            read_count = recv(socket_id, static_cast<void*>(write_pos), static_cast<size_t>(wanted_length), 0);
-        }
+            // How much data to assemble the current packet?
+            int wanted_length = rx.amount_wanted();
 
-        if (read_count == 0)
-        {
-            stop("Underlying socket closed (recv returned 0)");
-        }
-        else if (read_count < 0)
-        {
-            if (errno != EWOULDBLOCK)
+            // Try to read the desired amount
+            int read_count = 0;
             {
-                stop("Error during receive");
+                auto write_pos = rx.get_write_pos();
+                read_count = read_ahead.receive(socket_id,
+                                                static_cast<uint8_t*>(write_pos),
+                                                static_cast<size_t>(wanted_length));
             }
-        }
-        else
-        {
-            rx.data_received(socket_cast(read_count));
 
-            if (rx.is_error())
+            if (read_count == 0)
             {
-                rx.prepare_new_packet();
-                stop("Assembly error");
+                stop("Underlying socket closed (recv returned 0)");
             }
-            else if (rx.is_packet_complete())
+            else if (read_count < 0)
             {
-                event::DataAvailableEvent<Protocol> d(&rx);
-                container->get_data_available()->push(d);
-                rx.prepare_new_packet();
+                if (errno != EWOULDBLOCK)
+                {
+                    stop("Error during receive");
+                }
             }
+            else
+            {
+                packet_data_received(container, read_count);
+            }
+
+            more = read_count > 0 && !read_ahead.is_empty();
         }
 
         elapsed_receive_time.start();
     }
 
+    template<typename Protocol, typename Packet>
+    void Socket<Protocol, Packet>::packet_data_received(const std::shared_ptr<BufferContainer<Protocol>>& container,
+                                                        int length)
+    {
+        auto& rx = container->get_rx_buffer();
+        rx.data_received(length);
+
+        if (rx.is_error())
+        {
+            rx.prepare_new_packet();
+            stop("Assembly error");
+        }
+        else if (rx.is_packet_complete())
+        {
+            event::DataAvailableEvent<Protocol> d(&rx);
+            container->get_data_available()->push(d);
+            rx.prepare_new_packet();
+        }
+    }
+
     template<typename Protocol, typename Packet>
     void Socket<Protocol, Packet>::write_data(const std::shared_ptr<BufferContainer<Protocol>>& container)
     {
@@ -381,14 +438,16 @@ namespace smooth::core::network
 
         // Try to send as much as possible. The only guarantee POSIX gives when a socket is writable
         // is that send( id, some_data, some_length ) will be >= 1 and may or may not send the entire
-        // packet.
+        // packet. All queued packets are handed over in one call so that small packets share TCP segments
+        // and system calls; data_has_been_sent() sorts out how far into the queue the data reached.
         auto& tx = container->get_tx_buffer();
-        auto data_to_send = tx.get_data_to_send();
-        auto length = tx.get_remaining_data_length();
-        auto amount_sent = ::send(socket_id,
-                                  data_to_send,
-                                  static_cast<size_t>(length),
-                                  SEND_FLAGS);
+        iovec gather_list[max_gather_count];
+
+        msghdr msg{};
+        msg.msg_iov = gather_list;
+        msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(tx.get_gather_list(gather_list, max_gather_count));
+
+        auto amount_sent = ::sendmsg(socket_id, &msg, SEND_FLAGS);
 
         if (amount_sent == -1)
         {
@@ -398,12 +457,18 @@ namespace smooth::core::network
         {
             tx.data_has_been_sent(static_cast<int>(amount_sent));
 
+            // Refill the look-ahead directly from the source instead of asking the application for more.
+            if (tx.is_pulling())
+            {
+                tx.pull();
+            }
+
             // Was a complete packet sent?
             if (tx.is_in_progress())
             {
                 elapsed_send_time.start();
             }
-            else
+            else if (!tx.is_pulling())
             {
                 // Let the application know it may now send another packet.
                 smooth::core::network::event::TransmitBufferEmptyEvent event(shared_from_this());
@@ -428,6 +493,7 @@ namespace smooth::core::network
                 if (res == 0 || (res == -1 && errno == EINPROGRESS))
                 {
                     active = true;
+                    set_buffer_socket_ids();
                 }
                 else
                 {
@@ -454,6 +520,8 @@ namespace smooth::core::network
             connected = false;
             elapsed_send_time.stop_and_zero();
         }
+
+        read_ahead.clear();
     }
 
     template<typename Protocol, typename Packet>
@@ -485,6 +553,7 @@ namespace smooth::core::network
         connected = true;
         set_non_blocking();
         set_no_delay();
+        set_buffer_socket_ids();
 
         SocketDispatcher::instance().perform_op(SocketOperation::Op::AddActiveSocket, shared_from_this());
     }
@@ -518,6 +587,28 @@ namespace smooth::core::network
         return res;
     }
 
+    template<typename Protocol, typename Packet>
+    void Socket<Protocol, Packet>::cork()
+    {
+        auto cont = buffers.lock();
+
+        if (cont)
+        {
+            cont->get_tx_buffer().cork();
+        }
+    }
+
+    template<typename Protocol, typename Packet>
+    void Socket<Protocol, Packet>::flush()
+    {
+        auto cont = buffers.lock();
+
+        if (cont)
+        {
+            cont->get_tx_buffer().flush();
+        }
+    }
+
     template<typename Protocol, typename Packet>
     void Socket<Protocol, Packet>::clear_buffers()
     {
@@ -528,4 +619,16 @@ namespace smooth::core::network
             cont->clear();
         }
     }
+
+    template<typename Protocol, typename Packet>
+    void Socket<Protocol, Packet>::set_buffer_socket_ids()
+    {
+        auto cont = buffers.lock();
+
+        if (cont)
+        {
+            cont->get_tx_buffer().set_socket_id(socket_id);
+            cont->get_rx_buffer().set_socket_id(socket_id);
+        }
+    }
 }
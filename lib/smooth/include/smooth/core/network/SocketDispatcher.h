@@ -19,13 +19,10 @@ limitations under the License.
 
 #include <cstring>
 #include <map>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <unordered_map>
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wsign-conversion"
-#include <sys/socket.h>
-#pragma GCC diagnostic pop
 #include "smooth/core/Task.h"
 #include "smooth/core/ipc/TaskEventQueue.h"
 #include "smooth/core/ipc/SubscribingTaskEventQueue.h"
@@ -33,6 +30,7 @@ limitations under the License.
 #include "NetworkStatus.h"
 #include "SocketOperation.h"
 #include "ISocketBackOff.h"
+#include "IReadinessBackend.h"
 
 namespace smooth::core::network
 {
@@ -46,17 +44,16 @@ namespace smooth::core::network
         private ISocketBackOff
     {
         public:
-#ifdef ESP_PLATFORM
-            using FD = size_t;
-#else
-            using FD = int;
-#endif
             ~SocketDispatcher() override = default;
 
             static SocketDispatcher& instance();
 
             void perform_op(SocketOperation::Op op, std::shared_ptr<ISocket> socket);
 
+            /// Requests that the read/write interest of the socket is re-evaluated, for example because
+            /// data has been put into its transmit buffer. May be called from any thread.
+            void request_interest_update(int socket_id);
+
             void tick() override;
 
             void event(const NetworkStatus& event) override;
@@ -67,13 +64,23 @@ namespace smooth::core::network
         private:
             SocketDispatcher();
 
-            int build_sets();
+            void restart_inactive_sockets();
 
-            void clear_sets();
+            void add_active_socket(const std::shared_ptr<ISocket>& socket);
 
-            void set_timeout();
+            uint8_t get_interest(const std::shared_ptr<ISocket>& socket);
 
-            void restart_inactive_sockets();
+            void update_interest(const std::shared_ptr<ISocket>& socket);
+
+            void process_interest_updates();
+
+            void expire_back_offs();
+
+            void dispatch(const SocketReadiness& readiness);
+
+            void dispatch_buffered(const std::shared_ptr<ISocket>& socket);
+
+            void park(int socket_id);
 
             void remove_socket_from_collection(std::vector<std::shared_ptr<ISocket>>& col,
                                                const std::shared_ptr<ISocket>& socket) const;
@@ -84,6 +91,8 @@ namespace smooth::core::network
 
             void shutdown_socket(std::shared_ptr<ISocket> socket);
 
+            void retry_deferred_shutdowns();
+
             bool is_backed_off(int socket_id);
 
             void remove_backed_off_socket(int socket_id);
@@ -92,21 +101,26 @@ namespace smooth::core::network
 
             std::map<int, std::shared_ptr<ISocket>> active_sockets;
             std::vector<std::shared_ptr<ISocket>> inactive_sockets;
+            /// Sockets that were busy when asked to shut down.
+            std::vector<std::shared_ptr<ISocket>> deferred_shutdowns{};
             std::mutex socket_guard;
             using NetworkEventQueue = smooth::core::ipc::SubscribingTaskEventQueue<NetworkStatus>;
             std::shared_ptr<NetworkEventQueue> network_events;
             using SocketOperationQueue = smooth::core::ipc::TaskEventQueue<SocketOperation>;
             std::shared_ptr<SocketOperationQueue> socket_op;
-
-            static void set_fd(FD socket_id, fd_set& fd);
-
-            static bool is_fd_set(FD socket_id, fd_set& fd);
-
-            fd_set read_set{};
-            fd_set write_set{};
-            timeval tv{};
+            std::unique_ptr<IReadinessBackend> backend;
+            std::unordered_map<int, uint8_t> interests{};
+            std::vector<SocketReadiness> ready{};
+            std::mutex interest_update_guard{};
+            std::vector<int> requested_interest_updates{};
+            std::vector<int> interest_updates_to_process{};
+            std::chrono::steady_clock::time_point next_timeout_check{};
             bool has_ip = false;
             static constexpr const char* tag = "SocketDispatcher";
+            static constexpr std::chrono::milliseconds wait_time{ 100 };
+            /// Interest of a socket that has been unregistered from the backend until it wants to read or write.
+            static constexpr uint8_t parked = 0xFF;
+            static constexpr std::chrono::milliseconds timeout_check_interval{ 100 };
             std::unordered_map<int, std::chrono::steady_clock::time_point> backed_off{};
 
             void check_socket_timeouts();
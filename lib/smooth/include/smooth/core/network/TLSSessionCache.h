@@ -0,0 +1,94 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <mbedtls/ssl.h>
+
+namespace smooth::core::network
+{
+    /// Server side TLS session cache, allowing clients to resume a previous session using its
+    /// session id instead of doing a full handshake. The cache holds a bounded number of sessions
+    /// and evicts the least recently used one when full. Sessions older than the timeout are not resumed.
+    class TLSSessionCache
+    {
+        public:
+            TLSSessionCache(size_t max_entries, std::chrono::seconds timeout);
+
+            /// Makes the given configuration use this cache. The cache must outlive the configuration.
+            void attach(mbedtls_ssl_config& conf);
+
+            [[nodiscard]] size_t size() const;
+
+        private:
+            struct Entry
+            {
+                Entry() = default;
+
+                // Entries hold the master secret, so they're never copied and wipe it when destroyed.
+                Entry(const Entry&) = delete;
+
+                Entry& operator=(const Entry&) = delete;
+
+                ~Entry();
+
+                std::array<unsigned char, sizeof(mbedtls_ssl_session::id)> id{};
+                size_t id_len{ 0 };
+                int ciphersuite{ 0 };
+                int compression{ 0 };
+                std::array<unsigned char, sizeof(mbedtls_ssl_session::master)> master{};
+                uint32_t verify_result{ 0 };
+#if defined(MBEDTLS_HAVE_TIME)
+                mbedtls_time_t start{};
+#endif
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+                unsigned char mfl_code{ 0 };
+#endif
+#if defined(MBEDTLS_SSL_TRUNCATED_HMAC)
+                int trunc_hmac{ 0 };
+#endif
+#if defined(MBEDTLS_SSL_ENCRYPT_THEN_MAC)
+                int encrypt_then_mac{ 0 };
+#endif
+                std::chrono::steady_clock::time_point stored{};
+
+                [[nodiscard]] bool matches(const mbedtls_ssl_session& session) const;
+
+                void store(const mbedtls_ssl_session& session);
+
+                void restore(mbedtls_ssl_session& session) const;
+            };
+
+            static int get(void* ctx, mbedtls_ssl_session* session);
+
+            static int set(void* ctx, const mbedtls_ssl_session* session);
+
+            std::list<Entry>::iterator find(const mbedtls_ssl_session& session);
+
+            const size_t max_entries;
+            const std::chrono::seconds timeout;
+
+            // Most recently used entry first
+            std::list<Entry> entries{};
+            mutable std::mutex guard{};
+    };
+}
@@ -27,6 +27,7 @@ namespace smooth::core
     // system.
     const uint32_t APPLICATION_BASE_PRIO = 5;
 
+    const uint32_t CRYPTO_WORKER_PRIO = 18;
     const uint32_t TIMER_SERVICE_PRIO = 19;
     const uint32_t SOCKET_DISPATCHER_PRIO = 20;
 }
@@ -22,6 +22,7 @@ limitations under the License.
 #include <functional>
 #include "smooth/core/timer/Timer.h"
 #include "smooth/core/timer/TimerExpiredEvent.h"
+#include "smooth/core/timer/TimerWheel.h"
 #include "smooth/core/ipc/TaskEventQueue.h"
 
 namespace smooth::core::timer
@@ -67,7 +68,7 @@ namespace smooth::core::timer
     /// A timer ensures that a context switch is made to the correct task before any processing takes place.
     /// This is done by sending an event on the provided event queue.
     class Timer
-        : public ITimer, public std::enable_shared_from_this<Timer>
+        : public ITimer, public std::enable_shared_from_this<Timer>, private TimerWheelNode
     {
         public:
             /// Factory method
@@ -138,7 +139,14 @@ namespace smooth::core::timer
 
             void calculate_next_execution();
 
+            /// Calculates the next expiry of a repeating timer based on the previous one so that the timer
+            /// doesn't drift, unless it has fallen behind by more than one interval.
+            void calculate_next_repetition(std::chrono::steady_clock::time_point now);
+
             std::weak_ptr<ipc::TaskEventQueue<TimerExpiredEvent>> queue;
             std::chrono::steady_clock::time_point expire_time;
+
+            // Keeps the timer alive while it is scheduled with the TimerService.
+            std::shared_ptr<Timer> scheduled_self{};
     };
 }
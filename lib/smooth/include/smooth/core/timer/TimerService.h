@@ -17,13 +17,13 @@ limitations under the License.
 
 #pragma once
 
-#include <algorithm>
+#include <chrono>
 #include <condition_variable>
-#include <functional>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include "smooth/core/Task.h"
+#include "smooth/core/timer/TimerWheel.h"
 
 namespace smooth::core::timer
 {
@@ -31,39 +31,10 @@ namespace smooth::core::timer
 
     using SharedTimer = std::shared_ptr<Timer>;
 
-    using TimerComparator = std::function<bool (SharedTimer left, SharedTimer right)>;
-
-    /// TimerQueue extends std::priority_queue with the ability to remove an item.
-    class TimerQueue
-        : public std::priority_queue<SharedTimer, std::vector<SharedTimer>, TimerComparator>
-    {
-        public:
-            explicit TimerQueue(const TimerComparator& cmp)
-                    :
-                      std::priority_queue<SharedTimer, std::vector<SharedTimer>, TimerComparator>(cmp)
-            {
-            }
-
-            void remove_timer(const SharedTimer& timer)
-            {
-                auto it = find_if(c.begin(),
-                                  c.end(),
-                                  [timer](const SharedTimer& o) {
-                                      // Compare pointers
-                                      bool found = timer == o;
-
-                                      return found;
-                                  });
-
-                if (it != c.end())
-                {
-                    c.erase(it);
-                }
-            }
-    };
-
     /// TimerService provides functionality to register a Timer that, when expired results in
     /// a message being posted to the Timer's event queue.
+    /// Timers are kept in a TimerWheel with a resolution of one millisecond so that starting and stopping
+    /// a timer takes constant time regardless of the number of running timers.
     /// \note You are not meant to use this class directly.
     class TimerService
         : private smooth::core::Task
@@ -83,8 +54,14 @@ namespace smooth::core::timer
             void tick() override;
 
         private:
-            TimerComparator cmp;
-            TimerQueue queue;
+            void expire(Timer& timer, std::chrono::steady_clock::time_point now);
+
+            /// Converts a time point to the wheel's tick, rounding up so that timers never expire early.
+            [[nodiscard]] uint64_t to_tick(std::chrono::steady_clock::time_point time) const;
+
+            TimerWheel wheel{};
+            const std::chrono::steady_clock::time_point epoch;
+            uint64_t wake_tick = TimerWheel::no_tick;
             std::mutex guard;
             std::condition_variable cond{};
     };
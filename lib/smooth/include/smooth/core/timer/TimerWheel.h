@@ -0,0 +1,117 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+
+namespace smooth::core::timer
+{
+    class TimerWheel;
+
+    /// The part of a timer that is linked into the TimerWheel. Kept in the timer itself so that
+    /// scheduling and cancelling never allocates.
+    class TimerWheelNode
+    {
+        public:
+            [[nodiscard]] bool is_scheduled() const
+            {
+                return level >= 0;
+            }
+
+            /// \return The tick at which the node expires, valid while scheduled.
+            [[nodiscard]] uint64_t get_expiry_tick() const
+            {
+                return expiry;
+            }
+
+        private:
+            friend TimerWheel;
+
+            TimerWheelNode* next = nullptr;
+            TimerWheelNode* prev = nullptr;
+            int level = -1;
+            size_t slot = 0;
+            uint64_t expiry = 0;
+    };
+
+    /// A hierarchical timing wheel; levels of 64 slots where each slot on a level covers all of the
+    /// level below it. Nodes are placed on the lowest level that can hold them and are moved down
+    /// (cascaded) as time passes, until they are in the lowest level where each slot is one tick.
+    /// Scheduling and cancelling are O(1), advancing is O(1) per tick plus the work of the
+    /// nodes expiring or cascading. Nodes further away than the range of the wheel are placed at
+    /// the far end and re-placed when cascaded.
+    /// The wheel is not thread-safe.
+    class TimerWheel
+    {
+        public:
+            static constexpr size_t slot_bits = 6;
+            static constexpr size_t slot_count = 1u << slot_bits;
+            static constexpr size_t level_count = 4;
+            static constexpr uint64_t no_tick = UINT64_MAX;
+
+            /// Schedules the node to expire at the given tick. A node that already is scheduled
+            /// is moved. Ticks that already have passed expire on the next advance().
+            void schedule(TimerWheelNode& node, uint64_t expiry_tick);
+
+            /// Cancels the node, if it is scheduled.
+            void cancel(TimerWheelNode& node);
+
+            /// Processes all ticks up to, and including, the given tick.
+            /// \param until The last tick to process.
+            /// \param on_expired Called with each expired node, after it has been removed from the wheel. It
+            /// may schedule the node it is called with again, but must not touch other nodes expiring on the same tick.
+            void advance(uint64_t until, const std::function<void(TimerWheelNode&)>& on_expired);
+
+            /// \return The next tick at which advance() has work to do, or no_tick if the wheel is empty.
+            [[nodiscard]] uint64_t next_tick_with_work() const;
+
+            /// \return The next tick to be processed.
+            [[nodiscard]] uint64_t get_current_tick() const
+            {
+                return current;
+            }
+
+            [[nodiscard]] bool empty() const
+            {
+                return count == 0;
+            }
+
+            [[nodiscard]] size_t size() const
+            {
+                return count;
+            }
+
+        private:
+            void link(TimerWheelNode& node);
+
+            void unlink(TimerWheelNode& node);
+
+            void cascade(size_t level);
+
+            void process_current_tick(const std::function<void(TimerWheelNode&)>& on_expired);
+
+            static size_t first_set_from(uint64_t bits, size_t start);
+
+            std::array<std::array<TimerWheelNode*, slot_count>, level_count> slots{};
+            std::array<uint64_t, level_count> occupied{};
+            uint64_t current = 0;
+            size_t count = 0;
+    };
+}
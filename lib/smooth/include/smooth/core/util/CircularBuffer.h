@@ -17,6 +17,8 @@ limitations under the License.
 
 #pragma once
 
+#include <utility>
+
 namespace smooth::core::util
 {
     /// \brief Interface for a circular buffer.
@@ -68,8 +70,21 @@ namespace smooth::core::util
 
             void put(const T& data) override;
 
+            /// Moves an item onto the buffer.
+            void put(T&& data);
+
             bool get(T& d) override;
 
+            /// Puts an item onto the buffer by swapping it with the slot it is stored in, without copying it.
+            /// \param data The item to put; receives the previous content of the slot, allowing any storage
+            /// it holds to be reused.
+            void exchange_put(T& data);
+
+            /// Gets an item by swapping it with the slot it is stored in, without copying it.
+            /// \param d Receives the item; its previous content is left in the buffer for reuse by exchange_put().
+            /// \return true on success, false on failure.
+            bool exchange_get(T& d);
+
             bool is_empty() override
             {
                 return count == 0;
@@ -97,6 +112,29 @@ namespace smooth::core::util
                 count = 0;
             }
 
+            /// Gives access to an item without removing it from the buffer.
+            /// \param index Index of the item, 0 being the oldest item.
+            /// \return A pointer to the item, or nullptr if there is no such item.
+            T* peek(int index)
+            {
+                return index >= 0 && index < count ? &buffer[(read_pos + index) % Size] : nullptr;
+            }
+
+            /// Removes the oldest item without copying it.
+            /// \return true if an item was removed, false if the buffer was empty.
+            bool drop()
+            {
+                bool res = !is_empty();
+
+                if (res)
+                {
+                    read_pos = next_pos(read_pos);
+                    --count;
+                }
+
+                return res;
+            }
+
             CircularBuffer(const CircularBuffer&) = delete;
 
             CircularBuffer& operator=(const CircularBuffer&) = delete;
@@ -107,6 +145,8 @@ namespace smooth::core::util
                 return (current + 1) % Size;
             }
 
+            void advance_write_pos();
+
             T buffer[static_cast<std::size_t>(Size)];
             int read_pos;
             int write_pos;
@@ -126,7 +166,27 @@ namespace smooth::core::util
     void CircularBuffer<T, Size>::put(const T& data)
     {
         buffer[write_pos] = data;
+        advance_write_pos();
+    }
+
+    template<typename T, int Size>
+    void CircularBuffer<T, Size>::put(T&& data)
+    {
+        buffer[write_pos] = std::move(data);
+        advance_write_pos();
+    }
+
+    template<typename T, int Size>
+    void CircularBuffer<T, Size>::exchange_put(T& data)
+    {
+        using std::swap;
+        swap(buffer[write_pos], data);
+        advance_write_pos();
+    }
 
+    template<typename T, int Size>
+    void CircularBuffer<T, Size>::advance_write_pos()
+    {
         if (!is_full())
         {
             ++count;
@@ -157,4 +217,22 @@ namespace smooth::core::util
 
         return res;
     }
+
+    template<typename T, int Size>
+    bool CircularBuffer<T, Size>::exchange_get(T& d)
+    {
+        bool res = false;
+
+        if (!is_empty())
+        {
+            using std::swap;
+            swap(buffer[read_pos], d);
+            read_pos = next_pos(read_pos);
+            --count;
+
+            res = true;
+        }
+
+        return res;
+    }
 }
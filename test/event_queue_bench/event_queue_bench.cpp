@@ -0,0 +1,151 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "event_queue_bench.h"
+#include <algorithm>
+#include <array>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace event_queue_bench
+{
+    static constexpr const char* tag = "Bench";
+
+    struct Round
+    {
+        size_t producers;
+        size_t batch_size;
+    };
+
+    static constexpr std::array<Round, 7> rounds{ { { 1, 1 }, { 2, 1 }, { 4, 1 }, { 8, 1 },
+                                                    { 4, 4 }, { 4, 16 }, { 4, 64 } } };
+    static constexpr seconds round_length{ 3 };
+    static constexpr size_t max_samples_per_producer = 200000;
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, milliseconds(500)),
+              queue(BenchQueue::create(1024, *this, *this))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+        start_round();
+    }
+
+    void App::tick()
+    {
+        if (running && steady_clock::now() - round_start > round_length)
+        {
+            stop_round();
+
+            if (++round < rounds.size())
+            {
+                start_round();
+            }
+            else
+            {
+                Log::info(tag, "Done");
+            }
+        }
+    }
+
+    void App::event(const BenchEvent& /*event*/)
+    {
+        ++received;
+    }
+
+    void App::start_round()
+    {
+        auto producer_count = rounds[round].producers;
+        set_event_batch_size(rounds[round].batch_size);
+
+        received = 0;
+        event_count_at_start = get_event_count();
+        wakeup_count_at_start = get_wakeup_count();
+        running = true;
+        latencies.clear();
+        latencies.resize(producer_count);
+        round_start = steady_clock::now();
+
+        for (size_t i = 0; i < producer_count; ++i)
+        {
+            latencies[i].reserve(max_samples_per_producer);
+            producers.emplace_back(&App::produce, this, static_cast<uint32_t>(i), std::ref(latencies[i]));
+        }
+    }
+
+    void App::stop_round()
+    {
+        running = false;
+
+        for (auto& t : producers)
+        {
+            t.join();
+        }
+
+        auto elapsed = duration_cast<milliseconds>(steady_clock::now() - round_start);
+
+        std::vector<nanoseconds> all;
+
+        for (auto& l : latencies)
+        {
+            all.insert(all.end(), l.begin(), l.end());
+        }
+
+        std::sort(all.begin(), all.end());
+
+        auto p99 = all.empty() ? nanoseconds(0) : all[all.size() * 99 / 100];
+
+        auto events = get_event_count() - event_count_at_start;
+        auto wakeups = std::max(get_wakeup_count() - wakeup_count_at_start, static_cast<uint64_t>(1));
+
+        Log::info(tag, "{} producer(s), batch size {}: {} events/s, {:.2f} events/wakeup, p99 push latency: {} ns",
+                  producers.size(),
+                  rounds[round].batch_size,
+                  received * 1000 / static_cast<uint64_t>(std::max(elapsed, milliseconds(1)).count()),
+                  static_cast<double>(events) / static_cast<double>(wakeups),
+                  p99.count());
+
+        producers.clear();
+    }
+
+    void App::produce(uint32_t id, std::vector<nanoseconds>& samples)
+    {
+        while (running)
+        {
+            auto start = steady_clock::now();
+            bool pushed = queue->push(BenchEvent{ id });
+            auto duration = steady_clock::now() - start;
+
+            if (!pushed)
+            {
+                // Queue is full, let the consumer catch up.
+                std::this_thread::yield();
+            }
+            else if (samples.size() < max_samples_per_producer)
+            {
+                samples.push_back(duration_cast<nanoseconds>(duration));
+            }
+        }
+    }
+}
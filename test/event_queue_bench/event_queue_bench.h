@@ -0,0 +1,80 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/ipc/TaskEventQueue.h"
+
+namespace event_queue_bench
+{
+    class BenchEvent
+    {
+        public:
+            BenchEvent() = default;
+
+            explicit BenchEvent(uint32_t producer)
+                    : producer(producer)
+            {
+            }
+
+            uint32_t producer = 0;
+    };
+
+    using BenchQueue = smooth::core::ipc::TaskEventQueue<BenchEvent>;
+
+    /// Feeds the application task from 1, 2, 4 and 8 producer threads for a fixed period each and
+    /// reports the number of events delivered per second and the p99 latency of push().
+    /// Then repeats with 4 producers while increasing the event batch size of the task,
+    /// reporting the number of events handled per wakeup.
+    class App
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<BenchEvent>
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void tick() override;
+
+            void event(const BenchEvent& event) override;
+
+        private:
+            void start_round();
+
+            void stop_round();
+
+            void produce(uint32_t id, std::vector<std::chrono::nanoseconds>& latencies);
+
+            std::shared_ptr<BenchQueue> queue;
+            std::vector<std::thread> producers{};
+            std::vector<std::vector<std::chrono::nanoseconds>> latencies{};
+            std::atomic_bool running{ false };
+            std::chrono::steady_clock::time_point round_start{};
+            uint64_t received = 0;
+            uint64_t event_count_at_start = 0;
+            uint64_t wakeup_count_at_start = 0;
+            size_t round = 0;
+    };
+}
@@ -0,0 +1,275 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_bench.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <malloc.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/HTTPProtocol.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/http/regular/ChunkedEncoding.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/responses/StreamingResponse.h"
+#include "smooth/core/network/PacketReceiveBuffer.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::core::network;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace std::chrono;
+
+namespace http_bench
+{
+    static constexpr std::size_t chunk_size = 4096;
+    static constexpr std::size_t stream_size = 50 * 1024 * 1024;
+
+    /// How much the heap may grow once the stream is under way before memory use is no longer constant.
+    static constexpr std::size_t heap_slack = 16 * 1024;
+
+    class NoResponse
+        : public IServerResponse
+    {
+        public:
+            void reply(std::unique_ptr<IResponseOperation>, bool) override
+            {
+            }
+
+            void reply_error(std::unique_ptr<IResponseOperation>) override
+            {
+                ++errors;
+            }
+
+            int errors{ 0 };
+
+        protected:
+            smooth::core::Task& get_task() override
+            {
+                throw std::logic_error("Not used");
+            }
+
+            void upgrade_to_websocket_internal() override
+            {}
+    };
+
+    using Receiver = PacketReceiveBuffer<HTTPProtocol, 5>;
+
+    /// Bytes currently allocated on the heap
+    static std::size_t heap_in_use()
+    {
+#if __GLIBC_PREREQ(2, 33)
+        return mallinfo2().uordblks;
+#else
+        return static_cast<std::size_t>(mallinfo().uordblks);
+#endif
+    }
+
+    static uint8_t pattern(std::size_t i)
+    {
+        return static_cast<uint8_t>(i * 31 + (i >> 12));
+    }
+
+    /// Same sequence of calls as Socket::read_data(), with the application taking each packet right away.
+    static void feed(Receiver& rx, const uint8_t* data, std::size_t length,
+                     const std::function<void(HTTPPacket&)>& receive)
+    {
+        std::size_t pos = 0;
+
+        while (pos < length)
+        {
+            auto wanted = static_cast<std::size_t>(rx.amount_wanted());
+            auto count = std::min(wanted, length - pos);
+
+            {
+                auto write_pos = rx.get_write_pos();
+                std::copy(data + pos, data + pos + count, static_cast<uint8_t*>(write_pos));
+            }
+
+            pos += count;
+            rx.data_received(static_cast<int>(count));
+
+            if (rx.is_packet_complete())
+            {
+                rx.prepare_new_packet();
+                HTTPPacket packet{};
+                rx.get(packet);
+                receive(packet);
+            }
+        }
+    }
+
+    static void chunked_upload()
+    {
+        NoResponse response{};
+        Receiver rx{ std::make_unique<HTTPProtocol>(1024, static_cast<int>(chunk_size), response) };
+
+        std::string headers = "POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n";
+        feed(rx, reinterpret_cast<const uint8_t*>(headers.data()), headers.size(), [](HTTPPacket&) {});
+
+        std::size_t received = 0;
+        std::size_t mismatches = 0;
+        std::size_t packets = 0;
+        std::size_t oversized = 0;
+        bool last_seen = false;
+        std::size_t baseline = 0;
+        std::size_t high_water = 0;
+
+        auto receive = [&](HTTPPacket& packet) {
+                           for (auto b : packet.data())
+                           {
+                               mismatches += b != pattern(received++) ? 1U : 0U;
+                           }
+
+                           oversized += packet.data().size() > chunk_size ? 1U : 0U;
+                           last_seen = !packet.is_continued();
+                           ++packets;
+                       };
+
+        std::vector<uint8_t> encoded{};
+        std::size_t sent = 0;
+        auto start = steady_clock::now();
+
+        while (sent < stream_size)
+        {
+            // A client decides its own chunk sizes, unrelated to the server's.
+            auto length = std::min(stream_size - sent, std::size_t{ 1000 } + (sent / 1000) % 9000);
+            encoded.clear();
+            chunked::append_chunk_start(length, encoded);
+
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                encoded.push_back(pattern(sent + i));
+            }
+
+            sent += length;
+            chunked::append_chunk_end(sent == stream_size, encoded);
+            feed(rx, encoded.data(), encoded.size(), receive);
+
+            if (sent < 1024 * 1024)
+            {
+                baseline = std::max(baseline, heap_in_use());
+            }
+            else
+            {
+                high_water = std::max(high_water, heap_in_use());
+            }
+        }
+
+        auto elapsed = duration<double>(steady_clock::now() - start).count();
+
+        Log::info(tag, "Chunked upload: {} MB, {:.0f} MB/s, {} packets, heap high-water {} bytes, {} in the first MB",
+                  stream_size / (1024 * 1024),
+                  static_cast<double>(stream_size) / elapsed / (1024 * 1024),
+                  packets, high_water, baseline);
+
+        if (received != stream_size || mismatches > 0 || oversized > 0 || !last_seen || response.errors > 0)
+        {
+            Log::error(tag, "Chunked upload: {} of {} bytes received, {} mismatches, {} oversized packets",
+                       received, stream_size, mismatches, oversized);
+        }
+
+        if (high_water > baseline + heap_slack)
+        {
+            Log::error(tag, "Chunked upload: heap grew by {} bytes while streaming", high_water - baseline);
+        }
+    }
+
+    static void chunked_response()
+    {
+        std::size_t produced = 0;
+
+        responses::StreamingResponse response{
+            ResponseCode::OK, "text/csv",
+            [&produced](std::size_t max_amount, std::vector<uint8_t>& target) {
+                auto count = std::min(max_amount, stream_size - produced);
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    target.push_back(pattern(produced++));
+                }
+
+                return produced < stream_size ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+            } };
+
+        ChunkedDecoder decoder{};
+        std::vector<uint8_t> data{};
+        std::vector<uint8_t> wire{};
+        std::size_t received = 0;
+        std::size_t mismatches = 0;
+        std::size_t baseline = 0;
+        std::size_t high_water = 0;
+        auto res = ResponseStatus::HasMoreData;
+        auto start = steady_clock::now();
+
+        while (res == ResponseStatus::HasMoreData)
+        {
+            // The framing HTTPServerClient puts around each part.
+            data.clear();
+            res = response.get_data(chunk_size, data);
+
+            wire.clear();
+            chunked::append_chunk_start(data.size(), wire);
+            wire.insert(wire.end(), data.begin(), data.end());
+            chunked::append_chunk_end(res == ResponseStatus::LastData, wire);
+
+            auto length = decoder.decode(wire.data(), wire.size());
+
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                mismatches += wire[i] != pattern(received++) ? 1U : 0U;
+            }
+
+            if (received < 1024 * 1024)
+            {
+                baseline = std::max(baseline, heap_in_use());
+            }
+            else
+            {
+                high_water = std::max(high_water, heap_in_use());
+            }
+        }
+
+        auto elapsed = duration<double>(steady_clock::now() - start).count();
+
+        Log::info(tag, "Chunked response: {} MB, {:.0f} MB/s, heap high-water {} bytes, {} in the first MB",
+                  stream_size / (1024 * 1024),
+                  static_cast<double>(stream_size) / elapsed / (1024 * 1024),
+                  high_water, baseline);
+
+        if (res != ResponseStatus::LastData || !decoder.is_done() || received != stream_size || mismatches > 0)
+        {
+            Log::error(tag, "Chunked response: {} of {} bytes received, {} mismatches",
+                       received, stream_size, mismatches);
+        }
+
+        if (high_water > baseline + heap_slack)
+        {
+            Log::error(tag, "Chunked response: heap grew by {} bytes while streaming", high_water - baseline);
+        }
+    }
+
+    void App::chunked()
+    {
+        chunked_upload();
+        chunked_response();
+    }
+}
@@ -0,0 +1,139 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_bench.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/compression/GzipCompressor.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::application::compression;
+using namespace std::chrono;
+
+namespace http_bench
+{
+    /// Script-like text, which compresses about as well as real JavaScript and CSS.
+    static std::vector<uint8_t> make_asset(std::size_t size, unsigned int seed)
+    {
+        static const std::vector<std::string> words{
+            "function ", "return ", "var ", "const ", "document.getElementById(", "addEventListener(", "'click'",
+            "this.", "value", "length", "=>", "{", "}", "(", ")", ";", ",", "if(", "else", "for(let i=0;i<",
+            ".style.", "display:none;", "margin:0 auto;", "color:#", "fetch('/api/", "JSON.parse(", "=", "+", "\n"
+        };
+
+        std::mt19937 rng{ seed };
+        std::uniform_int_distribution<std::size_t> pick{ 0, words.size() - 1 };
+        std::uniform_int_distribution<int> digit{ 0, 15 };
+
+        std::string res{};
+
+        while (res.size() < size)
+        {
+            auto w = pick(rng);
+            res += words[w];
+
+            if (w % 5 == 0)
+            {
+                res += "0123456789abcdef"[digit(rng)];
+            }
+        }
+
+        res.resize(size);
+
+        return { res.begin(), res.end() };
+    }
+
+    void App::gzip()
+    {
+        // A dashboard with 400 KB of scripts and style sheets, loaded over a link of about 1 MB/s
+        // which is what an ESP32 typically achieves over Wi-Fi.
+        constexpr double link_bytes_per_second = 1000000.0;
+
+        std::vector<std::vector<uint8_t>> assets{};
+        std::size_t total = 0;
+
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            assets.emplace_back(make_asset(30000 + i * 6000, i));
+            total += assets.back().size();
+        }
+
+        auto report = [&](const std::string& name, std::size_t transferred, double cpu_seconds) {
+                          auto load = static_cast<double>(transferred) / link_bytes_per_second + cpu_seconds;
+                          Log::info(tag, "Gzip {:>26}: {:>7} bytes ({:.1f}%), compression {:.2f} ms, "
+                                         "page load {:.2f} ms",
+                                    name,
+                                    transferred,
+                                    100.0 * static_cast<double>(transferred) / static_cast<double>(total),
+                                    cpu_seconds * 1000,
+                                    load * 1000);
+                      };
+
+        report("identity", total, 0.0);
+
+        for (uint8_t window_bits : std::vector<uint8_t>{ 9, 10, 12, 14 })
+        {
+            std::size_t transferred = 0;
+            auto start = steady_clock::now();
+
+            for (const auto& asset : assets)
+            {
+                GzipCompressor compressor{ window_bits };
+                std::vector<uint8_t> compressed{};
+
+                for (std::size_t offset = 0; offset < asset.size(); offset += 1024)
+                {
+                    compressor.write(asset.data() + offset, std::min<std::size_t>(1024, asset.size() - offset),
+                                     compressed);
+                }
+
+                compressor.finish(compressed);
+                transferred += compressed.size();
+            }
+
+            auto cpu = duration<double>(steady_clock::now() - start).count();
+
+            report("on-the-fly, window " + std::to_string(1 << window_bits), transferred, cpu);
+
+            if (transferred >= total / 2)
+            {
+                Log::error(tag, "Gzip: window {} compressed to more than half", 1 << window_bits);
+            }
+        }
+
+        std::size_t precompressed = 0;
+
+        for (const auto& asset : assets)
+        {
+            // Precompressed with zlib's default level, as a build step would, so no CPU time when serving.
+            uLongf size = compressBound(static_cast<uLong>(asset.size()));
+            std::vector<uint8_t> out(size);
+
+            if (compress2(out.data(), &size, asset.data(), static_cast<uLong>(asset.size()), 6) == Z_OK)
+            {
+                precompressed += size;
+            }
+        }
+
+        report("precompressed .gz", precompressed, 0.0);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_bench.h"
+#include <chrono>
+#include <string>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http::regular;
+using namespace std::chrono;
+
+namespace http_bench
+{
+    void App::header_parser()
+    {
+        const std::string request{
+            "GET /index.html?user=abc&id=1234 HTTP/1.1\r\n"
+            "Host: www.example.com:8080\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:68.0) Gecko/20100101 Firefox/68.0\r\n"
+            "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+            "Accept-Language: en-US,en;q=0.5\r\n"
+            "Accept-Encoding: gzip, deflate\r\n"
+            "Referer: http://www.example.com/start.html\r\n"
+            "Connection: keep-alive\r\n"
+            "Cookie: session=0123456789abcdef; theme=dark\r\n"
+            "Upgrade-Insecure-Requests: 1\r\n"
+            "Cache-Control: max-age=0\r\n"
+            "\r\n" };
+
+        HTTPHeaderParser p{};
+        const auto* data = reinterpret_cast<const uint8_t*>(request.data());
+        constexpr int iterations = 200000;
+        std::size_t parsed = 0;
+
+        auto start = steady_clock::now();
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            p.reset();
+
+            if (p.parse(data, request.size()) == HTTPHeaderParser::Result::Complete)
+            {
+                parsed += p.size();
+            }
+        }
+
+        auto elapsed = duration<double>(steady_clock::now() - start).count();
+        auto mb = static_cast<double>(request.size()) * iterations / (1024 * 1024);
+
+        Log::info(tag, "HTTPHeaderParser: {:.0f} requests/s, {:.0f} MB/s", iterations / elapsed, mb / elapsed);
+
+        if (parsed != 10 * static_cast<std::size_t>(iterations))
+        {
+            Log::error(tag, "HTTPHeaderParser: {} of {} headers parsed", parsed, 10 * iterations);
+        }
+    }
+}
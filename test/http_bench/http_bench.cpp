@@ -0,0 +1,48 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_bench.h"
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace http_bench
+{
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        header_parser();
+        template_processor();
+        request_router();
+        mime_parser();
+        websocket();
+        static_file_cache();
+        gzip();
+        chunked();
+
+        Log::info(tag, "Done");
+    }
+}
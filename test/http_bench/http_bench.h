@@ -0,0 +1,53 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include "smooth/core/Application.h"
+
+namespace http_bench
+{
+    /// Measures the building blocks of the HTTP server in isolation, without any sockets involved.
+    /// Each benchmark also checks its output, so that a fast but broken implementation doesn't go unnoticed.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            void init() override;
+
+        private:
+            void header_parser();
+
+            void template_processor();
+
+            void request_router();
+
+            void mime_parser();
+
+            void websocket();
+
+            void static_file_cache();
+
+            void gzip();
+
+            void chunked();
+    };
+
+    static constexpr const char* tag = "Bench";
+}
@@ -0,0 +1,128 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_bench.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/regular/MIMEParser.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http::regular;
+using namespace std::chrono;
+
+namespace http_bench
+{
+    class FormData
+        : public IFormData
+    {
+        public:
+            explicit FormData(const std::vector<uint8_t>& expected)
+                    : expected(expected)
+            {
+            }
+
+            void form_data(const std::string& /*name*/,
+                           const std::string& /*actual_file_name*/,
+                           const BoundaryIterator& begin,
+                           const BoundaryIterator& end,
+                           const bool /*file_start*/,
+                           const bool /*file_close*/) override
+            {
+                auto len = static_cast<std::size_t>(std::distance(begin, end));
+                correct = correct
+                          && received + len <= expected.size()
+                          && std::equal(begin, end, expected.cbegin() + static_cast<long>(received));
+                received += len;
+            }
+
+            const std::vector<uint8_t>& expected;
+            std::size_t received = 0;
+            bool correct = true;
+    };
+
+    class URLEncodedData
+        : public IURLEncodedData
+    {
+        public:
+            void url_encoded(std::unordered_map<std::string, std::string>& /*data*/) override
+            {
+            }
+    };
+
+    void App::mime_parser()
+    {
+        const std::string boundary = "---------------------------8819839691792623414370909194";
+
+        for (std::size_t size : { 1024u * 1024u, 20u * 1024u * 1024u })
+        {
+            // Pseudo-random content, with the occasional partial boundary to exercise the matcher.
+            std::vector<uint8_t> file(size);
+            uint32_t seed = 12345;
+
+            for (auto& b : file)
+            {
+                seed = seed * 1103515245 + 12345;
+                b = static_cast<uint8_t>(seed >> 16);
+            }
+
+            for (std::size_t i = 1000; i + boundary.size() < size; i += 100000)
+            {
+                std::string partial = "\r\n--" + boundary.substr(0, boundary.size() / 2);
+                std::copy(partial.begin(), partial.end(), file.begin() + static_cast<long>(i));
+            }
+
+            std::string head = "--" + boundary + "\r\n"
+                               + "Content-Disposition: form-data; name=\"file_to_upload\"; filename=\"data.bin\"\r\n"
+                               + "Content-Type: application/octet-stream\r\n\r\n";
+            std::string tail = "\r\n--" + boundary + "--\r\n";
+
+            std::vector<uint8_t> body{ head.begin(), head.end() };
+            body.insert(body.end(), file.begin(), file.end());
+            body.insert(body.end(), tail.begin(), tail.end());
+
+            // Received in 1460 byte segments, like TCP over Ethernet or Wi-Fi delivers it.
+            MIMEParser mime;
+            mime.detect_mode("multipart/form-data; boundary=" + boundary, body.size());
+
+            FormData form_data{ file };
+            URLEncodedData url_encoded{};
+
+            auto start = steady_clock::now();
+
+            for (std::size_t offset = 0; offset < body.size(); offset += 1460)
+            {
+                mime.parse(body.data() + offset, std::min<std::size_t>(1460, body.size() - offset),
+                           form_data, url_encoded, static_cast<uint16_t>(4096));
+            }
+
+            auto elapsed = duration<double>(steady_clock::now() - start).count();
+
+            Log::info(tag, "MIMEParser: {} MB upload, {:.0f} MB/s",
+                      size / (1024 * 1024),
+                      static_cast<double>(body.size()) / elapsed / (1024 * 1024));
+
+            if (!form_data.correct || form_data.received != file.size())
+            {
+                Log::error(tag, "MIMEParser: {} of {} bytes received intact", form_data.received, file.size());
+            }
+        }
+    }
+}
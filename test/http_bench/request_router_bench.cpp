@@ -0,0 +1,121 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_bench.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/core/filesystem/Path.h"
+#include "smooth/application/network/http/regular/RequestRouter.h"
+#include "smooth/application/network/http/regular/HTTPRequestHandler.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::core::filesystem;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace std::chrono;
+
+namespace http_bench
+{
+    class NoHandler
+        : public HTTPRequestHandler
+    {
+        public:
+            void request(IConnectionTimeoutModifier& /*timeout_modifier*/,
+                         const std::string& /*url*/,
+                         const std::vector<uint8_t>& /*content*/) override
+            {
+            }
+    };
+
+    void App::request_router()
+    {
+        // 500 routes, half of them with parameters
+        using HandlerByURL = std::unordered_map<std::string, std::shared_ptr<HTTPRequestHandler>>;
+        std::unordered_map<HTTPMethod, HandlerByURL> map{};
+        RequestRouter router{};
+        std::vector<std::string> static_urls{};
+        std::vector<std::string> param_urls{};
+        auto handler = std::make_shared<NoHandler>();
+        const Path web_root{ "/tmp/smooth_request_router_bench" };
+
+        for (int i = 0; i < 250; ++i)
+        {
+            auto group = "/api/group" + std::to_string(i / 10);
+            auto item = group + "/item" + std::to_string(i);
+            map[HTTPMethod::GET][item] = handler;
+            router.add(HTTPMethod::GET, item, handler);
+            static_urls.emplace_back(item);
+
+            // The map can only hold the static part; the parameterised URLs miss and fall back to the file system.
+            router.add(HTTPMethod::GET, item + "/{id}", handler);
+            param_urls.emplace_back(item + "/" + std::to_string(i * 7));
+        }
+
+        constexpr std::size_t iterations = 200;
+        std::size_t found = 0;
+        std::size_t routed = 0;
+
+        auto start = steady_clock::now();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            for (std::size_t u = 0; u < static_urls.size(); ++u)
+            {
+                auto& by_url = map[HTTPMethod::GET];
+                found += by_url.find(static_urls[u]) != by_url.end() ? 1U : 0U;
+
+                if (by_url.find(param_urls[u]) == by_url.end())
+                {
+                    FileInfo info(web_root / param_urls[u]);
+                    found += info.exists() ? 1U : 0U;
+                }
+            }
+        }
+
+        auto map_ns = duration<double, std::nano>(steady_clock::now() - start).count();
+
+        start = steady_clock::now();
+        RouteParameters params{};
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            for (std::size_t u = 0; u < static_urls.size(); ++u)
+            {
+                routed += router.find(HTTPMethod::GET, static_urls[u], params) ? 1U : 0U;
+                routed += router.find(HTTPMethod::GET, param_urls[u], params) ? 1U : 0U;
+            }
+        }
+
+        auto router_ns = duration<double, std::nano>(steady_clock::now() - start).count();
+        const auto lookups = iterations * static_urls.size() * 2;
+
+        Log::info(tag, "RequestRouter: map + file system {:.0f} ns/lookup, router {:.0f} ns/lookup",
+                  map_ns / static_cast<double>(lookups),
+                  router_ns / static_cast<double>(lookups));
+
+        // The map only finds the static routes, as the parameterised ones don't exist on the file system.
+        if (found != lookups / 2 || routed != lookups)
+        {
+            Log::error(tag, "RequestRouter: {} of {} routes found", routed, lookups);
+        }
+    }
+}
@@ -0,0 +1,152 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_bench.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/filesystem/FSLock.h"
+#include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/application/network/http/regular/StaticFileCache.h"
+#include "smooth/application/network/http/regular/responses/CachedFileResponse.h"
+#include "smooth/application/network/http/regular/responses/FileContentResponse.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::core::filesystem;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace std::chrono;
+
+namespace http_bench
+{
+    static std::size_t send_all(IResponseOperation& response)
+    {
+        std::size_t total = 0;
+        auto res = ResponseStatus::HasMoreData;
+
+        while (res == ResponseStatus::HasMoreData)
+        {
+            std::shared_ptr<const uint8_t> data{};
+            std::size_t length = 0;
+            res = response.get_data_view(1024, data, length);
+            total += length;
+        }
+
+        return total;
+    }
+
+    void App::static_file_cache()
+    {
+        FSLock::set_limit(5);
+
+        // A page with 30 assets of 1 - 8 KB
+        const Path web_root{ "/tmp/smooth_static_file_cache_bench" };
+        mkdir(web_root.str().c_str(), 0755);
+
+        std::vector<std::string> urls{};
+        std::size_t page_size = 0;
+
+        for (std::size_t i = 0; i < 30; ++i)
+        {
+            auto url = "asset" + std::to_string(i) + (i % 2 ? ".js" : ".css");
+            std::ofstream out((web_root / url).str(), std::ios::binary | std::ios::trunc);
+            out << std::string(1024 + i * 240, 'a');
+            page_size += 1024 + i * 240;
+            urls.emplace_back(url);
+        }
+
+        constexpr std::size_t pages = 500;
+        std::size_t uncached_served = 0;
+
+        // What serve_file did before: resolve and stat the path, then serve the file from the file system.
+        auto start = steady_clock::now();
+
+        for (std::size_t p = 0; p < pages; ++p)
+        {
+            for (const auto& url : urls)
+            {
+                Path search{ web_root };
+                search /= url;
+
+                if (web_root.is_parent_of(search))
+                {
+                    FileInfo info(search);
+
+                    if (info.is_regular_file())
+                    {
+                        responses::FileContentResponse response{ search };
+                        uncached_served += send_all(response);
+                    }
+                }
+            }
+        }
+
+        auto uncached = duration<double>(steady_clock::now() - start).count();
+
+        StaticFileCache cache{ web_root, { "index.html" }, {}, 1024 * 1024, 64 * 1024, seconds(1) };
+        std::size_t cold_served = 0;
+
+        start = steady_clock::now();
+
+        for (std::size_t p = 0; p < pages; ++p)
+        {
+            cache.clear();
+
+            for (const auto& url : urls)
+            {
+                responses::CachedFileResponse response{ cache.get(url) };
+                cold_served += send_all(response);
+            }
+        }
+
+        auto cold = duration<double>(steady_clock::now() - start).count();
+        std::size_t warm_served = 0;
+
+        start = steady_clock::now();
+
+        for (std::size_t p = 0; p < pages; ++p)
+        {
+            for (const auto& url : urls)
+            {
+                responses::CachedFileResponse response{ cache.get(url) };
+                warm_served += send_all(response);
+            }
+        }
+
+        auto warm = duration<double>(steady_clock::now() - start).count();
+        auto requests = static_cast<double>(pages * urls.size());
+
+        Log::info(tag, "StaticFileCache: requests/s without cache {:.0f}, cold cache {:.0f}, warm cache {:.0f}",
+                  requests / uncached, requests / cold, requests / warm);
+
+        if (uncached_served != pages * page_size
+            || cold_served != pages * page_size
+            || warm_served != pages * page_size)
+        {
+            Log::error(tag, "StaticFileCache: not all assets were served");
+        }
+
+        for (const auto& url : urls)
+        {
+            std::remove((web_root / url).str().c_str());
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_bench.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/filesystem/FSLock.h"
+#include "smooth/application/network/http/regular/TemplateProcessor.h"
+#include "smooth/application/network/http/regular/ITemplateDataRetriever.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::core::filesystem;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace std::chrono;
+
+namespace http_bench
+{
+    class DataRetriever
+        : public ITemplateDataRetriever
+    {
+        public:
+            void add(const std::string& key, const std::string& value)
+            {
+                data[key] = value;
+            }
+
+            std::string get(const std::string& key) const override
+            {
+                auto it = data.find(key);
+
+                return it == data.end() ? std::string{} : it->second;
+            }
+
+        private:
+            std::unordered_map<std::string, std::string> data{};
+    };
+
+    void App::template_processor()
+    {
+        FSLock::set_limit(5);
+
+        // A 50 KB template with 200 tokens
+        const Path path{ "/tmp/smooth_template_bench.html" };
+        auto dr = std::make_shared<DataRetriever>();
+        std::string content{};
+        std::string expected{};
+
+        for (int i = 0; i < 200; ++i)
+        {
+            auto key = "{{value_" + std::to_string(i % 50) + "}}";
+            auto value = "value " + std::to_string(i % 50);
+            dr->add(key, value);
+            content.append(std::string(240, 'x')).append(key);
+            expected.append(std::string(240, 'x')).append(value);
+        }
+
+        {
+            std::ofstream out{ path.str(), std::ios::binary | std::ios::trunc };
+            out << content;
+        }
+
+        TemplateProcessor tp({ ".html" }, dr);
+
+        constexpr int iterations = 500;
+        std::size_t rendered = 0;
+        bool correct = true;
+        std::vector<uint8_t> page{};
+
+        auto start = steady_clock::now();
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto response = tp.process_template(path);
+            auto status = ResponseStatus::HasMoreData;
+            page.clear();
+
+            while (status == ResponseStatus::HasMoreData)
+            {
+                status = response->get_data(1024, page);
+            }
+
+            correct = correct && std::equal(page.begin(), page.end(), expected.begin(), expected.end());
+            rendered += page.size();
+        }
+
+        auto elapsed = duration<double>(steady_clock::now() - start).count();
+
+        Log::info(tag, "TemplateProcessor: {:.0f} pages/s, {:.0f} MB/s",
+                  iterations / elapsed,
+                  static_cast<double>(rendered) / elapsed / (1024 * 1024));
+
+        if (!correct)
+        {
+            Log::error(tag, "TemplateProcessor: pages rendered incorrectly");
+        }
+
+        std::remove(path);
+    }
+}
@@ -0,0 +1,105 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_bench.h"
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/websocket/Masking.h"
+#include "smooth/application/network/http/websocket/responses/WSResponse.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::websocket;
+using namespace smooth::application::network::http::websocket::responses;
+using namespace std::chrono;
+
+namespace http_bench
+{
+    void App::websocket()
+    {
+        const uint8_t key[4] = { 0x12, 0x34, 0x56, 0x78 };
+
+        for (std::size_t size : { 125u, 4096u, 65536u })
+        {
+            std::vector<uint8_t> data(size);
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                data[i] = static_cast<uint8_t>(i * 31 + 7);
+            }
+
+            const auto iterations = static_cast<std::size_t>(256 * 1024 * 1024) / size;
+            auto bytewise_data = data;
+
+            auto start = steady_clock::now();
+            uint64_t byte_ix = 0;
+
+            for (std::size_t n = 0; n < iterations; ++n)
+            {
+                // The previous implementation
+                for (std::size_t i = 0; i < bytewise_data.size(); ++i, ++byte_ix)
+                {
+                    bytewise_data[i] = static_cast<uint8_t>(bytewise_data[i] ^ key[byte_ix % 4]);
+                }
+            }
+
+            auto bytewise = duration<double>(steady_clock::now() - start).count();
+
+            start = steady_clock::now();
+            uint64_t offset = 0;
+
+            for (std::size_t n = 0; n < iterations; ++n)
+            {
+                apply_mask(data.data(), data.size(), key, offset);
+            }
+
+            auto wordwise = duration<double>(steady_clock::now() - start).count();
+
+            start = steady_clock::now();
+            std::size_t framed = 0;
+            auto payload = std::make_shared<const std::vector<uint8_t>>(data);
+
+            for (std::size_t n = 0; n < iterations; ++n)
+            {
+                WSResponse response{ payload, false, true, true };
+                auto res = ResponseStatus::HasMoreData;
+
+                while (res == ResponseStatus::HasMoreData)
+                {
+                    std::shared_ptr<const uint8_t> view{};
+                    std::size_t length = 0;
+                    res = response.get_data_view(4096, view, length);
+                    framed += length;
+                }
+            }
+
+            auto sending = duration<double>(steady_clock::now() - start).count();
+            auto mb = static_cast<double>(iterations * size) / (1024 * 1024);
+
+            Log::info(tag, "Websocket {} B messages: unmask byte-wise {:.0f} MB/s, word-wise {:.0f} MB/s; "
+                           "framing {:.0f} MB/s",
+                      size, mb / bytewise, mb / wordwise, mb / sending);
+
+            if (data != bytewise_data || framed <= iterations * size)
+            {
+                Log::error(tag, "Websocket {} B messages: masking or framing is wrong", size);
+            }
+        }
+    }
+}
@@ -0,0 +1,193 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "http_file_bench.h"
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/filesystem/FSLock.h"
+#include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/Wifi.h"
+
+using namespace smooth::core;
+using namespace smooth::core::filesystem;
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http;
+using namespace std::chrono;
+
+namespace http_file_bench
+{
+    static constexpr uint16_t port = 8082;
+    static constexpr auto round_length = seconds(3);
+    static const char* tag = "Bench";
+    static const char* web_root = "/tmp/smooth_http_file_bench";
+
+    struct BenchFile
+    {
+        const char* name;
+        std::size_t size;
+    };
+
+    // 60k.bin fits the file cache, so it is the one whose chunks are pulled by the socket when the
+    // response look-ahead is enabled; the larger files are read from storage by the server task.
+    static constexpr std::array<BenchFile, 4> files{ { { "1k.bin", 1024 },
+                                                       { "60k.bin", 60 * 1024 },
+                                                       { "100k.bin", 100 * 1024 },
+                                                       { "10m.bin", 10 * 1024 * 1024 } } };
+
+    static double cpu_seconds()
+    {
+        timespec t{};
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+
+        return static_cast<double>(t.tv_sec) + static_cast<double>(t.tv_nsec) / 1e9;
+    }
+
+    App::App()
+            : Application(smooth::core::APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    App::~App()
+    {
+        if (client.joinable())
+        {
+            client.join();
+        }
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        // On Linux this only announces that the network is up.
+        get_wifi().connect_to_ap();
+
+        mkdir(web_root, 0700);
+
+        for (const auto& f : files)
+        {
+            std::ofstream out(std::string{ web_root } + "/" + f.name, std::ios::binary | std::ios::trunc);
+            std::string content(f.size, 'S');
+            out.write(content.data(), static_cast<std::streamsize>(content.size()));
+        }
+
+        FSLock::set_limit(5);
+
+        HTTPServerConfig cfg{ Path{ web_root }, { "index.html" }, { ".html" }, nullptr, MaxHeaderSize,
+                              ContentChunkSize, MaxResponses };
+
+        server = std::make_unique<InsecureServer>(*this, cfg);
+        server->start(2, 2, std::make_shared<network::IPv4>("127.0.0.1", port));
+
+        client = std::thread([this]() { run_client(); });
+    }
+
+    void App::run_client()
+    {
+        // Let the server start listening
+        std::this_thread::sleep_for(milliseconds(500));
+
+        auto s = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0)
+        {
+            // Compare against a run with the look-ahead set to 0, where the task provides each chunk.
+            Log::info(tag, "Response look-ahead: {} chunks", CONFIG_SMOOTH_HTTP_RESPONSE_LOOK_AHEAD);
+
+            for (const auto& f : files)
+            {
+                download(s, f.name, f.size);
+            }
+
+            Log::info(tag, "Done");
+        }
+        else
+        {
+            Log::error(tag, "Could not connect to server");
+        }
+
+        close(s);
+    }
+
+    void App::download(int s, const std::string& name, std::size_t size)
+    {
+        const std::string request = "GET /" + name + " HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n";
+        std::vector<char> buff(64 * 1024);
+
+        std::size_t requests = 0;
+        std::size_t body_bytes = 0;
+        bool ok = true;
+        auto start = steady_clock::now();
+        auto cpu_start = cpu_seconds();
+
+        while (ok && steady_clock::now() - start < round_length)
+        {
+            ok = send(s, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size());
+
+            // Read the headers, then the body; Content-Length is known from the file size.
+            std::string received{};
+            std::size_t header_end = std::string::npos;
+
+            while (ok && header_end == std::string::npos)
+            {
+                auto count = recv(s, buff.data(), buff.size(), 0);
+                ok = count > 0;
+                received.append(buff.data(), ok ? static_cast<std::size_t>(count) : 0);
+                header_end = received.find("\r\n\r\n");
+            }
+
+            std::size_t body = ok ? received.size() - header_end - 4 : 0;
+
+            while (ok && body < size)
+            {
+                auto count = recv(s, buff.data(), std::min(buff.size(), size - body), 0);
+                ok = count > 0;
+                body += ok ? static_cast<std::size_t>(count) : 0;
+            }
+
+            if (ok)
+            {
+                ++requests;
+                body_bytes += body;
+            }
+        }
+
+        auto elapsed = duration_cast<duration<double>>(steady_clock::now() - start).count();
+        auto cpu = cpu_seconds() - cpu_start;
+        auto mb = static_cast<double>(body_bytes) / (1024.0 * 1024.0);
+
+        Log::info(tag, "{:>8}: {} requests, {:.1f} req/s, {:.1f} MB/s, {:.2f} ms CPU per MB",
+                  name, requests, static_cast<double>(requests) / elapsed, mb / elapsed,
+                  mb > 0 ? cpu * 1000.0 / mb : 0.0);
+    }
+}
@@ -0,0 +1,52 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+#include "smooth/core/Application.h"
+#include "smooth/application/network/http/HTTPServer.h"
+
+namespace http_file_bench
+{
+    /// Serves files of 1 KB, 100 KB and 10 MB from a temporary web root and downloads each of them
+    /// repeatedly over a keep-alive loopback connection, reporting throughput and CPU time per MB.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            ~App() override;
+
+            void init() override;
+
+        private:
+            void run_client();
+
+            void download(int socket, const std::string& name, std::size_t size);
+
+            static constexpr int MaxHeaderSize = 1024;
+            static constexpr int ContentChunkSize = 4096;
+            static constexpr int MaxResponses = 10;
+
+            std::unique_ptr<smooth::application::network::http::InsecureServer> server{};
+            std::thread client{};
+    };
+}
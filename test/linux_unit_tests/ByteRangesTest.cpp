@@ -0,0 +1,286 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "smooth/application/network/http/regular/ByteRanges.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/StaticFileCache.h"
+#include "smooth/application/network/http/regular/responses/CachedFileResponse.h"
+#include "smooth/application/network/http/regular/responses/FileContentResponse.h"
+#include "smooth/core/filesystem/FSLock.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::core::filesystem;
+using namespace std::chrono;
+
+static const Path range_root{ "/tmp/byte_ranges_test" };
+
+static std::vector<uint8_t> make_file(const Path& path, std::size_t size)
+{
+    std::mt19937 gen{ 1234 };
+    std::vector<uint8_t> content(size);
+
+    for (auto& b : content)
+    {
+        b = static_cast<uint8_t>(gen());
+    }
+
+    mkdir(range_root.str().c_str(), 0755);
+    std::ofstream out(path.str(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+
+    return content;
+}
+
+// Receives up to max_total bytes of the body, using the data view or copying as a client connection would.
+static ResponseStatus receive(IResponseOperation& response,
+                              bool use_view,
+                              std::size_t max_total,
+                              std::vector<uint8_t>& received)
+{
+    auto res = ResponseStatus::HasMoreData;
+    std::size_t total = 0;
+
+    while (res == ResponseStatus::HasMoreData && total < max_total)
+    {
+        if (use_view)
+        {
+            std::shared_ptr<const uint8_t> data{};
+            std::size_t length = 0;
+            res = response.get_data_view(4096, data, length);
+
+            if (length > 0)
+            {
+                received.insert(received.end(), data.get(), data.get() + length);
+            }
+
+            total += length;
+        }
+        else
+        {
+            std::vector<uint8_t> data{};
+            res = response.get_data(4096, data);
+            received.insert(received.end(), data.begin(), data.end());
+            total += data.size();
+        }
+    }
+
+    return res;
+}
+
+static ByteRanges parse(const std::string& value, std::size_t size)
+{
+    ByteRanges ranges{};
+    REQUIRE(ranges.parse(value, size));
+
+    return ranges;
+}
+
+static std::string range_string(const ByteRanges& ranges)
+{
+    std::string res{};
+
+    for (const auto& r : ranges.get())
+    {
+        res += (res.empty() ? "" : ",") + std::to_string(r.first) + "-" + std::to_string(r.last);
+    }
+
+    return res;
+}
+
+SCENARIO("ByteRanges - parsing Range headers")
+{
+    GIVEN("A representation of 1000 bytes")
+    {
+        THEN("Valid ranges are clipped to the representation")
+        {
+            REQUIRE(range_string(parse("bytes=0-499", 1000)) == "0-499");
+            REQUIRE(range_string(parse("bytes=500-", 1000)) == "500-999");
+            REQUIRE(range_string(parse("bytes=-200", 1000)) == "800-999");
+            REQUIRE(range_string(parse("bytes=-2000", 1000)) == "0-999");
+            REQUIRE(range_string(parse("bytes=900-5000", 1000)) == "900-999");
+            REQUIRE(range_string(parse("bytes=0-0,-1", 1000)) == "0-0,999-999");
+            REQUIRE(range_string(parse(" Bytes = 1-2 , , 4-5,", 1000)) == "1-2,4-5");
+            REQUIRE(range_string(parse("bytes=2000-3000,10-19", 1000)) == "10-19");
+            REQUIRE(range_string(parse("bytes=0-99999999999999999", 1000)) == "0-999");
+        }
+
+        THEN("Ranges outside the representation are not satisfiable")
+        {
+            REQUIRE_FALSE(parse("bytes=1000-", 1000).is_satisfiable());
+            REQUIRE_FALSE(parse("bytes=-0", 1000).is_satisfiable());
+            REQUIRE_FALSE(parse("bytes=0-10", 0).is_satisfiable());
+            REQUIRE(ByteRanges::unsatisfied_range(1000) == "bytes */1000");
+        }
+
+        THEN("Invalid headers are ignored")
+        {
+            ByteRanges ranges{};
+
+            for (const auto* value : { "", "bytes", "bytes=", "bytes=,", "items=0-1", "bytes=5-4", "bytes=a-b",
+                                       "bytes=1", "bytes=--5", "bytes=0-1;2-3", "bytes=1-2-3",
+                                       "bytes=0-999999999999999999999" })
+            {
+                INFO(value);
+                REQUIRE_FALSE(ranges.parse(value, 1000));
+                REQUIRE_FALSE(ranges.is_satisfiable());
+            }
+
+            std::string many = "bytes=0-0";
+
+            for (std::size_t i = 1; i <= ByteRanges::max_ranges; ++i)
+            {
+                many += "," + std::to_string(i) + "-" + std::to_string(i);
+            }
+
+            REQUIRE_FALSE(ranges.parse(many, 1000));
+        }
+    }
+}
+
+SCENARIO("ByteRanges - multipart/byteranges body")
+{
+    FSLock::set_limit(5);
+    auto path = range_root / "multi.bin";
+    auto content = make_file(path, 100);
+
+    GIVEN("A request for several ranges")
+    {
+        responses::FileContentResponse response{ path };
+        response.set_ranges(parse("bytes=0-9,20-29,-5", content.size()));
+
+        THEN("Each range is sent as a part with its own Content-Range")
+        {
+            REQUIRE(response.get_response_code() == ResponseCode::Partial_Content);
+            const auto& headers = response.get_headers();
+            REQUIRE(headers.count(CONTENT_RANGE) == 0);
+
+            const auto& type = headers.at(CONTENT_TYPE);
+            const std::string prefix = "multipart/byteranges; boundary=";
+            REQUIRE(type.find(prefix) == 0);
+            const auto boundary = type.substr(prefix.size());
+
+            std::vector<uint8_t> body{};
+            REQUIRE(receive(response, true, body.max_size(), body) == ResponseStatus::LastData);
+            REQUIRE(headers.at(CONTENT_LENGTH) == std::to_string(body.size()));
+
+            std::string expected{};
+            std::vector<std::pair<std::size_t, std::size_t>> parts{ { 0, 9 }, { 20, 29 }, { 95, 99 } };
+
+            for (const auto& part : parts)
+            {
+                expected += expected.empty() ? "--" : "\r\n--";
+                expected += boundary + "\r\nContent-Type: application/octet-stream\r\n";
+                expected += "Content-Range: bytes " + std::to_string(part.first) + "-" + std::to_string(part.second)
+                            + "/100\r\n\r\n";
+                expected.append(content.begin() + static_cast<long>(part.first),
+                                content.begin() + static_cast<long>(part.second) + 1);
+            }
+
+            expected += "\r\n--" + boundary + "--\r\n";
+
+            REQUIRE(std::string(body.begin(), body.end()) == expected);
+        }
+    }
+
+    GIVEN("A request for a single range")
+    {
+        responses::FileContentResponse response{ path };
+        response.set_ranges(parse("bytes=10-", content.size()));
+
+        THEN("It is sent as is")
+        {
+            REQUIRE(response.get_response_code() == ResponseCode::Partial_Content);
+            REQUIRE(response.get_headers().at(CONTENT_RANGE) == "bytes 10-99/100");
+            REQUIRE(response.get_headers().at(CONTENT_LENGTH) == "90");
+            REQUIRE(response.get_headers().at(CONTENT_TYPE) == "application/octet-stream");
+
+            std::vector<uint8_t> body{};
+            REQUIRE(receive(response, false, body.max_size(), body) == ResponseStatus::LastData);
+            REQUIRE(body == std::vector<uint8_t>(content.begin() + 10, content.end()));
+        }
+    }
+}
+
+SCENARIO("ByteRanges - resuming an interrupted 10 MB download")
+{
+    FSLock::set_limit(5);
+    auto path = range_root / "bundle.bin";
+    const std::size_t size = 10 * 1024 * 1024;
+    auto content = make_file(path, size);
+
+    StaticFileCache cache{ range_root, {}, {}, 2 * size, 2 * size, seconds(10) };
+    auto cached = cache.get("bundle.bin");
+    REQUIRE(cached);
+    REQUIRE(cached->content);
+
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<std::size_t> dropped_after{ 1, size / 4 };
+
+    for (const auto* variant : { "file view", "file copy", "cached" })
+    {
+        GIVEN(std::string("A download through a ") + variant + " response that is dropped at random offsets")
+        {
+            std::vector<uint8_t> received{};
+            std::size_t attempts = 0;
+            auto res = ResponseStatus::HasMoreData;
+
+            while (res != ResponseStatus::LastData && attempts < 100)
+            {
+                ++attempts;
+                std::unique_ptr<IResponseOperation> response{};
+                auto offset = received.size();
+                auto ranges = parse("bytes=" + std::to_string(offset) + "-", size);
+
+                if (std::string(variant) == "cached")
+                {
+                    auto r = std::make_unique<responses::CachedFileResponse>(cached);
+                    r->set_ranges(ranges);
+                    response = std::move(r);
+                }
+                else
+                {
+                    auto r = std::make_unique<responses::FileContentResponse>(path);
+                    r->set_ranges(ranges);
+                    response = std::move(r);
+                }
+
+                REQUIRE(response->get_response_code() == ResponseCode::Partial_Content);
+                REQUIRE(response->get_headers().at(CONTENT_RANGE)
+                        == "bytes " + std::to_string(offset) + "-" + std::to_string(size - 1) + "/"
+                        + std::to_string(size));
+                REQUIRE(response->get_headers().at(CONTENT_LENGTH) == std::to_string(size - offset));
+
+                res = receive(*response, std::string(variant) != "file copy", dropped_after(gen), received);
+                REQUIRE(res != ResponseStatus::Error);
+            }
+
+            THEN("The resumed download is identical to the file")
+            {
+                REQUIRE(attempts > 1);
+                REQUIRE(received.size() == size);
+                REQUIRE(received == content);
+            }
+        }
+    }
+}
@@ -0,0 +1,381 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "smooth/application/network/http/HTTPProtocol.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/http/regular/ChunkedEncoding.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/responses/StreamingResponse.h"
+#include "smooth/core/network/PacketReceiveBuffer.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::core::network;
+
+static constexpr std::size_t chunk_size = 4096;
+static constexpr std::size_t stream_size = 256 * 1024;
+
+class NoResponse
+    : public IServerResponse
+{
+    public:
+        void reply(std::unique_ptr<IResponseOperation>, bool) override
+        {
+            ++replies;
+        }
+
+        void reply_error(std::unique_ptr<IResponseOperation>) override
+        {
+            ++errors;
+        }
+
+        int replies{ 0 };
+        int errors{ 0 };
+
+    protected:
+        smooth::core::Task& get_task() override
+        {
+            throw std::logic_error("Not used");
+        }
+
+        void upgrade_to_websocket_internal() override
+        {}
+};
+
+using Receiver = PacketReceiveBuffer<HTTPProtocol, 5>;
+
+static uint8_t pattern(std::size_t i)
+{
+    return static_cast<uint8_t>(i * 31 + (i >> 12));
+}
+
+static std::string to_string(const std::vector<uint8_t>& v)
+{
+    return { v.begin(), v.end() };
+}
+
+static std::vector<uint8_t> to_vector(const std::string& s)
+{
+    return { s.begin(), s.end() };
+}
+
+// Same sequence of calls as Socket::read_data(), with the application taking each packet right away.
+static void feed(Receiver& rx, const uint8_t* data, std::size_t length,
+                 const std::function<void(HTTPPacket&)>& receive)
+{
+    std::size_t pos = 0;
+
+    while (pos < length)
+    {
+        auto wanted = static_cast<std::size_t>(rx.amount_wanted());
+        auto count = std::min(wanted, length - pos);
+
+        {
+            auto write_pos = rx.get_write_pos();
+            std::copy(data + pos, data + pos + count, static_cast<uint8_t*>(write_pos));
+        }
+
+        pos += count;
+        rx.data_received(static_cast<int>(count));
+
+        if (rx.is_packet_complete())
+        {
+            rx.prepare_new_packet();
+            HTTPPacket packet{};
+            rx.get(packet);
+            receive(packet);
+        }
+    }
+}
+
+SCENARIO("ChunkedDecoder - decoding")
+{
+    const std::string encoded = "4\r\nWiki\r\n5;name=value\r\npedia\r\nE\r\n in\r\n\r\nchunks.\r\n0\r\nExpires: never\r\n\r\n";
+    const std::string decoded = "Wikipedia in\r\n\r\nchunks.";
+
+    GIVEN("All data at once")
+    {
+        ChunkedDecoder decoder{};
+        auto data = to_vector(encoded + "GET / HTTP/1.1");
+        auto length = decoder.decode(data.data(), data.size());
+
+        THEN("The body is decoded, ignoring what follows it")
+        {
+            REQUIRE(decoder.is_done());
+            REQUIRE(std::string(data.begin(), data.begin() + static_cast<long>(length)) == decoded);
+            REQUIRE(decoder.get_wanted_amount(100) == 0);
+        }
+    }
+
+    GIVEN("Data as much as the decoder wants")
+    {
+        ChunkedDecoder decoder{};
+        std::string result{};
+        std::size_t pos = 0;
+
+        while (!decoder.is_done() && !decoder.is_error())
+        {
+            auto count = std::min(decoder.get_wanted_amount(4), encoded.size() - pos);
+            REQUIRE(count > 0);
+            auto data = to_vector(encoded.substr(pos, count));
+            pos += count;
+            auto length = decoder.decode(data.data(), data.size());
+            result.append(data.begin(), data.begin() + static_cast<long>(length));
+        }
+
+        THEN("The body is decoded without reading beyond it")
+        {
+            REQUIRE(decoder.is_done());
+            REQUIRE(result == decoded);
+            REQUIRE(pos == encoded.size());
+        }
+    }
+
+    GIVEN("Malformed data")
+    {
+        for (const auto& malformed : { "x\r\n", "\r\n", "4\r\nWikiX\r\n", "4\n", "4\r\nWiki\r\n0\r\n\rX",
+                                       "1000000000000000\r\n" })
+        {
+            ChunkedDecoder decoder{};
+            auto data = to_vector(malformed);
+            decoder.decode(data.data(), data.size());
+            REQUIRE(decoder.is_error());
+        }
+    }
+
+    GIVEN("The encoding helpers")
+    {
+        std::vector<uint8_t> encoded_data{};
+        chunked::append_chunk_start(0x1f2e, encoded_data);
+        chunked::append_chunk_end(false, encoded_data);
+        chunked::append_chunk_start(1, encoded_data);
+        chunked::append_chunk_end(true, encoded_data);
+
+        THEN("The framing is as expected")
+        {
+            REQUIRE(to_string(encoded_data) == "1f2e\r\n\r\n1\r\n\r\n0\r\n\r\n");
+        }
+    }
+}
+
+SCENARIO("HTTPProtocol - chunked request body")
+{
+    NoResponse response{};
+    Receiver rx{ std::make_unique<HTTPProtocol>(1024, 8, response) };
+
+    GIVEN("A request with a chunked body, partly received along with the headers")
+    {
+        auto request = to_vector("POST /upload HTTP/1.1\r\n"
+                                 "Transfer-Encoding: gzip, Chunked\r\n"
+                                 "Content-Length: 3\r\n\r\n"
+                                 "5\r\nhel");
+        auto body = to_vector("lo\r\n"
+                              "e\r\n, chunked body\r\n"
+                              "0\r\n\r\n");
+
+        std::vector<HTTPPacket> packets{};
+        auto receive = [&packets](HTTPPacket& p) { packets.emplace_back(p); };
+        feed(rx, request.data(), request.size(), receive);
+        feed(rx, body.data(), body.size(), receive);
+
+        THEN("The body is delivered in parts of at most the chunk size")
+        {
+            REQUIRE(packets.size() > 1);
+            std::string body{};
+
+            for (std::size_t i = 0; i < packets.size(); ++i)
+            {
+                REQUIRE(packets[i].is_continuation() == (i > 0));
+                REQUIRE(packets[i].is_continued() == (i + 1 < packets.size()));
+                body += to_string(packets[i].data());
+            }
+
+            REQUIRE(body == "hello, chunked body");
+            REQUIRE(packets[0].get_request_url() == "/upload");
+            REQUIRE(packets[0].headers().at(TRANSFER_ENCODING) == "gzip, Chunked");
+            REQUIRE(response.errors == 0);
+        }
+
+        AND_THEN("A following request is received separately")
+        {
+            auto next = to_vector("GET /next HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+            std::vector<HTTPPacket> next_packets{};
+            feed(rx, next.data(), next.size(), [&next_packets](HTTPPacket& p) { next_packets.emplace_back(p); });
+
+            REQUIRE(next_packets.size() == 1);
+            REQUIRE(next_packets[0].get_request_url() == "/next");
+            REQUIRE_FALSE(next_packets[0].is_continuation());
+            REQUIRE_FALSE(next_packets[0].is_continued());
+        }
+    }
+
+    GIVEN("A request with a malformed chunked body")
+    {
+        auto request = to_vector("POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nnot hex\r\n");
+        feed(rx, request.data(), request.size(), [](HTTPPacket&) {});
+
+        THEN("It is rejected")
+        {
+            REQUIRE(response.errors == 1);
+        }
+    }
+
+    GIVEN("A request with a Content-Length larger than three chunks")
+    {
+        auto request = to_vector("POST /upload HTTP/1.1\r\nContent-Length: 30\r\n\r\n");
+        std::vector<uint8_t> body(30, 'x');
+
+        std::vector<HTTPPacket> packets{};
+        auto receive = [&packets](HTTPPacket& p) { packets.emplace_back(p); };
+        feed(rx, request.data(), request.size(), receive);
+        feed(rx, body.data(), body.size(), receive);
+
+        THEN("Only the first part starts the request")
+        {
+            std::size_t total = 0;
+
+            for (std::size_t i = 0; i < packets.size(); ++i)
+            {
+                REQUIRE(packets[i].is_continuation() == (i > 0));
+                total += packets[i].data().size();
+            }
+
+            REQUIRE(packets.size() > 3);
+            REQUIRE(total == 30);
+        }
+    }
+}
+
+SCENARIO("Chunked transfer - streaming through 4 KB chunks")
+{
+    GIVEN("An upload sent in chunks of varying size")
+    {
+        NoResponse response{};
+        Receiver rx{ std::make_unique<HTTPProtocol>(1024, static_cast<int>(chunk_size), response) };
+
+        auto headers = to_vector("POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n");
+        feed(rx, headers.data(), headers.size(), [](HTTPPacket&) {});
+
+        std::size_t received = 0;
+        std::size_t mismatches = 0;
+        std::size_t packets = 0;
+        bool last_seen = false;
+
+        auto receive = [&](HTTPPacket& packet) {
+                           for (auto b : packet.data())
+                           {
+                               mismatches += b != pattern(received++) ? 1U : 0U;
+                           }
+
+                           REQUIRE(packet.data().size() <= chunk_size);
+                           last_seen = !packet.is_continued();
+                           ++packets;
+                       };
+
+        std::vector<uint8_t> encoded{};
+        std::size_t sent = 0;
+
+        while (sent < stream_size)
+        {
+            // A client decides its own chunk sizes, unrelated to the server's.
+            auto length = std::min(stream_size - sent, std::size_t{ 1000 } + (sent / 1000) % 9000);
+            encoded.clear();
+            chunked::append_chunk_start(length, encoded);
+
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                encoded.push_back(pattern(sent + i));
+            }
+
+            sent += length;
+            chunked::append_chunk_end(sent == stream_size, encoded);
+            feed(rx, encoded.data(), encoded.size(), receive);
+        }
+
+        THEN("All data is received in packets of at most one chunk")
+        {
+            REQUIRE(received == stream_size);
+            REQUIRE(mismatches == 0);
+            REQUIRE(packets >= stream_size / chunk_size);
+            REQUIRE(last_seen);
+            REQUIRE(response.errors == 0);
+        }
+    }
+
+    GIVEN("A response produced as it is sent")
+    {
+        std::size_t produced = 0;
+
+        responses::StreamingResponse response{
+            ResponseCode::OK, "text/csv",
+            [&produced](std::size_t max_amount, std::vector<uint8_t>& target) {
+                auto count = std::min(max_amount, stream_size - produced);
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    target.push_back(pattern(produced++));
+                }
+
+                return produced < stream_size ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+            } };
+
+        REQUIRE(response.get_headers().count(CONTENT_LENGTH) == 0);
+        REQUIRE(response.get_headers().at(CONTENT_TYPE) == "text/csv");
+
+        ChunkedDecoder decoder{};
+        std::vector<uint8_t> data{};
+        std::vector<uint8_t> wire{};
+        std::size_t received = 0;
+        std::size_t mismatches = 0;
+        auto res = ResponseStatus::HasMoreData;
+
+        while (res == ResponseStatus::HasMoreData)
+        {
+            // The framing HTTPServerClient puts around each part.
+            data.clear();
+            res = response.get_data(chunk_size, data);
+
+            wire.clear();
+            chunked::append_chunk_start(data.size(), wire);
+            wire.insert(wire.end(), data.begin(), data.end());
+            chunked::append_chunk_end(res == ResponseStatus::LastData, wire);
+
+            auto length = decoder.decode(wire.data(), wire.size());
+
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                mismatches += wire[i] != pattern(received++) ? 1U : 0U;
+            }
+        }
+
+        THEN("All data is sent")
+        {
+            REQUIRE(res == ResponseStatus::LastData);
+            REQUIRE(decoder.is_done());
+            REQUIRE(received == stream_size);
+            REQUIRE(mismatches == 0);
+            REQUIRE(response.get_data(chunk_size, data) == ResponseStatus::NoData);
+        }
+    }
+}
@@ -0,0 +1,228 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "smooth/application/compression/GzipCompressor.h"
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/responses/GzipResponse.h"
+#include "smooth/application/network/http/regular/responses/StringResponse.h"
+
+using namespace smooth::application::compression;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+
+static std::vector<uint8_t> gunzip(const std::vector<uint8_t>& compressed)
+{
+    std::vector<uint8_t> res{};
+    z_stream stream{};
+    REQUIRE(inflateInit2(&stream, 16 + MAX_WBITS) == Z_OK);
+
+    stream.next_in = const_cast<Bytef*>(compressed.data());
+    stream.avail_in = static_cast<uInt>(compressed.size());
+
+    std::vector<uint8_t> out(16384);
+    int status = Z_OK;
+
+    while (status == Z_OK)
+    {
+        stream.next_out = out.data();
+        stream.avail_out = static_cast<uInt>(out.size());
+        status = inflate(&stream, Z_NO_FLUSH);
+        res.insert(res.end(), out.data(), out.data() + (out.size() - stream.avail_out));
+    }
+
+    inflateEnd(&stream);
+
+    // Z_STREAM_END means the trailer, including the CRC and size, has been verified.
+    REQUIRE(status == Z_STREAM_END);
+    REQUIRE(stream.avail_in == 0);
+
+    return res;
+}
+
+static std::vector<uint8_t> gzip(const std::vector<uint8_t>& data, uint8_t window_bits, std::size_t write_size)
+{
+    GzipCompressor compressor{ window_bits };
+    std::vector<uint8_t> res{};
+
+    for (std::size_t offset = 0; offset < data.size(); offset += write_size)
+    {
+        compressor.write(data.data() + offset, std::min(write_size, data.size() - offset), res);
+    }
+
+    compressor.finish(res);
+
+    return res;
+}
+
+// Text that resembles minified web assets; repetitive identifiers and keywords with random values.
+static std::vector<uint8_t> make_asset(std::size_t size, unsigned int seed)
+{
+    static const std::vector<std::string> words{
+        "function ", "return ", "var ", "const ", "document.getElementById(", "addEventListener(", "'click'",
+        "this.", "value", "length", "=>", "{", "}", "(", ")", ";", ",", "if(", "else", "for(let i=0;i<",
+        ".style.", "display:none;", "margin:0 auto;", "color:#", "fetch('/api/", "JSON.parse(", "=", "+", "\n"
+    };
+
+    std::mt19937 rng{ seed };
+    std::uniform_int_distribution<std::size_t> pick{ 0, words.size() - 1 };
+    std::uniform_int_distribution<int> digit{ 0, 15 };
+
+    std::string res{};
+
+    while (res.size() < size)
+    {
+        auto w = pick(rng);
+        res += words[w];
+
+        if (w % 5 == 0)
+        {
+            res += "0123456789abcdef"[digit(rng)];
+        }
+    }
+
+    res.resize(size);
+
+    return { res.begin(), res.end() };
+}
+
+SCENARIO("GzipCompressor - round trip through zlib")
+{
+    std::mt19937 rng{ 42 };
+    std::uniform_int_distribution<int> byte{ 0, 255 };
+
+    std::vector<uint8_t> random(100000);
+
+    for (auto& b : random)
+    {
+        b = static_cast<uint8_t>(byte(rng));
+    }
+
+    const std::vector<std::vector<uint8_t>> inputs{
+        {},
+        { 'a' },
+        std::vector<uint8_t>(100000, 'x'),
+        random,
+        make_asset(300000, 1)
+    };
+
+    for (uint8_t window_bits = GzipCompressor::min_window_bits;
+         window_bits <= GzipCompressor::max_window_bits;
+         ++window_bits)
+    {
+        for (auto write_size : { std::size_t{ 1 }, std::size_t{ 100 }, std::size_t{ 4096 }, std::size_t{ 1000000 } })
+        {
+            for (const auto& input : inputs)
+            {
+                if (write_size > 1 || input.size() <= 100000)
+                {
+                    auto compressed = gzip(input, window_bits, write_size);
+                    REQUIRE(gunzip(compressed) == input);
+                }
+            }
+        }
+    }
+
+    GIVEN("Repetitive data")
+    {
+        auto asset = make_asset(100000, 2);
+
+        THEN("It is compressed, better with a larger window")
+        {
+            auto small = gzip(asset, 9, 4096).size();
+            auto large = gzip(asset, 14, 4096).size();
+            REQUIRE(small < asset.size() / 2);
+            REQUIRE(large <= small);
+            REQUIRE(gzip(std::vector<uint8_t>(100000, 'x'), 10, 4096).size() < 1000);
+        }
+    }
+}
+
+SCENARIO("Content type and encoding negotiation")
+{
+    THEN("Content types are determined by extension")
+    {
+        REQUIRE(utils::get_content_type("/www/app.js") == "text/javascript");
+        REQUIRE(utils::get_content_type("/www/STYLE.CSS") == "text/css");
+        REQUIRE(utils::get_content_type("/www/index.html") == "text/html");
+        REQUIRE(utils::get_content_type("/www/image.jpeg") == "image/jpeg");
+        REQUIRE(utils::get_content_type("/www/image.svg") == "image/svg+xml");
+        REQUIRE(utils::get_content_type("/www/font.woff2") == "font/woff2");
+        REQUIRE(utils::get_content_type("/www/data.bin") == "application/octet-stream");
+        REQUIRE(utils::get_content_type("/www/no_extension") == "application/octet-stream");
+    }
+
+    THEN("Accepted encodings are determined by Accept-Encoding")
+    {
+        auto accepts = [](const std::string& accept_encoding) {
+                           std::unordered_map<std::string, std::string> headers{
+                               { ACCEPT_ENCODING, accept_encoding } };
+
+                           return utils::accepts_encoding(headers, "gzip");
+                       };
+
+        REQUIRE(accepts("gzip"));
+        REQUIRE(accepts("gzip, deflate, br"));
+        REQUIRE(accepts("deflate,GZIP;q=0.5"));
+        REQUIRE(accepts("*"));
+        REQUIRE_FALSE(accepts("deflate, br"));
+        REQUIRE_FALSE(accepts("gzip;q=0"));
+        REQUIRE_FALSE(accepts("gzip;q=0, *"));
+        REQUIRE_FALSE(accepts("*;q=0"));
+        REQUIRE_FALSE(accepts("identity"));
+        REQUIRE_FALSE(utils::accepts_encoding({}, "gzip"));
+    }
+}
+
+SCENARIO("GzipResponse - compressing a response")
+{
+    GIVEN("A string response")
+    {
+        auto asset = make_asset(20000, 3);
+        std::string body{ asset.begin(), asset.end() };
+        auto inner = std::make_unique<responses::StringResponse>(ResponseCode::OK, body, false);
+        responses::GzipResponse response{ std::move(inner), 10 };
+
+        WHEN("Sending it")
+        {
+            std::vector<uint8_t> sent{};
+            auto res = ResponseStatus::HasMoreData;
+
+            while (res == ResponseStatus::HasMoreData)
+            {
+                res = response.get_data(1024, sent);
+            }
+
+            THEN("The body is compressed while being sent")
+            {
+                REQUIRE(res == ResponseStatus::LastData);
+                REQUIRE(response.get_response_code() == ResponseCode::OK);
+                REQUIRE(response.get_headers().at(CONTENT_ENCODING) == "gzip");
+                REQUIRE(response.get_headers().at(CONTENT_TYPE) == "text/html");
+                REQUIRE(response.get_headers().count(CONTENT_LENGTH) == 0);
+                REQUIRE(sent.size() < asset.size() / 2);
+                REQUIRE(gunzip(sent) == asset);
+                REQUIRE(response.get_data(1024, sent) == ResponseStatus::NoData);
+            }
+        }
+    }
+}
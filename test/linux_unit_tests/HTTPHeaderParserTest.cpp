@@ -0,0 +1,306 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+
+using namespace smooth::application::network::http::regular;
+
+namespace
+{
+    const std::string browser_request{
+        "GET /index.html?user=abc&id=1234 HTTP/1.1\r\n"
+        "Host: www.example.com:8080\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:68.0) Gecko/20100101 Firefox/68.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate\r\n"
+        "Referer: http://www.example.com/start.html\r\n"
+        "Connection: keep-alive\r\n"
+        "Cookie: session=0123456789abcdef; theme=dark\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "Cache-Control: max-age=0\r\n"
+        "\r\n" };
+
+    HTTPHeaderParser::Result parse(HTTPHeaderParser& p, const std::string& s)
+    {
+        return p.parse(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    }
+
+    /// Feeds data in chunks of the given size, like the socket would.
+    HTTPHeaderParser::Result parse_in_chunks(HTTPHeaderParser& p, const std::string& s, std::size_t chunk)
+    {
+        auto res = HTTPHeaderParser::Result::Incomplete;
+
+        for (std::size_t len = std::min(chunk, s.size());
+             res == HTTPHeaderParser::Result::Incomplete && len <= s.size() && len > 0;
+             len = len == s.size() ? s.size() + 1 : std::min(len + chunk, s.size()))
+        {
+            res = p.parse(reinterpret_cast<const uint8_t*>(s.data()), len);
+        }
+
+        return res;
+    }
+}
+
+SCENARIO("HTTPHeaderParser - requests")
+{
+    GIVEN("A complete request")
+    {
+        HTTPHeaderParser p{};
+        const std::string req = browser_request + "body";
+
+        THEN("It is parsed")
+        {
+            REQUIRE(parse(p, req) == HTTPHeaderParser::Result::Complete);
+            REQUIRE(p.is_request());
+            REQUIRE(p.method() == "GET");
+            REQUIRE(p.url() == "/index.html?user=abc&id=1234");
+            REQUIRE(p.version() == "1.1");
+            REQUIRE(p.header_size() == browser_request.size());
+            REQUIRE(p.size() == 10);
+            REQUIRE(p.get("host") == "www.example.com:8080");
+            REQUIRE(p.get("ACCEPT-ENCODING") == "gzip, deflate");
+            REQUIRE(p.get("Content-Length").empty());
+        }
+    }
+
+    GIVEN("A request fed one byte at a time")
+    {
+        HTTPHeaderParser p{};
+
+        THEN("It is incomplete until the last byte")
+        {
+            for (std::size_t i = 1; i < browser_request.size(); ++i)
+            {
+                REQUIRE(p.parse(reinterpret_cast<const uint8_t*>(browser_request.data()), i)
+                        == HTTPHeaderParser::Result::Incomplete);
+            }
+
+            REQUIRE(parse(p, browser_request) == HTTPHeaderParser::Result::Complete);
+            REQUIRE(p.header_size() == browser_request.size());
+            REQUIRE(p.get("Cookie") == "session=0123456789abcdef; theme=dark");
+        }
+    }
+
+    GIVEN("Header values with optional whitespace")
+    {
+        HTTPHeaderParser p{};
+        const std::string req{ "POST /a HTTP/1.0\r\nContent-Length:12\r\nX-A: \t v \t\r\nX-Empty:\r\n\r\n" };
+        REQUIRE(parse(p, req) == HTTPHeaderParser::Result::Complete);
+
+        THEN("Whitespace is trimmed")
+        {
+            REQUIRE(p.get("content-length") == "12");
+            REQUIRE(p.get("x-a") == "v");
+            REQUIRE(p.get("x-empty").empty());
+            REQUIRE(p.size() == 3);
+        }
+    }
+
+    GIVEN("A request without headers")
+    {
+        HTTPHeaderParser p{};
+
+        THEN("It is complete")
+        {
+            REQUIRE(parse(p, "GET / HTTP/1.1\r\n\r\n") == HTTPHeaderParser::Result::Complete);
+            REQUIRE(p.size() == 0);
+            REQUIRE(p.header_size() == 18);
+        }
+    }
+
+    GIVEN("Malformed requests")
+    {
+        const std::vector<std::string> bad{
+            "GET /\r\n\r\n",
+            "GET / HTTP/1\r\n\r\n",
+            "GET / FTP/1.1\r\n\r\n",
+            " / HTTP/1.1\r\n\r\n",
+            "GET / HTTP/1.1\r\nNoColon\r\n\r\n",
+            "GET / HTTP/1.1\r\n: value\r\n\r\n",
+            "GET / HTTP/1.1\r\nBad Name: value\r\n\r\n",
+            "GET / HTTP/1.1\r\nName : value\r\n\r\n",
+            "GET / HTTP/1.1\r\nLF-only: value\n\r\n\r\n",
+        };
+
+        THEN("They are rejected")
+        {
+            for (const auto& s : bad)
+            {
+                HTTPHeaderParser p{};
+                INFO(s);
+                REQUIRE(parse(p, s) == HTTPHeaderParser::Result::Error);
+            }
+        }
+    }
+
+    GIVEN("More headers than fit in the table")
+    {
+        std::string s{ "GET / HTTP/1.1\r\n" };
+
+        for (std::size_t i = 0; i <= HTTPHeaderParser::max_headers; ++i)
+        {
+            s += "X-" + std::to_string(i) + ": v\r\n";
+        }
+
+        s += "\r\n";
+        HTTPHeaderParser p{};
+
+        THEN("The request is rejected")
+        {
+            REQUIRE(parse(p, s) == HTTPHeaderParser::Result::Error);
+        }
+    }
+}
+
+SCENARIO("HTTPHeaderParser - responses")
+{
+    GIVEN("A response")
+    {
+        HTTPHeaderParser p{};
+
+        THEN("Status code and headers are parsed")
+        {
+            const std::string res{ "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n" };
+            REQUIRE(parse(p, res) == HTTPHeaderParser::Result::Complete);
+            REQUIRE_FALSE(p.is_request());
+            REQUIRE(p.status_code() == 404);
+            REQUIRE(p.version() == "1.1");
+            REQUIRE(p.get("content-length") == "0");
+        }
+
+        AND_THEN("Reset prepares for the next message")
+        {
+            REQUIRE(parse(p, "HTTP/1.1 200 OK\r\n\r\n") == HTTPHeaderParser::Result::Complete);
+            p.reset();
+            REQUIRE(parse(p, "HTTP/1.1 500 Internal Server Error\r\n\r\n")
+                    == HTTPHeaderParser::Result::Complete);
+            REQUIRE(p.status_code() == 500);
+        }
+    }
+
+    GIVEN("A response with an invalid status code")
+    {
+        HTTPHeaderParser p{};
+
+        THEN("It is rejected")
+        {
+            REQUIRE(parse(p, "HTTP/1.1 2x0 OK\r\n\r\n") == HTTPHeaderParser::Result::Error);
+        }
+    }
+}
+
+SCENARIO("HTTPHeaderParser - finding the end of the headers")
+{
+    GIVEN("Terminators at every alignment")
+    {
+        THEN("Each is found at the right offset")
+        {
+            for (std::size_t offset = 0; offset < 40; ++offset)
+            {
+                std::string s(offset, 'a');
+                s += "\r\n\r\n";
+                s += std::string(17, 'b');
+
+                for (std::size_t start = 0; start <= offset; ++start)
+                {
+                    REQUIRE(HTTPHeaderParser::find_header_end(reinterpret_cast<const uint8_t*>(s.data()),
+                                                              s.size(), start) == offset);
+                }
+
+                REQUIRE(HTTPHeaderParser::find_header_end(reinterpret_cast<const uint8_t*>(s.data()),
+                                                          offset + 3, 0) == HTTPHeaderParser::npos);
+            }
+        }
+    }
+
+    GIVEN("Near misses")
+    {
+        const std::string s{ "\r\r\n\r\r\n\n\r\n\r\r\n\r\r\n\r\n" };
+
+        THEN("Only the real terminator is found")
+        {
+            REQUIRE(HTTPHeaderParser::find_header_end(reinterpret_cast<const uint8_t*>(s.data()), s.size(), 0)
+                    == s.size() - 4);
+        }
+    }
+}
+
+SCENARIO("HTTPHeaderParser - fuzzing")
+{
+    std::mt19937 gen(4711);
+    const std::string alphabet{ "\r\n :\tGETPOSHTP/1.0aZ" };
+    std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+    std::uniform_int_distribution<int> any_byte(0, 255);
+    std::uniform_int_distribution<std::size_t> chunk(1, 64);
+
+    GIVEN("Mutated and random input")
+    {
+        THEN("Parsing in chunks gives the same result as parsing all at once")
+        {
+            for (int round = 0; round < 20000; ++round)
+            {
+                std::string s;
+
+                if (round % 2 == 0)
+                {
+                    s = browser_request;
+                    std::uniform_int_distribution<std::size_t> pos(0, s.size() - 1);
+
+                    for (int i = 0; i < 1 + round % 5; ++i)
+                    {
+                        s[pos(gen)] = round % 4 == 0 ? static_cast<char>(any_byte(gen)) : alphabet[pick(gen)];
+                    }
+                }
+                else
+                {
+                    s.resize(static_cast<std::size_t>(round % 200));
+
+                    for (auto& c : s)
+                    {
+                        c = alphabet[pick(gen)];
+                    }
+                }
+
+                HTTPHeaderParser whole{};
+                HTTPHeaderParser chunked{};
+                auto expected = parse(whole, s);
+                auto actual = parse_in_chunks(chunked, s, chunk(gen));
+
+                REQUIRE(actual == expected);
+
+                if (expected == HTTPHeaderParser::Result::Complete)
+                {
+                    REQUIRE(whole.header_size() <= s.size());
+                    REQUIRE(whole.header_size() == chunked.header_size());
+                    REQUIRE(whole.size() == chunked.size());
+
+                    for (const auto& h : whole)
+                    {
+                        REQUIRE(h.name.data() >= s.data());
+                        REQUIRE(h.value.data() + h.value.size() <= s.data() + whole.header_size());
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,278 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include <memory>
+#include <string>
+#include "smooth/core/Task.h"
+#include "smooth/application/network/http/HTTPServerClient.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::core::network::event;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+
+namespace
+{
+    class OwnerTask
+        : public Task
+    {
+        public:
+            OwnerTask()
+                    : Task("Owner", 0, 0, std::chrono::milliseconds(1000))
+            {
+            }
+    };
+
+    /// Stands in for the socket; the test sends the data from the transmit buffer itself.
+    class FakeSocket
+        : public ISocket
+    {
+        public:
+            bool start(std::shared_ptr<InetAddress>) override { return true; }
+
+            void stop(const char*) override { stopped = true; }
+
+            bool restart() override { return true; }
+
+            bool is_active() const override { return !stopped; }
+
+            bool has_send_expired() const override { return false; }
+
+            bool has_receive_expired() const override { return false; }
+
+            int get_socket_id() const override { return INVALID_SOCKET; }
+
+            bool is_server() const override { return false; }
+
+            void set_send_timeout(std::chrono::milliseconds) override {}
+
+            void set_receive_timeout(std::chrono::milliseconds) override {}
+
+            std::chrono::milliseconds get_receive_timeout() const override { return std::chrono::milliseconds{ 0 }; }
+
+            std::chrono::milliseconds get_send_timeout() const override { return std::chrono::milliseconds{ 0 }; }
+
+            bool stopped{ false };
+
+        protected:
+            bool is_connected() const override { return !stopped; }
+
+            void readable(ISocketBackOff&) override {}
+
+            void writable() override {}
+
+            bool has_data_to_transmit() override { return false; }
+
+            bool has_buffered_data() override { return false; }
+
+            bool has_room_to_receive() override { return true; }
+
+            bool is_busy() override { return false; }
+
+            bool internal_start() override { return true; }
+
+            void publish_connected_status() override {}
+
+            void stop_internal() override {}
+
+            void clear_socket_id() override {}
+    };
+
+    class TestClient
+        : public HTTPServerClient
+    {
+        public:
+            TestClient(Task& task, ClientPool<HTTPServerClient>& pool, std::shared_ptr<ISocket> s)
+                    : HTTPServerClient(task, pool, 1024, 10, 5)
+            {
+                socket = std::move(s);
+            }
+    };
+
+    /// A response held in memory, sent in chunks of the size the client asks for.
+    class MemoryResponse
+        : public IResponseOperation
+    {
+        public:
+            MemoryResponse(const std::string& content, bool pullable, int fail_at = 0)
+                    : content(std::make_shared<std::string>(content)),
+                      pullable(pullable),
+                      fail_at(fail_at)
+            {
+                headers[CONTENT_LENGTH] = std::to_string(content.size());
+            }
+
+            ResponseCode get_response_code() override
+            {
+                return ResponseCode::OK;
+            }
+
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override
+            {
+                std::shared_ptr<const uint8_t> view{};
+                std::size_t length = 0;
+                auto res = get_data_view(max_amount, view, length);
+
+                if (length > 0)
+                {
+                    target.assign(view.get(), view.get() + length);
+                }
+
+                return res;
+            }
+
+            bool has_data_view() const override
+            {
+                return true;
+            }
+
+            ResponseStatus get_data_view(std::size_t max_amount,
+                                         std::shared_ptr<const uint8_t>& data,
+                                         std::size_t& length) override
+            {
+                ResponseStatus res;
+
+                if (++calls == fail_at)
+                {
+                    res = ResponseStatus::Error;
+                }
+                else if (offset >= content->size())
+                {
+                    res = ResponseStatus::NoData;
+                }
+                else
+                {
+                    length = std::min(max_amount, content->size() - offset);
+                    data = std::shared_ptr<const uint8_t>(content,
+                                                          reinterpret_cast<const uint8_t*>(content->data()) + offset);
+                    offset += length;
+                    res = offset < content->size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+                }
+
+                return res;
+            }
+
+            bool can_be_pulled() const override
+            {
+                return pullable;
+            }
+
+        private:
+            std::shared_ptr<std::string> content;
+            std::size_t offset{ 0 };
+            const bool pullable;
+            const int fail_at;
+            int calls{ 0 };
+    };
+
+    // Sends what is queued the way the socket does, pulling more from the source as packets are sent.
+    std::string send_all(IPacketSendBuffer<HTTPProtocol>& tx)
+    {
+        std::string sent{};
+        tx.pull();
+
+        while (!tx.is_empty())
+        {
+            if (!tx.is_in_progress())
+            {
+                tx.prepare_next_packet();
+            }
+
+            auto length = tx.get_remaining_data_length();
+            sent.append(reinterpret_cast<const char*>(tx.get_data_to_send()), static_cast<std::size_t>(length));
+            tx.data_has_been_sent(length);
+
+            if (tx.is_pulling())
+            {
+                tx.pull();
+            }
+        }
+
+        return sent;
+    }
+
+    bool ends_with(const std::string& s, const std::string& end)
+    {
+        return s.size() >= end.size() && s.compare(s.size() - end.size(), end.size(), end) == 0;
+    }
+}
+
+SCENARIO("HTTPServerClient - handing over from a pulled response to the next")
+{
+    GIVEN("A client")
+    {
+        OwnerTask task{};
+        ClientPool<HTTPServerClient> pool{ task, 1 };
+        auto socket = std::make_shared<FakeSocket>();
+        auto client = std::make_shared<TestClient>(task, pool, socket);
+        auto& tx = client->get_buffers().lock()->get_tx_buffer();
+        const std::string first_body{ "0123456789abcdefghijklmnopqrstuvwxy" };
+
+        WHEN("Replying with a response that can be pulled, followed by one that can't")
+        {
+            client->reply(std::make_unique<MemoryResponse>(first_body, true), false);
+            client->reply(std::make_unique<MemoryResponse>("second", false), false);
+
+            THEN("The socket pulls the first response")
+            {
+                REQUIRE(tx.is_pulling());
+            }
+
+            THEN("Events while the socket is pulling don't send anything")
+            {
+                tx.pull();
+                auto slots = tx.available_slots();
+                client->event(TransmitBufferEmptyEvent{ socket });
+                REQUIRE(tx.available_slots() == slots);
+                REQUIRE(tx.is_pulling());
+            }
+
+            THEN("The next response is sent once the first has been pulled dry")
+            {
+                auto first = send_all(tx);
+                REQUIRE_FALSE(tx.is_pulling());
+                REQUIRE(ends_with(first, "\r\n\r\n" + first_body));
+                REQUIRE(tx.is_empty());
+
+                client->event(TransmitBufferEmptyEvent{ socket });
+
+                REQUIRE_FALSE(tx.is_pulling());
+                auto second = send_all(tx);
+                REQUIRE(second.find("HTTP/1.1 200") == 0);
+                REQUIRE(ends_with(second, "\r\n\r\nsecond"));
+                REQUIRE_FALSE(socket->stopped);
+            }
+        }
+
+        WHEN("A pulled response fails")
+        {
+            client->reply(std::make_unique<MemoryResponse>(first_body, true, 3), false);
+            send_all(tx);
+
+            THEN("The client closes once the socket has stopped pulling")
+            {
+                REQUIRE_FALSE(tx.is_pulling());
+                REQUIRE_FALSE(socket->stopped);
+                client->event(TransmitBufferEmptyEvent{ socket });
+                REQUIRE(socket->stopped);
+            }
+        }
+    }
+}
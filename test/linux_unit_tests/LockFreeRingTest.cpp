@@ -0,0 +1,143 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+#include "smooth/core/ipc/LockFreeRing.h"
+
+using namespace smooth::core::ipc;
+
+SCENARIO("LockFreeRing - basic operation")
+{
+    GIVEN("A ring with a capacity that isn't a power of two")
+    {
+        LockFreeRing<int> ring(5);
+
+        THEN("Capacity is rounded up")
+        {
+            REQUIRE(ring.capacity() == 8);
+            REQUIRE(ring.empty());
+        }
+
+        WHEN("Filled")
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                REQUIRE(ring.push(i));
+            }
+
+            THEN("It can't take more")
+            {
+                REQUIRE_FALSE(ring.push(8));
+                REQUIRE(ring.count() == 8);
+            }
+
+            AND_THEN("Items come out in order, across wrap-around")
+            {
+                int v = -1;
+
+                for (int round = 0; round < 3; ++round)
+                {
+                    for (int i = 0; i < 8; ++i)
+                    {
+                        REQUIRE(ring.pop(v));
+                        REQUIRE(v == round * 8 + i);
+                        REQUIRE(ring.push(v + 8));
+                    }
+                }
+
+                REQUIRE(ring.count() == 8);
+            }
+        }
+
+        WHEN("Empty")
+        {
+            int v = -1;
+
+            THEN("Nothing can be popped")
+            {
+                REQUIRE_FALSE(ring.pop(v));
+                REQUIRE(v == -1);
+            }
+        }
+    }
+}
+
+SCENARIO("LockFreeRing - move only items")
+{
+    LockFreeRing<std::unique_ptr<int>> ring(2);
+
+    REQUIRE(ring.push(std::make_unique<int>(42)));
+
+    std::unique_ptr<int> out;
+    REQUIRE(ring.pop(out));
+    REQUIRE(out);
+    REQUIRE(*out == 42);
+}
+
+SCENARIO("LockFreeRing - multiple producers")
+{
+    GIVEN("Four producers")
+    {
+        constexpr int producers = 4;
+        constexpr int per_producer = 20000;
+        LockFreeRing<int> ring(64);
+        std::vector<std::thread> threads;
+
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&ring, p]() {
+                                     for (int i = 0; i < per_producer; ++i)
+                                     {
+                                         while (!ring.push(p * per_producer + i))
+                                         {
+                                             std::this_thread::yield();
+                                         }
+                                     }
+                                 });
+        }
+
+        THEN("Every item is received exactly once and in order per producer")
+        {
+            std::vector<int> last(producers, -1);
+            int received = 0;
+
+            while (received < producers * per_producer)
+            {
+                int v;
+
+                if (ring.pop(v))
+                {
+                    auto p = v / per_producer;
+                    REQUIRE(v % per_producer == last[static_cast<size_t>(p)] + 1);
+                    last[static_cast<size_t>(p)] = v % per_producer;
+                    ++received;
+                }
+            }
+
+            for (auto& t : threads)
+            {
+                t.join();
+            }
+
+            REQUIRE(ring.empty());
+        }
+    }
+}
@@ -16,6 +16,7 @@ limitations under the License.
 */
 
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include "smooth/application/network/http/regular/MIMEParser.h"
 #include "smooth/core/filesystem/Path.h"
 #include "smooth/core/filesystem/File.h"
@@ -229,9 +230,11 @@ SCENARIO("MIMEParser - application/x-www-form-urlencoded")
                 void url_encoded(std::unordered_map<std::string, std::string>& data) override
                 {
                     received = data;
+                    ++calls;
                 }
 
                 std::unordered_map<std::string, std::string> received{};
+                int calls{ 0 };
         };
 
         MIMEParser mime;
@@ -261,7 +264,135 @@ SCENARIO("MIMEParser - application/x-www-form-urlencoded")
 
                 REQUIRE(udt.received.at("free_text") == "test text");
                 REQUIRE(udt.received.at("submit") == "Send text");
+                REQUIRE(udt.calls == 1);
             }
         }
+
+        WHEN("Provided with url encoded data of a chunked request, i.e. without a Content-Length")
+        {
+            auto file = Path{ "test_data" } / "url_encoded.txt";
+
+            REQUIRE(mime.detect_mode("application/x-www-form-urlencoded"));
+
+            File f{ file };
+            std::vector<uint8_t> data;
+            REQUIRE(f.read(data));
+
+            THEN("Waits for the last part before parsing the data")
+            {
+                FormDataTester fdt{};
+                URLDataTester udt{};
+
+                for (std::size_t i = 0; i < data.size(); ++i)
+                {
+                    mime.set_last_part(i + 1 == data.size());
+                    mime.parse(&data[i], 1, fdt, udt, static_cast<uint16_t> (4096));
+
+                    if (i + 1 < data.size())
+                    {
+                        REQUIRE(udt.calls == 0);
+                    }
+                }
+
+                REQUIRE(udt.calls == 1);
+                REQUIRE(udt.received.at("free_text") == "test text");
+                REQUIRE(udt.received.at("submit") == "Send text");
+            }
+        }
+    }
+}
+
+SCENARIO("MIMEParser - large upload")
+{
+    class FormDataTester : public IFormData
+    {
+        public:
+            explicit FormDataTester(const std::vector<uint8_t>& expected)
+                    : expected(expected)
+            {
+            }
+
+            void form_data(const std::string& /*name*/,
+                           const std::string& /*actual_file_name*/,
+                           const BoundaryIterator& begin,
+                           const BoundaryIterator& end,
+                           const bool file_start,
+                           const bool file_close) override
+            {
+                auto len = static_cast<std::size_t>(std::distance(begin, end));
+                starts += file_start ? 1 : 0;
+                closes += file_close ? 1 : 0;
+                correct = correct
+                          && received + len <= expected.size()
+                          && std::equal(begin, end, expected.cbegin() + static_cast<long>(received));
+                received += len;
+            }
+
+            const std::vector<uint8_t>& expected;
+            std::size_t received = 0;
+            int starts = 0;
+            int closes = 0;
+            bool correct = true;
+    };
+
+    class URLDataTester : public IURLEncodedData
+    {
+        public:
+            void url_encoded(std::unordered_map<std::string, std::string>&) override
+            {
+            }
+    };
+
+    const std::string boundary = "---------------------------8819839691792623414370909194";
+
+    // Many times the size of the parser's window.
+    const std::size_t size = 256 * 1024;
+
+    // Pseudo-random content, with the occasional partial boundary to exercise the matcher.
+    std::vector<uint8_t> file(size);
+    uint32_t seed = 12345;
+
+    for (auto& b : file)
+    {
+        seed = seed * 1103515245 + 12345;
+        b = static_cast<uint8_t>(seed >> 16);
+    }
+
+    for (std::size_t i = 1000; i + boundary.size() < size; i += 100000)
+    {
+        std::string partial = "\r\n--" + boundary.substr(0, boundary.size() / 2);
+        std::copy(partial.begin(), partial.end(), file.begin() + static_cast<long>(i));
+    }
+
+    std::string head = "--" + boundary + "\r\n"
+                       + "Content-Disposition: form-data; name=\"file_to_upload\"; filename=\"data.bin\"\r\n"
+                       + "Content-Type: application/octet-stream\r\n\r\n";
+    std::string tail = "\r\n--" + boundary + "--\r\n";
+
+    std::vector<uint8_t> body{ head.begin(), head.end() };
+    body.insert(body.end(), file.begin(), file.end());
+    body.insert(body.end(), tail.begin(), tail.end());
+
+    GIVEN("A 256 KB upload received in 1460 byte segments")
+    {
+        MIMEParser mime;
+        REQUIRE(mime.detect_mode("multipart/form-data; boundary=" + boundary, body.size()));
+
+        FormDataTester fdt{ file };
+        URLDataTester udt{};
+
+        for (std::size_t offset = 0; offset < body.size(); offset += 1460)
+        {
+            mime.parse(body.data() + offset, std::min<std::size_t>(1460, body.size() - offset),
+                       fdt, udt, static_cast<uint16_t>(4096));
+        }
+
+        THEN("The file is received intact")
+        {
+            REQUIRE(fdt.correct);
+            REQUIRE(fdt.received == file.size());
+            REQUIRE(fdt.starts == 1);
+            REQUIRE(fdt.closes == 1);
+        }
     }
 }
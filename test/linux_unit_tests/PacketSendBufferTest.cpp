@@ -0,0 +1,258 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "smooth/core/network/PacketSendBuffer.h"
+#include "smooth/application/network/http/HTTPProtocol.h"
+
+using namespace smooth::core::network;
+using namespace smooth::application::network::http;
+
+using SendBuffer = PacketSendBuffer<HTTPProtocol, 5>;
+
+static std::shared_ptr<const uint8_t> make_view(std::size_t size)
+{
+    auto storage = std::make_shared<std::vector<uint8_t>>(size, static_cast<uint8_t>('x'));
+
+    return std::shared_ptr<const uint8_t>(storage, storage->data());
+}
+
+SCENARIO("PacketSendBuffer - releasing data that is sent from where its owner keeps it")
+{
+    GIVEN("A send buffer with two queued packets referring to external data")
+    {
+        SendBuffer tx{};
+        auto first = make_view(100);
+        auto second = make_view(50);
+
+        REQUIRE(tx.put(HTTPPacket{ first, 100 }));
+        REQUIRE(tx.put(HTTPPacket{ second, 50 }));
+        REQUIRE(first.use_count() == 2);
+        REQUIRE(second.use_count() == 2);
+
+        WHEN("The first packet is sent in two parts")
+        {
+            tx.prepare_next_packet();
+            tx.data_has_been_sent(60);
+
+            THEN("It is only let go of once completely sent")
+            {
+                REQUIRE(first.use_count() == 2);
+                tx.data_has_been_sent(40);
+                REQUIRE_FALSE(tx.is_in_progress());
+                REQUIRE(first.use_count() == 1);
+                REQUIRE(second.use_count() == 2);
+            }
+        }
+
+        WHEN("Both packets are sent in a single vectored send")
+        {
+            iovec list[4]{};
+            tx.prepare_next_packet();
+            REQUIRE(tx.get_gather_list(list, 4) == 2);
+            tx.data_has_been_sent(150);
+
+            THEN("Neither is referenced any longer")
+            {
+                REQUIRE(tx.is_empty());
+                REQUIRE(first.use_count() == 1);
+                REQUIRE(second.use_count() == 1);
+            }
+        }
+
+        WHEN("The send ends within the second packet")
+        {
+            iovec list[4]{};
+            tx.prepare_next_packet();
+            REQUIRE(tx.get_gather_list(list, 4) == 2);
+            tx.data_has_been_sent(120);
+
+            THEN("Only the first is let go of")
+            {
+                REQUIRE(tx.is_in_progress());
+                REQUIRE(tx.get_remaining_data_length() == 30);
+                REQUIRE(first.use_count() == 1);
+                REQUIRE(second.use_count() == 2);
+            }
+        }
+
+        WHEN("The buffer is cleared")
+        {
+            tx.prepare_next_packet();
+            tx.clear();
+
+            THEN("Nothing is referenced any longer")
+            {
+                REQUIRE(tx.is_empty());
+                REQUIRE(first.use_count() == 1);
+                REQUIRE(second.use_count() == 1);
+            }
+        }
+    }
+}
+
+class CountingSource
+    : public IPacketSource<HTTPPacket>
+{
+    public:
+        explicit CountingSource(int count)
+                : count(count)
+        {
+        }
+
+        bool get_next_packet(HTTPPacket& packet) override
+        {
+            ++calls;
+
+            if (on_pull)
+            {
+                on_pull();
+            }
+
+            auto res = provided < count;
+
+            if (res)
+            {
+                packet = HTTPPacket{ make_view(10), 10 };
+                ++provided;
+            }
+
+            return res;
+        }
+
+        const int count;
+        int provided{ 0 };
+        int calls{ 0 };
+        std::function<void()> on_pull{};
+};
+
+// Sends what is queued the way the socket does, pulling more from the source as packets are sent.
+static int send_all(SendBuffer& tx)
+{
+    int sent = 0;
+    tx.pull();
+
+    while (!tx.is_empty())
+    {
+        if (!tx.is_in_progress())
+        {
+            tx.prepare_next_packet();
+        }
+
+        auto length = tx.get_remaining_data_length();
+        sent += length;
+        tx.data_has_been_sent(length);
+
+        if (tx.is_pulling())
+        {
+            tx.pull();
+        }
+    }
+
+    return sent;
+}
+
+SCENARIO("PacketSendBuffer - pulling packets from a source")
+{
+    GIVEN("A send buffer and a source of six packets")
+    {
+        SendBuffer tx{};
+        auto source = std::make_shared<CountingSource>(6);
+
+        WHEN("The source is attached with a look-ahead of two packets")
+        {
+            tx.set_source(source, 2);
+
+            THEN("Only the look-ahead is pulled")
+            {
+                REQUIRE(tx.is_pulling());
+                tx.pull();
+                REQUIRE(source->calls == 2);
+                REQUIRE(tx.available_slots() == 3);
+
+                tx.pull();
+                REQUIRE(source->calls == 2);
+            }
+
+            THEN("All packets are sent after which the source is let go of")
+            {
+                REQUIRE(send_all(tx) == 60);
+                REQUIRE(source->provided == 6);
+                REQUIRE_FALSE(tx.is_pulling());
+                REQUIRE(source.use_count() == 1);
+            }
+        }
+
+        WHEN("The look-ahead is larger than the buffer")
+        {
+            tx.set_source(source, 10);
+            tx.pull();
+
+            THEN("The buffer is filled")
+            {
+                REQUIRE(source->provided == 5);
+                REQUIRE(tx.available_slots() == 0);
+            }
+        }
+
+        WHEN("Packets already have been put into the buffer")
+        {
+            REQUIRE(tx.put(HTTPPacket{ make_view(10), 10 }));
+            tx.set_source(source, 2);
+            tx.pull();
+
+            THEN("They count towards the look-ahead")
+            {
+                REQUIRE(source->provided == 1);
+                REQUIRE(send_all(tx) == 70);
+            }
+        }
+
+        WHEN("The buffer is cleared")
+        {
+            tx.set_source(source, 2);
+            tx.pull();
+            tx.clear();
+            tx.pull();
+
+            THEN("The source is detached")
+            {
+                REQUIRE_FALSE(tx.is_pulling());
+                REQUIRE(source->calls == 2);
+                REQUIRE(tx.is_empty());
+                REQUIRE(source.use_count() == 1);
+            }
+        }
+
+        WHEN("The buffer is cleared while the source provides a packet")
+        {
+            tx.set_source(source, 2);
+            source->on_pull = [&tx]() { tx.clear(); };
+            tx.pull();
+
+            THEN("The packet isn't queued and no more are pulled")
+            {
+                REQUIRE(source->calls == 1);
+                REQUIRE_FALSE(tx.is_pulling());
+                REQUIRE(tx.is_empty());
+            }
+        }
+    }
+}
@@ -0,0 +1,219 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "smooth/core/Task.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/ipc/Publisher.h"
+#include "smooth/core/ipc/SubscribingTaskEventQueue.h"
+
+using namespace smooth::core;
+using namespace smooth::core::ipc;
+
+namespace
+{
+    class Counted
+    {
+        public:
+            Counted() = default;
+
+            explicit Counted(int value)
+                    : value(value)
+            {
+            }
+
+            Counted(const Counted& other)
+                    : value(other.value)
+            {
+                ++copies;
+            }
+
+            Counted(Counted&&) = default;
+
+            Counted& operator=(const Counted& other)
+            {
+                value = other.value;
+                ++copies;
+
+                return *this;
+            }
+
+            Counted& operator=(Counted&&) = default;
+
+            int value = 0;
+            static std::atomic<int> copies;
+    };
+
+    std::atomic<int> Counted::copies{ 0 };
+
+    class Receiver
+        : public IEventListener<Counted>
+    {
+        public:
+            using ReceiverQueue = SubscribingTaskEventQueue<Counted>;
+
+            explicit Receiver(Task& task)
+                    : queue(ReceiverQueue::create(10, task, *this))
+            {
+            }
+
+            void event(const Counted& item) override
+            {
+                received.push_back(&item);
+                sum += item.value;
+            }
+
+            /// Forward everything in the queue, just like the Task does.
+            void drain()
+            {
+                auto& q = static_cast<ITaskEventQueue&>(*queue);
+
+                while (queue->count() > 0)
+                {
+                    q.forward_to_event_listener();
+                }
+            }
+
+            std::shared_ptr<ReceiverQueue> queue;
+            std::vector<const Counted*> received{};
+            int sum = 0;
+    };
+
+    class OwnerTask
+        : public Task
+    {
+        public:
+            OwnerTask()
+                    : Task("Owner", 0, 0, std::chrono::milliseconds(1000))
+            {
+            }
+    };
+}
+
+SCENARIO("Publishing to several subscribers")
+{
+    GIVEN("Four subscribers")
+    {
+        OwnerTask task{};
+        std::vector<std::unique_ptr<Receiver>> receivers{};
+
+        for (int i = 0; i < 4; ++i)
+        {
+            receivers.emplace_back(std::make_unique<Receiver>(task));
+        }
+
+        Counted::copies = 0;
+
+        WHEN("Publishing by reference")
+        {
+            Counted item{ 5 };
+            Publisher<Counted>::publish(item);
+
+            THEN("The item is copied exactly once")
+            {
+                REQUIRE(Counted::copies == 1);
+
+                for (auto& r : receivers)
+                {
+                    r->drain();
+                    REQUIRE(r->sum == 5);
+                }
+
+                REQUIRE(Counted::copies == 1);
+            }
+        }
+
+        WHEN("Publishing a shared item")
+        {
+            auto item = std::make_shared<const Counted>(7);
+            Publisher<Counted>::publish(item);
+
+            THEN("All subscribers receive the same instance and nothing is copied")
+            {
+                for (auto& r : receivers)
+                {
+                    r->drain();
+                    REQUIRE(r->received.size() == 1);
+                    REQUIRE(r->received[0] == item.get());
+                }
+
+                REQUIRE(Counted::copies == 0);
+            }
+        }
+
+        WHEN("A subscriber goes away")
+        {
+            receivers.pop_back();
+            Publisher<Counted>::publish(Counted{ 1 });
+
+            THEN("Remaining subscribers still receive items")
+            {
+                for (auto& r : receivers)
+                {
+                    r->drain();
+                    REQUIRE(r->sum == 1);
+                }
+            }
+        }
+
+        WHEN("Publishing while subscribers come and go")
+        {
+            std::atomic_bool running{ true };
+
+            std::thread publisher([&running]() {
+                                      while (running)
+                                      {
+                                          Publisher<Counted>::publish(std::make_shared<const Counted>(1));
+                                      }
+                                  });
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                Receiver r{ task };
+                r.drain();
+            }
+
+            running = false;
+            publisher.join();
+
+            THEN("Nothing breaks")
+            {
+                REQUIRE(Counted::copies == 0);
+            }
+        }
+    }
+
+    GIVEN("No subscribers")
+    {
+        Counted::copies = 0;
+
+        WHEN("Publishing by reference")
+        {
+            Publisher<Counted>::publish(Counted{ 1 });
+
+            THEN("No copy is made")
+            {
+                REQUIRE(Counted::copies == 0);
+            }
+        }
+    }
+}
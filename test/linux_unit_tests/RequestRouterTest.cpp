@@ -0,0 +1,168 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "smooth/application/network/http/regular/RequestRouter.h"
+#include "smooth/application/network/http/regular/HTTPRequestHandler.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+
+class NamedHandler
+    : public HTTPRequestHandler
+{
+    public:
+        explicit NamedHandler(std::string name)
+                : name(std::move(name))
+        {
+        }
+
+        void request(IConnectionTimeoutModifier& /*timeout_modifier*/,
+                     const std::string& /*url*/,
+                     const std::vector<uint8_t>& /*content*/) override
+        {
+        }
+
+        const std::string name;
+};
+
+static std::string find(const RequestRouter& router, HTTPMethod method, std::string_view url,
+                        RouteParameters& params)
+{
+    auto handler = router.find(method, url, params);
+
+    return handler ? static_cast<NamedHandler*>(handler)->name : "";
+}
+
+SCENARIO("RequestRouter - static routes")
+{
+    RequestRouter router;
+    RouteParameters params;
+    REQUIRE(router.add(HTTPMethod::GET, "/", std::make_shared<NamedHandler>("root")));
+    REQUIRE(router.add(HTTPMethod::GET, "/api/status", std::make_shared<NamedHandler>("status")));
+    REQUIRE(router.add(HTTPMethod::GET, "/api/state", std::make_shared<NamedHandler>("state")));
+    REQUIRE(router.add(HTTPMethod::POST, "/api/status", std::make_shared<NamedHandler>("post status")));
+
+    REQUIRE(find(router, HTTPMethod::GET, "/", params) == "root");
+    REQUIRE(find(router, HTTPMethod::GET, "/api/status", params) == "status");
+    REQUIRE(find(router, HTTPMethod::GET, "/api/state", params) == "state");
+    REQUIRE(find(router, HTTPMethod::POST, "/api/status", params) == "post status");
+    REQUIRE(params.empty());
+
+    REQUIRE(find(router, HTTPMethod::GET, "/api/stat", params).empty());
+    REQUIRE(find(router, HTTPMethod::GET, "/api/statuses", params).empty());
+    REQUIRE(find(router, HTTPMethod::GET, "/api", params).empty());
+    REQUIRE(find(router, HTTPMethod::PUT, "/api/status", params).empty());
+
+    // Replacing a route
+    REQUIRE(router.add(HTTPMethod::GET, "/api/status", std::make_shared<NamedHandler>("new status")));
+    REQUIRE(find(router, HTTPMethod::GET, "/api/status", params) == "new status");
+}
+
+SCENARIO("RequestRouter - parameters")
+{
+    RequestRouter router;
+    RouteParameters params;
+    REQUIRE(router.add(HTTPMethod::GET, "/api/sensor/{id}", std::make_shared<NamedHandler>("sensor")));
+    REQUIRE(router.add(HTTPMethod::GET, "/api/sensor/{id}/value/{index}", std::make_shared<NamedHandler>("value")));
+
+    REQUIRE(find(router, HTTPMethod::GET, "/api/sensor/12", params) == "sensor");
+    REQUIRE(params.size() == 1);
+    REQUIRE(params.get("id") == "12");
+    REQUIRE_FALSE(params.has("index"));
+
+    REQUIRE(find(router, HTTPMethod::GET, "/api/sensor/temp/value/3", params) == "value");
+    REQUIRE(params.size() == 2);
+    REQUIRE(params.get("id") == "temp");
+    REQUIRE(params.get("index") == "3");
+
+    // Parameters match a single, non-empty segment.
+    REQUIRE(find(router, HTTPMethod::GET, "/api/sensor/", params).empty());
+    REQUIRE(find(router, HTTPMethod::GET, "/api/sensor/12/value", params).empty());
+    REQUIRE(find(router, HTTPMethod::GET, "/api/sensor/12/value/3/4", params).empty());
+    REQUIRE(params.empty());
+}
+
+SCENARIO("RequestRouter - wildcards")
+{
+    RequestRouter router;
+    RouteParameters params;
+    REQUIRE(router.add(HTTPMethod::GET, "/static/*", std::make_shared<NamedHandler>("static")));
+    REQUIRE(router.add(HTTPMethod::GET, "/user/{name}/files/*", std::make_shared<NamedHandler>("files")));
+
+    REQUIRE(find(router, HTTPMethod::GET, "/static/css/site.css", params) == "static");
+    REQUIRE(params.get(RouteParameters::wildcard) == "css/site.css");
+
+    REQUIRE(find(router, HTTPMethod::GET, "/static/", params) == "static");
+    REQUIRE(params.has(RouteParameters::wildcard));
+    REQUIRE(params.get(RouteParameters::wildcard).empty());
+
+    REQUIRE(find(router, HTTPMethod::GET, "/user/bob/files/a/b.txt", params) == "files");
+    REQUIRE(params.get("name") == "bob");
+    REQUIRE(params.get(RouteParameters::wildcard) == "a/b.txt");
+
+    REQUIRE(find(router, HTTPMethod::GET, "/static", params).empty());
+}
+
+SCENARIO("RequestRouter - precedence")
+{
+    RequestRouter router;
+    RouteParameters params;
+    REQUIRE(router.add(HTTPMethod::GET, "/a/b/c", std::make_shared<NamedHandler>("static")));
+    REQUIRE(router.add(HTTPMethod::GET, "/a/{x}/d", std::make_shared<NamedHandler>("param")));
+    REQUIRE(router.add(HTTPMethod::GET, "/a/*", std::make_shared<NamedHandler>("wildcard")));
+
+    WHEN("A static route matches")
+    {
+        REQUIRE(find(router, HTTPMethod::GET, "/a/b/c", params) == "static");
+        REQUIRE(params.empty());
+    }
+
+    WHEN("The static route is a dead end, the parameter is tried")
+    {
+        REQUIRE(find(router, HTTPMethod::GET, "/a/b/d", params) == "param");
+        REQUIRE(params.size() == 1);
+        REQUIRE(params.get("x") == "b");
+    }
+
+    WHEN("Neither matches, the wildcard is used without stale parameters")
+    {
+        REQUIRE(find(router, HTTPMethod::GET, "/a/b/e", params) == "wildcard");
+        REQUIRE(params.size() == 1);
+        REQUIRE(params.get(RouteParameters::wildcard) == "b/e");
+    }
+}
+
+SCENARIO("RequestRouter - invalid routes")
+{
+    RequestRouter router;
+    auto handler = std::make_shared<NamedHandler>("handler");
+
+    REQUIRE_FALSE(router.add(HTTPMethod::GET, "/a/*/b", handler));
+    REQUIRE_FALSE(router.add(HTTPMethod::GET, "/a/{}", handler));
+    REQUIRE_FALSE(router.add(HTTPMethod::GET, "/a/{id", handler));
+    REQUIRE_FALSE(router.add(HTTPMethod::GET, "/a/x{id}", handler));
+    REQUIRE_FALSE(router.add(HTTPMethod::GET, "/a/{id}x", handler));
+    REQUIRE_FALSE(router.add(HTTPMethod::GET, "/{a}/{b}/{c}/{d}/{e}/{f}/{g}/{h}/{i}", handler));
+
+    REQUIRE(router.add(HTTPMethod::GET, "/a/{id}", handler));
+    REQUIRE_FALSE(router.add(HTTPMethod::GET, "/a/{name}/b", handler));
+}
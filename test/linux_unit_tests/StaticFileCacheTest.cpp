@@ -0,0 +1,225 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include "smooth/application/network/http/regular/StaticFileCache.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/responses/CachedFileResponse.h"
+#include "smooth/core/filesystem/FSLock.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::core::filesystem;
+using namespace std::chrono;
+
+static const Path web_root{ "/tmp/static_file_cache_test" };
+
+static void write_file(const Path& path, const std::string& content)
+{
+    std::ofstream out(path.str(), std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+static void setup_web_root()
+{
+    mkdir(web_root.str().c_str(), 0755);
+    mkdir((web_root / "sub").str().c_str(), 0755);
+    write_file(web_root / "style.css", "body {}");
+    write_file(web_root / "large.js", std::string(1000, 'x'));
+    write_file(web_root / "page.html", "Hello {{name}}");
+    write_file(web_root / "app.js", "var a = 1;");
+    write_file(web_root / "app.js.gz", "not really gzip");
+    write_file(web_root / "sub" / "index.html", "<html></html>");
+}
+
+static std::size_t send_all(IResponseOperation& response)
+{
+    std::size_t total = 0;
+    auto res = ResponseStatus::HasMoreData;
+
+    while (res == ResponseStatus::HasMoreData)
+    {
+        std::shared_ptr<const uint8_t> data{};
+        std::size_t length = 0;
+        res = response.get_data_view(1024, data, length);
+        total += length;
+    }
+
+    return total;
+}
+
+SCENARIO("StaticFileCache - resolving files")
+{
+    FSLock::set_limit(5);
+    setup_web_root();
+
+    GIVEN("A cache")
+    {
+        StaticFileCache cache{ web_root, { "index.html" }, { ".html" }, 10000, 100, seconds(10) };
+
+        WHEN("Requesting a small file")
+        {
+            auto file = cache.get("style.css");
+
+            THEN("Headers and content are available")
+            {
+                REQUIRE(file);
+                REQUIRE(file->path == web_root / "style.css");
+                REQUIRE(file->headers.at(CONTENT_LENGTH) == "7");
+                REQUIRE(file->headers.at(CONTENT_TYPE) == "text/css");
+                REQUIRE(file->headers.at(ETAG) == file->etag);
+                REQUIRE(file->headers.count(LAST_MODIFIED) == 1);
+                REQUIRE(file->headers.at(ACCEPT_RANGES) == "bytes");
+                REQUIRE(file->content);
+                REQUIRE(std::string(file->content->begin(), file->content->end()) == "body {}");
+                REQUIRE(cache.get("style.css") == file);
+
+                responses::CachedFileResponse response{ file };
+                REQUIRE(response.get_response_code() == ResponseCode::OK);
+                REQUIRE(response.get_headers().at(ETAG) == file->etag);
+                REQUIRE(send_all(response) == 7);
+            }
+        }
+
+        WHEN("Requesting a file through equivalent URLs")
+        {
+            auto file = cache.get("/style.css");
+            auto used = cache.size();
+
+            THEN("They share a single entry")
+            {
+                REQUIRE(file);
+                REQUIRE(cache.get("style.css") == file);
+                REQUIRE(cache.get("//style.css") == file);
+                REQUIRE(cache.get("/./style.css") == file);
+                REQUIRE(cache.get("/sub/../style.css") == file);
+                REQUIRE(cache.size() == used);
+                REQUIRE(cache.get("/sub/") == cache.get("sub"));
+            }
+        }
+
+        WHEN("Requesting a file with a precompressed sibling")
+        {
+            auto file = cache.get("app.js");
+
+            THEN("Both variants are loaded with the content type of the original")
+            {
+                REQUIRE(file);
+                REQUIRE(file->headers.at(CONTENT_TYPE) == "text/javascript");
+                REQUIRE(file->headers.at(VARY) == ACCEPT_ENCODING);
+                REQUIRE(file->headers.count(CONTENT_ENCODING) == 0);
+                REQUIRE(file->gzipped);
+                REQUIRE(file->gzipped->path == web_root / "app.js.gz");
+                REQUIRE(file->gzipped->headers.at(CONTENT_TYPE) == "text/javascript");
+                REQUIRE(file->gzipped->headers.at(CONTENT_ENCODING) == "gzip");
+                REQUIRE(file->gzipped->headers.at(CONTENT_LENGTH) == "15");
+                REQUIRE(file->gzipped->etag != file->etag);
+                REQUIRE_FALSE(cache.get("style.css")->gzipped);
+            }
+        }
+
+        WHEN("Requesting a directory")
+        {
+            auto file = cache.get("sub");
+
+            THEN("The index file is resolved")
+            {
+                REQUIRE(file);
+                REQUIRE(file->path == web_root / "sub" / "index.html");
+            }
+        }
+
+        WHEN("Requesting files that are too large or templates")
+        {
+            auto large = cache.get("large.js");
+            auto page = cache.get("page.html");
+
+            THEN("They are resolved without keeping their contents")
+            {
+                REQUIRE(large);
+                REQUIRE_FALSE(large->content);
+                REQUIRE(large->headers.at(CONTENT_LENGTH) == "1000");
+                REQUIRE(large->headers.at(ACCEPT_RANGES) == "bytes");
+                REQUIRE(page);
+                REQUIRE_FALSE(page->content);
+                REQUIRE(page->headers.count(ACCEPT_RANGES) == 0);
+            }
+        }
+
+        WHEN("Requesting files that don't exist or are outside the web root")
+        {
+            THEN("Nothing is found")
+            {
+                REQUIRE_FALSE(cache.get("missing.css"));
+                REQUIRE_FALSE(cache.get("../static_file_cache_test_other"));
+                REQUIRE_FALSE(cache.get("/sub/../../etc/passwd"));
+                REQUIRE(cache.size() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("StaticFileCache - eviction and revalidation")
+{
+    FSLock::set_limit(5);
+    setup_web_root();
+
+    GIVEN("A cache with room for a single file")
+    {
+        StaticFileCache cache{ web_root, { "index.html" }, {}, 400, 100, milliseconds(0) };
+
+        auto first = cache.get("style.css");
+        auto used = cache.size();
+        REQUIRE(used > 0);
+
+        WHEN("Another file is requested")
+        {
+            auto second = cache.get("sub/index.html");
+
+            THEN("The least recently used file is evicted")
+            {
+                REQUIRE(cache.size() <= 400);
+                REQUIRE(cache.get("style.css") != first);
+            }
+        }
+
+        WHEN("The file changes")
+        {
+            write_file(web_root / "style.css", "body { color: red; }");
+            auto changed = cache.get("style.css");
+
+            THEN("It is reloaded")
+            {
+                REQUIRE(changed != first);
+                REQUIRE(changed->headers.at(CONTENT_LENGTH) == "20");
+                REQUIRE(changed->etag != first->etag);
+            }
+        }
+
+        WHEN("The file is unchanged")
+        {
+            THEN("The cached file is used")
+            {
+                REQUIRE(cache.get("style.css") == first);
+            }
+        }
+    }
+}
@@ -16,14 +16,21 @@ limitations under the License.
 */
 
 #include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
 #include <unordered_map>
 
 #define EXPOSE_PRIVATE_PARTS_FOR_TEST
 
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
 #include "smooth/application/network/http/regular/ITemplateDataRetriever.h"
+#include "smooth/application/network/http/regular/CompiledTemplate.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/core/filesystem/FSLock.h"
 
+using namespace smooth::application::network::http;
 using namespace smooth::application::network::http::regular;
+using namespace smooth::core::filesystem;
 
 class DataRetriever
     : public ITemplateDataRetriever
@@ -35,8 +42,14 @@ class DataRetriever
             data.emplace("{{food}}", "an ice cream");
         }
 
+        void add(const std::string& key, const std::string& value)
+        {
+            data[key] = value;
+        }
+
         std::string get(const std::string& key) const override
         {
+            ++lookups;
             std::string res{};
             try
             {
@@ -49,10 +62,31 @@ class DataRetriever
             return res;
         }
 
+        mutable int lookups{ 0 };
+
     private:
         std::unordered_map<std::string, std::string> data{};
 };
 
+static void write_file(const Path& path, const std::string& content)
+{
+    std::ofstream out{ path.str(), std::ios::binary | std::ios::trunc };
+    out << content;
+}
+
+static std::string render(IResponseOperation& response, std::size_t chunk_size)
+{
+    std::vector<uint8_t> data{};
+    auto status = ResponseStatus::HasMoreData;
+
+    while (status == ResponseStatus::HasMoreData)
+    {
+        status = response.get_data(chunk_size, data);
+    }
+
+    return std::string{ data.begin(), data.end() };
+}
+
 SCENARIO("Parsing a text")
 {
     GIVEN("A text")
@@ -88,3 +122,66 @@ SCENARIO("Parsing a text with unknown tokens")
         }
     }
 }
+
+SCENARIO("Compiling a template")
+{
+    GIVEN("A text with tokens and things that look like tokens")
+    {
+        CompiledTemplate t{ "{{a}}{{{b}}}{{ c}}{{d-1_x}}{{}}" };
+
+        THEN("Splits it into literal text and tokens")
+        {
+            std::string rebuilt{};
+
+            for (const auto& segment : t.get_segments())
+            {
+                rebuilt.append(segment.token == CompiledTemplate::npos ? "L:" : "T:");
+                rebuilt.append(t.text(segment));
+                rebuilt.append("|");
+            }
+
+            REQUIRE(rebuilt == "T:{{a}}|L:{|T:{{b}}|L:}{{ c}}|T:{{d-1_x}}|L:{{}}|");
+            REQUIRE(t.get_tokens() == std::vector<std::string>{ "{{a}}", "{{b}}", "{{d-1_x}}" });
+        }
+    }
+}
+
+SCENARIO("Streaming a template file")
+{
+    FSLock::set_limit(5);
+
+    GIVEN("A template file")
+    {
+        const Path path{ "/tmp/template_test.html" };
+        write_file(path, "Hello {{name}}, want {{food}}? Bye {{name}}.");
+
+        auto dr = std::make_shared<DataRetriever>();
+        TemplateProcessor tp({ ".html" }, dr);
+
+        THEN("It is rendered in small chunks, with a correct content length")
+        {
+            auto response = tp.process_template(path);
+            REQUIRE(response);
+            REQUIRE(response->get_headers().at(CONTENT_LENGTH) == "38");
+            REQUIRE(render(*response, 3) == "Hello Bob, want an ice cream? Bye Bob.");
+
+            AND_THEN("Each token present is looked up once")
+            {
+                REQUIRE(dr->lookups == 2);
+            }
+        }
+
+        THEN("The compiled template is reused until the file changes")
+        {
+            auto first = tp.get_compiled(path);
+            REQUIRE(first == tp.get_compiled(path));
+
+            write_file(path, "Changed {{name}}");
+            auto changed = tp.process_template(path);
+            REQUIRE(render(*changed, 1024) == "Changed Bob");
+            REQUIRE(first != tp.get_compiled(path));
+        }
+
+        std::remove(path);
+    }
+}
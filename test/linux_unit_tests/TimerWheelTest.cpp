@@ -0,0 +1,174 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "smooth/core/timer/TimerWheel.h"
+
+using namespace smooth::core::timer;
+
+namespace
+{
+    class Node
+        : public TimerWheelNode
+    {
+        public:
+            uint64_t expected = 0;
+            uint64_t fired_at = TimerWheel::no_tick;
+            int fire_count = 0;
+    };
+}
+
+SCENARIO("TimerWheel - expiry")
+{
+    GIVEN("A wheel with nodes spread over all levels and beyond")
+    {
+        TimerWheel wheel{};
+        std::vector<Node> nodes(10000);
+        std::mt19937_64 gen(1234);
+        std::uniform_int_distribution<uint64_t> dist(0, static_cast<uint64_t>(1) << 26);
+
+        for (auto& n : nodes)
+        {
+            n.expected = dist(gen);
+            wheel.schedule(n, n.expected);
+        }
+
+        REQUIRE(wheel.size() == nodes.size());
+
+        auto earliest = std::min_element(nodes.begin(), nodes.end(),
+                                         [](const Node& a, const Node& b) { return a.expected < b.expected; });
+
+        THEN("The next tick with work is no later than the first expiry")
+        {
+            REQUIRE(wheel.next_tick_with_work() <= earliest->expected);
+        }
+
+        WHEN("Advancing in irregular steps")
+        {
+            std::uniform_int_distribution<uint64_t> step(1, 100000);
+            uint64_t until = 0;
+
+            while (!wheel.empty())
+            {
+                until += step(gen);
+                wheel.advance(until, [&wheel](TimerWheelNode& node) {
+                                  auto& n = static_cast<Node&>(node);
+                                  n.fired_at = wheel.get_current_tick() - 1;
+                                  ++n.fire_count;
+                              });
+            }
+
+            THEN("Each node expires exactly once, on its tick")
+            {
+                for (auto& n : nodes)
+                {
+                    REQUIRE(n.fire_count == 1);
+                    REQUIRE(n.fired_at == n.expected);
+                    REQUIRE_FALSE(n.is_scheduled());
+                }
+            }
+        }
+
+        WHEN("Half of the nodes are cancelled")
+        {
+            for (size_t i = 0; i < nodes.size(); i += 2)
+            {
+                wheel.cancel(nodes[i]);
+            }
+
+            REQUIRE(wheel.size() == nodes.size() / 2);
+
+            wheel.advance(static_cast<uint64_t>(1) << 27, [](TimerWheelNode& node) {
+                              ++static_cast<Node&>(node).fire_count;
+                          });
+
+            THEN("Only the others expire")
+            {
+                REQUIRE(wheel.empty());
+
+                for (size_t i = 0; i < nodes.size(); ++i)
+                {
+                    REQUIRE(nodes[i].fire_count == (i % 2 == 0 ? 0 : 1));
+                }
+            }
+        }
+    }
+
+    GIVEN("A repeating node")
+    {
+        TimerWheel wheel{};
+        Node n{};
+        wheel.schedule(n, 100);
+
+        WHEN("It is scheduled again each time it expires")
+        {
+            std::vector<uint64_t> ticks{};
+
+            for (uint64_t t = 0; t < 1000; t += 7)
+            {
+                wheel.advance(t, [&wheel, &ticks](TimerWheelNode& node) {
+                                  auto tick = wheel.get_current_tick() - 1;
+                                  ticks.push_back(tick);
+                                  wheel.schedule(node, tick + 100);
+                              });
+            }
+
+            THEN("It expires on each interval")
+            {
+                REQUIRE(ticks == std::vector<uint64_t>{ 100, 200, 300, 400, 500, 600, 700, 800, 900 });
+                REQUIRE(n.is_scheduled());
+                REQUIRE(n.get_expiry_tick() == 1000);
+            }
+        }
+
+        WHEN("It is moved to an earlier tick")
+        {
+            wheel.schedule(n, 5);
+            uint64_t fired = 0;
+            wheel.advance(10, [&wheel, &fired](TimerWheelNode& /*node*/) { fired = wheel.get_current_tick() - 1; });
+
+            THEN("It expires on the new tick")
+            {
+                REQUIRE(fired == 5);
+                REQUIRE(wheel.empty());
+            }
+        }
+    }
+
+    GIVEN("A wheel that has advanced")
+    {
+        TimerWheel wheel{};
+        wheel.advance(5000, [](TimerWheelNode&) {});
+
+        WHEN("Scheduling a node in the past")
+        {
+            Node n{};
+            wheel.schedule(n, 10);
+            uint64_t fired = 0;
+            wheel.advance(6000, [&wheel, &fired](TimerWheelNode& /*node*/) { fired = wheel.get_current_tick() - 1; });
+
+            THEN("It expires on the next tick")
+            {
+                REQUIRE(fired == 5001);
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include <memory>
+#include <vector>
+#include "smooth/application/network/http/websocket/Masking.h"
+#include "smooth/application/network/http/websocket/responses/WSResponse.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::websocket;
+using namespace smooth::application::network::http::websocket::responses;
+
+static std::vector<uint8_t> make_data(std::size_t size)
+{
+    std::vector<uint8_t> data(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        data[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    return data;
+}
+
+static void reference_mask(std::vector<uint8_t>& data, const uint8_t (& key)[4])
+{
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(data[i] ^ key[i % 4]);
+    }
+}
+
+static std::vector<uint8_t> send_all(WSResponse& response, std::size_t max_amount, int& calls)
+{
+    std::vector<uint8_t> sent{};
+    auto res = ResponseStatus::HasMoreData;
+    calls = 0;
+
+    while (res == ResponseStatus::HasMoreData)
+    {
+        std::shared_ptr<const uint8_t> data{};
+        std::size_t length = 0;
+        res = response.get_data_view(max_amount, data, length);
+        sent.insert(sent.end(), data.get(), data.get() + length);
+        ++calls;
+    }
+
+    return sent;
+}
+
+SCENARIO("Websocket - masking")
+{
+    const uint8_t key[4] = { 0x12, 0x34, 0x56, 0x78 };
+
+    GIVEN("Payloads of various sizes and offsets into the buffer")
+    {
+        auto correct = true;
+
+        for (std::size_t size = 0; size < 100; ++size)
+        {
+            for (std::size_t start = 0; start < 8; ++start)
+            {
+                auto expected = make_data(size);
+                reference_mask(expected, key);
+
+                auto buffer = make_data(size);
+                buffer.insert(buffer.begin(), start, 0);
+
+                uint64_t offset = 0;
+                apply_mask(buffer.data() + start, size, key, offset);
+
+                correct = correct
+                          && offset == size
+                          && std::equal(expected.begin(), expected.end(), buffer.begin() + static_cast<long>(start));
+            }
+        }
+
+        THEN("The result matches byte by byte masking")
+        {
+            REQUIRE(correct);
+        }
+    }
+
+    GIVEN("A payload received in parts of odd sizes")
+    {
+        auto data = make_data(1000);
+        auto expected = data;
+        reference_mask(expected, key);
+
+        uint64_t offset = 0;
+        std::size_t pos = 0;
+
+        for (std::size_t part = 1; pos < data.size(); part = part * 3 + 1)
+        {
+            auto len = std::min(part, data.size() - pos);
+            apply_mask(data.data() + pos, len, key, offset);
+            pos += len;
+        }
+
+        THEN("The mask phase is kept between the parts")
+        {
+            REQUIRE(offset == data.size());
+            REQUIRE(data == expected);
+        }
+    }
+}
+
+SCENARIO("Websocket - outgoing frames")
+{
+    GIVEN("A control frame")
+    {
+        WSResponse response{ OpCode::Ping };
+        int calls;
+        auto sent = send_all(response, 100, calls);
+
+        THEN("Only the header is sent")
+        {
+            REQUIRE(calls == 1);
+            REQUIRE(sent == std::vector<uint8_t>{ 0x89, 0x00 });
+        }
+    }
+
+    GIVEN("Payloads with 7, 16 and 64 bit lengths, sent in parts")
+    {
+        for (std::size_t size : { 125u, 126u, 70000u })
+        {
+            auto payload = make_data(size);
+            WSResponse response{ payload, false, true, true };
+            int calls;
+            auto sent = send_all(response, 1000, calls);
+
+            std::vector<uint8_t> expected{ 0x82 };
+
+            if (size == 125)
+            {
+                expected.push_back(125);
+            }
+            else if (size == 126)
+            {
+                expected.insert(expected.end(), { 126, 0x00, 126 });
+            }
+            else
+            {
+                expected.insert(expected.end(), { 127, 0, 0, 0, 0, 0, 0x01, 0x11, 0x70 });
+            }
+
+            expected.insert(expected.end(), payload.begin(), payload.end());
+
+            THEN("A single frame with the full payload length is sent")
+            {
+                REQUIRE(sent == expected);
+                REQUIRE(calls == static_cast<int>((size + 999) / 1000));
+            }
+        }
+    }
+
+    GIVEN("A continuation fragment of text")
+    {
+        WSResponse response{ std::string{ "abc" }, false, false };
+        int calls;
+        auto sent = send_all(response, 100, calls);
+
+        THEN("The op code is Continuation without the fin-bit")
+        {
+            REQUIRE(sent == std::vector<uint8_t>{ 0x00, 0x03, 'a', 'b', 'c' });
+        }
+    }
+}
@@ -0,0 +1,280 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "mqtt_window_bench.h"
+#include <array>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/Wifi.h"
+
+using namespace smooth;
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+using namespace smooth::application::network::mqtt;
+
+namespace mqtt_window_bench
+{
+    static constexpr uint16_t port = 18830;
+    static constexpr auto round_length = seconds(5);
+    static constexpr std::array<size_t, 3> windows{ 1, 8, 32 };
+    static const char* tag = "Bench";
+
+    MockBroker::MockBroker(uint16_t port, std::chrono::milliseconds round_trip_time)
+            : port(port), round_trip_time(round_trip_time)
+    {
+    }
+
+    MockBroker::~MockBroker()
+    {
+        running = false;
+
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    void MockBroker::start()
+    {
+        running = true;
+        worker = std::thread([this]() { run(); });
+    }
+
+    void MockBroker::run()
+    {
+        auto listener = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0
+            && listen(listener, 1) == 0)
+        {
+            auto client = accept(listener, nullptr, nullptr);
+
+            if (client >= 0)
+            {
+                serve(client);
+                close(client);
+            }
+        }
+        else
+        {
+            Log::error(tag, "Could not listen on port {}", port);
+        }
+
+        close(listener);
+    }
+
+    void MockBroker::serve(int client)
+    {
+        std::vector<uint8_t> rx{};
+        std::array<uint8_t, 4096> buff{};
+        bool connected = true;
+
+        while (running && connected)
+        {
+            pollfd fd{ client, POLLIN, 0 };
+
+            if (poll(&fd, 1, 1) > 0)
+            {
+                auto read = recv(client, buff.data(), buff.size(), 0);
+                connected = read > 0;
+
+                if (connected)
+                {
+                    rx.insert(rx.end(), buff.begin(), buff.begin() + read);
+                }
+            }
+
+            // Split received data into complete packets: fixed header byte, variable length
+            // "remaining length" and the remaining bytes.
+            bool complete = true;
+
+            while (complete && rx.size() >= 2)
+            {
+                size_t remaining = 0;
+                size_t multiplier = 1;
+                size_t pos = 1;
+                bool more = true;
+
+                while (more && pos < rx.size())
+                {
+                    remaining += (rx[pos] & 0x7Fu) * multiplier;
+                    multiplier *= 128;
+                    more = (rx[pos] & 0x80u) != 0;
+                    ++pos;
+                }
+
+                complete = !more && rx.size() >= pos + remaining;
+
+                if (complete)
+                {
+                    std::vector<uint8_t> packet(rx.begin(), rx.begin() + static_cast<long>(pos + remaining));
+                    rx.erase(rx.begin(), rx.begin() + static_cast<long>(pos + remaining));
+                    handle_packet(packet);
+                }
+            }
+
+            connected = connected && send_due_replies(client);
+        }
+    }
+
+    void MockBroker::handle_packet(const std::vector<uint8_t>& packet)
+    {
+        auto type = packet[0] >> 4;
+
+        if (type == 1)
+        {
+            // CONNECT -> CONNACK, sent immediately.
+            reply({ 0x20, 0x02, 0x00, 0x00 }, false, false);
+        }
+        else if (type == 3)
+        {
+            auto qos = (packet[0] >> 1) & 0x03;
+
+            if (qos > 0)
+            {
+                // Skip remaining length, then topic, to reach the packet id.
+                size_t pos = 1;
+
+                while (packet[pos] & 0x80u)
+                {
+                    ++pos;
+                }
+
+                ++pos;
+                size_t topic_len = static_cast<size_t>((packet[pos] << 8) | packet[pos + 1]);
+                pos += 2 + topic_len;
+
+                auto response = qos == 1 ? uint8_t{ 0x40 } : uint8_t{ 0x50 };
+                reply({ response, 0x02, packet[pos], packet[pos + 1] }, true, qos == 1);
+            }
+        }
+        else if (type == 6)
+        {
+            // PUBREL -> PUBCOMP
+            reply({ 0x70, 0x02, packet[2], packet[3] }, true, true);
+        }
+        else if (type == 12)
+        {
+            // PINGREQ -> PINGRESP
+            reply({ 0xD0, 0x00 }, false, false);
+        }
+    }
+
+    void MockBroker::reply(std::vector<uint8_t> data, bool delayed, bool completes)
+    {
+        auto due = steady_clock::now() + (delayed ? round_trip_time : milliseconds(0));
+        replies.push_back({ due, std::move(data), completes });
+    }
+
+    bool MockBroker::send_due_replies(int client)
+    {
+        bool ok = true;
+        auto now = steady_clock::now();
+
+        while (ok && !replies.empty() && replies.front().due <= now)
+        {
+            auto& r = replies.front();
+            ok = send(client, r.data.data(), r.data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(r.data.size());
+
+            if (ok && r.completes)
+            {
+                ++completed;
+            }
+
+            replies.pop_front();
+        }
+
+        return ok;
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, milliseconds(10)),
+              broker(port, milliseconds(50)),
+              mqtt_data(MQTTDataQueue::create(10, *this, *this)),
+              client("bench", seconds(60), 8192, 10, mqtt_data)
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+        broker.start();
+
+        // On Linux this only announces that the network is up.
+        get_wifi().connect_to_ap();
+        std::this_thread::sleep_for(milliseconds(100));
+        client.connect_to(std::make_shared<core::network::IPv4>("127.0.0.1", port), false);
+    }
+
+    void App::event(const MQTTData&)
+    {
+    }
+
+    void App::tick()
+    {
+        if (client.is_connected() && round < windows.size())
+        {
+            if (!started)
+            {
+                started = true;
+                start_round();
+            }
+            else if (steady_clock::now() - round_start >= round_length)
+            {
+                auto done = broker.get_completed() - completed_at_start;
+                auto elapsed = duration_cast<duration<double>>(steady_clock::now() - round_start).count();
+                Log::info(tag, "Window {:2}: {} QoS1 messages in {:.1f} s, {:.1f} msg/s",
+                          windows[round], done, elapsed, static_cast<double>(done) / elapsed);
+
+                ++round;
+
+                if (round < windows.size())
+                {
+                    start_round();
+                }
+                else
+                {
+                    Log::info(tag, "Done");
+                }
+            }
+
+            while (round < windows.size() && client.publish("bench", "payload", QoS::AT_LEAST_ONCE, false))
+            {
+            }
+        }
+    }
+
+    void App::start_round()
+    {
+        client.set_send_window(windows[round]);
+        completed_at_start = broker.get_completed();
+        round_start = steady_clock::now();
+    }
+}
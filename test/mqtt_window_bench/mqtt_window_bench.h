@@ -0,0 +1,108 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/ipc/TaskEventQueue.h"
+#include "smooth/application/network/mqtt/MqttClient.h"
+
+namespace mqtt_window_bench
+{
+    /// A minimal MQTT broker that accepts a single client and acknowledges everything it receives
+    /// after a fixed delay, simulating the round trip time to a remote broker.
+    class MockBroker
+    {
+        public:
+            MockBroker(uint16_t port, std::chrono::milliseconds round_trip_time);
+
+            ~MockBroker();
+
+            MockBroker(const MockBroker&) = delete;
+
+            MockBroker& operator=(const MockBroker&) = delete;
+
+            void start();
+
+            /// \return The number of QoS 1 and 2 messages that have been fully acknowledged.
+            [[nodiscard]] uint64_t get_completed() const
+            {
+                return completed;
+            }
+
+        private:
+            struct Reply
+            {
+                std::chrono::steady_clock::time_point due;
+                std::vector<uint8_t> data;
+                bool completes;
+            };
+
+            void run();
+
+            void serve(int client);
+
+            void handle_packet(const std::vector<uint8_t>& packet);
+
+            void reply(std::vector<uint8_t> data, bool delayed, bool completes);
+
+            bool send_due_replies(int client);
+
+            uint16_t port;
+            std::chrono::milliseconds round_trip_time;
+            std::thread worker{};
+            std::atomic_bool running{ false };
+            std::atomic<uint64_t> completed{ 0 };
+            std::deque<Reply> replies{};
+    };
+
+    /// Publishes as fast as the MqttClient allows to the MockBroker, which acknowledges messages
+    /// after 50 ms, and reports messages per second for send windows of 1, 8 and 32 messages.
+    class App
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<smooth::application::network::mqtt::MQTTData>
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void tick() override;
+
+            void event(const smooth::application::network::mqtt::MQTTData& event) override;
+
+        private:
+            void start_round();
+
+            using MQTTDataQueue = smooth::core::ipc::TaskEventQueue<smooth::application::network::mqtt::MQTTData>;
+            MockBroker broker;
+            std::shared_ptr<MQTTDataQueue> mqtt_data;
+            smooth::application::network::mqtt::MqttClient client;
+            std::chrono::steady_clock::time_point round_start{};
+            uint64_t completed_at_start = 0;
+            size_t round = 0;
+            bool started = false;
+    };
+}
@@ -0,0 +1,216 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "packet_handoff_bench.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/PacketReceiveBuffer.h"
+#include "smooth/application/network/http/HTTPProtocol.h"
+#include "smooth/application/network/mqtt/packet/MQTTProtocol.h"
+
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::core::logging;
+using namespace smooth::application::network;
+using namespace std::chrono;
+
+static std::atomic<uint64_t> allocations{ 0 };
+static std::atomic<uint64_t> allocated_bytes{ 0 };
+
+// This benchmark is Linux only; count allocations by replacing the global allocation functions.
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    allocated_bytes += size;
+    auto p = std::malloc(size == 0 ? 1 : size);
+
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace packet_handoff_bench
+{
+    static const char* tag = "Bench";
+    static constexpr int chunk_size = 4096;
+    static constexpr int content_length = 1024 * 1024;
+    static constexpr int request_count = 16;
+    static constexpr int mqtt_count = 100000;
+
+    struct Counters
+    {
+        uint64_t allocations;
+        uint64_t bytes;
+        steady_clock::time_point time;
+
+        static Counters now()
+        {
+            return { ::allocations, ::allocated_bytes, steady_clock::now() };
+        }
+    };
+
+    template<typename Protocol, typename Packet>
+    static int feed(PacketReceiveBuffer<Protocol, 5>& rx, const std::vector<uint8_t>& data, Packet* kept)
+    {
+        // Same sequence of calls as Socket::read_data(), with the application taking each packet right away.
+        std::size_t pos = 0;
+        int packets = 0;
+
+        while (pos < data.size())
+        {
+            auto wanted = static_cast<std::size_t>(rx.amount_wanted());
+            auto length = std::min(wanted, data.size() - pos);
+
+            {
+                auto write_pos = rx.get_write_pos();
+                std::memcpy(static_cast<uint8_t*>(write_pos), data.data() + pos, length);
+            }
+
+            pos += length;
+            rx.data_received(static_cast<int>(length));
+
+            if (rx.is_packet_complete())
+            {
+                rx.prepare_new_packet();
+                ++packets;
+
+                if (kept)
+                {
+                    rx.get(*kept);
+                }
+                else
+                {
+                    Packet fresh{};
+                    rx.get(fresh);
+                }
+            }
+        }
+
+        return packets;
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        http_chunks(false);
+        http_chunks(true);
+        mqtt_messages(false);
+        mqtt_messages(true);
+
+        Log::info(tag, "Done");
+    }
+
+    static void report(const char* name, bool keep_packet, const char* unit, int count, const Counters& start)
+    {
+        auto end = Counters::now();
+        auto elapsed = duration_cast<duration<double>>(end.time - start.time).count();
+
+        Log::info(tag, "{:>10}, {:>13}: {:6.2f} allocations, {:8.1f} bytes allocated per {}, {:8.0f} {}/s",
+                  name,
+                  keep_packet ? "kept packet" : "fresh packet",
+                  static_cast<double>(end.allocations - start.allocations) / count,
+                  static_cast<double>(end.bytes - start.bytes) / count,
+                  unit,
+                  count / elapsed,
+                  unit);
+    }
+
+    void App::http_chunks(bool keep_packet)
+    {
+        std::string headers{ "POST /upload/a/path/that/is/longer/than/sso HTTP/1.1\r\n"
+                             "Host: localhost\r\n"
+                             "Content-Type: application/octet-stream\r\n"
+                             "Content-Length: " + std::to_string(content_length) + "\r\n\r\n" };
+
+        std::vector<uint8_t> request{ headers.begin(), headers.end() };
+        request.resize(request.size() + content_length, 'x');
+
+        PacketReceiveBuffer<http::HTTPProtocol, 5> rx{
+            std::make_unique<http::HTTPProtocol>(1024, chunk_size, *this) };
+        http::HTTPPacket kept{};
+        http::HTTPPacket* target = keep_packet ? &kept : nullptr;
+
+        // Warm up, so that any storage that is reused has been allocated.
+        feed(rx, request, target);
+
+        auto start = Counters::now();
+        int chunks = 0;
+
+        for (int i = 0; i < request_count; ++i)
+        {
+            chunks += feed(rx, request, target);
+        }
+
+        report("HTTP", keep_packet, "4KB chunk", chunks, start);
+    }
+
+    void App::mqtt_messages(bool keep_packet)
+    {
+        // QoS 0 PUBLISH to topic "bench" with a 32 byte payload
+        std::vector<uint8_t> message{ 0x30, 2 + 5 + 32, 0x00, 0x05, 'b', 'e', 'n', 'c', 'h' };
+        message.resize(message.size() + 32, 'x');
+
+        std::vector<uint8_t> stream{};
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            stream.insert(stream.end(), message.begin(), message.end());
+        }
+
+        PacketReceiveBuffer<mqtt::packet::MQTTProtocol, 5> rx{ std::make_unique<mqtt::packet::MQTTProtocol>() };
+        mqtt::packet::MQTTPacket kept{};
+        mqtt::packet::MQTTPacket* target = keep_packet ? &kept : nullptr;
+
+        feed(rx, stream, target);
+
+        auto start = Counters::now();
+        int messages = 0;
+
+        for (int i = 0; i < mqtt_count / 1000; ++i)
+        {
+            messages += feed(rx, stream, target);
+        }
+
+        report("MQTT", keep_packet, "message", messages, start);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include "smooth/core/Application.h"
+#include "smooth/application/network/http/IServerResponse.h"
+
+namespace packet_handoff_bench
+{
+    /// Measures allocations made while packets are assembled and handed to the application.
+    class App
+        : public smooth::core::Application,
+        public smooth::application::network::http::IServerResponse
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void reply(std::unique_ptr<smooth::application::network::http::IResponseOperation>, bool) override
+            {
+            }
+
+            void reply_error(std::unique_ptr<smooth::application::network::http::IResponseOperation>) override
+            {
+            }
+
+        protected:
+            smooth::core::Task& get_task() override
+            {
+                return *this;
+            }
+
+            void upgrade_to_websocket_internal() override
+            {
+            }
+
+        private:
+            void http_chunks(bool keep_packet);
+
+            void mqtt_messages(bool keep_packet);
+    };
+}
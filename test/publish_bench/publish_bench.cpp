@@ -0,0 +1,138 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "publish_bench.h"
+#include <algorithm>
+#include <array>
+#include "smooth/core/ipc/Publisher.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::ipc;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace publish_bench
+{
+    static constexpr const char* tag = "Bench";
+    static constexpr size_t frame_size = 4096;
+    static constexpr size_t frames_per_tick = 64;
+    static constexpr size_t ticks_per_round = 20;
+
+    struct Round
+    {
+        size_t subscribers;
+        bool shared;
+    };
+
+    static constexpr std::array<Round, 6> rounds{ { { 1, false }, { 4, false }, { 16, false },
+                                                    { 1, true }, { 4, true }, { 16, true } } };
+
+    std::atomic<uint32_t> Frame::copies{ 0 };
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, milliseconds(50))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+        latencies.reserve(frames_per_tick * ticks_per_round);
+        start_round();
+    }
+
+    void App::tick()
+    {
+        if (round < rounds.size())
+        {
+            const Frame source{ frame_size };
+
+            for (size_t i = 0; i < frames_per_tick; ++i)
+            {
+                auto start = steady_clock::now();
+
+                if (rounds[round].shared)
+                {
+                    Publisher<Frame>::publish(std::make_shared<const Frame>(frame_size));
+                }
+                else
+                {
+                    Publisher<Frame>::publish(source);
+                }
+
+                latencies.push_back(duration_cast<nanoseconds>(steady_clock::now() - start));
+            }
+
+            if (++ticks_in_round == ticks_per_round)
+            {
+                report_round();
+
+                if (++round < rounds.size())
+                {
+                    start_round();
+                }
+                else
+                {
+                    subscribers.clear();
+                    Log::info(tag, "Done");
+                }
+            }
+        }
+    }
+
+    void App::event(const Frame& /*event*/)
+    {
+    }
+
+    void App::start_round()
+    {
+        subscribers.clear();
+
+        for (size_t i = 0; i < rounds[round].subscribers; ++i)
+        {
+            subscribers.emplace_back(FrameQueue::create(static_cast<int>(frames_per_tick * 2), *this, *this));
+        }
+
+        latencies.clear();
+        ticks_in_round = 0;
+        copies_at_start = Frame::copies;
+    }
+
+    void App::report_round()
+    {
+        std::sort(latencies.begin(), latencies.end());
+
+        nanoseconds total{ 0 };
+
+        for (auto& l : latencies)
+        {
+            total += l;
+        }
+
+        auto published = latencies.size();
+        auto copies = Frame::copies - copies_at_start;
+
+        Log::info(tag, "{:>2} subscriber(s), {:>9}: {:.2f} copies/publish, mean {} ns, p99 {} ns",
+                  rounds[round].subscribers,
+                  rounds[round].shared ? "shared" : "reference",
+                  static_cast<double>(copies) / static_cast<double>(published),
+                  total.count() / static_cast<int64_t>(published),
+                  latencies[published * 99 / 100].count());
+    }
+}
@@ -0,0 +1,91 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/ipc/SubscribingTaskEventQueue.h"
+
+namespace publish_bench
+{
+    /// A large event, such as a sensor frame, that counts how many times it is copied.
+    class Frame
+    {
+        public:
+            Frame() = default;
+
+            explicit Frame(size_t size)
+                    : data(size)
+            {
+            }
+
+            Frame(const Frame& other)
+                    : data(other.data)
+            {
+                ++copies;
+            }
+
+            Frame(Frame&&) = default;
+
+            Frame& operator=(const Frame& other)
+            {
+                data = other.data;
+                ++copies;
+
+                return *this;
+            }
+
+            Frame& operator=(Frame&&) = default;
+
+            std::vector<uint8_t> data{};
+            static std::atomic<uint32_t> copies;
+    };
+
+    /// Publishes 4 kB frames to 1, 4 and 16 subscribers, first by reference via Publisher<T>::publish(const T&)
+    /// and then as a shared instance via Publisher<T>::publish(std::shared_ptr<const T>), and reports the number
+    /// of copies made per published frame as well as the mean and p99 latency of the publish call.
+    class App
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<Frame>
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void tick() override;
+
+            void event(const Frame& event) override;
+
+        private:
+            void start_round();
+
+            void report_round();
+
+            using FrameQueue = smooth::core::ipc::SubscribingTaskEventQueue<Frame>;
+            std::vector<std::shared_ptr<FrameQueue>> subscribers{};
+            std::vector<std::chrono::nanoseconds> latencies{};
+            size_t round = 0;
+            size_t ticks_in_round = 0;
+            uint32_t copies_at_start = 0;
+    };
+}
@@ -16,10 +16,15 @@ limitations under the License.
 */
 
 #include "secure_server_socket_test.h"
+#include <algorithm>
 #include <deque>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include "smooth/core/Task.h"
 #include "smooth/core/task_priorities.h"
 #include "smooth/core/Application.h"
+#include "smooth/core/SystemStatistics.h"
 #include "smooth/core/logging/log.h"
 #include "smooth/core/network/IPv4.h"
 #include "smooth/core/network/ServerSocket.h"
@@ -135,9 +140,87 @@ void fill(const char* src, std::vector<unsigned char>& target)
 
 namespace secure_server_socket_test
 {
+    static constexpr size_t connections_per_round = 50;
+    static constexpr size_t concurrent_handshakes = 20;
+    static constexpr uint16_t plain_port = 8080;
+    static constexpr milliseconds probe_interval{ 2 };
+
+    LatencyProbe::~LatencyProbe()
+    {
+        stop();
+    }
+
+    void LatencyProbe::start(uint16_t port)
+    {
+        running = true;
+        worker = std::thread([this, port]() { run(port); });
+    }
+
+    void LatencyProbe::stop()
+    {
+        running = false;
+
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    std::pair<double, double> LatencyProbe::take_latency()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        auto avg = latency_count > 0 ? duration<double, std::micro>(latency_sum).count() / latency_count : 0.0;
+        auto max = duration<double, std::micro>(latency_max).count();
+        latency_sum = nanoseconds{ 0 };
+        latency_max = nanoseconds{ 0 };
+        latency_count = 0;
+
+        return { avg, max };
+    }
+
+    void LatencyProbe::run(uint16_t port)
+    {
+        auto client = socket(AF_INET, SOCK_STREAM, 0);
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        bool ok = ::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+
+        if (!ok)
+        {
+            Log::error("Probe", "Could not connect to port {}", port);
+        }
+
+        while (running && ok)
+        {
+            char c = 'p';
+            auto start = steady_clock::now();
+            ok = send(client, &c, 1, MSG_NOSIGNAL) == 1 && recv(client, &c, 1, 0) == 1;
+
+            auto latency = steady_clock::now() - start;
+
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                latency_sum += latency;
+                latency_max = std::max(latency_max, duration_cast<nanoseconds>(latency));
+                ++latency_count;
+            }
+
+            std::this_thread::sleep_for(probe_interval);
+        }
+
+        close(client);
+    }
+
     App::App()
-            : Application(smooth::core::APPLICATION_BASE_PRIO, std::chrono::milliseconds(1000))
+            : Application(smooth::core::APPLICATION_BASE_PRIO, std::chrono::milliseconds(1000)),
+              client_buffers(std::make_shared<BufferContainer<StreamingProtocol>>(*this, *this, *this, *this,
+                                                                                  std::make_unique<StreamingProtocol>()))
     {
+        first_byte_times.reserve(connections_per_round);
     }
 
     void App::init()
@@ -157,7 +240,7 @@ namespace secure_server_socket_test
         // Point your browser to https://localhost:8443 and watch the debug output, or using curl:
         // curl --verbose --cacert self_signed/root_ca.crt https://localhost:8443
         //
-        // Note, the browser/curl will not receive a response.
+        // Each received byte is echoed back.
 
         std::vector<unsigned char> ca_chain{};
         std::vector<unsigned char> own_certs{};
@@ -176,5 +259,162 @@ namespace secure_server_socket_test
                                                                                 private_key,
                                                                                 password);
         server->start(std::make_shared<IPv4>("0.0.0.0", 8443));
+
+        client_context.init_client(ca_chain);
+        client_context.set_session_reuse(resumption);
+
+        // Plaintext echo server used to measure latency while handshakes are in progress.
+        plain_server = ServerSocket<StreamingClient, StreamingProtocol, void>::create(*this, 1, 1);
+        plain_server->start(std::make_shared<IPv4>("0.0.0.0", plain_port));
+    }
+
+    void App::tick()
+    {
+        if (!client_socket && !done)
+        {
+            round_start = steady_clock::now();
+            connect();
+        }
+        else if (done && probing && concurrent_clients.empty())
+        {
+            // The probe has run for a tick on an otherwise idle system.
+            idle_latency = probe.take_latency();
+            start_concurrent_handshakes();
+        }
+    }
+
+    void App::start_concurrent_handshakes()
+    {
+        client_context.set_session_reuse(false);
+        round_start = steady_clock::now();
+
+        for (size_t i = 0; i < concurrent_handshakes; ++i)
+        {
+            ConcurrentClient c;
+            c.buffers = std::make_shared<BufferContainer<StreamingProtocol>>(*this, *this, *this, *this,
+                                                                             std::make_unique<StreamingProtocol>());
+            c.socket = SecureSocket<StreamingProtocol>::create(c.buffers, client_context.create_context());
+            c.socket->start(std::make_shared<IPv4>("127.0.0.1", 8443));
+            concurrent_clients.emplace_back(std::move(c));
+        }
+    }
+
+    void App::concurrent_echo_received()
+    {
+        ++concurrent_echoes;
+
+        if (concurrent_echoes == concurrent_handshakes)
+        {
+            auto elapsed = duration_cast<milliseconds>(steady_clock::now() - round_start);
+            auto busy_latency = probe.take_latency();
+            probe.stop();
+            probing = false;
+
+            Log::info("Handshake", "{} concurrent handshakes completed in {} ms", concurrent_handshakes,
+                      elapsed.count());
+            Log::info("Handshake", "Plaintext latency idle: avg {:.0f} us, max {:.0f} us",
+                      idle_latency.first, idle_latency.second);
+            Log::info("Handshake", "Plaintext latency during handshakes: avg {:.0f} us, max {:.0f} us",
+                      busy_latency.first, busy_latency.second);
+
+            // Both ends of every connection are open, so this shows the memory they hold.
+            SystemStatistics::instance().dump();
+
+            for (auto& c : concurrent_clients)
+            {
+                c.socket->stop("Concurrent round done");
+            }
+        }
+    }
+
+    void App::connect()
+    {
+        client_buffers->clear();
+        connect_start = steady_clock::now();
+        client_socket = SecureSocket<StreamingProtocol>::create(client_buffers, client_context.create_context());
+        client_socket->start(std::make_shared<IPv4>("127.0.0.1", 8443));
+    }
+
+    void App::event(const TransmitBufferEmptyEvent&)
+    {
+    }
+
+    void App::event(const DataAvailableEvent<StreamingProtocol>& event)
+    {
+        StreamingProtocol::packet_type packet;
+
+        if (event.get(packet))
+        {
+            if (client_socket)
+            {
+                first_byte_times.push_back(duration_cast<microseconds>(steady_clock::now() - connect_start));
+                client_socket->stop("Echo received");
+            }
+            else
+            {
+                concurrent_echo_received();
+            }
+        }
+    }
+
+    void App::event(const ConnectionStatusEvent& event)
+    {
+        if (event.is_connected())
+        {
+            auto same_socket = [&event](const ConcurrentClient& c) {
+                                   return c.socket == event.get_socket();
+                               };
+
+            auto concurrent = std::find_if(concurrent_clients.begin(), concurrent_clients.end(), same_socket);
+
+            // The byte is sent once the handshake has completed.
+            if (concurrent != concurrent_clients.end())
+            {
+                concurrent->buffers->get_tx_buffer().put(StreamPacket{ 'h' });
+            }
+            else
+            {
+                client_buffers->get_tx_buffer().put(StreamPacket{ 'h' });
+            }
+        }
+        else if (client_socket)
+        {
+            client_socket.reset();
+
+            if (first_byte_times.size() == connections_per_round)
+            {
+                report();
+                first_byte_times.clear();
+
+                done = resumption;
+                resumption = true;
+                client_context.set_session_reuse(resumption);
+                round_start = steady_clock::now();
+            }
+
+            if (!done)
+            {
+                connect();
+            }
+            else
+            {
+                probing = true;
+                probe.start(plain_port);
+            }
+        }
+    }
+
+    void App::report()
+    {
+        auto elapsed = duration_cast<duration<double>>(steady_clock::now() - round_start);
+        std::sort(first_byte_times.begin(), first_byte_times.end());
+
+        auto p50 = first_byte_times[first_byte_times.size() / 2];
+        auto p99 = first_byte_times[first_byte_times.size() * 99 / 100];
+
+        Log::info("Handshake", "Resumption {}: {:.1f} handshakes/s, time to first byte p50: {} us, p99: {} us",
+                  resumption ? "on" : "off",
+                  static_cast<double>(first_byte_times.size()) / elapsed.count(),
+                  p50.count(), p99.count());
     }
 }
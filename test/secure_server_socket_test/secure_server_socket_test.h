@@ -17,28 +17,109 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "smooth/core/Application.h"
 #include "smooth/core/network/SecureSocket.h"
 #include "smooth/core/ipc/IEventListener.h"
 #include "smooth/core/ipc/TaskEventQueue.h"
 #include "smooth/core/network/Socket.h"
 #include "smooth/core/network/ServerSocket.h"
+#include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/event/ConnectionStatusEvent.h"
 #include "StreamingProtocol.h"
 #include "StreamingClient.h"
 
 namespace secure_server_socket_test
 {
+    /// Sends one byte at a time to a plaintext echo server over a blocking socket and measures
+    /// the time until it comes back.
+    class LatencyProbe
+    {
+        public:
+            LatencyProbe() = default;
+
+            ~LatencyProbe();
+
+            LatencyProbe(const LatencyProbe&) = delete;
+
+            LatencyProbe& operator=(const LatencyProbe&) = delete;
+
+            void start(uint16_t port);
+
+            void stop();
+
+            /// Returns the average and maximum round trip time since the last call, in microseconds.
+            std::pair<double, double> take_latency();
+
+        private:
+            void run(uint16_t port);
+
+            std::thread worker{};
+            std::atomic_bool running{ false };
+            std::mutex guard{};
+            std::chrono::nanoseconds latency_sum{};
+            std::chrono::nanoseconds latency_max{};
+            int latency_count = 0;
+    };
+
+    /// Besides serving StreamingClients, the application repeatedly connects to its own server over
+    /// loopback and measures handshakes per second and time to first echoed byte, first with
+    /// full handshakes and then with session resumption. Finally it measures the latency of a
+    /// plaintext connection while many handshakes are in progress at once.
     class App
-        : public smooth::core::Application
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::TransmitBufferEmptyEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::DataAvailableEvent<StreamingProtocol>>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::ConnectionStatusEvent>
     {
         public:
             App();
 
             void init() override;
 
+            void tick() override;
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent&) override;
+
+            void event(const smooth::core::network::event::DataAvailableEvent<StreamingProtocol>&) override;
+
+            void event(const smooth::core::network::event::ConnectionStatusEvent&) override;
+
         private:
+            struct ConcurrentClient
+            {
+                std::shared_ptr<smooth::core::network::BufferContainer<StreamingProtocol>> buffers;
+                std::shared_ptr<smooth::core::network::SecureSocket<StreamingProtocol>> socket;
+            };
+
+            void connect();
+
+            void report();
+
+            void start_concurrent_handshakes();
+
+            void concurrent_echo_received();
+
             std::shared_ptr<smooth::core::network::ServerSocket<StreamingClient,
                                                                 StreamingProtocol, void>> server{};
+            smooth::core::network::MBedTLSContext client_context{};
+            std::shared_ptr<smooth::core::network::BufferContainer<StreamingProtocol>> client_buffers;
+            std::shared_ptr<smooth::core::network::SecureSocket<StreamingProtocol>> client_socket{};
+            std::chrono::steady_clock::time_point connect_start{};
+            std::chrono::steady_clock::time_point round_start{};
+            std::vector<std::chrono::microseconds> first_byte_times{};
+            bool resumption{ false };
+            bool done{ false };
+            std::shared_ptr<smooth::core::network::ServerSocket<StreamingClient,
+                                                                StreamingProtocol, void>> plain_server{};
+            LatencyProbe probe{};
+            std::vector<ConcurrentClient> concurrent_clients{};
+            size_t concurrent_echoes{ 0 };
+            std::pair<double, double> idle_latency{};
+            bool probing{ false };
     };
 }
@@ -41,13 +41,14 @@ namespace server_socket_test
 
             void event(const smooth::core::network::event::DataAvailableEvent<StreamingProtocol>& event) override
             {
-                // Print data as it is received.
+                // Print data as it is received and echo it back.
                 StreamingProtocol::packet_type packet;
 
                 if (event.get(packet))
                 {
                     std::string s{ static_cast<char>(packet.data()[0]) };
                     smooth::core::logging::Log::debug("-->", s);
+                    container->get_tx_buffer().put(packet);
                 }
             }
 
@@ -16,6 +16,7 @@ limitations under the License.
 */
 
 #include "server_socket_test.h"
+#include <algorithm>
 #include <deque>
 #include "smooth/core/Task.h"
 #include "smooth/core/task_priorities.h"
@@ -34,9 +35,14 @@ using namespace smooth::core::logging;
 
 namespace server_socket_test
 {
+    static constexpr size_t pings_per_round = 1000;
+
     App::App()
-            : Application(smooth::core::APPLICATION_BASE_PRIO, std::chrono::milliseconds(1000))
+            : Application(smooth::core::APPLICATION_BASE_PRIO, std::chrono::milliseconds(1000)),
+              ping_buffers(std::make_shared<BufferContainer<StreamingProtocol>>(*this, *this, *this, *this,
+                                                                                std::make_unique<StreamingProtocol>()))
     {
+        round_trips.reserve(pings_per_round);
     }
 
     void App::init()
@@ -58,4 +64,65 @@ namespace server_socket_test
         // Point your browser to http://localhost:8080 and watch the output.
         // Or, if you're on linux, do "echo ` date` | nc localhost 8080 -w1"
     }
+
+    void App::tick()
+    {
+        if (!ping_socket && server)
+        {
+            ping_socket = Socket<StreamingProtocol>::create(ping_buffers);
+            ping_socket->start(std::make_shared<IPv4>("127.0.0.1", 8080));
+        }
+    }
+
+    void App::event(const TransmitBufferEmptyEvent&)
+    {
+    }
+
+    void App::event(const DataAvailableEvent<StreamingProtocol>& event)
+    {
+        StreamingProtocol::packet_type packet;
+
+        if (event.get(packet))
+        {
+            round_trips.push_back(duration_cast<microseconds>(steady_clock::now() - ping_sent));
+
+            if (round_trips.size() == pings_per_round)
+            {
+                report();
+                round_trips.clear();
+            }
+
+            send_ping();
+        }
+    }
+
+    void App::event(const ConnectionStatusEvent& event)
+    {
+        if (event.is_connected())
+        {
+            round_trips.clear();
+            send_ping();
+        }
+        else
+        {
+            ping_socket.reset();
+        }
+    }
+
+    void App::send_ping()
+    {
+        ping_sent = steady_clock::now();
+        ping_buffers->get_tx_buffer().put(StreamPacket{ 'p' });
+    }
+
+    void App::report()
+    {
+        std::sort(round_trips.begin(), round_trips.end());
+
+        auto p50 = round_trips[round_trips.size() / 2];
+        auto p99 = round_trips[round_trips.size() * 99 / 100];
+
+        Log::info("PingPong", "{} round trips, p50: {} us, p99: {} us, max: {} us",
+                  round_trips.size(), p50.count(), p99.count(), round_trips.back().count());
+    }
 }
@@ -18,27 +18,51 @@ limitations under the License.
 #pragma once
 
 #include <functional>
+#include <vector>
 #include "smooth/core/Application.h"
 #include "smooth/core/network/SecureSocket.h"
 #include "smooth/core/ipc/IEventListener.h"
 #include "smooth/core/ipc/TaskEventQueue.h"
 #include "smooth/core/network/Socket.h"
 #include "smooth/core/network/ServerSocket.h"
+#include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/event/ConnectionStatusEvent.h"
 #include "StreamingProtocol.h"
 #include "StreamingClient.h"
 
 namespace server_socket_test
 {
+    /// Besides serving StreamingClients, the application measures the round trip time of single
+    /// byte ping-pongs against its own server over loopback and reports p50/p99 every round.
     class App
-        : public smooth::core::Application
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::TransmitBufferEmptyEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::DataAvailableEvent<StreamingProtocol>>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::ConnectionStatusEvent>
     {
         public:
             App();
 
             void init() override;
 
+            void tick() override;
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent&) override;
+
+            void event(const smooth::core::network::event::DataAvailableEvent<StreamingProtocol>&) override;
+
+            void event(const smooth::core::network::event::ConnectionStatusEvent&) override;
+
         private:
+            void send_ping();
+
+            void report();
+
             std::shared_ptr<smooth::core::network::ServerSocket<StreamingClient,
                                                                 StreamingProtocol, void>> server{};
+            std::shared_ptr<smooth::core::network::BufferContainer<StreamingProtocol>> ping_buffers;
+            std::shared_ptr<smooth::core::network::Socket<StreamingProtocol>> ping_socket{};
+            std::chrono::steady_clock::time_point ping_sent{};
+            std::vector<std::chrono::microseconds> round_trips{};
     };
 }
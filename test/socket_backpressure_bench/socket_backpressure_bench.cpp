@@ -0,0 +1,293 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "socket_backpressure_bench.h"
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/Wifi.h"
+
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::core::network::event;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace socket_backpressure_bench
+{
+    static constexpr uint16_t probe_port = 18850;
+    static constexpr uint16_t flood_port = 18851;
+    static constexpr milliseconds probe_interval{ 2 };
+    static constexpr milliseconds consume_time{ 5 };
+    static const char* tag = "Bench";
+
+    static std::vector<uint8_t> mqtt_publish()
+    {
+        // QoS 0 PUBLISH to topic "bench" with a 32 byte payload
+        std::vector<uint8_t> m{ 0x30, 2 + 5 + 32, 0x00, 0x05, 'b', 'e', 'n', 'c', 'h' };
+        m.insert(m.end(), 32, 'x');
+
+        return m;
+    }
+
+    static microseconds cpu_time()
+    {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+
+        return seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+               + microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+    }
+
+    Feeder::~Feeder()
+    {
+        stop();
+    }
+
+    void Feeder::start(uint16_t port, bool flood)
+    {
+        flooding = flood;
+        running = true;
+        listening = false;
+        worker = std::thread([this, port]() { run(port); });
+
+        // Don't let the client connect before there is someone to connect to.
+        while (running && !listening)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void Feeder::stop()
+    {
+        running = false;
+        cond.notify_all();
+
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    void Feeder::delivered()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        ++delivered_count;
+        cond.notify_all();
+    }
+
+    std::pair<double, double> Feeder::take_latency()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        auto avg = latency_count > 0 ? duration<double, std::micro>(latency_sum).count() / latency_count : 0.0;
+        auto max = duration<double, std::micro>(latency_max).count();
+        latency_sum = nanoseconds{ 0 };
+        latency_max = nanoseconds{ 0 };
+        latency_count = 0;
+
+        return { avg, max };
+    }
+
+    void Feeder::run(uint16_t port)
+    {
+        auto listener = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0
+            && listen(listener, 1) == 0)
+        {
+            listening = true;
+            auto client = accept(listener, nullptr, nullptr);
+
+            if (client >= 0)
+            {
+                if (flooding)
+                {
+                    flood_messages(client);
+                }
+                else
+                {
+                    probe(client);
+                }
+
+                close(client);
+            }
+        }
+        else
+        {
+            Log::error(tag, "Could not listen on port {}", port);
+            running = false;
+        }
+
+        close(listener);
+    }
+
+    void Feeder::flood_messages(int client)
+    {
+        std::vector<uint8_t> data{};
+
+        for (int i = 0; i < 64; ++i)
+        {
+            auto m = mqtt_publish();
+            data.insert(data.end(), m.begin(), m.end());
+        }
+
+        // Blocks once the receiving side stops reading; fails once it closes the connection.
+        while (running && send(client, data.data(), data.size(), MSG_NOSIGNAL) > 0)
+        {
+        }
+    }
+
+    void Feeder::probe(int client)
+    {
+        auto message = mqtt_publish();
+        int sent = 0;
+        bool ok = true;
+
+        while (running && ok)
+        {
+            auto start = steady_clock::now();
+            ok = send(client, message.data(), message.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(message.size());
+            ++sent;
+
+            std::unique_lock<std::mutex> lock(guard);
+            cond.wait(lock, [this, sent]() { return !running || delivered_count >= sent; });
+
+            auto latency = steady_clock::now() - start;
+            latency_sum += latency;
+            latency_max = std::max(latency_max, duration_cast<nanoseconds>(latency));
+            ++latency_count;
+            lock.unlock();
+
+            std::this_thread::sleep_for(probe_interval);
+        }
+    }
+
+    SlowConsumer::SlowConsumer()
+            : Task("SlowConsumer", 8192, APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void SlowConsumer::event(const DataAvailableEvent<MQTTProto>& event)
+    {
+        MQTTProto::packet_type p;
+
+        if (event.get(p))
+        {
+            ++consumed;
+            std::this_thread::sleep_for(consume_time);
+        }
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1)),
+              probe_buffers(std::make_shared<BufferContainer<MQTTProto>>(*this, *this, *this, *this,
+                                                                         std::make_unique<MQTTProto>())),
+              flood_buffers(std::make_shared<BufferContainer<MQTTProto>>(slow_consumer,
+                                                                         slow_consumer,
+                                                                         slow_consumer,
+                                                                         slow_consumer,
+                                                                         std::make_unique<MQTTProto>()))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+        slow_consumer.start();
+
+        // On Linux this only announces that the network is up.
+        get_wifi().connect_to_ap();
+        std::this_thread::sleep_for(milliseconds(100));
+
+        probe_feeder.start(probe_port, false);
+        probe_socket = Socket<MQTTProto>::create(probe_buffers);
+        probe_socket->start(std::make_shared<IPv4>("127.0.0.1", probe_port));
+    }
+
+    void App::tick()
+    {
+        ++ticks;
+
+        if (ticks == 1 || ticks == 5)
+        {
+            // Let things settle before measuring.
+            begin_measurement();
+        }
+        else if (ticks == 3)
+        {
+            report("Alone");
+
+            flood_feeder.start(flood_port, true);
+            flood_socket = Socket<MQTTProto>::create(flood_buffers);
+            flood_socket->start(std::make_shared<IPv4>("127.0.0.1", flood_port));
+        }
+        else if (ticks == 7)
+        {
+            report("Slow consumer");
+
+            flood_socket->stop("Done");
+            probe_socket->stop("Done");
+            flood_feeder.stop();
+            probe_feeder.stop();
+            Log::info(tag, "Done");
+        }
+    }
+
+    void App::begin_measurement()
+    {
+        probe_feeder.take_latency();
+        slow_consumer.take_consumed();
+        cpu_at_start = cpu_time();
+        measure_start = steady_clock::now();
+    }
+
+    void App::report(const char* phase)
+    {
+        auto wall = duration_cast<microseconds>(steady_clock::now() - measure_start);
+        auto cpu = cpu_time() - cpu_at_start;
+        auto latency = probe_feeder.take_latency();
+        auto consumed = slow_consumer.take_consumed();
+
+        Log::info(tag, "{:>13}: CPU {:5.1f}%, probe latency avg {:7.1f} us, max {:8.1f} us, slow consumer {:5.0f} msg/s",
+                  phase,
+                  100.0 * static_cast<double>(cpu.count()) / static_cast<double>(wall.count()),
+                  latency.first,
+                  latency.second,
+                  static_cast<double>(consumed) * 1e6 / static_cast<double>(wall.count()));
+    }
+
+    void App::event(const DataAvailableEvent<MQTTProto>& event)
+    {
+        MQTTProto::packet_type p;
+
+        if (event.get(p))
+        {
+            probe_feeder.delivered();
+        }
+    }
+}
@@ -0,0 +1,153 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/Task.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/Socket.h"
+#include "smooth/core/network/event/ConnectionStatusEvent.h"
+#include "smooth/core/network/event/DataAvailableEvent.h"
+#include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
+#include "smooth/application/network/mqtt/packet/MQTTProtocol.h"
+
+namespace socket_backpressure_bench
+{
+    using MQTTProto = smooth::application::network::mqtt::packet::MQTTProtocol;
+
+    /// Accepts a single connection and sends MQTT messages to it, either as fast as the connection
+    /// allows (flooding) or one at a time, measuring the time until each has been delivered (probing).
+    class Feeder
+    {
+        public:
+            Feeder() = default;
+
+            ~Feeder();
+
+            Feeder(const Feeder&) = delete;
+
+            Feeder& operator=(const Feeder&) = delete;
+
+            void start(uint16_t port, bool flood);
+
+            void stop();
+
+            void delivered();
+
+            /// Returns the average and maximum latency since the last call, in microseconds.
+            std::pair<double, double> take_latency();
+
+        private:
+            void run(uint16_t port);
+
+            void flood_messages(int client);
+
+            void probe(int client);
+
+            std::thread worker{};
+            bool flooding = false;
+            std::atomic_bool running{ false };
+            std::atomic_bool listening{ false };
+            std::mutex guard{};
+            std::condition_variable cond{};
+            int delivered_count = 0;
+            std::chrono::nanoseconds latency_sum{};
+            std::chrono::nanoseconds latency_max{};
+            int latency_count = 0;
+    };
+
+    /// Consumes packets slowly on its own task, to keep its receive buffer full.
+    class SlowConsumer
+        : public smooth::core::Task,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::TransmitBufferEmptyEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::ConnectionStatusEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::DataAvailableEvent<MQTTProto>>
+    {
+        public:
+            SlowConsumer();
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent&) override
+            {
+            }
+
+            void event(const smooth::core::network::event::ConnectionStatusEvent&) override
+            {
+            }
+
+            void event(const smooth::core::network::event::DataAvailableEvent<MQTTProto>& event) override;
+
+            int take_consumed()
+            {
+                return consumed.exchange(0);
+            }
+
+        private:
+            std::atomic_int consumed{ 0 };
+    };
+
+    /// Measures the latency of one connection and the CPU usage of the process,
+    /// first on its own and then while another connection has a slow consumer.
+    class App
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::TransmitBufferEmptyEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::ConnectionStatusEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::DataAvailableEvent<MQTTProto>>
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void tick() override;
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent&) override
+            {
+            }
+
+            void event(const smooth::core::network::event::ConnectionStatusEvent&) override
+            {
+            }
+
+            void event(const smooth::core::network::event::DataAvailableEvent<MQTTProto>& event) override;
+
+        private:
+            void begin_measurement();
+
+            void report(const char* phase);
+
+            SlowConsumer slow_consumer{};
+            Feeder probe_feeder{};
+            Feeder flood_feeder{};
+            std::shared_ptr<smooth::core::network::BufferContainer<MQTTProto>> probe_buffers;
+            std::shared_ptr<smooth::core::network::BufferContainer<MQTTProto>> flood_buffers;
+            std::shared_ptr<smooth::core::network::ISocket> probe_socket{};
+            std::shared_ptr<smooth::core::network::ISocket> flood_socket{};
+            std::chrono::steady_clock::time_point measure_start{};
+            std::chrono::microseconds cpu_at_start{};
+            int ticks = 0;
+    };
+}
@@ -0,0 +1,139 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "socket_dispatcher_bench.h"
+#include <algorithm>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/network/EpollBackend.h"
+#include "smooth/core/network/SelectBackend.h"
+
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace socket_dispatcher_bench
+{
+    static constexpr const char* tag = "Bench";
+    static constexpr int iterations = 2000;
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        const std::vector<size_t> idle_counts{ 10, 100, 1000, 10000 };
+        raise_file_limit(idle_counts.back() * 2 + 100);
+
+        for (auto idle : idle_counts)
+        {
+            EpollBackend epoll;
+            run("epoll", epoll, idle);
+
+            // select() can't handle descriptors >= FD_SETSIZE
+            if (idle * 2 + 10 < FD_SETSIZE)
+            {
+                SelectBackend select;
+                run("select", select, idle);
+            }
+        }
+    }
+
+    void App::run(const char* name, IReadinessBackend& backend, size_t idle_count)
+    {
+        std::vector<int> fds;
+        bool ok = true;
+
+        for (size_t i = 0; ok && i < idle_count; ++i)
+        {
+            int pair[2];
+            ok = socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0;
+
+            if (ok)
+            {
+                fds.push_back(pair[0]);
+                fds.push_back(pair[1]);
+                backend.add(pair[0], IReadinessBackend::INTEREST_READ);
+            }
+        }
+
+        int hot[2];
+        ok = ok && socketpair(AF_UNIX, SOCK_STREAM, 0, hot) == 0;
+
+        if (ok)
+        {
+            backend.add(hot[0], IReadinessBackend::INTEREST_READ);
+
+            std::vector<SocketReadiness> ready;
+            uint8_t b = 0;
+            nanoseconds total{ 0 };
+
+            for (int i = 0; i < iterations; ++i)
+            {
+                ok = write(hot[1], &b, 1) == 1;
+
+                auto start = steady_clock::now();
+                backend.wait(milliseconds(100), ready);
+                total += steady_clock::now() - start;
+
+                for (const auto& r : ready)
+                {
+                    if (r.readable)
+                    {
+                        ok = read(r.socket_id, &b, 1) == 1 && ok;
+                    }
+                }
+            }
+
+            Log::info(tag, "{:>6}: {:>5} idle sockets: {:>8.2f} us per dispatch", name, idle_count,
+                      static_cast<double>(total.count()) / iterations / 1000.0);
+
+            backend.remove(hot[0]);
+            close(hot[0]);
+            close(hot[1]);
+        }
+        else
+        {
+            Log::error(tag, "Could not create {} sockets", idle_count);
+        }
+
+        for (auto fd : fds)
+        {
+            close(fd);
+        }
+    }
+
+    void App::raise_file_limit(size_t wanted)
+    {
+        rlimit limit{};
+
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < wanted)
+        {
+            limit.rlim_cur = std::min(static_cast<rlim_t>(wanted), limit.rlim_max);
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+}
@@ -0,0 +1,41 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include "smooth/core/Application.h"
+#include "smooth/core/network/IReadinessBackend.h"
+
+namespace socket_dispatcher_bench
+{
+    /// Measures the cost of waiting for and dispatching a single ready socket while
+    /// an increasing number of idle sockets are registered with the readiness backend.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            void init() override;
+
+        private:
+            void run(const char* name, smooth::core::network::IReadinessBackend& backend, size_t idle_count);
+
+            static void raise_file_limit(size_t wanted);
+    };
+}
@@ -0,0 +1,214 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "socket_gather_bench.h"
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/Wifi.h"
+
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::core::network::event;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace socket_gather_bench
+{
+    static constexpr uint16_t port = 18831;
+    static constexpr auto round_length = seconds(3);
+    static const char* tag = "Bench";
+
+    struct Round
+    {
+        int size;
+        bool corked;
+    };
+
+    static constexpr std::array<Round, 4> rounds{ { { 64, false }, { 64, true }, { 1024, false }, { 1024, true } } };
+
+    Sink::Sink(uint16_t port)
+            : port(port)
+    {
+    }
+
+    Sink::~Sink()
+    {
+        running = false;
+
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    void Sink::start()
+    {
+        running = true;
+        worker = std::thread([this]() { run(); });
+    }
+
+    void Sink::run()
+    {
+        auto listener = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0
+            && listen(listener, 1) == 0)
+        {
+            auto client = accept(listener, nullptr, nullptr);
+            std::vector<uint8_t> buff(65536);
+            bool connected = client >= 0;
+
+            while (running && connected)
+            {
+                pollfd fd{ client, POLLIN, 0 };
+
+                if (poll(&fd, 1, 10) > 0)
+                {
+                    auto read = recv(client, buff.data(), buff.size(), 0);
+                    connected = read > 0;
+                    received += connected ? static_cast<uint64_t>(read) : 0;
+                }
+            }
+
+            close(client);
+        }
+        else
+        {
+            Log::error(tag, "Could not listen on port {}", port);
+        }
+
+        close(listener);
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, milliseconds(100)),
+              sink(port),
+              buffers(std::make_shared<BufferContainer<BenchProtocol>>(*this, *this, *this, *this,
+                                                                       std::make_unique<BenchProtocol>()))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+        sink.start();
+
+        // On Linux this only announces that the network is up.
+        get_wifi().connect_to_ap();
+        std::this_thread::sleep_for(milliseconds(100));
+
+        sock = Socket<BenchProtocol>::create(buffers);
+        sock->start(std::make_shared<IPv4>("127.0.0.1", port));
+    }
+
+    void App::tick()
+    {
+        if (connected && round < rounds.size() && steady_clock::now() - round_start >= round_length)
+        {
+            auto elapsed = duration_cast<duration<double>>(steady_clock::now() - round_start).count();
+            auto bytes = static_cast<double>(sink.get_received() - received_at_start);
+
+            Log::info(tag, "{:4} byte messages, {:>9}: {:>9.0f} msg/s, {:6.1f} MB/s, {:>8.0f} sends/s",
+                      rounds[round].size,
+                      rounds[round].corked ? "corked" : "uncorked",
+                      static_cast<double>(messages) / elapsed,
+                      bytes / elapsed / (1024 * 1024),
+                      static_cast<double>(sends) / elapsed);
+
+            ++round;
+
+            if (round < rounds.size())
+            {
+                start_round();
+            }
+            else
+            {
+                Log::info(tag, "Done");
+            }
+        }
+    }
+
+    void App::event(const TransmitBufferEmptyEvent&)
+    {
+        // One event per send that completed all data handed to it.
+        ++sends;
+        fill();
+    }
+
+    void App::event(const DataAvailableEvent<BenchProtocol>&)
+    {
+    }
+
+    void App::event(const ConnectionStatusEvent& event)
+    {
+        connected = event.is_connected();
+
+        if (connected)
+        {
+            start_round();
+        }
+        else
+        {
+            Log::error(tag, "Disconnected");
+        }
+    }
+
+    void App::start_round()
+    {
+        messages = 0;
+        sends = 0;
+        received_at_start = sink.get_received();
+        round_start = steady_clock::now();
+        fill();
+    }
+
+    void App::fill()
+    {
+        if (round < rounds.size())
+        {
+            const BenchPacket packet{ rounds[round].size };
+
+            if (rounds[round].corked)
+            {
+                sock->cork();
+            }
+
+            while (sock->send(packet))
+            {
+                ++messages;
+            }
+
+            if (rounds[round].corked)
+            {
+                sock->flush();
+            }
+        }
+    }
+}
@@ -0,0 +1,182 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "smooth/core/Application.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/IPacketAssembly.h"
+#include "smooth/core/network/IPacketDisassembly.h"
+#include "smooth/core/network/Socket.h"
+#include "smooth/core/network/event/ConnectionStatusEvent.h"
+#include "smooth/core/network/event/DataAvailableEvent.h"
+#include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
+
+namespace socket_gather_bench
+{
+    class BenchPacket
+        : public smooth::core::network::IPacketDisassembly
+    {
+        public:
+            static constexpr int max_size = 1024;
+
+            BenchPacket() = default;
+
+            explicit BenchPacket(int size)
+                    : size(size)
+            {
+                buff.fill('x');
+            }
+
+            int get_send_length() override
+            {
+                return size;
+            }
+
+            const uint8_t* get_data() override
+            {
+                return buff.data();
+            }
+
+            std::array<uint8_t, max_size>& data()
+            {
+                return buff;
+            }
+
+        private:
+            std::array<uint8_t, max_size> buff{};
+            int size = 0;
+    };
+
+    /// Nothing is ever received, the protocol only exists to satisfy the socket.
+    class BenchProtocol
+        : public smooth::core::network::IPacketAssembly<BenchProtocol, BenchPacket>
+    {
+        public:
+            using packet_type = BenchPacket;
+
+            int get_wanted_amount(BenchPacket& /*packet*/) override
+            {
+                return 1;
+            }
+
+            void data_received(BenchPacket& /*packet*/, int /*length*/) override
+            {
+                complete = true;
+            }
+
+            uint8_t* get_write_pos(BenchPacket& packet) override
+            {
+                return packet.data().data();
+            }
+
+            bool is_complete(BenchPacket& /*packet*/) const override
+            {
+                return complete;
+            }
+
+            bool is_error() override
+            {
+                return false;
+            }
+
+            void packet_consumed() override
+            {
+                complete = false;
+            }
+
+            void reset() override
+            {
+                packet_consumed();
+            }
+
+        private:
+            bool complete{ false };
+    };
+
+    /// Accepts a single connection and reads everything sent to it.
+    class Sink
+    {
+        public:
+            explicit Sink(uint16_t port);
+
+            ~Sink();
+
+            Sink(const Sink&) = delete;
+
+            Sink& operator=(const Sink&) = delete;
+
+            void start();
+
+            [[nodiscard]] uint64_t get_received() const
+            {
+                return received;
+            }
+
+        private:
+            void run();
+
+            uint16_t port;
+            std::thread worker{};
+            std::atomic_bool running{ false };
+            std::atomic<uint64_t> received{ 0 };
+    };
+
+    /// Sends 64 byte and 1 kB messages as fast as the transmit buffer allows, with and without
+    /// corking, and reports messages per second, throughput and the number of completed sends per second.
+    class App
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::TransmitBufferEmptyEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::DataAvailableEvent<BenchProtocol>>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::ConnectionStatusEvent>
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void tick() override;
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent&) override;
+
+            void event(const smooth::core::network::event::DataAvailableEvent<BenchProtocol>&) override;
+
+            void event(const smooth::core::network::event::ConnectionStatusEvent& event) override;
+
+        private:
+            void fill();
+
+            void start_round();
+
+            Sink sink;
+            std::shared_ptr<smooth::core::network::BufferContainer<BenchProtocol>> buffers;
+            std::shared_ptr<smooth::core::network::Socket<BenchProtocol>> sock{};
+            std::chrono::steady_clock::time_point round_start{};
+            uint64_t received_at_start = 0;
+            uint64_t messages = 0;
+            uint64_t sends = 0;
+            size_t round = 0;
+            bool connected = false;
+    };
+}
@@ -0,0 +1,356 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "socket_read_bench.h"
+#include <array>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/Wifi.h"
+
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::core::network::event;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+static std::atomic<uint64_t> recv_calls{ 0 };
+
+// This benchmark is Linux only; count the calls by providing recv() ourselves.
+extern "C" ssize_t recv(int fd, void* buf, size_t len, int flags)
+{
+    ++recv_calls;
+
+    return syscall(SYS_recvfrom, fd, buf, len, flags, nullptr, nullptr);
+}
+
+namespace socket_read_bench
+{
+    static constexpr uint16_t base_port = 18840;
+    static const char* tag = "Bench";
+
+    enum class Kind
+    {
+        MQTT,
+        Websocket,
+        HTTP
+    };
+
+    struct Round
+    {
+        Kind kind;
+        const char* name;
+        bool lock_step;
+        int count;
+    };
+
+    static constexpr std::array<Round, 5> rounds{ { { Kind::MQTT, "MQTT", false, 50000 },
+                                                    { Kind::MQTT, "MQTT", true, 5000 },
+                                                    { Kind::Websocket, "Websocket", false, 50000 },
+                                                    { Kind::Websocket, "Websocket", true, 5000 },
+                                                    { Kind::HTTP, "HTTP", true, 5000 } } };
+
+    static constexpr size_t payload_size = 32;
+
+    static std::vector<uint8_t> mqtt_publish()
+    {
+        // QoS 0 PUBLISH to topic "bench"
+        std::vector<uint8_t> m{ 0x30, static_cast<uint8_t>(2 + 5 + payload_size), 0x00, 0x05, 'b', 'e', 'n', 'c', 'h' };
+        m.insert(m.end(), payload_size, 'x');
+
+        return m;
+    }
+
+    static std::vector<uint8_t> websocket_frame()
+    {
+        // Final, binary frame with a masked payload, as sent by a client.
+        std::vector<uint8_t> m{ 0x82, static_cast<uint8_t>(0x80 | payload_size), 1, 2, 3, 4 };
+
+        for (size_t i = 0; i < payload_size; ++i)
+        {
+            m.push_back(static_cast<uint8_t>('x' ^ m[2 + i % 4]));
+        }
+
+        return m;
+    }
+
+    static std::vector<uint8_t> http_request()
+    {
+        std::string s{ "POST /bench HTTP/1.1\r\nHost: localhost\r\nContent-Length: 32\r\n\r\n" };
+        s.append(payload_size, 'x');
+
+        return { s.begin(), s.end() };
+    }
+
+    static std::vector<uint8_t> upgrade_request()
+    {
+        std::string s{ "GET /ws HTTP/1.1\r\nHost: localhost\r\nConnection: Upgrade\r\nUpgrade: websocket\r\n\r\n" };
+
+        return { s.begin(), s.end() };
+    }
+
+    Feeder::~Feeder()
+    {
+        stop();
+    }
+
+    void Feeder::start(uint16_t port,
+                       std::vector<uint8_t> pre,
+                       std::vector<uint8_t> msg,
+                       int message_count,
+                       bool step)
+    {
+        preamble = std::move(pre);
+        message = std::move(msg);
+        count = message_count;
+        lock_step = step;
+        delivered_count = 0;
+        running = true;
+        listening = false;
+        worker = std::thread([this, port]() { run(port); });
+
+        // Don't let the client connect before there is someone to connect to.
+        while (running && !listening)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void Feeder::stop()
+    {
+        running = false;
+
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    void Feeder::run(uint16_t port)
+    {
+        auto listener = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0
+            && listen(listener, 1) == 0)
+        {
+            listening = true;
+            auto client = accept(listener, nullptr, nullptr);
+
+            if (client >= 0)
+            {
+                feed(client);
+                close(client);
+            }
+        }
+        else
+        {
+            Log::error(tag, "Could not listen on port {}", port);
+            running = false;
+        }
+
+        close(listener);
+    }
+
+    void Feeder::feed(int client)
+    {
+        // When streaming, send many messages per call so that the sender isn't the bottleneck.
+        const int per_send = lock_step ? 1 : 64;
+        std::vector<uint8_t> data{};
+
+        for (int i = 0; i < per_send; ++i)
+        {
+            data.insert(data.end(), message.begin(), message.end());
+        }
+
+        bool ok = true;
+
+        if (!preamble.empty())
+        {
+            // Like a websocket client, wait for the upgrade to be acknowledged before sending any frames.
+            ok = send(client, preamble.data(), preamble.size(), MSG_NOSIGNAL)
+                 == static_cast<ssize_t>(preamble.size());
+
+            while (running && ok && delivered_count == 0)
+            {
+                std::this_thread::yield();
+            }
+
+            delivered_count = 0;
+        }
+
+        int sent = 0;
+
+        while (running && ok && sent < count)
+        {
+            ok = send(client, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size());
+            sent += per_send;
+
+            while (running && lock_step && delivered_count < sent)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        while (running)
+        {
+            std::this_thread::sleep_for(milliseconds(10));
+        }
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1)),
+              mqtt_buffers(std::make_shared<BufferContainer<MQTTProto>>(*this, *this, *this, *this,
+                                                                        std::make_unique<MQTTProto>())),
+              http_buffers(std::make_shared<BufferContainer<HTTPProto>>(*this, *this, *this, *this,
+                                                                        std::make_unique<HTTPProto>(1024, 1024,
+                                                                                                    *this)))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        // On Linux this only announces that the network is up.
+        get_wifi().connect_to_ap();
+        std::this_thread::sleep_for(milliseconds(100));
+        start_round();
+    }
+
+    template<typename Protocol>
+    std::shared_ptr<ISocket> App::connect(const std::shared_ptr<BufferContainer<Protocol>>& buffers, uint16_t port)
+    {
+        auto s = Socket<Protocol>::create(buffers);
+        s->start(std::make_shared<IPv4>("127.0.0.1", port));
+
+        return s;
+    }
+
+    void App::start_round()
+    {
+        const auto& r = rounds[round];
+        auto port = static_cast<uint16_t>(base_port + round);
+        upgraded = false;
+
+        if (r.kind == Kind::MQTT)
+        {
+            feeder.start(port, {}, mqtt_publish(), r.count, r.lock_step);
+            sock = connect(mqtt_buffers, port);
+        }
+        else if (r.kind == Kind::Websocket)
+        {
+            // Websocket frames are received by an upgraded HTTP protocol, just like on a server.
+            feeder.start(port, upgrade_request(), websocket_frame(), r.count, r.lock_step);
+            sock = connect(http_buffers, port);
+        }
+        else
+        {
+            feeder.start(port, {}, http_request(), r.count, r.lock_step);
+            sock = connect(http_buffers, port);
+        }
+
+        begin_measurement();
+    }
+
+    void App::begin_measurement()
+    {
+        received = 0;
+        recv_at_start = recv_calls;
+        round_start = steady_clock::now();
+    }
+
+    void App::message_received()
+    {
+        ++received;
+        feeder.delivered();
+
+        if (round < rounds.size() && received == rounds[round].count)
+        {
+            const auto& r = rounds[round];
+            auto elapsed = duration_cast<duration<double>>(steady_clock::now() - round_start).count();
+            auto calls = static_cast<double>(recv_calls - recv_at_start);
+
+            Log::info(tag, "{:>9}, {:>9}: {:6.2f} recv() calls per message, {:>8.0f} msg/s",
+                      r.name,
+                      r.lock_step ? "lock-step" : "streaming",
+                      calls / r.count,
+                      r.count / elapsed);
+
+            sock->stop("Round done");
+            feeder.stop();
+            ++round;
+
+            if (round < rounds.size())
+            {
+                start_round();
+            }
+            else
+            {
+                Log::info(tag, "Done");
+            }
+        }
+    }
+
+    void App::event(const DataAvailableEvent<MQTTProto>& event)
+    {
+        MQTTProto::packet_type p;
+
+        if (event.get(p))
+        {
+            message_received();
+        }
+    }
+
+    void App::event(const DataAvailableEvent<HTTPProto>& event)
+    {
+        HTTPProto::packet_type p;
+
+        if (event.get(p))
+        {
+            if (rounds[round].kind == Kind::Websocket && !upgraded)
+            {
+                upgraded = true;
+                http_buffers->get_protocol().upgrade_to_websocket();
+                begin_measurement();
+                feeder.delivered();
+            }
+            else
+            {
+                message_received();
+            }
+        }
+    }
+
+    void App::event(const TransmitBufferEmptyEvent&)
+    {
+    }
+
+    void App::event(const ConnectionStatusEvent&)
+    {
+    }
+}
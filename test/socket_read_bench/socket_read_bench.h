@@ -0,0 +1,144 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/Socket.h"
+#include "smooth/core/network/event/ConnectionStatusEvent.h"
+#include "smooth/core/network/event/DataAvailableEvent.h"
+#include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
+#include "smooth/application/network/http/HTTPProtocol.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/mqtt/packet/MQTTProtocol.h"
+
+namespace socket_read_bench
+{
+    /// Accepts a single connection and sends it the same message a number of times, either as fast
+    /// as possible or waiting for the previous message to be delivered to the application first.
+    class Feeder
+    {
+        public:
+            Feeder() = default;
+
+            ~Feeder();
+
+            Feeder(const Feeder&) = delete;
+
+            Feeder& operator=(const Feeder&) = delete;
+
+            void start(uint16_t port,
+                       std::vector<uint8_t> preamble,
+                       std::vector<uint8_t> message,
+                       int count,
+                       bool lock_step);
+
+            void stop();
+
+            void delivered()
+            {
+                ++delivered_count;
+            }
+
+        private:
+            void run(uint16_t port);
+
+            void feed(int client);
+
+            std::vector<uint8_t> preamble{};
+            std::vector<uint8_t> message{};
+            int count = 0;
+            bool lock_step = false;
+            std::thread worker{};
+            std::atomic_bool running{ false };
+            std::atomic_bool listening{ false };
+            std::atomic_int delivered_count{ 0 };
+    };
+
+    using MQTTProto = smooth::application::network::mqtt::packet::MQTTProtocol;
+    using HTTPProto = smooth::application::network::http::HTTPProtocol;
+
+    /// Receives MQTT, websocket and HTTP messages and reports the number of recv() calls per message.
+    class App
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::TransmitBufferEmptyEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::ConnectionStatusEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::DataAvailableEvent<MQTTProto>>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::DataAvailableEvent<HTTPProto>>,
+        public smooth::application::network::http::IServerResponse
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent&) override;
+
+            void event(const smooth::core::network::event::ConnectionStatusEvent&) override;
+
+            void event(const smooth::core::network::event::DataAvailableEvent<MQTTProto>& event) override;
+
+            void event(const smooth::core::network::event::DataAvailableEvent<HTTPProto>& event) override;
+
+            void reply(std::unique_ptr<smooth::application::network::http::IResponseOperation>, bool) override
+            {
+            }
+
+            void reply_error(std::unique_ptr<smooth::application::network::http::IResponseOperation>) override
+            {
+            }
+
+        protected:
+            smooth::core::Task& get_task() override
+            {
+                return *this;
+            }
+
+            void upgrade_to_websocket_internal() override
+            {
+            }
+
+        private:
+            void start_round();
+
+            void message_received();
+
+            void begin_measurement();
+
+            template<typename Protocol>
+            std::shared_ptr<smooth::core::network::ISocket>
+            connect(const std::shared_ptr<smooth::core::network::BufferContainer<Protocol>>& buffers, uint16_t port);
+
+            Feeder feeder{};
+            std::shared_ptr<smooth::core::network::BufferContainer<MQTTProto>> mqtt_buffers;
+            std::shared_ptr<smooth::core::network::BufferContainer<HTTPProto>> http_buffers;
+            std::shared_ptr<smooth::core::network::ISocket> sock{};
+            std::chrono::steady_clock::time_point round_start{};
+            uint64_t recv_at_start = 0;
+            int received = 0;
+            bool upgraded = false;
+            size_t round = 0;
+    };
+}
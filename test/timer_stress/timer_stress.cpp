@@ -0,0 +1,154 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "timer_stress.h"
+#include <algorithm>
+#include <random>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::timer;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace timer_stress
+{
+    static constexpr const char* tag = "Stress";
+    static constexpr int timer_count = 10000;
+    static constexpr seconds report_interval{ 5 };
+    static constexpr size_t report_count = 6;
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1)),
+              queue(ExpiredQueue::create(timer_count * 2, *this, *this))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> dist(100, 1000);
+
+        timers.reserve(timer_count);
+        intervals.reserve(timer_count);
+        last_expiry.resize(timer_count);
+        restarted.resize(timer_count);
+        jitter.reserve(timer_count * 50);
+
+        for (int i = 0; i < timer_count; ++i)
+        {
+            intervals.emplace_back(dist(gen));
+            timers.emplace_back(i, queue, true, intervals.back());
+        }
+
+        auto start = steady_clock::now();
+
+        for (int i = 0; i < timer_count; ++i)
+        {
+            timers[static_cast<size_t>(i)]->start();
+            last_expiry[static_cast<size_t>(i)] = steady_clock::now();
+        }
+
+        auto started = steady_clock::now();
+
+        Log::info(tag, "Started {} timers in {} us", timer_count, duration_cast<microseconds>(started - start).count());
+
+        period_start = started;
+    }
+
+    void App::tick()
+    {
+        if (reports < report_count && steady_clock::now() - period_start >= report_interval)
+        {
+            report();
+
+            if (++reports == report_count)
+            {
+                auto start = steady_clock::now();
+
+                for (auto& t : timers)
+                {
+                    t->stop();
+                }
+
+                Log::info(tag, "Stopped {} timers in {} us",
+                          timer_count,
+                          duration_cast<microseconds>(steady_clock::now() - start).count());
+
+                Log::info(tag, "Done");
+            }
+            else if (reports == report_count / 2)
+            {
+                // Restart half of the timers while running, as is done with e.g. keep-alive timers.
+                auto start = steady_clock::now();
+
+                for (size_t i = 0; i < timers.size(); i += 2)
+                {
+                    timers[i]->reset();
+                    last_expiry[i] = steady_clock::now();
+                    restarted[i] = true;
+                }
+
+                Log::info(tag, "Restarted {} timers in {} us",
+                          timer_count / 2,
+                          duration_cast<microseconds>(steady_clock::now() - start).count());
+            }
+        }
+    }
+
+    void App::event(const TimerExpiredEvent& event)
+    {
+        auto now = steady_clock::now();
+        auto id = static_cast<size_t>(event.get_id());
+        auto actual = now - last_expiry[id];
+        auto deviation = duration_cast<microseconds>(actual - intervals[id]);
+
+        if (restarted[id])
+        {
+            // The expiry may have been queued before the restart, skip it.
+            restarted[id] = false;
+        }
+        else
+        {
+            jitter.push_back(deviation < microseconds(0) ? -deviation : deviation);
+        }
+
+        last_expiry[id] = now;
+    }
+
+    void App::report()
+    {
+        auto elapsed = duration_cast<milliseconds>(steady_clock::now() - period_start);
+
+        if (!jitter.empty())
+        {
+            std::sort(jitter.begin(), jitter.end());
+
+            Log::info(tag, "{} expiries/s, jitter p50: {} us, p99: {} us, max: {} us",
+                      static_cast<int64_t>(jitter.size()) * 1000 / elapsed.count(),
+                      jitter[jitter.size() / 2].count(),
+                      jitter[jitter.size() * 99 / 100].count(),
+                      jitter.back().count());
+        }
+
+        jitter.clear();
+        period_start = steady_clock::now();
+    }
+}
@@ -0,0 +1,60 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/ipc/TaskEventQueue.h"
+#include "smooth/core/timer/Timer.h"
+#include "smooth/core/timer/TimerExpiredEvent.h"
+
+namespace timer_stress
+{
+    /// Runs 10000 repeating timers with intervals between 100 and 1000 ms and reports how much the
+    /// time between two expiries of each timer deviates from its interval (jitter), as well as the
+    /// time it takes to start, and to stop and restart, all timers.
+    class App
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<smooth::core::timer::TimerExpiredEvent>
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void tick() override;
+
+            void event(const smooth::core::timer::TimerExpiredEvent& event) override;
+
+        private:
+            void report();
+
+            using ExpiredQueue = smooth::core::ipc::TaskEventQueue<smooth::core::timer::TimerExpiredEvent>;
+            std::shared_ptr<ExpiredQueue> queue;
+            std::vector<smooth::core::timer::TimerOwner> timers{};
+            std::vector<std::chrono::milliseconds> intervals{};
+            std::vector<std::chrono::steady_clock::time_point> last_expiry{};
+            std::vector<bool> restarted{};
+            std::vector<std::chrono::microseconds> jitter{};
+            std::chrono::steady_clock::time_point period_start{};
+            size_t reports = 0;
+    };
+}